@@ -0,0 +1,198 @@
+#include "stdafx.h"
+#include "Benchmark.h"
+
+#include "AI/Astar.h"
+
+#include <random>
+
+static constexpr int s_GridSizes[] = { 256, 1024, 4096 };
+static constexpr float s_ObstacleDensity = 0.15f;
+static constexpr size_t s_QueryCount = 32;
+static constexpr int s_ShortQueryRange = 48;
+
+// The A* this engine shipped before the open list became a binary heap, kept here as the baseline.
+// Open and closed lists are std::sets searched linearly, so it only runs on the short queries
+namespace LegacyAstar
+{
+	struct Node
+	{
+		uint32_t G = 0, H = 0;
+		Astar::GridCoord coordinates;
+		Ref<Node> parent;
+
+		Node(Astar::GridCoord coordinates, Ref<Node> parent = nullptr)
+			:coordinates(coordinates), parent(parent) {}
+
+		uint32_t GetScore() const { return G + H; }
+	};
+
+	using NodeSet = std::set<Ref<Node>>;
+
+	static const Astar::GridCoord s_Direction[8] = {
+		{ 0, 1 }, { 1, 0 }, { 0, -1 }, { -1, 0 },
+		{ -1, -1 }, { 1, 1 }, { -1, 1 }, { 1, -1 }
+	};
+
+	static Ref<Node> FindNodeOnList(const NodeSet& nodes, Astar::GridCoord coordinates)
+	{
+		for (Ref<Node> node : nodes)
+		{
+			if (node->coordinates == coordinates)
+				return node;
+		}
+		return nullptr;
+	}
+
+	static std::vector<Vector2f> FindPath(Vector2f source, Vector2f goal, const Astar::AstarGrid* grid)
+	{
+		std::vector<Vector2f> path;
+
+		Astar::GridCoord sourceCoords;
+		Astar::GridCoord goalCoords;
+
+		if (!grid->PositionToGridCoord(source, sourceCoords) || !grid->PositionToGridCoord(goal, goalCoords))
+			return path;
+
+		Ref<Node> current = nullptr;
+		NodeSet openSet;
+		NodeSet closedSet;
+
+		openSet.insert(CreateRef<Node>(sourceCoords));
+
+		while (!openSet.empty())
+		{
+			current = *openSet.begin();
+			for (Ref<Node> node : openSet)
+			{
+				if (node->GetScore() <= current->GetScore())
+					current = node;
+			}
+
+			if (current->coordinates == goalCoords)
+				break;
+
+			closedSet.insert(current);
+			openSet.erase(current);
+
+			for (uint32_t i = 0; i < 8; i++)
+			{
+				Astar::GridCoord newCoords(current->coordinates + s_Direction[i]);
+
+				if (grid->DetectCollision(newCoords) || FindNodeOnList(closedSet, newCoords))
+					continue;
+
+				uint32_t totalcost = current->G + ((i < 4) ? 10 : 14);
+
+				Ref<Node> successor = FindNodeOnList(openSet, newCoords);
+
+				if (successor == nullptr)
+				{
+					successor = CreateRef<Node>(newCoords, current);
+					successor->G = totalcost;
+					successor->H = Astar::Heuristic::Octagonal(successor->coordinates, goalCoords);
+					openSet.insert(successor);
+				}
+				else if (totalcost < successor->G)
+				{
+					successor->parent = current;
+					successor->G = totalcost;
+				}
+			}
+		}
+
+		while (current != nullptr)
+		{
+			Vector2f position;
+			grid->GridCoordToPosition(current->coordinates, position);
+			path.push_back(position);
+			current = current->parent;
+		}
+		return path;
+	}
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+struct BenchmarkGrid
+{
+	// std::vector<bool> is packed so the cells are stored as bytes behind the bool** the grid expects
+	Scope<bool[]> cells;
+	std::vector<bool*> columns;
+	Scope<Astar::AstarGrid> grid;
+
+	BenchmarkGrid(int size, std::mt19937& generator)
+	{
+		std::bernoulli_distribution obstacle(s_ObstacleDensity);
+
+		cells = Scope<bool[]>(new bool[(size_t)size * size]);
+		columns.resize(size);
+
+		for (int x = 0; x < size; x++)
+		{
+			columns[x] = cells.get() + (size_t)x * size;
+			for (int y = 0; y < size; y++)
+				columns[x][y] = obstacle(generator);
+		}
+
+		grid = CreateScope<Astar::AstarGrid>(size, size, 1.0f, 1.0f, Vector2f(0.0f, 0.0f), columns.data());
+	}
+
+	Vector2f Free(int x, int y)
+	{
+		columns[x][y] = false;
+		return Vector2f((float)x + 0.5f, (float)y + 0.5f);
+	}
+};
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+BENCHMARK(Astar)
+{
+	std::mt19937 generator(1234);
+	Astar::Generator* astar = Astar::Generator::GetInstance();
+
+	for (int size : s_GridSizes)
+	{
+		BenchmarkGrid grid(size, generator);
+		std::string label = std::to_string(size) + "x" + std::to_string(size);
+
+		// Short queries both implementations can answer in reasonable time
+		std::uniform_int_distribution<int> position(0, size - 1 - s_ShortQueryRange);
+		std::uniform_int_distribution<int> offset(s_ShortQueryRange / 2, s_ShortQueryRange);
+
+		std::vector<std::pair<Vector2f, Vector2f>> shortQueries;
+		while (shortQueries.size() < s_QueryCount)
+		{
+			int x = position(generator), y = position(generator);
+			Vector2f source = grid.Free(x, y);
+			Vector2f goal = grid.Free(x + offset(generator), y + offset(generator));
+
+			// Unreachable goals make the legacy version flood the whole grid
+			if (!astar->FindPath(source, goal, grid.grid.get()).empty())
+				shortQueries.emplace_back(source, goal);
+		}
+
+		size_t index = 0;
+		double legacyMs = Benchmark::Time(s_QueryCount, [&]()
+			{
+				auto& [source, goal] = shortQueries[index++ % shortQueries.size()];
+				LegacyAstar::FindPath(source, goal, grid.grid.get());
+			});
+		Benchmark::Report(label + " short, legacy", legacyMs, "ms/path");
+
+		index = 0;
+		double currentMs = Benchmark::Time(s_QueryCount, [&]()
+			{
+				auto& [source, goal] = shortQueries[index++ % shortQueries.size()];
+				astar->FindPath(source, goal, grid.grid.get());
+			});
+		Benchmark::Report(label + " short, current", currentMs, "ms/path");
+		Benchmark::Report(label + " short, speedup", legacyMs / currentMs, "x");
+
+		// Corner to corner, only the current implementation finishes these
+		Vector2f source = grid.Free(0, 0);
+		Vector2f goal = grid.Free(size - 1, size - 1);
+		double crossMs = Benchmark::Time(4, [&]() { astar->FindPath(source, goal, grid.grid.get()); });
+		Benchmark::Report(label + " corner to corner, current", crossMs, "ms/path");
+	}
+}
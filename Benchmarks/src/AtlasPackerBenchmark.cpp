@@ -0,0 +1,102 @@
+#include "stdafx.h"
+#include "Benchmark.h"
+
+#include "Renderer/AtlasPacker.h"
+#include "Renderer/TextureAtlas.h"
+
+#include <random>
+
+static constexpr uint32_t s_PageSize = 2048;
+static constexpr uint32_t s_RectCount = 16384; // more than fit in a page for every size range
+
+struct SizeRange
+{
+	const char* label;
+	uint32_t min, max;
+};
+
+static constexpr SizeRange s_SizeRanges[] = { { "8-32", 8, 32 }, { "16-128", 16, 128 }, { "32-256", 32, 256 } };
+
+struct RectSize
+{
+	uint32_t width, height;
+};
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Offer every rectangle to an empty page, the ones that don't fit are skipped
+static uint32_t FillPage(AtlasPacker& packer, const std::vector<RectSize>& sizes)
+{
+	packer.Clear();
+
+	AtlasPacker::Rect rect;
+	uint32_t inserted = 0;
+	for (const RectSize& size : sizes)
+	{
+		if (packer.Insert(size.width, size.height, rect))
+			inserted++;
+	}
+	return inserted;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+BENCHMARK(AtlasPacker)
+{
+	std::mt19937 generator(1234);
+	AtlasPacker packer(s_PageSize, s_PageSize);
+
+	for (const SizeRange& range : s_SizeRanges)
+	{
+		std::string label = std::string(range.label) + " texels";
+		std::uniform_int_distribution<uint32_t> size(range.min, range.max);
+
+		std::vector<RectSize> sizes(s_RectCount);
+		for (RectSize& rectSize : sizes)
+			rectSize = { size(generator), size(generator) };
+
+		// In the order textures are first drawn
+		uint32_t inserted = 0;
+		double packMs = Benchmark::Time(20, [&]() { inserted = FillPage(packer, sizes); });
+		Benchmark::Report(label + ", pack a page", packMs, "ms");
+		Benchmark::Report(label + ", rectangles per page", inserted, "rects");
+		Benchmark::Report(label + ", occupancy", 100.0 * packer.GetOccupancy(), "%");
+
+		// Tallest first, the order the atlas repacks a page in
+		std::sort(sizes.begin(), sizes.end(), [](const RectSize& a, const RectSize& b) { return a.height > b.height; });
+		double repackMs = Benchmark::Time(20, [&]() { inserted = FillPage(packer, sizes); });
+		Benchmark::Report(label + ", repack a page", repackMs, "ms");
+		Benchmark::Report(label + ", repacked occupancy", 100.0 * packer.GetOccupancy(), "%");
+	}
+
+	// The same through the atlas, which adds a gutter around each texture and tracks what is in the page
+	if (!Benchmark::InitRenderer())
+		return;
+
+	bool enabled = TextureAtlas::IsEnabled();
+	for (const SizeRange& range : s_SizeRanges)
+	{
+		std::string label = std::string(range.label) + " texels";
+		std::uniform_int_distribution<uint32_t> size(range.min, range.max);
+
+		std::vector<Ref<Texture>> textures(s_RectCount);
+		for (Ref<Texture>& texture : textures)
+			texture = Texture2D::Create(size(generator), size(generator));
+
+		double atlasMs = Benchmark::Time(5, [&]()
+			{
+				TextureAtlas::Init(s_PageSize, 1, range.max);
+				TextureAtlas::SetEnabled(true);
+				for (const Ref<Texture>& texture : textures)
+					TextureAtlas::Find(texture);
+			});
+
+		TextureAtlas::Stats stats = TextureAtlas::GetStats();
+		Benchmark::Report(label + ", atlas fill a page", atlasMs, "ms");
+		Benchmark::Report(label + ", atlas textures per page", stats.textures, "textures");
+		Benchmark::Report(label + ", atlas occupancy with gutters", 100.0 * stats.occupancy, "%");
+	}
+
+	TextureAtlas::Init();
+	TextureAtlas::SetEnabled(enabled);
+}
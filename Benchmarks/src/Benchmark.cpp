@@ -0,0 +1,69 @@
+#include "stdafx.h"
+#include "Benchmark.h"
+
+#include "Renderer/Renderer.h"
+#include "Renderer/RenderCommand.h"
+
+struct RegisteredBenchmark
+{
+	const char* name;
+	Benchmark::Function function;
+};
+
+// Registered from static initializers so the list has to be created on first use
+static std::vector<RegisteredBenchmark>& GetBenchmarks()
+{
+	static std::vector<RegisteredBenchmark> s_Benchmarks;
+	return s_Benchmarks;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+bool Benchmark::Register(const char* name, Function function)
+{
+	GetBenchmarks().push_back({ name, function });
+	return true;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+int Benchmark::Run(int argc, char* argv[])
+{
+	std::vector<std::string> selected(argv + 1, argv + argc);
+
+	int run = 0;
+	for (const RegisteredBenchmark& benchmark : GetBenchmarks())
+	{
+		if (!selected.empty() && std::find(selected.begin(), selected.end(), benchmark.name) == selected.end())
+			continue;
+
+		std::printf("[%s]\n", benchmark.name);
+		benchmark.function();
+		run++;
+	}
+
+	if (run == 0)
+	{
+		std::printf("No benchmarks matched, available:\n");
+		for (const RegisteredBenchmark& benchmark : GetBenchmarks())
+			std::printf("  %s\n", benchmark.name);
+		return 1;
+	}
+	return 0;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void Benchmark::Report(const std::string& label, double value, const char* unit)
+{
+	std::printf("  %-48s %12.3f %s\n", label.c_str(), value, unit);
+	std::fflush(stdout);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+bool Benchmark::InitRenderer()
+{
+	static bool s_RendererInitialized = RenderCommand::CreateRendererAPI(true, false) == 0 && Renderer::Init();
+	return s_RendererInitialized;
+}
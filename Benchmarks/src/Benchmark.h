@@ -0,0 +1,39 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+
+// A named benchmark. Run the executable with the names of the benchmarks to run, or with no arguments to run them all
+class Benchmark
+{
+public:
+	using Function = void(*)();
+
+	static bool Register(const char* name, Function function);
+	static int Run(int argc, char* argv[]);
+
+	// Average milliseconds per call over the iterations, after one call to warm up
+	template<typename Func>
+	static double Time(size_t iterations, Func&& func)
+	{
+		func();
+
+		auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < iterations; i++)
+		{
+			func();
+		}
+		std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - start;
+		return duration.count() / (double)iterations;
+	}
+
+	static void Report(const std::string& label, double value, const char* unit);
+
+	// Start the renderer without a window, draws are recorded by the null renderer API rather than executed
+	static bool InitRenderer();
+};
+
+#define BENCHMARK(name) \
+	static void Benchmark_##name(); \
+	static bool s_Benchmark_##name = Benchmark::Register(#name, &Benchmark_##name); \
+	static void Benchmark_##name()
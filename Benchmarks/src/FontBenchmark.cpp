@@ -0,0 +1,103 @@
+#include "stdafx.h"
+#include "Benchmark.h"
+
+#include "Core/Application.h"
+#include "Renderer/Font.h"
+#include "Scene/Scene.h"
+#include "Scene/Entity.h"
+#include "Scene/Components.h"
+#include "Scene/SceneSerializer.h"
+#include "Scene/AssetManager.h"
+
+#include <fstream>
+
+static constexpr size_t s_TextComponentCount = 1000;
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static size_t ReadFile(const std::filesystem::path& filepath)
+{
+	std::ifstream file(filepath, std::ios::in | std::ios::binary | std::ios::ate);
+	if (!file)
+		return 0;
+
+	std::vector<char> contents((size_t)file.tellg());
+	file.seekg(0);
+	file.read(contents.data(), contents.size());
+	return contents.size();
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Font::Init with a cache should be little more than reading the font and its cache, the file reads are timed on their
+// own to check. The fonts are copied next to the benchmarks when they are built
+BENCHMARK(FontLoading)
+{
+	if (!Benchmark::InitRenderer())
+		return;
+
+	const std::filesystem::path fontPath = Application::GetWorkingDirectory() / "data" / "Fonts" / "Manrope-Medium.ttf";
+	if (!std::filesystem::exists(fontPath))
+	{
+		std::printf("  %s not found, run from the directory the benchmarks were built to\n", fontPath.string().c_str());
+		return;
+	}
+
+	// The warm up call writes the cache if there isn't one yet
+	double initMs = Benchmark::Time(20, []() { Font::Init(); });
+	Benchmark::Report("Font::Init, cached", initMs, "ms");
+
+	std::filesystem::path cachePath = fontPath;
+	cachePath.replace_extension(".fontcache");
+	size_t bytes = 0;
+	double readMs = Benchmark::Time(20, [&]() { bytes = ReadFile(fontPath) + ReadFile(cachePath); });
+	Benchmark::Report("read the font and cache files", readMs, "ms");
+	Benchmark::Report("font and cache size", (double)bytes / 1024.0, "KB");
+	Benchmark::Report("file reads, share of Font::Init", 100.0 * readMs / initMs, "%");
+
+	// A copy of the font so removing its cache doesn't touch the one beside the benchmarks
+	const std::filesystem::path directory = std::filesystem::temp_directory_path() / "FontBenchmark";
+	const std::filesystem::path copyPath = directory / fontPath.filename();
+	std::filesystem::path copyCachePath = copyPath;
+	copyCachePath.replace_extension(".fontcache");
+	std::filesystem::create_directories(directory);
+	std::filesystem::copy_file(fontPath, copyPath, std::filesystem::copy_options::overwrite_existing);
+
+	double generateMs = Benchmark::Time(3, [&]()
+		{
+			std::filesystem::remove(copyCachePath);
+			CreateRef<Font>(copyPath);
+		});
+	Benchmark::Report("load without a cache, generate and save", generateMs, "ms");
+
+	// Text components as a scene loads them, the first to use a font loads it and the rest find it in the asset manager
+	std::string prefab;
+	{
+		Scene scene("");
+		Entity entity = scene.CreateEntity();
+		TextComponent& textComp = entity.AddComponent<TextComponent>();
+		textComp.text = "Benchmark";
+		textComp.font = AssetManager::GetAsset<Font>(copyPath);
+		prefab = SceneSerializer::SerializeEntity(entity);
+	}
+
+	double firstMs = Benchmark::Time(20, [&]()
+		{
+			Scene scene("");
+			SceneSerializer::DeserializeEntity(&scene, prefab);
+		});
+	Benchmark::Report("deserialize a text entity, font not loaded", firstMs, "ms");
+
+	Ref<Font> loaded = AssetManager::GetAsset<Font>(copyPath);
+	double loadedMs = Benchmark::Time(5, [&]()
+		{
+			Scene scene("");
+			for (size_t i = 0; i < s_TextComponentCount; i++)
+				SceneSerializer::DeserializeEntity(&scene, prefab);
+		});
+	Benchmark::Report("deserialize a text entity, font already loaded", 1000.0 * loadedMs / s_TextComponentCount, "us");
+
+	loaded.reset();
+	Font::Shutdown();
+	std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,108 @@
+#include "stdafx.h"
+#include "Benchmark.h"
+
+#include "AI/HierarchicalPathfinder.h"
+#include "Core/ThreadPool.h"
+
+#include <random>
+
+static constexpr int s_GridSize = 512;
+static constexpr float s_ObstacleDensity = 0.15f;
+static constexpr size_t s_AgentCounts[] = { 100, 1000, 10000 };
+static constexpr size_t s_GoalCount = 8; // agents head for a few shared destinations, as crowds usually do
+static constexpr size_t s_AstarQueryCount = 1000;
+
+struct AgentQuery
+{
+	Astar::GridCoord source;
+	Astar::GridCoord goal;
+};
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static double QueriesPerSecond(size_t queries, double ms)
+{
+	return (double)queries / (ms / 1000.0);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+BENCHMARK(HierarchicalPathfinder)
+{
+	std::mt19937 generator(1234);
+	std::bernoulli_distribution obstacle(s_ObstacleDensity);
+	std::uniform_int_distribution<int> cell(0, s_GridSize - 1);
+
+	Scope<bool[]> cells(new bool[(size_t)s_GridSize * s_GridSize]);
+	std::vector<bool*> columns(s_GridSize);
+	for (int x = 0; x < s_GridSize; x++)
+	{
+		columns[x] = cells.get() + (size_t)x * s_GridSize;
+		for (int y = 0; y < s_GridSize; y++)
+			columns[x][y] = obstacle(generator);
+	}
+
+	auto freeCell = [&]()
+	{
+		Astar::GridCoord coordinate(cell(generator), cell(generator));
+		columns[coordinate.x][coordinate.y] = false;
+		return coordinate;
+	};
+
+	std::vector<Astar::GridCoord> goals;
+	for (size_t i = 0; i < s_GoalCount; i++)
+		goals.push_back(freeCell());
+
+	std::vector<AgentQuery> queries(s_AgentCounts[std::size(s_AgentCounts) - 1]);
+	for (size_t i = 0; i < queries.size(); i++)
+		queries[i] = { freeCell(), goals[i % s_GoalCount] };
+
+	Astar::AstarGrid grid(s_GridSize, s_GridSize, 1.0f, 1.0f, Vector2f(0.0f, 0.0f), columns.data());
+
+	Astar::HierarchicalPathfinder pathfinder;
+	double buildMs = Benchmark::Time(1, [&]() { pathfinder.Build(grid); });
+	Benchmark::Report("build 512x512", buildMs, "ms");
+
+	// Flat A* on the same queries as the baseline, its cost doesn't depend on how many agents there are
+	Astar::Generator* astar = Astar::Generator::GetInstance();
+	size_t index = 0;
+	double astarMs = Benchmark::Time(s_AstarQueryCount, [&]()
+		{
+			const AgentQuery& query = queries[index++ % queries.size()];
+			Vector2f source, goal;
+			grid.GridCoordToPosition(query.source, source);
+			grid.GridCoordToPosition(query.goal, goal);
+			astar->FindPath(source, goal, &grid);
+		});
+	Benchmark::Report("flat A*", QueriesPerSecond(1, astarMs), "queries/s");
+
+	for (size_t agents : s_AgentCounts)
+	{
+		std::string label = std::to_string(agents) + " agents";
+
+		pathfinder.ResetStats();
+		double singleMs = Benchmark::Time(3, [&]()
+			{
+				for (size_t i = 0; i < agents; i++)
+					pathfinder.FindPath(queries[i].source, queries[i].goal);
+			});
+		Benchmark::Report(label + ", 1 thread", QueriesPerSecond(agents, singleMs), "queries/s");
+
+		Astar::HierarchicalPathfinder::Stats stats = pathfinder.GetStats();
+		uint32_t lookups = stats.cacheHits + stats.cacheMisses;
+		Benchmark::Report(label + ", cache hit rate", lookups > 0 ? 100.0 * stats.cacheHits / lookups : 0.0, "%");
+
+		ThreadPool::Init();
+		double parallelMs = Benchmark::Time(3, [&]()
+			{
+				ThreadPool::ParallelFor(agents, 16, [&](size_t begin, size_t end)
+					{
+						for (size_t i = begin; i < end; i++)
+							pathfinder.FindPath(queries[i].source, queries[i].goal);
+					});
+			});
+		Benchmark::Report(label + ", " + std::to_string(ThreadPool::GetThreadCount()) + " threads", QueriesPerSecond(agents, parallelMs), "queries/s");
+	}
+
+	ThreadPool::Shutdown();
+}
@@ -0,0 +1,86 @@
+#include "stdafx.h"
+#include "Benchmark.h"
+
+#include "Logging/Instrumentor.h"
+
+#include <thread>
+
+static constexpr size_t s_ScopesPerBatch = 10000; // fits in a thread's ring buffer
+static constexpr size_t s_BatchCount = 50;
+static constexpr std::chrono::milliseconds s_DrainWait(25); // longer than the writer's drain interval
+
+static volatile uint64_t s_Sink = 0;
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Timed directly rather than through PROFILE_SCOPE so the cost is measured in debug builds too
+static void RecordScopes(uint32_t nameId)
+{
+	for (size_t i = 0; i < s_ScopesPerBatch; i++)
+	{
+		InstrumentationTimer timer(nameId);
+		s_Sink = s_Sink + 1;
+	}
+}
+
+static void EmptyScopes()
+{
+	for (size_t i = 0; i < s_ScopesPerBatch; i++)
+	{
+		s_Sink = s_Sink + 1;
+	}
+}
+
+// Back to back batches would fill the ring faster than the writer drains it and time the dropping instead,
+// so each batch is timed on its own and the writer catches up in between
+static double TimeRecording(uint32_t nameId)
+{
+	RecordScopes(nameId);
+
+	std::chrono::duration<double, std::milli> total(0.0);
+	for (size_t i = 0; i < s_BatchCount; i++)
+	{
+		std::this_thread::sleep_for(s_DrainWait);
+
+		auto start = std::chrono::steady_clock::now();
+		RecordScopes(nameId);
+		total += std::chrono::steady_clock::now() - start;
+	}
+	return total.count() / (double)s_BatchCount;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+BENCHMARK(Instrumentor)
+{
+	const uint32_t nameId = Instrumentor::InternName("Benchmark scope");
+	auto toNs = [](double batchMs) { return batchMs * 1.0e6 / (double)s_ScopesPerBatch; };
+
+	double emptyMs = Benchmark::Time(s_BatchCount, EmptyScopes);
+
+	// Without a session the timer only checks whether anything is recording
+	double idleMs = Benchmark::Time(s_BatchCount, [nameId]() { RecordScopes(nameId); });
+	Benchmark::Report("scope, not recording", toNs(idleMs - emptyMs), "ns/scope");
+
+	std::filesystem::path filepath = std::filesystem::temp_directory_path() / "InstrumentorBenchmark.prof";
+	bool wasEnabled = Instrumentor::IsEnabled();
+	Instrumentor::Enable();
+
+	for (ProfileFormat format : { ProfileFormat::Binary, ProfileFormat::ChromeTrace })
+	{
+		std::string label = format == ProfileFormat::Binary ? "scope, recording binary" : "scope, recording chrome trace";
+
+		Instrumentor::BeginSession("Benchmark", filepath.string(), format);
+		uint64_t droppedBefore = Instrumentor::GetDroppedEvents();
+		double recordingMs = TimeRecording(nameId);
+		uint64_t dropped = Instrumentor::GetDroppedEvents() - droppedBefore;
+		Instrumentor::EndSession("Benchmark");
+
+		Benchmark::Report(label, toNs(recordingMs - emptyMs), "ns/scope");
+		Benchmark::Report(label + ", dropped", (double)dropped, "events");
+	}
+
+	if (!wasEnabled)
+		Instrumentor::Disable();
+	std::filesystem::remove(filepath);
+}
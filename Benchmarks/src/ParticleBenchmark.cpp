@@ -0,0 +1,67 @@
+#include "stdafx.h"
+#include "Benchmark.h"
+
+#include "ParticleSystem/ParticleSystem.h"
+#include "Renderer/Renderer.h"
+#include "Renderer/Renderer2D.h"
+
+static constexpr uint32_t s_ParticleCounts[] = { 10000, 100000, 1000000 };
+static constexpr float s_DeltaTime = 1.0f / 60.0f;
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static ParticleProps MakeProps(float lifeTime)
+{
+	ParticleProps props;
+	props.velocity = Vector2f(0.0f, 2.0f);
+	props.velocityVariation = Vector2f(3.0f, 1.0f);
+	props.beginColour = Colour(1.0f, 0.5f, 0.0f, 1.0f);
+	props.endColour = Colour(0.2f, 0.2f, 0.2f, 0.0f);
+	props.rotationSpeed = 1.0f;
+	props.lifeTime = lifeTime;
+	return props;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+BENCHMARK(ParticleSystem)
+{
+	bool rendering = Benchmark::InitRenderer();
+
+	for (uint32_t count : s_ParticleCounts)
+	{
+		std::string label = std::to_string(count) + " particles";
+		ParticleSystem particleSystem(count);
+
+		// Nothing expires, so this is the cost of integrating a full system
+		ParticleProps immortal = MakeProps(1.0e6f);
+		particleSystem.Emit(immortal, count);
+		double updateMs = Benchmark::Time(20, [&]() { particleSystem.OnUpdate(s_DeltaTime); });
+		Benchmark::Report(label + ", update", updateMs, "ms/frame");
+
+		// A one second life time at 60fps with a sixtieth emitted each frame adds removal and emission.
+		// Running for a couple of seconds first spreads out the ages so particles expire every frame
+		particleSystem.Clear();
+		ParticleProps shortLived = MakeProps(1.0f);
+		auto frame = [&]()
+		{
+			particleSystem.OnUpdate(s_DeltaTime);
+			particleSystem.Emit(shortLived, count / 60);
+		};
+		for (int i = 0; i < 120; i++)
+			frame();
+		double steadyMs = Benchmark::Time(20, frame);
+		Benchmark::Report(label + ", update and re-emit", steadyMs, "ms/frame");
+
+		if (rendering)
+		{
+			double drawMs = Benchmark::Time(20, [&]()
+				{
+					Renderer::BeginScene(Matrix4x4(), Matrix4x4());
+					Renderer2D::DrawParticles(particleSystem);
+					Renderer::EndScene();
+				});
+			Benchmark::Report(label + ", batch into quads", drawMs, "ms/frame");
+		}
+	}
+}
@@ -0,0 +1,94 @@
+#include "stdafx.h"
+#include "Benchmark.h"
+
+#include "Scene/Scene.h"
+#include "Scene/Entity.h"
+#include "Scene/Components.h"
+#include "Scene/SceneGraph.h"
+#include "Scene/SceneSerializer.h"
+#include "Scene/Prefab.h"
+
+static constexpr size_t s_SpawnCount = 1000;
+static constexpr size_t s_BulkSpawnCount = 100000;
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// A body with a sprite and a box collider, and two children with sprites
+static Entity CreatePrefabEntity(Scene& scene)
+{
+	Entity root = scene.CreateEntity("Enemy");
+	root.AddComponent<TransformComponent>();
+	root.AddComponent<SpriteComponent>();
+	root.AddComponent<RigidBody2DComponent>(RigidBody2DComponent::BodyType::DYNAMIC, true);
+	root.AddComponent<BoxCollider2DComponent>();
+
+	for (int i = 0; i < 2; i++)
+	{
+		Entity child = scene.CreateEntity("Part");
+		child.AddComponent<TransformComponent>(Vector3f(i == 0 ? -0.5f : 0.5f, 0.0f, 0.0f));
+		child.AddComponent<SpriteComponent>();
+		SceneGraph::Reparent(child, root);
+	}
+	return root;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static double SpawnsPerSecond(size_t spawns, double ms)
+{
+	return (double)spawns * 1000.0 / ms;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Instances spawned one at a time the way InstantiateEntity used to, writing the prefab out as xml and parsing it
+// back in, against InstantiateEntity's cached prefab, reusing one prefab, and spawning many at once
+BENCHMARK(PrefabSpawning)
+{
+	if (!Benchmark::InitRenderer())
+		return;
+
+	Scene prefabScene("");
+	Entity prefabEntity = CreatePrefabEntity(prefabScene);
+	const Vector3f position(1.0f, 2.0f, 0.0f);
+
+	double xmlMs = Benchmark::Time(5, [&]()
+		{
+			Scene scene("");
+			for (size_t i = 0; i < s_SpawnCount; i++)
+			{
+				Entity entity = SceneSerializer::DeserializeEntity(&scene, SceneSerializer::SerializeEntity(prefabEntity), true);
+				if (TransformComponent* transformComp = entity.TryGetComponent<TransformComponent>())
+					transformComp->position += position;
+			}
+		});
+	Benchmark::Report("xml round trip", SpawnsPerSecond(s_SpawnCount, xmlMs), "spawns/s");
+
+	double instantiateMs = Benchmark::Time(5, [&]()
+		{
+			Scene scene("");
+			for (size_t i = 0; i < s_SpawnCount; i++)
+				scene.InstantiateEntity(prefabEntity, position);
+		});
+	Benchmark::Report("InstantiateEntity, cached prefab", SpawnsPerSecond(s_SpawnCount, instantiateMs), "spawns/s");
+
+	Prefab prefab(prefabEntity);
+	double reusedMs = Benchmark::Time(5, [&]()
+		{
+			Scene scene("");
+			for (size_t i = 0; i < s_SpawnCount; i++)
+				scene.InstantiatePrefab(prefab, { position });
+		});
+	Benchmark::Report("InstantiatePrefab, one compiled prefab", SpawnsPerSecond(s_SpawnCount, reusedMs), "spawns/s");
+
+	const std::vector<Vector3f> positions(s_BulkSpawnCount, position);
+	double bulkMs = Benchmark::Time(5, [&]()
+		{
+			Scene scene("");
+			scene.InstantiatePrefab(prefab, positions);
+		});
+	Benchmark::Report("InstantiatePrefab, 100k at once", SpawnsPerSecond(s_BulkSpawnCount, bulkMs), "spawns/s");
+
+	Benchmark::Report("InstantiateEntity speed up over xml", xmlMs / instantiateMs, "x");
+	Benchmark::Report("compiled prefab speed up over xml", xmlMs / reusedMs, "x");
+}
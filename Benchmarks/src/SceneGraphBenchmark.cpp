@@ -0,0 +1,92 @@
+#include "stdafx.h"
+#include "Benchmark.h"
+
+#include "Scene/SceneGraph.h"
+#include "Scene/Components.h"
+#include "Core/ThreadPool.h"
+
+static constexpr size_t s_NodeCount = 100000;
+static constexpr uint32_t s_ThreadCounts[] = { 1, 2, 4, 8 };
+
+static entt::entity CreateNode(entt::registry& registry, entt::entity parent)
+{
+	entt::entity entity = registry.create();
+	registry.emplace<TransformComponent>(entity, Vector3f(1.0f, 0.0f, 0.0f), Vector3f(0.0f, 0.0f, 0.1f), Vector3f(1.0f, 1.0f, 1.0f));
+	HierarchyComponent& hierarchyComp = registry.emplace<HierarchyComponent>(entity);
+
+	if (parent != entt::null)
+	{
+		// Added as the first child so building wide hierarchies doesn't walk the sibling list
+		HierarchyComponent& parentComp = registry.get<HierarchyComponent>(parent);
+		hierarchyComp.parent = parent;
+		hierarchyComp.nextSibling = parentComp.firstChild;
+		if (parentComp.firstChild != entt::null)
+			registry.get<HierarchyComponent>(parentComp.firstChild).previousSibling = entity;
+		parentComp.firstChild = entity;
+	}
+	return entity;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// A few roots with every other node as their direct children
+static void BuildWide(entt::registry& registry)
+{
+	std::vector<entt::entity> roots;
+	for (size_t i = 0; i < 4; i++)
+		roots.push_back(CreateNode(registry, entt::null));
+
+	for (size_t i = roots.size(); i < s_NodeCount; i++)
+		CreateNode(registry, roots[i % roots.size()]);
+}
+
+// Chains 100 nodes deep
+static void BuildDeep(entt::registry& registry)
+{
+	entt::entity parent = entt::null;
+	for (size_t i = 0; i < s_NodeCount; i++)
+		parent = CreateNode(registry, i % 100 == 0 ? entt::null : parent);
+}
+
+// Trees with four children per node
+static void BuildMixed(entt::registry& registry)
+{
+	std::vector<entt::entity> nodes;
+	for (size_t i = 0; i < s_NodeCount; i++)
+		nodes.push_back(CreateNode(registry, i % 5000 == 0 ? entt::null : nodes[(i - 1) / 4]));
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static void RunHierarchy(const char* name, void(*build)(entt::registry&))
+{
+	entt::registry registry;
+	build(registry);
+
+	for (uint32_t threads : s_ThreadCounts)
+	{
+		ThreadPool::Init(threads - 1);
+		SceneGraph::SetParallelUpdate(threads > 1);
+
+		// Every transform changes each frame so the whole hierarchy is updated
+		double ms = Benchmark::Time(50, [&registry]()
+			{
+				registry.view<TransformComponent>().each([](auto entity, TransformComponent& transformComp) { transformComp.MakeDirty(); });
+				SceneGraph::Traverse(registry);
+			});
+
+		Benchmark::Report(std::string(name) + ", " + std::to_string(threads) + " threads", ms, "ms/frame");
+	}
+
+	ThreadPool::Shutdown();
+	SceneGraph::SetParallelUpdate(true);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+BENCHMARK(SceneGraphTraverse)
+{
+	RunHierarchy("wide 100k", &BuildWide);
+	RunHierarchy("deep 100k", &BuildDeep);
+	RunHierarchy("mixed 100k", &BuildMixed);
+}
@@ -0,0 +1,98 @@
+#include "stdafx.h"
+#include "Benchmark.h"
+
+#include "Scene/Scene.h"
+#include "Scene/Entity.h"
+#include "Scene/Components.h"
+#include "Scene/SceneGraph.h"
+#include "Scene/SceneSerializer.h"
+#include "Scene/BinarySceneSerializer.h"
+
+#include <random>
+
+static constexpr size_t s_EntityCounts[] = { 1000, 10000, 100000 };
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Sprites, circles and bodies with colliders in groups of four, the last three of each group children of the first
+static void BuildScene(Scene& scene, size_t entityCount)
+{
+	std::mt19937 generator(1234);
+	std::uniform_real_distribution<float> value(-100.0f, 100.0f);
+
+	Entity parent;
+	for (size_t i = 0; i < entityCount; i++)
+	{
+		Entity entity = scene.CreateEntity("Entity " + std::to_string(i));
+		entity.GetOrAddComponent<TransformComponent>().position = Vector3f(value(generator), value(generator), 0.0f);
+
+		switch (i % 3)
+		{
+		case 0:
+			entity.AddComponent<SpriteComponent>().tint = Colour(0.5f, 0.5f, 1.0f, 1.0f);
+			break;
+		case 1:
+			entity.AddComponent<CircleRendererComponent>().radius = 0.25f;
+			break;
+		case 2:
+			entity.AddComponent<RigidBody2DComponent>(RigidBody2DComponent::BodyType::DYNAMIC, false);
+			entity.AddComponent<BoxCollider2DComponent>();
+			break;
+		}
+
+		if (i % 4 == 0)
+			parent = entity;
+		else
+			SceneGraph::Reparent(entity, parent);
+	}
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// The same scene loaded from xml and from the binary format ConvertFromXml writes, each into a new scene
+BENCHMARK(SceneLoading)
+{
+	if (!Benchmark::InitRenderer())
+		return;
+
+	const std::filesystem::path directory = std::filesystem::temp_directory_path() / "SceneLoadBenchmark";
+	const std::filesystem::path xmlPath = directory / "Xml.scene";
+	const std::filesystem::path binaryPath = directory / "Binary.scene";
+	std::filesystem::create_directories(directory);
+
+	for (size_t entityCount : s_EntityCounts)
+	{
+		std::string label = std::to_string(entityCount) + " entities";
+		{
+			Scene scene(xmlPath);
+			BuildScene(scene, entityCount);
+			SceneSerializer(&scene).Serialize(xmlPath);
+		}
+
+		if (!BinarySceneSerializer::ConvertFromXml(xmlPath, binaryPath))
+		{
+			std::printf("  could not convert %s\n", xmlPath.string().c_str());
+			continue;
+		}
+
+		const size_t iterations = std::max<size_t>(1, 10000 / entityCount);
+		double xmlMs = Benchmark::Time(iterations, [&]()
+			{
+				Scene scene(xmlPath);
+				SceneSerializer(&scene).Deserialize(xmlPath);
+			});
+		double binaryMs = Benchmark::Time(iterations, [&]()
+			{
+				Scene scene(binaryPath);
+				BinarySceneSerializer(&scene).Deserialize(binaryPath);
+			});
+
+		Benchmark::Report(label + ", xml load", xmlMs, "ms");
+		Benchmark::Report(label + ", binary load", binaryMs, "ms");
+		Benchmark::Report(label + ", binary speed up", xmlMs / binaryMs, "x");
+		Benchmark::Report(label + ", xml size", (double)std::filesystem::file_size(xmlPath) / 1024.0, "KB");
+		Benchmark::Report(label + ", binary size", (double)std::filesystem::file_size(binaryPath) / 1024.0, "KB");
+	}
+
+	std::filesystem::remove_all(directory);
+}
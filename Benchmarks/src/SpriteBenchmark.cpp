@@ -0,0 +1,60 @@
+#include "stdafx.h"
+#include "Benchmark.h"
+
+#include "Scene/Scene.h"
+#include "Scene/Entity.h"
+#include "Scene/Components.h"
+#include "Core/ThreadPool.h"
+
+static constexpr uint32_t s_SpriteColumns = 1000;
+static constexpr uint32_t s_SpriteRows = 500;
+static constexpr size_t s_TextureCount = 64; // more than a batch's texture slots so batches break as they would in a game
+static constexpr uint32_t s_ThreadCounts[] = { 1, 2, 4, 8 };
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+BENCHMARK(SpriteSubmission)
+{
+	if (!Benchmark::InitRenderer())
+		return;
+
+	std::vector<Ref<Texture2D>> textures;
+	for (size_t i = 0; i < s_TextureCount; i++)
+		textures.push_back(Texture2D::Create(4, 4));
+
+	Scene scene("");
+	for (uint32_t y = 0; y < s_SpriteRows; y++)
+	{
+		for (uint32_t x = 0; x < s_SpriteColumns; x++)
+		{
+			Entity entity = scene.CreateEntity();
+			entity.AddComponent<TransformComponent>(Vector3f((float)x, (float)y, 0.0f));
+			SpriteComponent& spriteComp = entity.AddComponent<SpriteComponent>();
+			spriteComp.texture = textures[(x * 7 + y) % s_TextureCount];
+		}
+	}
+
+	// Every sprite is in view so none are culled
+	Matrix4x4 cameraTransform = Matrix4x4::Translate(Vector3f(s_SpriteColumns * 0.5f, s_SpriteRows * 0.5f, 0.0f));
+	Matrix4x4 projection = Matrix4x4::OrthographicRH(-(float)s_SpriteColumns, (float)s_SpriteColumns, -(float)s_SpriteRows, (float)s_SpriteRows, -1.0f, 1.0f);
+
+	double singleMs = 0.0;
+	for (uint32_t threads : s_ThreadCounts)
+	{
+		// A pool of no workers still leaves the calling thread, Init(0) would start one per core
+		if (threads > 1)
+			ThreadPool::Init(threads - 1);
+		else
+			ThreadPool::Shutdown();
+
+		double ms = Benchmark::Time(10, [&]() { scene.Render(nullptr, cameraTransform, projection); });
+		if (threads == 1)
+			singleMs = ms;
+
+		std::string label = "500k sprites, " + std::to_string(threads) + " threads";
+		Benchmark::Report(label, ms, "ms/frame");
+		Benchmark::Report(label + ", speedup", singleMs / ms, "x");
+	}
+
+	ThreadPool::Shutdown();
+}
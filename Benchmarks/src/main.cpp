@@ -0,0 +1,12 @@
+#include "stdafx.h"
+#include "Benchmark.h"
+
+#include "Logging/Logger.h"
+
+int main(int argc, char* argv[])
+{
+	// Run from beside the executable, as the applications do, so the data copied there is found
+	std::filesystem::current_path(std::filesystem::weakly_canonical(std::filesystem::path(argv[0])).parent_path());
+	Logger::Init();
+	return Benchmark::Run(argc, argv);
+}
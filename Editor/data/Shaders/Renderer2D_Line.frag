@@ -1,4 +1,4 @@
-#version 330 core
+#version 450 core
 
 layout(origin_upper_left) in vec4 gl_FragCoord;
 layout(location = 0) out vec4 colour;
@@ -8,7 +8,10 @@ in vec2 v_texcoord;
 in float v_width;
 in float v_length;
 
-uniform int u_Caps;
+layout(std140, binding = 3) uniform Line
+{
+	int u_Caps;
+};
 
 float CalculateD(float dx, float dy)
 {
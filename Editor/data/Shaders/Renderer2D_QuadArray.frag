@@ -0,0 +1,35 @@
+#version 450 core
+
+layout(location = 0) out vec4 frag_colour;
+layout(location = 1) out int entityId;
+
+struct VertexOutput
+{
+	vec4 Colour;
+	vec2 TexCoord;
+};
+
+layout (location = 0) in VertexOutput Input;
+layout (location = 2) in flat float v_TexIndex;
+layout (location = 3) in flat int v_EntityId;
+
+layout (binding = 0) uniform sampler2D u_Textures[16];
+layout (binding = 16) uniform sampler2DArray u_TextureArrays[16];
+
+void main()
+{
+	// Below 16 is a texture slot, above is (array << 10 | layer) + 16
+	int index = int(v_TexIndex);
+	if(index < 16)
+	{
+		frag_colour = texture(u_Textures[index], Input.TexCoord) * Input.Colour;
+	}
+	else
+	{
+		index -= 16;
+		frag_colour = texture(u_TextureArrays[index >> 10], vec3(Input.TexCoord, float(index & 1023))) * Input.Colour;
+	}
+	if(frag_colour.a <= 0.0001)
+		discard;
+	entityId = v_EntityId;
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+#version 450 core
+
+layout(location = 0) out vec4 frag_colour;
+layout(location = 1) out int entityId;
+
+struct VertexOutput
+{
+	vec3 PosW;
+	vec2 TexCoord0;
+	vec2 TexCoord1;
+	vec3 Tangent;
+	vec3 Normal;
+	vec4 Colour;
+};
+
+layout (binding = 0) uniform sampler2D u_Albedo;
+layout (binding = 1) uniform sampler2D u_Normal;
+layout (binding = 2) uniform sampler2D u_MixMap;
+
+layout (location = 0) in VertexOutput Input;
+layout (location = 6) in vec4 v_Tint;
+layout (location = 7) flat in int v_EntityId;
+
+void main()
+{
+	frag_colour = texture(u_Albedo, Input.TexCoord0) * v_Tint;
+	if(frag_colour.a <= 0.0001)
+		discard;
+	entityId = v_EntityId;
+}
\ No newline at end of file
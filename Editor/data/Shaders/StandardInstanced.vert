@@ -0,0 +1,68 @@
+#version 450 core
+
+layout(location = 0) in vec3 a_Position;
+layout(location = 1) in vec3 a_Normal;
+layout(location = 2) in vec3 a_Tangent;
+layout(location = 3) in vec2 a_TexCoord0;
+layout(location = 4) in vec2 a_TexCoord1;
+layout(location = 5) in vec4 a_Colour;
+
+layout(std140, binding = 0) uniform ConstantBuffer
+{
+	uniform mat4 u_ViewProjection;
+	uniform vec3 u_EyePosition;
+};
+
+layout(std140, binding = 1) uniform ModelBuffer
+{
+	uniform mat4 u_ModelMatrix;
+	uniform vec4 u_Colour;
+	uniform vec2 u_TextureOffset;
+	uniform float u_TilingFactor;
+	uniform int u_EntityId;
+};
+
+struct InstanceData
+{
+	mat4 ModelMatrix;
+	vec4 Colour;
+	ivec4 EntityId;
+};
+
+layout(std140, binding = 2) uniform InstanceBuffer
+{
+	InstanceData u_Instances[128];
+};
+
+struct VertexOutput
+{
+	vec3 PosW;
+	vec2 TexCoord0;
+	vec2 TexCoord1;
+	vec3 Tangent;
+	vec3 Normal;
+	vec4 Colour;
+};
+
+layout (location = 0) out VertexOutput Output;
+layout (location = 6) out vec4 v_Tint;
+layout (location = 7) flat out int v_EntityId;
+
+void main()
+{
+	mat4 modelMatrix = u_Instances[gl_InstanceID].ModelMatrix;
+	v_Tint = u_Instances[gl_InstanceID].Colour;
+	v_EntityId = u_Instances[gl_InstanceID].EntityId.x;
+
+	Output.Colour = a_Colour;
+
+	vec4 posW = modelMatrix * vec4(a_Position, 1.0f);
+	Output.PosW = posW.xyz;
+	gl_Position = u_ViewProjection * posW;
+	Output.Normal = normalize((modelMatrix * vec4(a_Normal, 0.0)).xyz);
+
+	Output.Tangent = normalize((modelMatrix * vec4(a_Tangent, 0.0)).xyz);
+
+	Output.TexCoord0 = (a_TexCoord0 + u_TextureOffset) * u_TilingFactor;
+	Output.TexCoord1 = a_TexCoord1;
+}
\ No newline at end of file
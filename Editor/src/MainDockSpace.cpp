@@ -14,6 +14,7 @@
 
 #include "Panels/ContentExplorerPanel.h"
 #include "Panels/JoystickInfoPanel.h"
+#include "Panels/StatisticsPanel.h"
 #include "Panels/ContentExplorerPanel.h"
 #include "Panels/EditorPreferencesPanel.h"
 #include "Panels/ProjectSettingsPanel.h"
@@ -53,6 +54,7 @@ MainDockSpace::MainDockSpace()
 	m_ShowHierarchy = true;
 	m_ShowContentExplorer = true;
 	m_ShowJoystickInfo = true;
+	m_ShowStatistics = false;
 
 	m_ShowTilemapEditor = false;
 
@@ -87,6 +89,7 @@ void MainDockSpace::OnAttach()
 	Settings::SetDefaultBool("Windows", "Console", m_ShowConsole);
 	Settings::SetDefaultBool("Windows", "ContentExplorer", m_ShowContentExplorer);
 	Settings::SetDefaultBool("Windows", "JoystickInfo", m_ShowJoystickInfo);
+	Settings::SetDefaultBool("Windows", "Statistics", m_ShowStatistics);
 	Settings::SetDefaultBool("Windows", "Hierarchy", m_ShowHierarchy);
 	Settings::SetDefaultBool("Windows", "Properties", m_ShowProperties);
 	Settings::SetDefaultBool("Windows", "ErrorList", m_ShowErrorList);
@@ -107,6 +110,7 @@ void MainDockSpace::OnAttach()
 	m_ShowProjectSettings = Settings::GetBool("Windows", "ProjectSettings");
 	m_ShowContentExplorer = Settings::GetBool("Windows", "ContentExplorer");
 	m_ShowJoystickInfo = Settings::GetBool("Windows", "JoystickInfo");
+	m_ShowStatistics = Settings::GetBool("Windows", "Statistics");
 	m_ShowErrorList = Settings::GetBool("Windows", "ErrorList");
 	m_ShowProperties = Settings::GetBool("Windows", "Properties");
 	m_ShowHierarchy = Settings::GetBool("Windows", "Hierarchy");
@@ -123,6 +127,7 @@ void MainDockSpace::OnAttach()
 	Application::GetLayerStack().AddOverlay(CreateRef<ProjectSettingsPanel>(&m_ShowProjectSettings));
 	Application::GetLayerStack().AddOverlay(m_ContentExplorer);
 	Application::GetLayerStack().AddOverlay(CreateRef<JoystickInfoPanel>(&m_ShowJoystickInfo));
+	Application::GetLayerStack().AddOverlay(CreateRef<StatisticsPanel>(&m_ShowStatistics));
 	Application::GetLayerStack().AddOverlay(CreateRef<ErrorListPanel>(&m_ShowErrorList));
 	Application::GetLayerStack().AddOverlay(CreateRef<ConsolePanel>(&m_ShowConsole));
 	Ref<HierarchyPanel> hierarchyPanel = CreateRef<HierarchyPanel>(&m_ShowHierarchy);
@@ -159,6 +164,7 @@ void MainDockSpace::OnDetach()
 	Settings::SetBool("Windows", "Console", m_ShowConsole);
 	Settings::SetBool("Windows", "ContentExplorer", m_ShowContentExplorer);
 	Settings::SetBool("Windows", "JoystickInfo", m_ShowJoystickInfo);
+	Settings::SetBool("Windows", "Statistics", m_ShowStatistics);
 	Settings::SetBool("Windows", "Hierarchy", m_ShowHierarchy);
 	Settings::SetBool("Windows", "Properties", m_ShowProperties);
 	Settings::SetBool("Windows", "ErrorList", m_ShowErrorList);
@@ -343,6 +349,7 @@ void MainDockSpace::OnImGuiRender()
 			ImGui::MenuItem(ICON_FA_CIRCLE_XMARK" Error List", "", &m_ShowErrorList);
 			ImGui::MenuItem(ICON_FA_CLIPBOARD_LIST" Task List", "", &m_ShowTaskList, false);//TODO: Create Task List ImguiPanel
 			ImGui::MenuItem(ICON_FA_GAMEPAD" Joystick Info", "", &m_ShowJoystickInfo);
+			ImGui::MenuItem(ICON_FA_CHART_LINE" Statistics", "", &m_ShowStatistics);
 #ifdef DEBUG
 			ImGui::MenuItem("ImGui Demo", "", &m_ShowImGuiDemo);
 #endif // DEBUG
@@ -43,6 +43,7 @@ private:
 	bool m_ShowHierarchy;
 	bool m_ShowContentExplorer;
 	bool m_ShowJoystickInfo;
+	bool m_ShowStatistics;
 	bool m_ShowTilemapEditor;
 
 #ifdef DEBUG
@@ -548,6 +548,46 @@ void PropertiesPanel::DrawComponents(Entity entity)
 			}
 		});
 
+	// Particle System------------------------------------------------------------------------------------------------------------------
+	DrawComponent<ParticleSystemComponent>(ICON_MDI_FIRE" Particle System", entity, [&](auto& particleSystem)
+		{
+			ImGui::BeginGroup();
+			if (!m_EditParticleSystemCommand.first)
+				m_EditParticleSystemCommand.second = CreateRef<EditComponentCommand<ParticleSystemComponent>>(entity);
+
+			bool edited = false;
+			ParticleProps& props = particleSystem.properties;
+
+			edited |= ImGui::Checkbox("Emitting", &particleSystem.emitting);
+			edited |= ImGui::DragFloat("Emission Rate", &particleSystem.emissionRate, 1.0f, 0.0f, 100000.0f);
+			int maxParticles = (int)particleSystem.maxParticles;
+			if (ImGui::DragInt("Max Particles", &maxParticles, 10.0f, 1, 1000000)) {
+				particleSystem.maxParticles = (uint32_t)maxParticles;
+				edited = true;
+			}
+			edited |= ImGui::DragFloat("Life Time", &props.lifeTime, 0.01f, 0.01f, 100.0f);
+			edited |= ImGui::Vector("Velocity", props.velocity);
+			edited |= ImGui::Vector("Velocity Variation", props.velocityVariation);
+			edited |= ImGui::ColorEdit4("Begin Colour", &props.beginColour.r);
+			edited |= ImGui::ColorEdit4("End Colour", &props.endColour.r);
+			edited |= ImGui::DragFloat("Size Begin", &props.sizeBegin, 0.01f, 0.0f, 100.0f);
+			edited |= ImGui::DragFloat("Size End", &props.sizeEnd, 0.01f, 0.0f, 100.0f);
+			edited |= ImGui::DragFloat("Size Variation", &props.sizeVariation, 0.01f, 0.0f, 100.0f);
+			edited |= ImGui::DragFloat("Rotation Speed", &props.rotationSpeed, 0.01f);
+
+			if (edited) {
+				SceneManager::CurrentScene()->MakeDirty();
+				m_EditParticleSystemCommand.first = true;
+			}
+
+			ImGui::EndGroup();
+			if (!ImGui::IsItemActive() && m_EditParticleSystemCommand.first) {
+				HistoryManager::AddHistoryRecord(m_EditParticleSystemCommand.second);
+				m_EditParticleSystemCommand.first = false;
+				m_EditParticleSystemCommand.second = nullptr;
+			}
+		});
+
 	// Tilemap ------------------------------------------------------------------------------------------------------------------------
 	DrawComponent<TilemapComponent>(ICON_FA_BORDER_ALL" Tilemap", entity, [=](auto& tilemap)
 		{
@@ -1124,6 +1164,18 @@ void PropertiesPanel::DrawComponents(Entity entity)
 			ImGui::Checkbox("Disabled", &button.disabled);
 		});
 
+	// Entity Pool --------------------------------------------------------------------------------------------------------------------
+	DrawComponent<EntityPoolComponent>(ICON_FA_RECYCLE" Entity Pool", entity, [](auto& entityPool)
+		{
+			int prewarmCount = (int)entityPool.prewarmCount;
+			if (ImGui::DragInt("Prewarm Count", &prewarmCount, 1.0f, 0, 100000))
+			{
+				entityPool.prewarmCount = (uint32_t)prewarmCount;
+				SceneManager::CurrentScene()->MakeDirty();
+			}
+			ImGui::Tooltip("Instances created for the pool when the scene starts playing");
+		});
+
 	// Lua Script ---------------------------------------------------------------------------------------------------------------------
 	DrawComponent<LuaScriptComponent>(ICON_FA_FILE_CODE" Lua Script", entity, [&entity](auto& luaScript)
 		{
@@ -1170,6 +1222,7 @@ void PropertiesPanel::DrawAddComponent(Entity entity)
 		AddComponentMenuItem<SpriteComponent>(ICON_FA_IMAGE" Sprite", entity);
 		AddComponentMenuItem<AnimatedSpriteComponent>(ICON_FA_IMAGE" Animated Sprite", entity);
 		AddComponentMenuItem<CircleRendererComponent>(ICON_FA_CIRCLE" Circle Renderer", entity);
+		AddComponentMenuItem<ParticleSystemComponent>(ICON_MDI_FIRE" Particle System", entity);
 		AddComponentMenuItem<TilemapComponent>(ICON_FA_BORDER_ALL" Tilemap", entity);
 		AddComponentMenuItem<StaticMeshComponent>(ICON_FA_SHAPES" Static Mesh", entity);
 		AddComponentMenuItem<CameraComponent>(ICON_FA_VIDEO" Camera", entity);
@@ -1184,6 +1237,7 @@ void PropertiesPanel::DrawAddComponent(Entity entity)
 		AddComponentMenuItem<StateMachineComponent>(ICON_FA_DIAGRAM_PROJECT" State Machine", entity);
 		AddComponentMenuItem<BillboardComponent>(ICON_FA_SIGN_HANGING" Billboard", entity);
 		AddComponentMenuItem<PointLightComponent>(ICON_FA_LIGHTBULB" Point Light", entity);
+		AddComponentMenuItem<EntityPoolComponent>(ICON_FA_RECYCLE" Entity Pool", entity);
 
 		if (ImGui::BeginMenu("UI Widgets")) {
 			AddComponentMenuItem<CanvasComponent>(ICON_FA_OBJECT_GROUP" Canvas", entity);
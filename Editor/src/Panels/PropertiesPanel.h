@@ -94,6 +94,7 @@ private:
 	std::pair<bool, Ref<EditComponentCommand<SpriteComponent>>> m_EditSpriteCommand;
 	std::pair<bool, Ref<EditComponentCommand<AnimatedSpriteComponent>>> m_EditAnimatedSpriteCommand;
 	std::pair<bool, Ref<EditComponentCommand<CircleRendererComponent>>> m_EditCircleRendererCommand;
+	std::pair<bool, Ref<EditComponentCommand<ParticleSystemComponent>>> m_EditParticleSystemCommand;
 	std::pair<bool, Ref<EditComponentCommand<TilemapComponent>>> m_EditTilemapCommand;
 	std::pair<bool, Ref<EditComponentCommand<StaticMeshComponent>>> m_EditStaticMeshCommand;
 	std::pair<bool, Ref<EditComponentCommand<CameraComponent>>> m_EditCameraCommand;
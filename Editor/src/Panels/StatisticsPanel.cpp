@@ -0,0 +1,90 @@
+#include "StatisticsPanel.h"
+
+#include "imgui/imgui.h"
+#include "IconsFontAwesome6.h"
+
+#include "MainDockSpace.h"
+
+#include "Engine.h"
+#include "Core/Statistics.h"
+
+StatisticsPanel::StatisticsPanel(bool* show)
+	:m_Show(show), Layer("Statistics")
+{
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void StatisticsPanel::OnImGuiRender()
+{
+	if (!*m_Show)
+	{
+		return;
+	}
+
+	ImGui::SetNextWindowSize(ImVec2(640, 480), ImGuiCond_FirstUseEver);
+	if (ImGui::Begin(ICON_FA_CHART_LINE" Statistics", m_Show))
+	{
+		if (ImGui::IsWindowFocused())
+		{
+			MainDockSpace::SetFocussedWindow(this);
+		}
+
+		if (ImGui::Button(ICON_FA_FILE_CSV" Save CSV"))
+		{
+			Statistics::WriteCSV(Application::GetWorkingDirectory() / "Statistics.csv");
+		}
+		ImGui::SameLine();
+		if (ImGui::Button("Reset"))
+		{
+			Statistics::Reset();
+		}
+
+		uint32_t count = Statistics::GetCount();
+		if (m_Selected >= count)
+			m_Selected = 0;
+
+		if (count > 0)
+		{
+			std::vector<float> history = Statistics::GetHistory(m_Selected);
+			std::string name = Statistics::GetName(m_Selected);
+			ImGui::PlotLines("##History", history.data(), (int)history.size(), 0, name.c_str(), FLT_MAX, FLT_MAX, ImVec2(ImGui::GetContentRegionAvail().x, 80.0f));
+		}
+
+		ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY | ImGuiTableFlags_SizingStretchProp;
+		if (ImGui::BeginTable("##Statistics", 6, flags))
+		{
+			ImGui::TableSetupScrollFreeze(0, 1);
+			ImGui::TableSetupColumn("Name");
+			ImGui::TableSetupColumn("Last");
+			ImGui::TableSetupColumn("Mean");
+			ImGui::TableSetupColumn("P50");
+			ImGui::TableSetupColumn("P95");
+			ImGui::TableSetupColumn("P99");
+			ImGui::TableHeadersRow();
+
+			for (Statistics::StatId id = 0; id < count; id++)
+			{
+				Statistics::Summary summary = Statistics::GetSummary(id);
+				std::string name = Statistics::GetName(id);
+
+				ImGui::TableNextRow();
+				ImGui::TableNextColumn();
+				if (ImGui::Selectable(name.c_str(), m_Selected == id, ImGuiSelectableFlags_SpanAllColumns))
+					m_Selected = id;
+				ImGui::TableNextColumn();
+				ImGui::Text("%.3f", summary.last);
+				ImGui::TableNextColumn();
+				ImGui::Text("%.3f", summary.mean);
+				ImGui::TableNextColumn();
+				ImGui::Text("%.3f", summary.p50);
+				ImGui::TableNextColumn();
+				ImGui::Text("%.3f", summary.p95);
+				ImGui::TableNextColumn();
+				ImGui::Text("%.3f", summary.p99);
+			}
+			ImGui::EndTable();
+		}
+	}
+	ImGui::End();
+}
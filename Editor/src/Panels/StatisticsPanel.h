@@ -0,0 +1,15 @@
+#pragma once
+
+#include "Core/Layer.h"
+
+class StatisticsPanel
+	:public Layer
+{
+public:
+	explicit StatisticsPanel(bool* show);
+	~StatisticsPanel() = default;
+	void OnImGuiRender() override;
+private:
+	bool* m_Show;
+	uint32_t m_Selected = 0;
+};
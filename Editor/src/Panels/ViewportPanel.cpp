@@ -1022,14 +1022,28 @@ void ViewportPanel::OnImGuiRender()
 
 		if (m_ShowStats)
 		{
-			ImGui::GetWindowDrawList()->AddRectFilled(ImVec2(window_pos.x, window_pos.y + ImGui::GetStyle().ItemSpacing.y), ImVec2(window_pos.x + 250, window_pos.y + (24 * 4)), IM_COL32(0, 0, 0, 30), 3.0f);
+			ImGui::GetWindowDrawList()->AddRectFilled(ImVec2(window_pos.x, window_pos.y + ImGui::GetStyle().ItemSpacing.y), ImVec2(window_pos.x + 250, window_pos.y + (24 * (TextureAtlas::IsEnabled() ? 12 : 11))), IM_COL32(0, 0, 0, 30), 3.0f);
 			ImGui::Text("Draw Calls: %i", Renderer2D::GetStats().drawCalls);
 			ImGui::Text("Quad Count: %i", Renderer2D::GetStats().quadCount);
+			ImGui::Text("Batch Breaks: %i (%i texture)", Renderer2D::GetStats().batchBreaks, Renderer2D::GetStats().textureBatchBreaks);
+			ImGui::Text("Buffer Stalls: %i", Renderer2D::GetStats().bufferStalls);
+			if (TextureAtlas::IsEnabled())
+			{
+				TextureAtlas::Stats atlasStats = TextureAtlas::GetStats();
+				ImGui::Text("Atlas: %i textures, %i pages, %.0f%%", atlasStats.textures, atlasStats.pages, atlasStats.occupancy * 100.0f);
+			}
 			ImGui::Text("Line Count: %i", Renderer2D::GetStats().lineCount);
 			ImGui::Text("Hair Line Count: %i", Renderer2D::GetStats().hairLineCount);
+			ImGui::Text("Visible: %i", Renderer2D::GetStats().visibleCount);
+			ImGui::Text("Culled: %i", Renderer2D::GetStats().culledCount);
+			ImGui::Text("State Changes Avoided: %i", Renderer::GetStats().stateChangesAvoided);
+			ImGui::Text("Scene Graph Nodes: %i", SceneGraph::GetStats().nodeCount);
+			ImGui::Text("Transforms Updated: %i", SceneGraph::GetStats().transformsUpdated);
 		}
 
 		Renderer2D::ResetStats();
+		SceneGraph::ResetStats();
+		Renderer::ResetStats();
 	}
 	if (!shown)
 		ImGui::PopStyleVar();
@@ -19,6 +19,12 @@ int main(int argc, char* argv[])
 	if (rCode != -1)
 		return rCode;
 
+	if (Application::IsHeadless())
+	{
+		CLIENT_ERROR("The editor can't run headless");
+		return EXIT_FAILURE;
+	}
+
 	Window* window = app->CreateDesktopWindow(WindowProps("Editor", 1920, 1080, 100, 100));
 
 	if (!window)
@@ -5,6 +5,60 @@ namespace Astar
 {
 	Generator* Generator::s_Instance = nullptr;
 
+	static constexpr uint32_t s_NoNode = UINT32_MAX;
+
+	struct OpenEntry
+	{
+		uint32_t score;
+		uint32_t heuristic;
+		uint32_t node;
+	};
+
+	// Orders the heap so the lowest score is at the front, ties go to the node closest to the goal
+	struct OpenEntryCompare
+	{
+		bool operator()(const OpenEntry& a, const OpenEntry& b) const
+		{
+			if (a.score != b.score)
+				return a.score > b.score;
+			return a.heuristic > b.heuristic;
+		}
+	};
+
+	// Per node search state indexed by y * width + x, kept between searches to avoid reallocating
+	struct SearchScratch
+	{
+		std::vector<uint32_t> cost;
+		std::vector<uint32_t> parent;
+		std::vector<uint32_t> visited; // the search that cost and parent were last written by
+		std::vector<uint64_t> closed;
+		std::vector<OpenEntry> open;
+		uint32_t search = 0;
+
+		void Prepare(size_t nodeCount)
+		{
+			if (cost.size() < nodeCount)
+			{
+				cost.resize(nodeCount);
+				parent.resize(nodeCount);
+				visited.resize(nodeCount, 0);
+			}
+			closed.assign((nodeCount + 63) / 64, 0);
+			open.clear();
+
+			if (++search == 0)
+			{
+				std::fill(visited.begin(), visited.end(), 0);
+				search = 1;
+			}
+		}
+
+		bool IsClosed(uint32_t node) const { return (closed[node >> 6] >> (node & 63)) & 1; }
+		void Close(uint32_t node) { closed[node >> 6] |= (uint64_t)1 << (node & 63); }
+	};
+
+	static thread_local SearchScratch s_Scratch;
+
 	GridCoord Heuristic::GetDelta(GridCoord source, GridCoord goal)
 	{
 		return GridCoord(abs(source.x - goal.x), abs(source.y - goal.y));
@@ -34,26 +88,6 @@ namespace Astar
 		SetHeuristic(&Heuristic::Octagonal);
 	}
 
-	Ref<Node> Generator::FindNodeOnList(const NodeSet& nodes, GridCoord coordinates) const
-	{
-		for (Ref<Node> node : nodes)
-		{
-			if (node->coordinates == coordinates)
-			{
-				return node;
-			}
-		}
-		return nullptr;
-	}
-
-	void Generator::ReleaseNodes(NodeSet& nodes) const
-	{
-		for (auto it = nodes.begin(); it != nodes.end();)
-		{
-			it = nodes.erase(it);
-		}
-	}
-
 	Generator* Generator::GetInstance()
 	{
 		if (s_Instance == nullptr)
@@ -86,79 +120,82 @@ namespace Astar
 		if (!grid->PositionToGridCoord(goal, goalCoords))
 			return path;
 
-		Ref<Node> current = nullptr;
-		NodeSet openSet;
-		NodeSet closedSet;
+		if (grid->DetectCollision(goalCoords))
+			return path;
+
+		const uint32_t width = (uint32_t)grid->width;
+		auto nodeIndex = [width](GridCoord coordinates) { return (uint32_t)coordinates.y * width + (uint32_t)coordinates.x; };
+
+		SearchScratch& scratch = s_Scratch;
+		scratch.Prepare((size_t)grid->width * (size_t)grid->height);
+
+		const uint32_t sourceIndex = nodeIndex(sourceCoords);
+		const uint32_t goalIndex = nodeIndex(goalCoords);
 
-		openSet.insert(CreateRef<Node>(sourceCoords));
+		scratch.cost[sourceIndex] = 0;
+		scratch.parent[sourceIndex] = s_NoNode;
+		scratch.visited[sourceIndex] = scratch.search;
 
-		while (!openSet.empty())
+		uint32_t heuristic = m_Heuristic(sourceCoords, goalCoords);
+		scratch.open.push_back({ heuristic, heuristic, sourceIndex });
+
+		bool found = false;
+		while (!scratch.open.empty())
 		{
-			current = *openSet.begin();
-			for (Ref<Node> node : openSet)
-			{
-				if (node->GetScore() <= current->GetScore())
-				{
-					current = node;
-				}
-			}
+			std::pop_heap(scratch.open.begin(), scratch.open.end(), OpenEntryCompare());
+			uint32_t current = scratch.open.back().node;
+			scratch.open.pop_back();
 
-			if (current->coordinates == goalCoords)
+			// A node is pushed again whenever a cheaper route to it is found, so skip the stale entries
+			if (scratch.IsClosed(current))
+				continue;
+			scratch.Close(current);
+
+			if (current == goalIndex)
 			{
-				break; // found the goal so exit
+				found = true;
+				break;
 			}
 
-			closedSet.insert(current);
-			openSet.erase(std::find(openSet.begin(), openSet.end(), current));
-
+			GridCoord currentCoords((int)(current % width), (int)(current / width));
 			for (uint32_t i = 0; i < m_Directions; i++)
 			{
-				GridCoord newCoords(current->coordinates + m_Direction[i]);
+				GridCoord newCoords(currentCoords + m_Direction[i]);
+
+				if (grid->DetectCollision(newCoords))
+					continue;
+
+				uint32_t successor = nodeIndex(newCoords);
+				if (scratch.IsClosed(successor))
+					continue;
+
+				uint32_t totalcost = scratch.cost[current] + ((i < 4) ? 10 : 14);
 
-				if (grid->DetectCollision(newCoords) || FindNodeOnList(closedSet, newCoords))
+				if (scratch.visited[successor] == scratch.search && totalcost >= scratch.cost[successor])
 					continue;
 
-				uint32_t totalcost = current->G + ((i < 4) ? 10 : 14);
-
-				Ref<Node> successor = FindNodeOnList(openSet, newCoords);
-
-				if (successor == nullptr)
-				{
-					successor = CreateRef<Node>(newCoords, current);
-					successor->G = totalcost;
-					successor->H = m_Heuristic(successor->coordinates, goalCoords);
-					openSet.insert(successor);
-				}
-				else if (totalcost < successor->G)
-				{
-					successor->parent = current;
-					successor->G = totalcost;
-				}
+				scratch.visited[successor] = scratch.search;
+				scratch.cost[successor] = totalcost;
+				scratch.parent[successor] = current;
+
+				heuristic = m_Heuristic(newCoords, goalCoords);
+				scratch.open.push_back({ totalcost + heuristic, heuristic, successor });
+				std::push_heap(scratch.open.begin(), scratch.open.end(), OpenEntryCompare());
 			}
 		}
 
-		while (current != nullptr)
+		if (!found)
+			return path;
+
+		for (uint32_t node = goalIndex; node != s_NoNode; node = scratch.parent[node])
 		{
 			/*convert coordinates back into world positions*/
 			Vector2f position;
-			grid->GridCoordToPosition(current->coordinates, position);
+			grid->GridCoordToPosition(GridCoord((int)(node % width), (int)(node / width)), position);
 			path.push_back(position);
-			current = current->parent;
 		}
 
-		ReleaseNodes(openSet);
-		ReleaseNodes(closedSet);
-		return std::vector<Vector2f>();
-	}
-
-	Node::Node(GridCoord coordinates, Ref<Node> parent)
-		:coordinates(coordinates), parent(parent)
-	{
-		G = H = 0;
-	}
-
-	uint32_t Node::GetScore() const
-	{
-		return G + H;
+		std::reverse(path.begin(), path.end());
+		return path;
 	}
 }
\ No newline at end of file
@@ -2,7 +2,6 @@
 
 #include <vector>
 #include <functional>
-#include <set>
 #include "math/Vector2f.h"
 #include "Core/core.h"
 
@@ -48,32 +47,35 @@ namespace Astar
 
 		bool PositionToGridCoord(Vector2f position, GridCoord& coordinate) const
 		{
-			Vector2f vPosition = position - origin;
+			Vector2f localPosition = position - origin;
 
-			vPosition.y = vPosition.x / (float)width;
-			vPosition.x = vPosition.y / (float)height;
+			coordinate.x = (int)floor(localPosition.x / cellWidth);
+			coordinate.y = (int)floor(localPosition.y / cellHeight);
 
-			coordinate.x = (uint32_t)floor(position.x);
-			coordinate.y = (uint32_t)floor(position.y);
-
-			return (coordinate.x < width&& coordinate.y < height);
+			return IsInside(coordinate);
 		}
 
 		bool GridCoordToPosition(GridCoord coordinate, Vector2f& position) const
 		{
-			position.x = ((float)(coordinate.x * width) + (cellWidth / 2.0f));
-			position.y = ((float)(coordinate.y * height) + (cellHeight / 2.0f));
+			position.x = ((float)coordinate.x * cellWidth) + (cellWidth / 2.0f);
+			position.y = ((float)coordinate.y * cellHeight) + (cellHeight / 2.0f);
 
 			position += origin;
 
-			return(coordinate.x < width&& coordinate.y < height);
+			return IsInside(coordinate);
+		}
+
+		bool IsInside(GridCoord coordinate) const
+		{
+			return coordinate.x >= 0 && coordinate.y >= 0 && coordinate.x < width && coordinate.y < height;
 		}
 
+		// Cells outside of the grid are treated as blocked
 		bool DetectCollision(GridCoord coordinate) const
 		{
-			if (coordinate.x > width || coordinate.y > height)
+			if (!IsInside(coordinate))
 			{
-				return false;
+				return true;
 			}
 
 			return collisions[coordinate.x][coordinate.y];
@@ -82,31 +84,18 @@ namespace Astar
 
 	using HeuristicFunction = std::function<uint32_t(GridCoord, GridCoord)>;
 
-	struct Node
-	{
-		uint32_t G;
-		uint32_t H;
-		GridCoord coordinates;
-		Ref<Node> parent;
-
-		Node(GridCoord coordinates, Ref<Node> parent = nullptr);
-
-		uint32_t GetScore() const;
-	};
-
-	using NodeSet = std::set<Ref<Node>>;
-
 	class Generator
 	{
 		Generator();
-		Ref<Node> FindNodeOnList(const NodeSet& nodes, GridCoord coordinates) const;
-		void ReleaseNodes(NodeSet& nodes) const;
 
 	public:
 		static Generator* GetInstance();
 
 		void SetDiagonalMovement(bool enable);
 		void SetHeuristic(HeuristicFunction function);
+
+		// Returns the cell centres from the source to the goal, empty if the goal can't be reached
+		// Safe to call from several threads at once as long as the settings aren't being changed
 		std::vector<Vector2f> FindPath(Vector2f source, Vector2f goal, const AstarGrid* grid) const;
 
 	private:
@@ -115,7 +104,6 @@ namespace Astar
 			{ 0, 1 }, { 1, 0 }, { 0, -1 }, { -1, 0 },
 			{ -1, -1 }, { 1, 1 }, { -1, 1 }, { 1, -1 }
 		};
-		std::vector<GridCoord> m_Collisions;
 		uint32_t m_Directions;
 		static Generator* s_Instance;
 	};
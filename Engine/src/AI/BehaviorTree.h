@@ -17,6 +17,8 @@
 
 namespace BehaviourTree
 {
+class BehaviourTree;
+
 class Node
 {
 public:
@@ -32,6 +34,10 @@ public:
 
 	virtual Status update(float deltaTime) = 0;
 	virtual void initialize() {}
+
+	// A copy of the node and its children that hasn't run yet, the copies use the blackboard of the given tree
+	virtual Ref<Node> clone(BehaviourTree* behaviourTree) const = 0;
+
 	virtual void terminate(Status s) {}
 
 	Status tick(float deltaTime)
@@ -56,7 +62,7 @@ public:
 
 	void reset() { m_Status = Status::Invalid; }
 
-	Vector2f GetEditorPosition() { return m_EditorPosition; }
+	Vector2f GetEditorPosition() const { return m_EditorPosition; }
 	void SetEditorPosition(Vector2f editorPosition) { m_EditorPosition = editorPosition; }
 private:
 	Status m_Status = Status::Invalid;
@@ -86,6 +92,16 @@ public:
 	std::vector<Ref<Node>>::const_reverse_iterator rend() const { return m_Children.rend(); }
 
 protected:
+	Ref<Node> cloneChildren(Ref<Composite> copy, BehaviourTree* behaviourTree) const
+	{
+		copy->SetEditorPosition(GetEditorPosition());
+		for (const Ref<Node>& child : m_Children)
+		{
+			copy->addChild(child->clone(behaviourTree));
+		}
+		return copy;
+	}
+
 	std::vector<Ref<Node>> m_Children;
 };
 
@@ -171,6 +187,11 @@ public:
 	}
 	bool hasVector3(std::string const& key) const { return m_Vector3fs.find(key) != m_Vector3fs.end(); }
 
+	//PATH, filled in at runtime so it isn't serialized with the other values
+	void setPath(std::string const& key, std::vector<Vector2f> value) { m_Paths[key] = std::move(value); }
+	const std::vector<Vector2f>& getPath(std::string const& key) { return m_Paths[key]; }
+	bool hasPath(std::string const& key) const { return m_Paths.find(key) != m_Paths.end(); }
+
 	std::unordered_map<std::string, bool>::iterator getBoolsBegin() { return m_Bools.begin(); }
 	std::unordered_map<std::string, bool>::iterator getBoolsEnd() { return m_Bools.end(); }
 
@@ -200,6 +221,7 @@ private:
 	std::unordered_map<std::string, std::string> m_Strings;
 	std::unordered_map<std::string, Vector2f> m_Vector2s;
 	std::unordered_map<std::string, Vector3f> m_Vector3fs;
+	std::unordered_map<std::string, std::vector<Vector2f>> m_Paths;
 };
 
 //--------------------------------------------------------------------------------------------------------------------
@@ -215,6 +237,14 @@ public:
 	bool hasChild() const { return m_Child != nullptr; }
 
 protected:
+	Ref<Node> cloneChild(Ref<Decorator> copy, BehaviourTree* behaviourTree) const
+	{
+		copy->SetEditorPosition(GetEditorPosition());
+		if (m_Child)
+			copy->setChild(m_Child->clone(behaviourTree));
+		return copy;
+	}
+
 	Ref<Node> m_Child = nullptr;
 };
 
@@ -238,6 +268,19 @@ public:
 	void setRoot(const Ref<Node> node) { m_Root = node; }
 	const Ref<Node> getRoot() { return m_Root; }
 
+	// A tree of its own with a copy of the blackboard, none of the nodes have run yet
+	Ref<BehaviourTree> cloneTree() const
+	{
+		Ref<BehaviourTree> copy = CreateRef<BehaviourTree>();
+		*copy->m_Blackboard = *m_Blackboard;
+		if (m_Root)
+			copy->m_Root = m_Root->clone(copy.get());
+		copy->SetEditorPosition(GetEditorPosition());
+		return copy;
+	}
+
+	Ref<Node> clone(BehaviourTree* behaviourTree) const override { return cloneTree(); }
+
 private:
 	Ref<Node> m_Root = nullptr;
 	Ref<Blackboard> m_Blackboard = nullptr;
@@ -391,6 +434,7 @@ private:
 class Selector : public Composite
 {
 public:
+	Ref<Node> clone(BehaviourTree* behaviourTree) const override { return cloneChildren(CreateRef<Selector>(), behaviourTree); }
 
 	Status update(float deltaTime) override
 	{
@@ -419,6 +463,7 @@ public:
 class Sequence : public Composite
 {
 public:
+	Ref<Node> clone(BehaviourTree* behaviourTree) const override { return cloneChildren(CreateRef<Sequence>(), behaviourTree); }
 
 	Status update(float deltaTime) override
 	{
@@ -446,6 +491,8 @@ public:
 class StatefulSelector : public Composite
 {
 public:
+	Ref<Node> clone(BehaviourTree* behaviourTree) const override { return cloneChildren(CreateRef<StatefulSelector>(), behaviourTree); }
+
 	void initialize() override
 	{
 		it = m_Children.begin();
@@ -481,6 +528,8 @@ private:
 class MemSequence : public Composite
 {
 public:
+	Ref<Node> clone(BehaviourTree* behaviourTree) const override { return cloneChildren(CreateRef<MemSequence>(), behaviourTree); }
+
 	void initialize() override
 	{
 		it = m_Children.begin();
@@ -515,6 +564,15 @@ public:
 	ParallelSequence(bool successOnAll = true, bool failOnAll = true) : m_UseSuccessFailPolicy(true), m_SuccessOnAll(successOnAll), m_FailOnAll(failOnAll) {}
 	ParallelSequence(int minSuccess, int minFail) : m_MinSuccess(minSuccess), m_MinFail(minFail) {}
 
+	Ref<Node> clone(BehaviourTree* behaviourTree) const override
+	{
+		Ref<ParallelSequence> copy = CreateRef<ParallelSequence>(m_SuccessOnAll, m_FailOnAll);
+		copy->m_UseSuccessFailPolicy = m_UseSuccessFailPolicy;
+		copy->m_MinSuccess = m_MinSuccess;
+		copy->m_MinFail = m_MinFail;
+		return cloneChildren(copy, behaviourTree);
+	}
+
 	Status update(float deltaTime) override
 	{
 		ASSERT(hasChildren(), "Composite has no children");
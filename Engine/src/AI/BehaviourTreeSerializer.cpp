@@ -91,6 +91,12 @@ void Serializer::SerializeNode(tinyxml2::XMLElement* pElement, const Ref<Node> n
 		tinyxml2::XMLElement* pCustomTask = pElement->InsertNewChildElement("CustomTask");
 		SerializationUtils::Encode(pElement, customTask->getFilePath());
 	}
+	else if (Ref<FindPath> findPath = std::dynamic_pointer_cast<FindPath>(node)) {
+		tinyxml2::XMLElement* pFindPath = pElement->InsertNewChildElement("FindPath");
+		pFindPath->SetAttribute("Source", findPath->getSourceKey().c_str());
+		pFindPath->SetAttribute("Goal", findPath->getGoalKey().c_str());
+		pFindPath->SetAttribute("Path", findPath->getPathKey().c_str());
+	}
 
 }
 Ref<Node> Serializer::DeserializeNode(tinyxml2::XMLElement* pElement, BehaviourTree* behaviourTree)
@@ -227,6 +233,15 @@ Ref<Node> Serializer::DeserializeNode(tinyxml2::XMLElement* pElement, BehaviourT
 		customTask->SetEditorPosition(position);
 		return customTask;
 	}
+	else if (name == "FindPath")
+	{
+		const char* sourceKey = pElement->Attribute("Source");
+		const char* goalKey = pElement->Attribute("Goal");
+		const char* pathKey = pElement->Attribute("Path");
+		Ref<FindPath> findPath = CreateRef<FindPath>(behaviourTree, sourceKey ? sourceKey : "Position", goalKey ? goalKey : "Target", pathKey ? pathKey : "Path");
+		findPath->SetEditorPosition(position);
+		return findPath;
+	}
 
 	else
 	{
@@ -10,6 +10,11 @@ namespace BehaviourTree
 		BlackboardBool(Ref<Blackboard> blackboard, std::string const& blackboardkey, bool isSet)
 			:m_Blackboard(blackboard), mBlackboardKey(blackboardkey), mIsSet(isSet) {}
 
+		Ref<Node> clone(BehaviourTree* behaviourTree) const override
+		{
+			return cloneChild(CreateRef<BlackboardBool>(behaviourTree->getBlackboard(), mBlackboardKey, mIsSet), behaviourTree);
+		}
+
 		Status update(float deltaTime) override
 		{
 			if (!(m_Blackboard->getBool(mBlackboardKey) != mIsSet))
@@ -32,6 +37,11 @@ namespace BehaviourTree
 		BlackboardCompare(Ref<Blackboard> blackboard, std::string const& blackboardkey_1, std::string const& blackboardkey_2, bool isEqual)
 			:m_Blackboard(blackboard), mBBKey_1(blackboardkey_1), mBBKey_2(blackboardkey_2), mIsEqual(isEqual) {}
 
+		Ref<Node> clone(BehaviourTree* behaviourTree) const override
+		{
+			return cloneChild(CreateRef<BlackboardCompare>(behaviourTree->getBlackboard(), mBBKey_1, mBBKey_2, mIsEqual), behaviourTree);
+		}
+
 		Status update(float deltaTime) override
 		{
 			if (!((m_Blackboard->getBool(mBBKey_1) == m_Blackboard->getBool(mBBKey_2)) != mIsEqual))
@@ -52,6 +62,8 @@ namespace BehaviourTree
 	class Succeeder : public Decorator
 	{
 	public:
+		Ref<Node> clone(BehaviourTree* behaviourTree) const override { return cloneChild(CreateRef<Succeeder>(), behaviourTree); }
+
 		Status update(float deltaTime) override
 		{
 			m_Child->tick(deltaTime);
@@ -63,6 +75,8 @@ namespace BehaviourTree
 	class Failer : public Decorator
 	{
 	public:
+		Ref<Node> clone(BehaviourTree* behaviourTree) const override { return cloneChild(CreateRef<Failer>(), behaviourTree); }
+
 		Status update(float deltaTime) override
 		{
 			m_Child->tick(deltaTime);
@@ -77,6 +91,8 @@ namespace BehaviourTree
 	class Inverter : public Decorator
 	{
 	public:
+		Ref<Node> clone(BehaviourTree* behaviourTree) const override { return cloneChild(CreateRef<Inverter>(), behaviourTree); }
+
 		Status update(float deltaTime) override
 		{
 			Status s = m_Child->tick(deltaTime);
@@ -100,6 +116,8 @@ namespace BehaviourTree
 	public:
 		explicit Repeater(int limit = 0) : limit(limit) {}
 
+		Ref<Node> clone(BehaviourTree* behaviourTree) const override { return cloneChild(CreateRef<Repeater>(limit), behaviourTree); }
+
 		void initialize() override
 		{
 			counter = 0;
@@ -127,6 +145,8 @@ namespace BehaviourTree
 	class UntilSuccess : public Decorator
 	{
 	public:
+		Ref<Node> clone(BehaviourTree* behaviourTree) const override { return cloneChild(CreateRef<UntilSuccess>(), behaviourTree); }
+
 		Status update(float deltaTime) override
 		{
 			while (true) {
@@ -145,6 +165,8 @@ namespace BehaviourTree
 	class UntilFailure : public Decorator
 	{
 	public:
+		Ref<Node> clone(BehaviourTree* behaviourTree) const override { return cloneChild(CreateRef<UntilFailure>(), behaviourTree); }
+
 		Status update(float deltaTime) override
 		{
 			while (true) {
@@ -0,0 +1,647 @@
+#include "stdafx.h"
+#include "HierarchicalPathfinder.h"
+
+#include "Core/ThreadPool.h"
+
+namespace Astar
+{
+	static constexpr uint32_t s_Unreachable = UINT32_MAX;
+	static constexpr uint32_t s_NoParent = UINT32_MAX;
+	static constexpr uint32_t s_GoalNode = UINT32_MAX - 1;
+
+	// Transitions are placed at both ends of entrances at least this long, otherwise in the middle
+	static constexpr int s_LongEntrance = 6;
+
+	static const GridCoord s_Directions[8] = {
+		{ 0, 1 }, { 1, 0 }, { 0, -1 }, { -1, 0 },
+		{ -1, -1 }, { 1, 1 }, { -1, 1 }, { 1, -1 }
+	};
+
+	struct SearchEntry
+	{
+		uint32_t score;
+		uint32_t node;
+
+		bool operator>(const SearchEntry& other) const { return score > other.score; }
+	};
+
+	// Per cell search state for a single cluster, indexed by (y - minY) * clusterSize + (x - minX)
+	struct ClusterScratch
+	{
+		std::vector<uint32_t> cost;
+		std::vector<uint32_t> parent;
+		std::vector<SearchEntry> open;
+	};
+
+	static thread_local ClusterScratch s_ClusterScratch;
+
+	// Per cell state for the search over entrances, indexed by cell with the goal in the last slot.
+	// Entries only count when stamped with the current search so nothing is cleared between queries
+	struct AbstractScratch
+	{
+		std::vector<uint32_t> cost;
+		std::vector<uint32_t> parent;
+		std::vector<uint32_t> visited;
+		std::vector<uint32_t> closed;
+		std::vector<SearchEntry> open;
+		uint32_t search = 0;
+
+		void Prepare(size_t nodeCount)
+		{
+			if (cost.size() < nodeCount)
+			{
+				cost.resize(nodeCount);
+				parent.resize(nodeCount);
+				visited.resize(nodeCount, 0);
+				closed.resize(nodeCount, 0);
+			}
+			open.clear();
+
+			if (++search == 0)
+			{
+				std::fill(visited.begin(), visited.end(), 0);
+				std::fill(closed.begin(), closed.end(), 0);
+				search = 1;
+			}
+		}
+	};
+
+	static thread_local AbstractScratch s_AbstractScratch;
+
+	/* ------------------------------------------------------------------------------------------------------------------ */
+
+	HierarchicalPathfinder::HierarchicalPathfinder(uint32_t clusterSize, size_t cacheCapacity)
+		:m_ClusterSize(clusterSize > 1 ? clusterSize : 2), m_CacheCapacity(cacheCapacity),
+		m_Grid(0, 0, 1.0f, 1.0f, Vector2f(), nullptr)
+	{
+	}
+
+	/* ------------------------------------------------------------------------------------------------------------------ */
+
+	void HierarchicalPathfinder::Build(const AstarGrid& grid)
+	{
+		PROFILE_FUNCTION();
+
+		std::unique_lock lock(m_GraphMutex);
+
+		m_Grid = AstarGrid(grid.width, grid.height, grid.cellWidth, grid.cellHeight, grid.origin, nullptr);
+		m_Width = grid.width > 0 ? grid.width : 0;
+		m_Height = grid.height > 0 ? grid.height : 0;
+
+		m_Blocked.assign((size_t)m_Width * (size_t)m_Height, 0);
+		for (int x = 0; x < m_Width; x++)
+		{
+			for (int y = 0; y < m_Height; y++)
+			{
+				m_Blocked[CellIndex(GridCoord(x, y))] = grid.collisions[x][y] ? 1 : 0;
+			}
+		}
+
+		m_ClustersWide = (m_Width + (int)m_ClusterSize - 1) / (int)m_ClusterSize;
+		m_ClustersHigh = (m_Height + (int)m_ClusterSize - 1) / (int)m_ClusterSize;
+
+		m_Clusters.clear();
+		m_Clusters.resize((size_t)m_ClustersWide * (size_t)m_ClustersHigh);
+		for (int cy = 0; cy < m_ClustersHigh; cy++)
+		{
+			for (int cx = 0; cx < m_ClustersWide; cx++)
+			{
+				Cluster& cluster = m_Clusters[(size_t)cy * m_ClustersWide + cx];
+				cluster.minX = cx * (int)m_ClusterSize;
+				cluster.minY = cy * (int)m_ClusterSize;
+				cluster.maxX = std::min(cluster.minX + (int)m_ClusterSize, m_Width) - 1;
+				cluster.maxY = std::min(cluster.minY + (int)m_ClusterSize, m_Height) - 1;
+			}
+		}
+
+		{
+			std::scoped_lock cacheLock(m_CacheMutex);
+			m_Cache.clear();
+			m_CacheList.clear();
+		}
+
+		RebuildClusters();
+		m_Dirty = false;
+	}
+
+	/* ------------------------------------------------------------------------------------------------------------------ */
+
+	void HierarchicalPathfinder::SetBlocked(GridCoord coordinate, bool blocked)
+	{
+		std::unique_lock lock(m_GraphMutex);
+
+		if (!m_Grid.IsInside(coordinate))
+			return;
+
+		uint32_t cell = CellIndex(coordinate);
+		if (IsBlocked(cell) == blocked)
+			return;
+
+		m_Blocked[cell] = blocked ? 1 : 0;
+		m_Clusters[ClusterOf(cell)].dirty = true;
+		m_Dirty = true;
+	}
+
+	/* ------------------------------------------------------------------------------------------------------------------ */
+
+	bool HierarchicalPathfinder::IsBlocked(GridCoord coordinate) const
+	{
+		std::shared_lock lock(m_GraphMutex);
+		return !m_Grid.IsInside(coordinate) || IsBlocked(CellIndex(coordinate));
+	}
+
+	/* ------------------------------------------------------------------------------------------------------------------ */
+
+	void HierarchicalPathfinder::Rebuild()
+	{
+		std::unique_lock lock(m_GraphMutex);
+		if (!m_Dirty)
+			return;
+
+		RebuildClusters();
+		m_Dirty = false;
+	}
+
+	/* ------------------------------------------------------------------------------------------------------------------ */
+
+	std::vector<Vector2f> HierarchicalPathfinder::FindPath(Vector2f source, Vector2f goal)
+	{
+		std::vector<Vector2f> path;
+
+		GridCoord sourceCoords;
+		GridCoord goalCoords;
+
+		if (!m_Grid.PositionToGridCoord(source, sourceCoords) || !m_Grid.PositionToGridCoord(goal, goalCoords))
+			return path;
+
+		std::vector<GridCoord> cells = FindPath(sourceCoords, goalCoords);
+		path.reserve(cells.size());
+		for (GridCoord cell : cells)
+		{
+			Vector2f position;
+			m_Grid.GridCoordToPosition(cell, position);
+			path.push_back(position);
+		}
+		return path;
+	}
+
+	/* ------------------------------------------------------------------------------------------------------------------ */
+
+	std::vector<GridCoord> HierarchicalPathfinder::FindPath(GridCoord source, GridCoord goal)
+	{
+		PROFILE_FUNCTION();
+
+		if (m_Dirty)
+			Rebuild();
+
+		std::shared_lock lock(m_GraphMutex);
+
+		std::vector<GridCoord> path;
+		if (!m_Grid.IsInside(source) || !m_Grid.IsInside(goal))
+			return path;
+
+		const uint32_t sourceCell = CellIndex(source);
+		const uint32_t goalCell = CellIndex(goal);
+		if (IsBlocked(goalCell))
+			return path;
+
+		const uint32_t sourceClusterIndex = ClusterOf(sourceCell);
+		const uint32_t goalClusterIndex = ClusterOf(goalCell);
+		const Cluster& sourceCluster = m_Clusters[sourceClusterIndex];
+		const Cluster& goalCluster = m_Clusters[goalClusterIndex];
+
+		std::vector<uint32_t> cells;
+
+		// Short paths that stay inside a single cluster don't need the abstract graph
+		if (sourceClusterIndex == goalClusterIndex && ClusterPath(sourceCluster, sourceCell, goalCell, cells))
+		{
+			path.reserve(cells.size());
+			for (uint32_t cell : cells)
+				path.push_back(CellCoord(cell));
+			return path;
+		}
+
+		// Connect the source and the goal to the entrances of their clusters
+		std::vector<uint32_t> sourceCosts(sourceCluster.entrances.size());
+		SearchCluster(sourceCluster, sourceCell);
+		for (size_t i = 0; i < sourceCluster.entrances.size(); i++)
+			sourceCosts[i] = ClusterCost(sourceCluster, sourceCluster.entrances[i]);
+
+		std::vector<uint32_t> goalCosts(goalCluster.entrances.size());
+		SearchCluster(goalCluster, goalCell);
+		for (size_t i = 0; i < goalCluster.entrances.size(); i++)
+			goalCosts[i] = ClusterCost(goalCluster, goalCluster.entrances[i]);
+
+		// A* over the entrances
+		AbstractScratch& scratch = s_AbstractScratch;
+		const uint32_t goalSlot = (uint32_t)m_Width * (uint32_t)m_Height;
+		scratch.Prepare((size_t)goalSlot + 1);
+
+		auto slot = [goalSlot](uint32_t node) { return node == s_GoalNode ? goalSlot : node; };
+
+		auto visit = [&](uint32_t node, uint32_t cost, uint32_t parent)
+		{
+			uint32_t index = slot(node);
+			if (scratch.closed[index] == scratch.search)
+				return;
+			if (scratch.visited[index] == scratch.search && cost >= scratch.cost[index])
+				return;
+			scratch.visited[index] = scratch.search;
+			scratch.cost[index] = cost;
+			scratch.parent[index] = parent;
+
+			uint32_t heuristic = node == s_GoalNode ? 0 : Heuristic::Octagonal(CellCoord(node), goal);
+			scratch.open.push_back({ cost + heuristic, node });
+			std::push_heap(scratch.open.begin(), scratch.open.end(), std::greater<SearchEntry>());
+		};
+
+		for (size_t i = 0; i < sourceCluster.entrances.size(); i++)
+		{
+			if (sourceCosts[i] != s_Unreachable)
+				visit(sourceCluster.entrances[i], sourceCosts[i], s_NoParent);
+		}
+
+		bool found = false;
+		while (!scratch.open.empty())
+		{
+			std::pop_heap(scratch.open.begin(), scratch.open.end(), std::greater<SearchEntry>());
+			uint32_t node = scratch.open.back().node;
+			scratch.open.pop_back();
+
+			if (node == s_GoalNode)
+			{
+				found = true;
+				break;
+			}
+
+			if (scratch.closed[node] == scratch.search)
+				continue;
+			scratch.closed[node] = scratch.search;
+			uint32_t cost = scratch.cost[node];
+
+			uint32_t clusterIndex = ClusterOf(node);
+			const Cluster& cluster = m_Clusters[clusterIndex];
+			size_t entranceCount = cluster.entrances.size();
+			size_t entrance = std::find(cluster.entrances.begin(), cluster.entrances.end(), node) - cluster.entrances.begin();
+			if (entrance == entranceCount)
+				continue;
+
+			for (size_t j = 0; j < entranceCount; j++)
+			{
+				uint32_t edgeCost = cluster.costs[entrance * entranceCount + j];
+				if (j != entrance && edgeCost != s_Unreachable)
+					visit(cluster.entrances[j], cost + edgeCost, node);
+			}
+
+			for (uint32_t partner : cluster.partners[entrance])
+				visit(partner, cost + 10, node);
+
+			if (clusterIndex == goalClusterIndex && goalCosts[entrance] != s_Unreachable)
+				visit(s_GoalNode, cost + goalCosts[entrance], node);
+		}
+
+		if (!found)
+			return path;
+
+		std::vector<uint32_t> abstractPath;
+		for (uint32_t node = scratch.parent[goalSlot]; node != s_NoParent; node = scratch.parent[node])
+			abstractPath.push_back(node);
+		std::reverse(abstractPath.begin(), abstractPath.end());
+		abstractPath.push_back(goalCell);
+
+		// Refine each step of the abstract path into cells
+		cells.clear();
+		cells.push_back(sourceCell);
+		std::vector<uint32_t> segment;
+		for (size_t i = 0; i < abstractPath.size(); i++)
+		{
+			uint32_t from = cells.back();
+			uint32_t to = abstractPath[i];
+			uint32_t clusterIndex = ClusterOf(from);
+
+			if (clusterIndex != ClusterOf(to))
+			{
+				cells.push_back(to);
+				continue;
+			}
+
+			// Paths between two entrances are shared by every query through the cluster
+			bool betweenEntrances = i > 0 && i + 1 < abstractPath.size();
+			bool refined = betweenEntrances
+				? CachedClusterPath(clusterIndex, from, to, segment)
+				: ClusterPath(m_Clusters[clusterIndex], from, to, segment);
+
+			if (!refined)
+				return path;
+			cells.insert(cells.end(), segment.begin() + 1, segment.end());
+		}
+
+		path.reserve(cells.size());
+		for (uint32_t cell : cells)
+			path.push_back(CellCoord(cell));
+		return path;
+	}
+
+	/* ------------------------------------------------------------------------------------------------------------------ */
+
+	HierarchicalPathfinder::Stats HierarchicalPathfinder::GetStats() const
+	{
+		std::shared_lock lock(m_GraphMutex);
+
+		Stats stats;
+		stats.clusters = (uint32_t)m_Clusters.size();
+		for (const Cluster& cluster : m_Clusters)
+			stats.entrances += (uint32_t)cluster.entrances.size();
+		stats.cacheHits = m_CacheHits;
+		stats.cacheMisses = m_CacheMisses;
+		return stats;
+	}
+
+	/* ------------------------------------------------------------------------------------------------------------------ */
+
+	void HierarchicalPathfinder::ResetStats()
+	{
+		m_CacheHits = 0;
+		m_CacheMisses = 0;
+	}
+
+	/* ------------------------------------------------------------------------------------------------------------------ */
+
+	uint32_t HierarchicalPathfinder::ClusterOf(uint32_t cell) const
+	{
+		GridCoord coordinates = CellCoord(cell);
+		return (uint32_t)(coordinates.y / (int)m_ClusterSize) * (uint32_t)m_ClustersWide + (uint32_t)(coordinates.x / (int)m_ClusterSize);
+	}
+
+	/* ------------------------------------------------------------------------------------------------------------------ */
+
+	void HierarchicalPathfinder::RebuildClusters()
+	{
+		PROFILE_FUNCTION();
+
+		// Rebuilding a cluster changes the transitions on all four of its borders,
+		// which changes the entrances of the neighbouring clusters too
+		std::vector<uint8_t> affected(m_Clusters.size(), 0);
+		for (int cy = 0; cy < m_ClustersHigh; cy++)
+		{
+			for (int cx = 0; cx < m_ClustersWide; cx++)
+			{
+				size_t index = (size_t)cy * m_ClustersWide + cx;
+				if (!m_Clusters[index].dirty)
+					continue;
+
+				BuildBorder(m_Clusters[index], true);
+				BuildBorder(m_Clusters[index], false);
+				if (cx > 0)
+					BuildBorder(m_Clusters[index - 1], true);
+				if (cy > 0)
+					BuildBorder(m_Clusters[index - m_ClustersWide], false);
+
+				affected[index] = 1;
+				if (cx > 0) affected[index - 1] = 1;
+				if (cx + 1 < m_ClustersWide) affected[index + 1] = 1;
+				if (cy > 0) affected[index - m_ClustersWide] = 1;
+				if (cy + 1 < m_ClustersHigh) affected[index + m_ClustersWide] = 1;
+			}
+		}
+
+		std::vector<uint32_t> rebuild;
+		for (uint32_t i = 0; i < (uint32_t)affected.size(); i++)
+		{
+			if (affected[i])
+				rebuild.push_back(i);
+		}
+
+		// Each cluster only writes its own entrances so they can be built in parallel
+		ThreadPool::ParallelFor(rebuild.size(), 4, [&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; i++)
+					BuildEntrances(rebuild[i]);
+			});
+
+		for (Cluster& cluster : m_Clusters)
+			cluster.dirty = false;
+
+		std::scoped_lock cacheLock(m_CacheMutex);
+		for (auto it = m_CacheList.begin(); it != m_CacheList.end();)
+		{
+			if (affected[it->cluster])
+			{
+				m_Cache.erase(it->key);
+				it = m_CacheList.erase(it);
+			}
+			else
+				++it;
+		}
+	}
+
+	/* ------------------------------------------------------------------------------------------------------------------ */
+
+	void HierarchicalPathfinder::BuildBorder(Cluster& cluster, bool east)
+	{
+		std::vector<Transition>& transitions = east ? cluster.east : cluster.south;
+		transitions.clear();
+
+		if ((east && cluster.maxX + 1 >= m_Width) || (!east && cluster.maxY + 1 >= m_Height))
+			return;
+
+		int length = east ? cluster.maxY - cluster.minY + 1 : cluster.maxX - cluster.minX + 1;
+
+		auto cellsAt = [&](int i)
+		{
+			GridCoord inside = east ? GridCoord(cluster.maxX, cluster.minY + i) : GridCoord(cluster.minX + i, cluster.maxY);
+			GridCoord outside = east ? GridCoord(cluster.maxX + 1, cluster.minY + i) : GridCoord(cluster.minX + i, cluster.maxY + 1);
+			return Transition{ CellIndex(inside), CellIndex(outside) };
+		};
+
+		// Each run of open cells along the border is an entrance
+		int runStart = -1;
+		for (int i = 0; i <= length; i++)
+		{
+			bool open = false;
+			if (i < length)
+			{
+				Transition transition = cellsAt(i);
+				open = !IsBlocked(transition.from) && !IsBlocked(transition.to);
+			}
+
+			if (open && runStart < 0)
+			{
+				runStart = i;
+			}
+			else if (!open && runStart >= 0)
+			{
+				int runEnd = i - 1;
+				if (runEnd - runStart + 1 >= s_LongEntrance)
+				{
+					transitions.push_back(cellsAt(runStart));
+					transitions.push_back(cellsAt(runEnd));
+				}
+				else
+				{
+					transitions.push_back(cellsAt((runStart + runEnd) / 2));
+				}
+				runStart = -1;
+			}
+		}
+	}
+
+	/* ------------------------------------------------------------------------------------------------------------------ */
+
+	void HierarchicalPathfinder::BuildEntrances(uint32_t clusterIndex)
+	{
+		Cluster& cluster = m_Clusters[clusterIndex];
+		cluster.entrances.clear();
+		cluster.partners.clear();
+
+		auto addTransition = [&cluster](uint32_t from, uint32_t to)
+		{
+			size_t entrance = std::find(cluster.entrances.begin(), cluster.entrances.end(), from) - cluster.entrances.begin();
+			if (entrance == cluster.entrances.size())
+			{
+				cluster.entrances.push_back(from);
+				cluster.partners.emplace_back();
+			}
+			cluster.partners[entrance].push_back(to);
+		};
+
+		for (const Transition& transition : cluster.east)
+			addTransition(transition.from, transition.to);
+		for (const Transition& transition : cluster.south)
+			addTransition(transition.from, transition.to);
+
+		int cx = (int)clusterIndex % m_ClustersWide;
+		int cy = (int)clusterIndex / m_ClustersWide;
+		if (cx > 0)
+		{
+			for (const Transition& transition : m_Clusters[clusterIndex - 1].east)
+				addTransition(transition.to, transition.from);
+		}
+		if (cy > 0)
+		{
+			for (const Transition& transition : m_Clusters[clusterIndex - m_ClustersWide].south)
+				addTransition(transition.to, transition.from);
+		}
+
+		size_t entranceCount = cluster.entrances.size();
+		cluster.costs.assign(entranceCount * entranceCount, s_Unreachable);
+		for (size_t i = 0; i < entranceCount; i++)
+		{
+			SearchCluster(cluster, cluster.entrances[i]);
+			for (size_t j = 0; j < entranceCount; j++)
+				cluster.costs[i * entranceCount + j] = ClusterCost(cluster, cluster.entrances[j]);
+		}
+	}
+
+	/* ------------------------------------------------------------------------------------------------------------------ */
+
+	void HierarchicalPathfinder::SearchCluster(const Cluster& cluster, uint32_t source) const
+	{
+		ClusterScratch& scratch = s_ClusterScratch;
+		const int stride = (int)m_ClusterSize;
+		scratch.cost.assign((size_t)stride * stride, s_Unreachable);
+		scratch.parent.assign((size_t)stride * stride, s_NoParent);
+		scratch.open.clear();
+
+		auto localIndex = [&](GridCoord coordinates) { return (uint32_t)((coordinates.y - cluster.minY) * stride + (coordinates.x - cluster.minX)); };
+
+		GridCoord sourceCoords = CellCoord(source);
+		scratch.cost[localIndex(sourceCoords)] = 0;
+		scratch.open.push_back({ 0, source });
+
+		while (!scratch.open.empty())
+		{
+			std::pop_heap(scratch.open.begin(), scratch.open.end(), std::greater<SearchEntry>());
+			SearchEntry current = scratch.open.back();
+			scratch.open.pop_back();
+
+			GridCoord currentCoords = CellCoord(current.node);
+			if (current.score > scratch.cost[localIndex(currentCoords)])
+				continue;
+
+			for (uint32_t i = 0; i < 8; i++)
+			{
+				GridCoord next = currentCoords + s_Directions[i];
+				if (next.x < cluster.minX || next.x > cluster.maxX || next.y < cluster.minY || next.y > cluster.maxY)
+					continue;
+
+				uint32_t nextCell = CellIndex(next);
+				if (IsBlocked(nextCell))
+					continue;
+
+				uint32_t cost = current.score + ((i < 4) ? 10 : 14);
+				uint32_t local = localIndex(next);
+				if (cost >= scratch.cost[local])
+					continue;
+
+				scratch.cost[local] = cost;
+				scratch.parent[local] = current.node;
+				scratch.open.push_back({ cost, nextCell });
+				std::push_heap(scratch.open.begin(), scratch.open.end(), std::greater<SearchEntry>());
+			}
+		}
+	}
+
+	/* ------------------------------------------------------------------------------------------------------------------ */
+
+	uint32_t HierarchicalPathfinder::ClusterCost(const Cluster& cluster, uint32_t cell) const
+	{
+		GridCoord coordinates = CellCoord(cell);
+		return s_ClusterScratch.cost[(size_t)(coordinates.y - cluster.minY) * m_ClusterSize + (coordinates.x - cluster.minX)];
+	}
+
+	/* ------------------------------------------------------------------------------------------------------------------ */
+
+	bool HierarchicalPathfinder::ClusterPath(const Cluster& cluster, uint32_t source, uint32_t target, std::vector<uint32_t>& cells) const
+	{
+		cells.clear();
+		SearchCluster(cluster, source);
+		if (ClusterCost(cluster, target) == s_Unreachable)
+			return false;
+
+		for (uint32_t cell = target; cell != s_NoParent;)
+		{
+			cells.push_back(cell);
+			GridCoord coordinates = CellCoord(cell);
+			cell = s_ClusterScratch.parent[(size_t)(coordinates.y - cluster.minY) * m_ClusterSize + (coordinates.x - cluster.minX)];
+		}
+		std::reverse(cells.begin(), cells.end());
+		return true;
+	}
+
+	/* ------------------------------------------------------------------------------------------------------------------ */
+
+	bool HierarchicalPathfinder::CachedClusterPath(uint32_t clusterIndex, uint32_t source, uint32_t target, std::vector<uint32_t>& cells)
+	{
+		uint64_t key = ((uint64_t)source << 32) | target;
+		{
+			std::scoped_lock cacheLock(m_CacheMutex);
+			auto it = m_Cache.find(key);
+			if (it != m_Cache.end())
+			{
+				m_CacheList.splice(m_CacheList.begin(), m_CacheList, it->second);
+				cells = it->second->cells;
+				m_CacheHits++;
+				return true;
+			}
+		}
+
+		m_CacheMisses++;
+		if (!ClusterPath(m_Clusters[clusterIndex], source, target, cells))
+			return false;
+
+		std::scoped_lock cacheLock(m_CacheMutex);
+		if (m_Cache.find(key) == m_Cache.end() && m_CacheCapacity > 0)
+		{
+			m_CacheList.push_front({ key, clusterIndex, cells });
+			m_Cache[key] = m_CacheList.begin();
+
+			if (m_CacheList.size() > m_CacheCapacity)
+			{
+				m_Cache.erase(m_CacheList.back().key);
+				m_CacheList.pop_back();
+			}
+		}
+		return true;
+	}
+}
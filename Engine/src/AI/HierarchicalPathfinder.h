@@ -0,0 +1,118 @@
+#pragma once
+
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <shared_mutex>
+#include <mutex>
+#include <atomic>
+
+#include "Astar.h"
+
+namespace Astar
+{
+	// Hierarchical path-finding A* (Botea, Muller & Schaeffer 2004)
+	// The grid is split into square clusters, searches run over the entrances between clusters
+	// and are then refined into cells one cluster at a time
+	class HierarchicalPathfinder
+	{
+	public:
+		struct Stats
+		{
+			uint32_t clusters = 0;
+			uint32_t entrances = 0;
+			uint32_t cacheHits = 0;
+			uint32_t cacheMisses = 0;
+		};
+
+		explicit HierarchicalPathfinder(uint32_t clusterSize = 16, size_t cacheCapacity = 4096);
+
+		// Copy the collision data from the grid and build every cluster
+		void Build(const AstarGrid& grid);
+
+		// Change a single cell, the clusters around it are rebuilt before the next query
+		void SetBlocked(GridCoord coordinate, bool blocked);
+		bool IsBlocked(GridCoord coordinate) const;
+
+		// Rebuild the clusters affected by SetBlocked
+		void Rebuild();
+
+		// Returns the cell centres from the source to the goal, empty if the goal can't be reached
+		// Can be called from several threads at once
+		std::vector<Vector2f> FindPath(Vector2f source, Vector2f goal);
+		std::vector<GridCoord> FindPath(GridCoord source, GridCoord goal);
+
+		// Cell sizes and origin used to convert between world positions and cells
+		const AstarGrid& GetGrid() const { return m_Grid; }
+
+		Stats GetStats() const;
+		void ResetStats();
+
+	private:
+		struct Transition
+		{
+			uint32_t from; // cell in this cluster
+			uint32_t to; // cell in the neighbouring cluster
+		};
+
+		struct Cluster
+		{
+			int minX, minY, maxX, maxY; // inclusive
+
+			// Transitions across the east and south borders, the west and north are owned by the neighbours
+			std::vector<Transition> east;
+			std::vector<Transition> south;
+
+			std::vector<uint32_t> entrances;
+			std::vector<std::vector<uint32_t>> partners; // cells each entrance leads to in other clusters
+			std::vector<uint32_t> costs; // entrances x entrances path costs within the cluster
+
+			bool dirty = true;
+		};
+
+		struct CacheEntry
+		{
+			uint64_t key;
+			uint32_t cluster;
+			std::vector<uint32_t> cells;
+		};
+
+		uint32_t CellIndex(GridCoord coordinates) const { return (uint32_t)coordinates.y * (uint32_t)m_Width + (uint32_t)coordinates.x; }
+		GridCoord CellCoord(uint32_t cell) const { return GridCoord((int)(cell % (uint32_t)m_Width), (int)(cell / (uint32_t)m_Width)); }
+		uint32_t ClusterOf(uint32_t cell) const;
+		bool IsBlocked(uint32_t cell) const { return m_Blocked[cell] != 0; }
+
+		void RebuildClusters();
+		void BuildBorder(Cluster& cluster, bool east);
+		void BuildEntrances(uint32_t clusterIndex);
+
+		// Dijkstra from a cell limited to the bounds of a cluster, fills the thread's scratch buffers
+		void SearchCluster(const Cluster& cluster, uint32_t source) const;
+		uint32_t ClusterCost(const Cluster& cluster, uint32_t cell) const;
+		bool ClusterPath(const Cluster& cluster, uint32_t source, uint32_t target, std::vector<uint32_t>& cells) const;
+		bool CachedClusterPath(uint32_t clusterIndex, uint32_t source, uint32_t target, std::vector<uint32_t>& cells);
+
+		uint32_t m_ClusterSize;
+		size_t m_CacheCapacity;
+
+		int m_Width = 0;
+		int m_Height = 0;
+		int m_ClustersWide = 0;
+		int m_ClustersHigh = 0;
+
+		AstarGrid m_Grid; // cell sizes and origin, the collision data is held in m_Blocked
+		std::vector<uint8_t> m_Blocked;
+		std::vector<Cluster> m_Clusters;
+		std::atomic<bool> m_Dirty = false;
+
+		mutable std::shared_mutex m_GraphMutex;
+
+		// Refined paths between pairs of entrances in the same cluster, most recently used at the front
+		std::mutex m_CacheMutex;
+		std::list<CacheEntry> m_CacheList;
+		std::unordered_map<uint64_t, std::list<CacheEntry>::iterator> m_Cache;
+
+		mutable std::atomic<uint32_t> m_CacheHits = 0;
+		mutable std::atomic<uint32_t> m_CacheMisses = 0;
+	};
+}
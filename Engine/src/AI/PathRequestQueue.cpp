@@ -0,0 +1,310 @@
+#include "stdafx.h"
+#include "PathRequestQueue.h"
+
+#include "HierarchicalPathfinder.h"
+#include "Core/ThreadPool.h"
+
+#include <deque>
+#include <atomic>
+#include <chrono>
+
+namespace Astar
+{
+	struct PathJob
+	{
+		const AstarGrid* grid = nullptr;
+		HierarchicalPathfinder* pathfinder = nullptr;
+
+		Vector2f source;
+		Vector2f goal;
+
+		// Key of the cell pair in the de-duplication map, cleared once the job has been solved
+		uint64_t key = 0;
+		bool shared = true;
+
+		PathRequestQueue::Status status = PathRequestQueue::Status::Pending;
+		std::vector<Vector2f> path;
+
+		// Number of handles still waiting on this job
+		uint32_t references = 0;
+	};
+
+	struct PathRequestKey
+	{
+		const void* owner;
+		uint64_t cells;
+
+		bool operator==(const PathRequestKey& other) const { return owner == other.owner && cells == other.cells; }
+	};
+
+	struct PathRequestKeyHash
+	{
+		size_t operator()(const PathRequestKey& key) const
+		{
+			return std::hash<const void*>()(key.owner) ^ (std::hash<uint64_t>()(key.cells) * 0x9E3779B97F4A7C15ull);
+		}
+	};
+
+	struct PathRequestData
+	{
+		std::mutex mutex;
+
+		PathRequestQueue::Handle nextHandle = 1;
+		std::unordered_map<PathRequestQueue::Handle, Ref<PathJob>> handles;
+		std::unordered_map<PathRequestKey, Ref<PathJob>, PathRequestKeyHash> unsolved;
+		std::deque<Ref<PathJob>> pending;
+
+		float frameBudget = 2.0f;
+
+		PathRequestQueue::Stats stats;
+	};
+
+	static PathRequestData s_Data;
+
+	/* ------------------------------------------------------------------------------------------------------------------ */
+
+	static PathRequestQueue::Handle AddRequest(Vector2f source, Vector2f goal, const AstarGrid& grid, const void* owner,
+		const AstarGrid* searchGrid, HierarchicalPathfinder* pathfinder)
+	{
+		GridCoord sourceCell, goalCell;
+		bool inside = grid.PositionToGridCoord(source, sourceCell);
+		inside &= grid.PositionToGridCoord(goal, goalCell);
+
+		std::scoped_lock lock(s_Data.mutex);
+
+		PathRequestQueue::Handle handle = s_Data.nextHandle++;
+		if (s_Data.nextHandle == PathRequestQueue::s_InvalidHandle)
+			s_Data.nextHandle = 1;
+
+		s_Data.stats.submitted++;
+
+		if (!inside)
+		{
+			Ref<PathJob> job = CreateRef<PathJob>();
+			job->status = PathRequestQueue::Status::Failed;
+			job->references = 1;
+			s_Data.handles[handle] = job;
+			return handle;
+		}
+
+		uint32_t sourceIndex = (uint32_t)sourceCell.y * (uint32_t)grid.width + (uint32_t)sourceCell.x;
+		uint32_t goalIndex = (uint32_t)goalCell.y * (uint32_t)grid.width + (uint32_t)goalCell.x;
+		PathRequestKey key = { owner, ((uint64_t)sourceIndex << 32) | goalIndex };
+
+		auto found = s_Data.unsolved.find(key);
+		if (found != s_Data.unsolved.end())
+		{
+			found->second->references++;
+			s_Data.handles[handle] = found->second;
+			s_Data.stats.deduplicated++;
+			return handle;
+		}
+
+		Ref<PathJob> job = CreateRef<PathJob>();
+		job->grid = searchGrid;
+		job->pathfinder = pathfinder;
+		job->source = source;
+		job->goal = goal;
+		job->key = key.cells;
+		job->references = 1;
+
+		s_Data.unsolved[key] = job;
+		s_Data.pending.push_back(job);
+		s_Data.handles[handle] = job;
+		return handle;
+	}
+
+	/* ------------------------------------------------------------------------------------------------------------------ */
+
+	PathRequestQueue::Handle PathRequestQueue::Submit(Vector2f source, Vector2f goal, const AstarGrid* grid)
+	{
+		if (!grid)
+			return s_InvalidHandle;
+
+		return AddRequest(source, goal, *grid, grid, grid, nullptr);
+	}
+
+	/* ------------------------------------------------------------------------------------------------------------------ */
+
+	PathRequestQueue::Handle PathRequestQueue::Submit(Vector2f source, Vector2f goal, HierarchicalPathfinder* pathfinder)
+	{
+		if (!pathfinder)
+			return s_InvalidHandle;
+
+		return AddRequest(source, goal, pathfinder->GetGrid(), pathfinder, nullptr, pathfinder);
+	}
+
+	/* ------------------------------------------------------------------------------------------------------------------ */
+
+	PathRequestQueue::Status PathRequestQueue::GetStatus(Handle handle)
+	{
+		std::scoped_lock lock(s_Data.mutex);
+
+		auto found = s_Data.handles.find(handle);
+		if (found == s_Data.handles.end())
+			return Status::Invalid;
+
+		return found->second->status;
+	}
+
+	/* ------------------------------------------------------------------------------------------------------------------ */
+
+	bool PathRequestQueue::TryGetPath(Handle handle, std::vector<Vector2f>& path)
+	{
+		std::scoped_lock lock(s_Data.mutex);
+
+		auto found = s_Data.handles.find(handle);
+		if (found == s_Data.handles.end() || found->second->status == Status::Pending)
+			return false;
+
+		Ref<PathJob> job = found->second;
+		s_Data.handles.erase(found);
+
+		// The last handle can take the path rather than copying it
+		if (--job->references == 0)
+			path = std::move(job->path);
+		else
+			path = job->path;
+
+		return true;
+	}
+
+	/* ------------------------------------------------------------------------------------------------------------------ */
+
+	void PathRequestQueue::Release(Handle handle)
+	{
+		std::scoped_lock lock(s_Data.mutex);
+
+		auto found = s_Data.handles.find(handle);
+		if (found == s_Data.handles.end())
+			return;
+
+		found->second->references--;
+		s_Data.handles.erase(found);
+	}
+
+	/* ------------------------------------------------------------------------------------------------------------------ */
+
+	void PathRequestQueue::Update()
+	{
+		PROFILE_FUNCTION();
+
+		std::vector<Ref<PathJob>> jobs;
+		float budget;
+		{
+			std::scoped_lock lock(s_Data.mutex);
+
+			jobs.reserve(s_Data.pending.size());
+			for (Ref<PathJob>& job : s_Data.pending)
+			{
+				// Nothing is waiting on this request any more
+				if (job->references == 0)
+				{
+					s_Data.unsolved.erase({ job->pathfinder ? (const void*)job->pathfinder : (const void*)job->grid, job->key });
+					continue;
+				}
+				jobs.push_back(job);
+			}
+			s_Data.pending.clear();
+			budget = s_Data.frameBudget;
+		}
+
+		if (jobs.empty())
+		{
+			std::scoped_lock lock(s_Data.mutex);
+			s_Data.stats.pending = 0;
+			return;
+		}
+
+		// Jobs are taken in submission order, once the deadline passes the remaining jobs are left for the next frame.
+		// The first job is always taken so the queue keeps moving when the budget is zero or too small for any search
+		auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds((int64_t)(std::max(budget, 0.0f) * 1000.0f));
+		std::atomic<size_t> next = 0;
+
+		ThreadPool::ParallelFor(ThreadPool::GetThreadCount(), 1, [&](size_t begin, size_t end)
+			{
+				for (size_t worker = begin; worker < end; worker++)
+				{
+					while (next.load() == 0 || std::chrono::steady_clock::now() < deadline)
+					{
+						size_t index = next.fetch_add(1);
+						if (index >= jobs.size())
+							return;
+
+						PathJob& job = *jobs[index];
+						if (job.pathfinder)
+							job.path = job.pathfinder->FindPath(job.source, job.goal);
+						else
+							job.path = Generator::GetInstance()->FindPath(job.source, job.goal, job.grid);
+					}
+				}
+			});
+
+		size_t solved = std::min(next.load(), jobs.size());
+
+		std::scoped_lock lock(s_Data.mutex);
+
+		for (size_t i = 0; i < solved; i++)
+		{
+			PathJob& job = *jobs[i];
+			job.status = job.path.empty() ? Status::Failed : Status::Ready;
+			s_Data.unsolved.erase({ job.pathfinder ? (const void*)job.pathfinder : (const void*)job.grid, job.key });
+		}
+
+		// Put the jobs that missed the deadline back at the front so they keep their place in the queue
+		for (size_t i = jobs.size(); i > solved; i--)
+		{
+			s_Data.pending.push_front(jobs[i - 1]);
+		}
+
+		s_Data.stats.solved += (uint32_t)solved;
+		s_Data.stats.pending = (uint32_t)s_Data.pending.size();
+	}
+
+	/* ------------------------------------------------------------------------------------------------------------------ */
+
+	void PathRequestQueue::SetFrameBudget(float milliseconds)
+	{
+		std::scoped_lock lock(s_Data.mutex);
+		s_Data.frameBudget = milliseconds;
+	}
+
+	/* ------------------------------------------------------------------------------------------------------------------ */
+
+	float PathRequestQueue::GetFrameBudget()
+	{
+		std::scoped_lock lock(s_Data.mutex);
+		return s_Data.frameBudget;
+	}
+
+	/* ------------------------------------------------------------------------------------------------------------------ */
+
+	void PathRequestQueue::Clear()
+	{
+		std::scoped_lock lock(s_Data.mutex);
+
+		s_Data.handles.clear();
+		s_Data.unsolved.clear();
+		s_Data.pending.clear();
+		s_Data.stats.pending = 0;
+	}
+
+	/* ------------------------------------------------------------------------------------------------------------------ */
+
+	PathRequestQueue::Stats PathRequestQueue::GetStats()
+	{
+		std::scoped_lock lock(s_Data.mutex);
+		return s_Data.stats;
+	}
+
+	/* ------------------------------------------------------------------------------------------------------------------ */
+
+	void PathRequestQueue::ResetStats()
+	{
+		std::scoped_lock lock(s_Data.mutex);
+
+		uint32_t pending = s_Data.stats.pending;
+		s_Data.stats = Stats();
+		s_Data.stats.pending = pending;
+	}
+}
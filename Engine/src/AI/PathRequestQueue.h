@@ -0,0 +1,61 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "Astar.h"
+
+namespace Astar
+{
+	class HierarchicalPathfinder;
+
+	// Path requests that are solved on the worker threads once per frame, within a time budget.
+	// Requests between the same cells on the same grid in a frame share a single search
+	class PathRequestQueue
+	{
+	public:
+		using Handle = uint32_t;
+		static constexpr Handle s_InvalidHandle = 0;
+
+		enum class Status
+		{
+			Invalid,
+			Pending,
+			Ready,
+			Failed
+		};
+
+		struct Stats
+		{
+			uint32_t submitted = 0;
+			uint32_t deduplicated = 0;
+			uint32_t solved = 0;
+			uint32_t pending = 0;
+		};
+
+		// The grid or pathfinder must stay alive until the request has been solved
+		static Handle Submit(Vector2f source, Vector2f goal, const AstarGrid* grid);
+		static Handle Submit(Vector2f source, Vector2f goal, HierarchicalPathfinder* pathfinder);
+
+		static Status GetStatus(Handle handle);
+
+		// Copies the path out and releases the handle, returns false if the request hasn't been solved
+		static bool TryGetPath(Handle handle, std::vector<Vector2f>& path);
+
+		// Release a handle without collecting the path, the search is skipped if nothing else is waiting on it
+		static void Release(Handle handle);
+
+		// Solve pending requests across the worker threads until the frame budget runs out
+		// Requests that don't fit in the budget are solved in a later frame, at least one is solved each frame
+		static void Update();
+
+		static void SetFrameBudget(float milliseconds);
+		static float GetFrameBudget();
+
+		// Drop every request, outstanding handles become invalid
+		static void Clear();
+
+		static Stats GetStats();
+		static void ResetStats();
+	};
+}
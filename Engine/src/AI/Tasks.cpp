@@ -2,6 +2,8 @@
 #include "Tasks.h"
 
 #include "Scripting/Lua/LuaManager.h"
+#include "Scene/SceneManager.h"
+#include "Scene/Scene.h"
 
 #include "Logging/Instrumentor.h"
 
@@ -20,9 +22,37 @@ BehaviourTree::CustomTask::CustomTask(BehaviourTree* behaviourTree, const std::f
 		ENGINE_ERROR("could not find custom task lua script");
 	}
 
+	// Compiled once so copies of the task don't read and parse the script again
+	sol::load_result chunk = LuaManager::GetState().load_file(m_AbsoluteFilepath.string());
+	if (!chunk.valid())
+	{
+		sol::error error = chunk;
+		ENGINE_ERROR("Failed to load custom task lua script {0}: {1}", m_AbsoluteFilepath, error.what());
+		return;
+	}
+
+	m_Bytecode = CreateRef<sol::bytecode>(chunk.get<sol::protected_function>().dump());
+	CreateEnvironment();
+}
+
+BehaviourTree::CustomTask::CustomTask(BehaviourTree* behaviourTree, const CustomTask& task)
+	:Leaf(behaviourTree), m_AbsoluteFilepath(task.m_AbsoluteFilepath), m_Bytecode(task.m_Bytecode)
+{
+	CreateEnvironment();
+}
+
+BehaviourTree::CustomTask::~CustomTask()
+{
+}
+
+void BehaviourTree::CustomTask::CreateEnvironment()
+{
+	if (!m_Bytecode)
+		return;
+
 	m_SolEnvironment = CreateRef<sol::environment>(LuaManager::GetState(), sol::create, LuaManager::GetState().globals());
 
-	sol::protected_function_result result = LuaManager::GetState().script_file(m_AbsoluteFilepath.string(), *m_SolEnvironment, sol::script_pass_on_error);
+	sol::protected_function_result result = LuaManager::GetState().script(m_Bytecode->as_string_view(), *m_SolEnvironment, sol::script_pass_on_error);
 
 	if (!result.valid())
 	{
@@ -47,8 +77,11 @@ BehaviourTree::CustomTask::CustomTask(BehaviourTree* behaviourTree, const std::f
 	LuaManager::GetState().collect_garbage();
 }
 
-BehaviourTree::CustomTask::~CustomTask()
+Ref<BehaviourTree::Node> BehaviourTree::CustomTask::clone(BehaviourTree* behaviourTree) const
 {
+	Ref<CustomTask> copy = CreateRef<CustomTask>(behaviourTree, *this);
+	copy->SetEditorPosition(GetEditorPosition());
+	return copy;
 }
 
 void BehaviourTree::CustomTask::initialize()
@@ -102,3 +135,66 @@ void BehaviourTree::CustomTask::terminate(Status s)
 		}
 	}
 }
+
+BehaviourTree::FindPath::FindPath(BehaviourTree* behaviourTree, const std::string& sourceKey, const std::string& goalKey, const std::string& pathKey)
+	:Leaf(behaviourTree), m_SourceKey(sourceKey), m_GoalKey(goalKey), m_PathKey(pathKey)
+{
+}
+
+BehaviourTree::FindPath::~FindPath()
+{
+	Astar::PathRequestQueue::Release(m_Handle);
+}
+
+Ref<BehaviourTree::Node> BehaviourTree::FindPath::clone(BehaviourTree* behaviourTree) const
+{
+	Ref<FindPath> copy = CreateRef<FindPath>(behaviourTree, m_SourceKey, m_GoalKey, m_PathKey);
+	copy->SetEditorPosition(GetEditorPosition());
+	return copy;
+}
+
+void BehaviourTree::FindPath::initialize()
+{
+	PROFILE_FUNCTION();
+
+	Astar::PathRequestQueue::Release(m_Handle);
+	m_Handle = Astar::PathRequestQueue::s_InvalidHandle;
+
+	Scene* scene = SceneManager::CurrentScene();
+	if (!scene || !scene->GetPathfinder())
+	{
+		ENGINE_ERROR("Find path task needs a tilemap with collisions in the scene");
+		return;
+	}
+
+	Ref<Blackboard> blackboard = m_BehaviourTree->getBlackboard();
+	m_Handle = Astar::PathRequestQueue::Submit(blackboard->getVector2(m_SourceKey), blackboard->getVector2(m_GoalKey), scene->GetPathfinder());
+}
+
+BehaviourTree::Node::Status BehaviourTree::FindPath::update(float deltaTime)
+{
+	PROFILE_FUNCTION();
+
+	switch (Astar::PathRequestQueue::GetStatus(m_Handle))
+	{
+	case Astar::PathRequestQueue::Status::Pending:
+		return Status::Running;
+	case Astar::PathRequestQueue::Status::Ready:
+	{
+		std::vector<Vector2f> path;
+		Astar::PathRequestQueue::TryGetPath(m_Handle, path);
+		m_Handle = Astar::PathRequestQueue::s_InvalidHandle;
+		m_BehaviourTree->getBlackboard()->setPath(m_PathKey, std::move(path));
+		return Status::Success;
+	}
+	default:
+		return Status::Failure;
+	}
+}
+
+void BehaviourTree::FindPath::terminate(Status s)
+{
+	// Nothing is waiting on the request any more, so the search can be skipped if it hasn't run yet
+	Astar::PathRequestQueue::Release(m_Handle);
+	m_Handle = Astar::PathRequestQueue::s_InvalidHandle;
+}
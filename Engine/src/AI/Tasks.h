@@ -1,6 +1,7 @@
 #pragma once
 
 #include "BehaviorTree.h"
+#include "PathRequestQueue.h"
 #include "sol/sol.hpp"
 
 namespace BehaviourTree
@@ -15,6 +16,13 @@ public:
 	{
 	}
 
+	Ref<Node> clone(BehaviourTree* behaviourTree) const final
+	{
+		Ref<Wait> copy = CreateRef<Wait>(behaviourTree, m_WaitTime);
+		copy->SetEditorPosition(GetEditorPosition());
+		return copy;
+	}
+
 	void initialize() final
 	{
 		m_CurrentTime = m_WaitTime;
@@ -51,8 +59,12 @@ class CustomTask : public Leaf
 {
 public:
 	CustomTask(BehaviourTree* behaviourTree, const std::filesystem::path& filepath);
+
+	// Run the script the task has already loaded in a new environment, without reading the file again
+	CustomTask(BehaviourTree* behaviourTree, const CustomTask& task);
 	~CustomTask();
 
+	Ref<Node> clone(BehaviourTree* behaviourTree) const final;
 	void initialize() final;
 	Status update(float deltaTime) final;
 	void terminate(Status s) final;
@@ -60,11 +72,41 @@ public:
 	const std::filesystem::path& getFilePath() { return m_AbsoluteFilepath; }
 
 private:
+	void CreateEnvironment();
+
 	std::filesystem::path m_AbsoluteFilepath;
 
+	// The compiled script, shared with the copies of the task
+	Ref<sol::bytecode> m_Bytecode;
+
 	Ref<sol::environment> m_SolEnvironment;
 	Ref<sol::protected_function> m_OnStateEntryFunc;
 	Ref<sol::protected_function> m_OnStateUpdateFunc;
 	Ref<sol::protected_function> m_OnStateExitFunc;
 };
+
+// Request a path between two blackboard positions on the scene's pathfinder and wait for it to be solved.
+// The cell centres along the path are written back to the blackboard
+class FindPath : public Leaf
+{
+public:
+	FindPath(BehaviourTree* behaviourTree, const std::string& sourceKey, const std::string& goalKey, const std::string& pathKey);
+	~FindPath();
+
+	Ref<Node> clone(BehaviourTree* behaviourTree) const final;
+	void initialize() final;
+	Status update(float deltaTime) final;
+	void terminate(Status s) final;
+
+	const std::string& getSourceKey() const { return m_SourceKey; }
+	const std::string& getGoalKey() const { return m_GoalKey; }
+	const std::string& getPathKey() const { return m_PathKey; }
+
+private:
+	std::string m_SourceKey;
+	std::string m_GoalKey;
+	std::string m_PathKey;
+
+	Astar::PathRequestQueue::Handle m_Handle = Astar::PathRequestQueue::s_InvalidHandle;
+};
 }
@@ -1,9 +1,14 @@
 #include "stdafx.h"
 #include "Application.h"
 
+#include <chrono>
+#include <thread>
+
 #include "GLFW/glfw3.h"
 
 #include "Settings.h"
+#include "ThreadPool.h"
+#include "Statistics.h"
 #include "InputParser.h"
 #include "Version.h"
 
@@ -15,6 +20,7 @@
 #include "Events/SceneEvent.h"
 
 #include "Scene/SceneManager.h"
+#include "Scene/BinarySceneSerializer.h"
 
 #include "Logging/Logger.h"
 #include "Core/Input.h"
@@ -60,13 +66,14 @@ Application::~Application()
 	m_LayerStack.PushPop();
 	SceneManager::Shutdown();
 	Settings::SaveSettings();
-	if (m_Window) {
+	if (m_Window || m_Headless) {
 		if (m_ImGuiManager) m_ImGuiManager->Shutdown();
 		Renderer::Shutdown();
 		Font::Shutdown();
 	}
 	AssetManager::Shutdown();
 	LuaManager::Shutdown();
+	ThreadPool::Shutdown();
 	PROFILE_END_SESSION("Shutdown");
 }
 
@@ -84,6 +91,12 @@ int Application::Init(int argc, char* argv[])
 			<< " [--help] "
 			<< " [--version] "
 			<< " [--profile] "
+			<< " [--stats <file>] "
+			<< " [--headless] "
+			<< " [--frames <count>] "
+			<< " [--timescale <scale>] "
+			<< " [--capture <file>] "
+			<< " [--convert-scene <file>] "
 			<< std::endl;
 		return EXIT_SUCCESS;
 	}
@@ -99,6 +112,47 @@ int Application::Init(int argc, char* argv[])
 		Instrumentor::Enable();
 	}
 
+	if (input.CmdOptionExists("--stats"))
+	{
+		m_StatisticsFile = input.GetCmdOption("--stats");
+	}
+
+	if (input.CmdOptionExists("--headless"))
+	{
+		m_Headless = true;
+	}
+
+	if (input.CmdOptionExists("--frames"))
+	{
+		m_FrameLimit = std::strtoull(input.GetCmdOption("--frames").c_str(), nullptr, 10);
+	}
+
+	if (input.CmdOptionExists("--timescale"))
+	{
+		m_TimeScale = std::strtod(input.GetCmdOption("--timescale").c_str(), nullptr);
+		if (m_TimeScale < 0.0 || (m_TimeScale == 0.0 && !m_Headless))
+		{
+			std::cerr << "Time scale must be greater than 0, or 0 when headless" << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (input.CmdOptionExists("--capture"))
+	{
+		m_CaptureFile = input.GetCmdOption("--capture");
+		if (!m_Headless)
+		{
+			std::cerr << "Capturing the last frame requires --headless" << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (input.CmdOptionExists("--convert-scene"))
+	{
+		m_ConvertSceneFile = input.GetCmdOption("--convert-scene");
+		m_Headless = true;
+	}
+
 	Settings::Init();
 	SetDefaultSettings();
 
@@ -114,21 +168,72 @@ int Application::Init(int argc, char* argv[])
 	}
 	
 	Random::Init();
+	ThreadPool::Init((uint32_t)std::max(Settings::GetInt("Engine", "Worker_Threads"), 0));
 	LuaManager::Init();
 
-	if(RenderCommand::CreateRendererAPI() != 0)
+	if(RenderCommand::CreateRendererAPI(m_Headless, !m_CaptureFile.empty()) != 0)
 		return EXIT_FAILURE;
 
+	if (m_Headless)
+	{
+		// The renderer still records its batches so the scene runs the same code as with a window,
+		// nothing is drawn unless the software renderer is used
+		Renderer::Init();
+		Font::Init();
+		Input::Init(nullptr);
+		ENGINE_INFO("Running headless");
+	}
+
 	ENGINE_INFO("Engine Version: {0}.{1}.{2}", VERSION_MAJOR, VERSION_MINOR, VERSION_PATCH);
 
 	ENGINE_INFO("Engine Initialised");
 	PROFILE_END_SESSION("Startup");
 
+	if (!m_ConvertSceneFile.empty())
+		return ConvertScene(m_ConvertSceneFile) ? EXIT_SUCCESS : EXIT_FAILURE;
+
 	return -1;
 }
 
 /* ------------------------------------------------------------------------------------------------------------------ */
 
+bool Application::ConvertScene(std::filesystem::path filepath)
+{
+	PROFILE_FUNCTION();
+
+	// Asset paths in the scene are relative to the open project
+	if (filepath.is_relative() && !m_OpenDocumentDirectory.empty())
+		filepath = m_OpenDocumentDirectory / filepath;
+
+	if (!std::filesystem::exists(filepath))
+	{
+		std::cerr << "Scene not found " << filepath << std::endl;
+		return false;
+	}
+
+	if (BinarySceneSerializer::IsBinaryScene(filepath))
+	{
+		std::cerr << filepath << " is already a binary scene" << std::endl;
+		return false;
+	}
+
+	// The binary scene replaces the xml so it is loaded from the same path, the xml is kept next to it for editing
+	std::filesystem::path xmlFilepath = filepath;
+	xmlFilepath += ".xml";
+	std::filesystem::copy_file(filepath, xmlFilepath, std::filesystem::copy_options::overwrite_existing);
+
+	if (!BinarySceneSerializer::ConvertFromXml(xmlFilepath, filepath))
+	{
+		std::cerr << "Could not convert " << filepath << std::endl;
+		return false;
+	}
+
+	ENGINE_INFO("Converted {0} to a binary scene", filepath);
+	return true;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
 Window* Application::CreateDesktopWindowImpl(const WindowProps& props)
 {
 	const char* windowStr = props.title.c_str();
@@ -176,18 +281,34 @@ void Application::Run()
 	double currentTime = GetTime();
 	double accumulator = 0.0f;
 
+	uint64_t frame = 0;
+	std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
 	m_Running = true;
 
 	while (m_Running)
 	{
 		PROFILE_SCOPE("Run Loop");
 
-		double newTime = GetTime();
-		double frameTime = newTime - currentTime;
-		currentTime = newTime;
+		std::chrono::steady_clock::time_point frameStart = std::chrono::steady_clock::now();
+
+		double frameTime;
+		if (m_Headless)
+		{
+			// Step exactly one fixed update per frame so every run of a scene is the same
+			frameTime = m_FixedUpdateInterval;
+		}
+		else
+		{
+			double newTime = GetTime();
+			frameTime = (newTime - currentTime) * m_TimeScale;
+			currentTime = newTime;
+		}
 
 		accumulator += frameTime;
 
+		uint32_t fixedUpdates = 0;
+
 		// On Fixed update
 		while (accumulator >= m_FixedUpdateInterval)
 		{
@@ -203,10 +324,14 @@ void Application::Run()
 				SceneManager::FixedUpdate();
 			}
 			accumulator -= m_FixedUpdateInterval;
+			fixedUpdates++;
 		}
 
-		m_Window->GetContext()->MakeCurrent();
-		m_Window->OnUpdate();
+		if (m_Window)
+		{
+			m_Window->GetContext()->MakeCurrent();
+			m_Window->OnUpdate();
+		}
 
 		// On Update
 		{
@@ -224,7 +349,7 @@ void Application::Run()
 		}
 
 		// Render the imgui of each of the layers
-		if (m_ImGuiManager->IsUsing())
+		if (m_ImGuiManager && m_ImGuiManager->IsUsing())
 		{
 			m_ImGuiManager->Begin();
 			for (Ref<Layer> layer : m_LayerStack)
@@ -237,8 +362,31 @@ void Application::Run()
 		m_LayerStack.PushPop();
 
 		Input::ClearInputData();
+
+		std::chrono::steady_clock::time_point frameEnd = std::chrono::steady_clock::now();
+
+		Statistics::Set(Statistics::FrameTime, std::chrono::duration<double, std::milli>(frameEnd - frameStart).count());
+		Statistics::Set(Statistics::FixedUpdates, (double)fixedUpdates);
+		Statistics::EndFrame();
+
+		frame++;
+		if (m_FrameLimit != 0 && frame >= m_FrameLimit)
+			m_Running = false;
+
+		// Hold the headless simulation to the scaled wall clock, a scale of 0 runs as fast as possible
+		if (m_Headless && m_TimeScale > 0.0 && m_Running)
+		{
+			std::chrono::duration<double> simulated(frame * (double)m_FixedUpdateInterval / m_TimeScale);
+			std::this_thread::sleep_until(startTime + std::chrono::duration_cast<std::chrono::steady_clock::duration>(simulated));
+		}
 	}
 
+	if (!m_StatisticsFile.empty())
+		Statistics::WriteCSV(m_StatisticsFile);
+
+	if (!m_CaptureFile.empty() && !RenderCommand::SaveBackBuffer(m_CaptureFile))
+		ENGINE_ERROR("Could not capture the last frame to {0}", m_CaptureFile);
+
 	PROFILE_END_SESSION("Run");
 }
 
@@ -269,7 +417,8 @@ void Application::OnEvent(Event& e)
 		return false;
 		});
 
-	m_ImGuiManager->OnEvent(e);
+	if (m_ImGuiManager)
+		m_ImGuiManager->OnEvent(e);
 
 	for (auto it = m_LayerStack.rbegin(); it != m_LayerStack.rend(); ++it)
 	{
@@ -392,6 +541,9 @@ void Application::SetDefaultSettings()
 	Settings::SetDefaultDouble(audio, "Master", 100.0);
 
 	Settings::SetDefaultValue("Files", "Recent_Files", "");
+
+	// 0 uses all but one of the hardware threads
+	Settings::SetDefaultInt("Engine", "Worker_Threads", 0);
 }
 
 /* ------------------------------------------------------------------------------------------------------------------ */
@@ -435,12 +587,27 @@ const std::filesystem::path& Application::GetOpenDocument()
 
 /* ------------------------------------------------------------------------------------------------------------------ */
 
+// The tests and benchmarks run the engine without an application, they work from the directory they were started in
+static const std::filesystem::path& GetStartDirectory()
+{
+	static const std::filesystem::path s_StartDirectory = std::filesystem::current_path();
+	return s_StartDirectory;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
 const std::filesystem::path& Application::GetOpenDocumentDirectory()
 {
+	if (!s_Instance)
+		return GetStartDirectory();
 	return s_Instance->m_OpenDocumentDirectory;
 }
 
+/* ------------------------------------------------------------------------------------------------------------------ */
+
 const std::filesystem::path& Application::GetWorkingDirectory()
 {
+	if (!s_Instance)
+		return GetStartDirectory();
 	return s_Instance->m_WorkingDirectory;
 }
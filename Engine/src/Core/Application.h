@@ -28,10 +28,13 @@ public:
 	static Window* GetWindow() { return Get().GetWindowImpl(); }
 
 	// Set whether to show Dear ImGui
-	static void ShowImGui(bool showImgui) { Get().m_ImGuiManager->SetIsUsing(showImgui); }
+	static void ShowImGui(bool showImgui) { if (Get().m_ImGuiManager) Get().m_ImGuiManager->SetIsUsing(showImgui); }
 
 	// Toggle whether Dear ImGui to shown
-	static void ToggleImGui() { Get().m_ImGuiManager->SetIsUsing(!Get().m_ImGuiManager->IsUsing()); }
+	static void ToggleImGui() { if (Get().m_ImGuiManager) Get().m_ImGuiManager->SetIsUsing(!Get().m_ImGuiManager->IsUsing()); }
+
+	// Is the application running without a window, started with --headless
+	static bool IsHeadless() { return Get().m_Headless; }
 
 	static LayerStack& GetLayerStack() { return Get().m_LayerStack; }
 
@@ -50,10 +53,10 @@ public:
 	// Gets the document that the application has open
 	static const std::filesystem::path& GetOpenDocument();
 
-	// Get the Open Document Directory object
+	// Get the Open Document Directory object, the current directory if there is no application
 	static const std::filesystem::path& GetOpenDocumentDirectory();
 
-	// Get the directory that the application was launched from
+	// Get the directory that the application was launched from, the current directory if there is no application
 	static const std::filesystem::path& GetWorkingDirectory();
 
 	// Calls an event
@@ -72,6 +75,7 @@ private:
 
 	bool SetOpenDocumentImpl(const std::filesystem::path& filepath);
 	void SetDefaultSettings();
+	bool ConvertScene(std::filesystem::path filepath);
 
 	double GetTime() const;
 
@@ -84,12 +88,19 @@ private:
 	bool m_Minimized = false;
 	float m_FixedUpdateInterval = 0.01f;
 
+	bool m_Headless = false;
+	uint64_t m_FrameLimit = 0; // 0 runs until closed
+	double m_TimeScale = 1.0; // simulated seconds per real second, 0 runs as fast as possible when headless
+
 	static Application* s_Instance;
 	friend int ::main(int argc, char* argv[]);
 
 	std::filesystem::path m_OpenDocument;
 	std::filesystem::path m_OpenDocumentDirectory;
 	std::filesystem::path m_WorkingDirectory;
+	std::filesystem::path m_StatisticsFile;
+	std::filesystem::path m_CaptureFile; // the last headless frame is written here with the software renderer
+	std::filesystem::path m_ConvertSceneFile; // converted to the binary scene format before exiting
 
 	static EventCallbackFn s_EventCallback;
 };
@@ -3,6 +3,7 @@
 #include "Core/core.h"
 #include "Core/UUID.h"
 #include "Core/Factory.h"
+#include "Core/Statistics.h"
 #include "Utilities/FileWatcher.h"
 
 #include <filesystem>
@@ -70,6 +71,7 @@ public:
 
 		Ref<T> asset = CreateRef<T>(filepath);
 		Add(asset);
+		Statistics::Add(Statistics::AssetLoads, 1.0);
 		return std::dynamic_pointer_cast<T>(asset);
 	}
 	template<typename T>
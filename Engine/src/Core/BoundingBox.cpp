@@ -60,9 +60,35 @@ void BoundingBox::Merge(const Vector3f& point)
 		m_Max.z = point.z;
 }
 
+BoundingBox BoundingBox::Transform(const Matrix4x4& transform) const
+{
+	if (!IsValid())
+		return *this;
+
+	// Transform the extents along each axis rather than all eight corners (Arvo, Graphics Gems 1990)
+	const float min[3] = { m_Min.x, m_Min.y, m_Min.z };
+	const float max[3] = { m_Max.x, m_Max.y, m_Max.z };
+
+	float newMin[3] = { transform(0, 3), transform(1, 3), transform(2, 3) };
+	float newMax[3] = { transform(0, 3), transform(1, 3), transform(2, 3) };
+
+	for (int i = 0; i < 3; i++)
+	{
+		for (int j = 0; j < 3; j++)
+		{
+			float a = transform(i, j) * min[j];
+			float b = transform(i, j) * max[j];
+			newMin[i] += std::min(a, b);
+			newMax[i] += std::max(a, b);
+		}
+	}
+
+	return BoundingBox(Vector3f(newMin[0], newMin[1], newMin[2]), Vector3f(newMax[0], newMax[1], newMax[2]));
+}
+
 Vector3f BoundingBox::Center() const
 {
-	return (m_Min - m_Max) * 0.5f;
+	return (m_Min + m_Max) * 0.5f;
 }
 
 void BoundingBox::Invalidate()
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "math/Vector3f.h"
+#include "math/Matrix.h"
 
 class BoundingBox
 {
@@ -14,6 +15,9 @@ public:
 	void Merge(const BoundingBox& other);
 	void Merge(const Vector3f& point);
 
+	// Axis aligned box enclosing this box after it has been transformed
+	BoundingBox Transform(const Matrix4x4& transform) const;
+
 	Vector3f Center() const;
 	Vector3f Min() const { return m_Min; };
 	Vector3f Max() const { return m_Max; };
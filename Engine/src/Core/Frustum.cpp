@@ -0,0 +1,72 @@
+#include "stdafx.h"
+#include "Frustum.h"
+
+Frustum::Frustum(const Matrix4x4& viewProjection)
+{
+	const Matrix4x4& m = viewProjection;
+
+	// Extract the clip planes from the rows of the view projection matrix (Gribb & Hartmann)
+	// The near plane uses the -1 to 1 depth range which is conservative for a 0 to 1 depth range
+	SetPlane(Side::Left, m(3, 0) + m(0, 0), m(3, 1) + m(0, 1), m(3, 2) + m(0, 2), m(3, 3) + m(0, 3));
+	SetPlane(Side::Right, m(3, 0) - m(0, 0), m(3, 1) - m(0, 1), m(3, 2) - m(0, 2), m(3, 3) - m(0, 3));
+	SetPlane(Side::Bottom, m(3, 0) + m(1, 0), m(3, 1) + m(1, 1), m(3, 2) + m(1, 2), m(3, 3) + m(1, 3));
+	SetPlane(Side::Top, m(3, 0) - m(1, 0), m(3, 1) - m(1, 1), m(3, 2) - m(1, 2), m(3, 3) - m(1, 3));
+	SetPlane(Side::Near, m(3, 0) + m(2, 0), m(3, 1) + m(2, 1), m(3, 2) + m(2, 2), m(3, 3) + m(2, 3));
+	SetPlane(Side::Far, m(3, 0) - m(2, 0), m(3, 1) - m(2, 1), m(3, 2) - m(2, 2), m(3, 3) - m(2, 3));
+
+	m_Valid = true;
+
+	Matrix4x4 inverse = Matrix4x4::Inverse(viewProjection);
+	for (int i = 0; i < 8; i++)
+	{
+		Vector4f corner = inverse * Vector4f((i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f, (i & 4) ? 1.0f : -1.0f, 1.0f);
+		if (corner.w <= FLT_EPSILON)
+		{
+			// Degenerate projection, don't restrict the bounds
+			m_Bounds = BoundingBox(Vector3f(-FLT_MAX, -FLT_MAX, -FLT_MAX), Vector3f(FLT_MAX, FLT_MAX, FLT_MAX));
+			return;
+		}
+		m_Bounds.Merge(Vector3f(corner.x / corner.w, corner.y / corner.w, corner.z / corner.w));
+	}
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+bool Frustum::Intersects(const BoundingBox& box) const
+{
+	if (!m_Valid || !box.IsValid())
+		return true;
+
+	const Vector3f min = box.Min();
+	const Vector3f max = box.Max();
+
+	for (const ClipPlane& plane : m_Planes)
+	{
+		// Test the corner furthest along the plane normal
+		Vector3f corner(
+			plane.normal.x >= 0.0f ? max.x : min.x,
+			plane.normal.y >= 0.0f ? max.y : min.y,
+			plane.normal.z >= 0.0f ? max.z : min.z);
+
+		if (Vector3f::Dot(plane.normal, corner) + plane.distance < 0.0f)
+			return false;
+	}
+	return true;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void Frustum::SetPlane(Side side, float a, float b, float c, float d)
+{
+	float length = sqrtf(a * a + b * b + c * c);
+	if (length <= FLT_EPSILON)
+	{
+		// A plane with no normal can't reject anything
+		m_Planes[(size_t)side] = ClipPlane();
+		return;
+	}
+
+	ClipPlane& plane = m_Planes[(size_t)side];
+	plane.normal = Vector3f(a / length, b / length, c / length);
+	plane.distance = d / length;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "math/Vector3f.h"
+#include "math/Matrix.h"
+#include "BoundingBox.h"
+
+#include <array>
+
+class Frustum
+{
+public:
+	enum class Side
+	{
+		Left, Right, Bottom, Top, Near, Far
+	};
+
+	// Points inside the frustum are on the positive side of every plane
+	struct ClipPlane
+	{
+		Vector3f normal;
+		float distance = 0.0f;
+	};
+
+	Frustum() = default;
+	explicit Frustum(const Matrix4x4& viewProjection);
+
+	// Conservative test, a box that straddles a corner of the frustum may be reported as intersecting
+	bool Intersects(const BoundingBox& box) const;
+
+	// World space box enclosing the eight corners of the frustum
+	const BoundingBox& GetBounds() const { return m_Bounds; }
+
+	// World space plane with a unit normal pointing into the frustum
+	const ClipPlane& GetPlane(Side side) const { return m_Planes[(size_t)side]; }
+
+private:
+	void SetPlane(Side side, float a, float b, float c, float d);
+
+	std::array<ClipPlane, 6> m_Planes;
+	BoundingBox m_Bounds;
+	bool m_Valid = false;
+};
@@ -26,6 +26,10 @@ void Input::SetMouseWheel(double X, double Y)
 
 bool Input::IsKeyPressedImpl(int keycode)
 {
+	// There is no window to read input from when running headless
+	if (!m_Window)
+		return false;
+
 	try
 	{
 		int state = glfwGetKey(m_Window, keycode);
@@ -40,6 +44,9 @@ bool Input::IsKeyPressedImpl(int keycode)
 
 bool Input::IsMouseButtonPressedImpl(int button)
 {
+	if (!m_Window)
+		return false;
+
 	try
 	{
 		int state = glfwGetMouseButton(m_Window, button);
@@ -54,6 +61,9 @@ bool Input::IsMouseButtonPressedImpl(int button)
 
 std::pair<double, double> Input::GetMousePosImpl()
 {
+	if (!m_Window)
+		return { 0.0, 0.0 };
+
 	try
 	{
 		double x, y;
@@ -81,6 +91,9 @@ double Input::GetMouseXImpl()
 
 bool Input::IsJoystickButtonPressedImpl(int joystickSlot, int button)
 {
+	if (!m_Window)
+		return false;
+
 	Joysticks::Joystick joystick = Joysticks::GetJoystick(joystickSlot);
 	if (joystick.isMapped)
 	{
@@ -104,6 +117,9 @@ bool Input::IsJoystickButtonPressedImpl(int joystickSlot, int button)
 
 double Input::GetJoystickAxisImpl(int joystickSlot, int axis)
 {
+	if (!m_Window)
+		return 0.0;
+
 	GLFWgamepadstate state;
 
 	if (glfwGetGamepadState(Joysticks::GetJoystick(joystickSlot).id, &state) && axis <= GLFW_GAMEPAD_AXIS_LAST)
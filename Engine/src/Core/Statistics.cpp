@@ -0,0 +1,261 @@
+#include "stdafx.h"
+#include "Statistics.h"
+
+#include <fstream>
+#include <mutex>
+
+#include "Logging/Logger.h"
+
+struct Statistic
+{
+	std::string name;
+
+	double current = 0.0; // value of the frame in progress
+	double last = 0.0;
+
+	double sum = 0.0;
+	double min = DBL_MAX;
+	double max = -DBL_MAX;
+	uint64_t frames = 0;
+
+	// Ring of the most recent frame values
+	std::vector<float> window;
+	uint32_t windowNext = 0;
+};
+
+struct StatisticsData
+{
+	std::mutex mutex;
+	std::vector<Statistic> statistics;
+	std::unordered_map<std::string, Statistics::StatId> ids;
+	uint32_t windowSize = 300;
+
+	StatisticsData()
+	{
+		const char* builtinNames[Statistics::BuiltinCount] = {
+			"Frame Time (ms)",
+			"Fixed Updates",
+			"Physics Time (ms)",
+			"Lua Time (ms)",
+			"Draw Calls",
+			"Quads",
+			"Batch Breaks",
+			"Culled Objects",
+			"Asset Loads"
+		};
+
+		for (const char* name : builtinNames)
+		{
+			ids[name] = (Statistics::StatId)statistics.size();
+			statistics.emplace_back().name = name;
+		}
+	}
+};
+
+static StatisticsData s_Data;
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Nearest rank percentile of the values in the window, sorted must be a copy of the window
+static double Percentile(std::vector<float>& sorted, double percentile)
+{
+	if (sorted.empty())
+		return 0.0;
+
+	size_t rank = (size_t)std::ceil(percentile / 100.0 * (double)sorted.size());
+	size_t index = std::clamp<size_t>(rank, 1, sorted.size()) - 1;
+	std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+	return (double)sorted[index];
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+Statistics::StatId Statistics::Register(const std::string& name)
+{
+	std::scoped_lock lock(s_Data.mutex);
+
+	auto [it, inserted] = s_Data.ids.try_emplace(name, (StatId)s_Data.statistics.size());
+	if (inserted)
+		s_Data.statistics.emplace_back().name = name;
+	return it->second;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+Statistics::StatId Statistics::Find(const std::string& name)
+{
+	std::scoped_lock lock(s_Data.mutex);
+
+	auto it = s_Data.ids.find(name);
+	return it != s_Data.ids.end() ? it->second : s_InvalidStat;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+std::string Statistics::GetName(StatId id)
+{
+	std::scoped_lock lock(s_Data.mutex);
+	return s_Data.statistics[id].name;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+uint32_t Statistics::GetCount()
+{
+	std::scoped_lock lock(s_Data.mutex);
+	return (uint32_t)s_Data.statistics.size();
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void Statistics::Add(StatId id, double value)
+{
+	std::scoped_lock lock(s_Data.mutex);
+	s_Data.statistics[id].current += value;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void Statistics::Set(StatId id, double value)
+{
+	std::scoped_lock lock(s_Data.mutex);
+	s_Data.statistics[id].current = value;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void Statistics::EndFrame()
+{
+	std::scoped_lock lock(s_Data.mutex);
+
+	for (Statistic& statistic : s_Data.statistics)
+	{
+		double value = statistic.current;
+		statistic.current = 0.0;
+		statistic.last = value;
+
+		statistic.sum += value;
+		statistic.min = std::min(statistic.min, value);
+		statistic.max = std::max(statistic.max, value);
+		statistic.frames++;
+
+		if (statistic.window.size() < s_Data.windowSize)
+		{
+			statistic.window.push_back((float)value);
+		}
+		else
+		{
+			statistic.window[statistic.windowNext] = (float)value;
+			statistic.windowNext = (statistic.windowNext + 1) % s_Data.windowSize;
+		}
+	}
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+Statistics::Summary Statistics::GetSummary(StatId id)
+{
+	std::scoped_lock lock(s_Data.mutex);
+
+	const Statistic& statistic = s_Data.statistics[id];
+
+	Summary summary;
+	summary.last = statistic.last;
+	summary.frames = statistic.frames;
+	if (statistic.frames > 0)
+	{
+		summary.mean = statistic.sum / (double)statistic.frames;
+		summary.min = statistic.min;
+		summary.max = statistic.max;
+	}
+
+	std::vector<float> sorted = statistic.window;
+	summary.p50 = Percentile(sorted, 50.0);
+	summary.p95 = Percentile(sorted, 95.0);
+	summary.p99 = Percentile(sorted, 99.0);
+	return summary;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+double Statistics::GetPercentile(StatId id, double percentile)
+{
+	std::scoped_lock lock(s_Data.mutex);
+
+	std::vector<float> sorted = s_Data.statistics[id].window;
+	return Percentile(sorted, percentile);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+std::vector<float> Statistics::GetHistory(StatId id)
+{
+	std::scoped_lock lock(s_Data.mutex);
+
+	const Statistic& statistic = s_Data.statistics[id];
+
+	std::vector<float> history;
+	history.reserve(statistic.window.size());
+	history.insert(history.end(), statistic.window.begin() + statistic.windowNext, statistic.window.end());
+	history.insert(history.end(), statistic.window.begin(), statistic.window.begin() + statistic.windowNext);
+	return history;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void Statistics::SetWindowSize(uint32_t frames)
+{
+	std::scoped_lock lock(s_Data.mutex);
+
+	s_Data.windowSize = std::max(frames, 1u);
+	for (Statistic& statistic : s_Data.statistics)
+	{
+		statistic.window.clear();
+		statistic.windowNext = 0;
+	}
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+uint32_t Statistics::GetWindowSize()
+{
+	std::scoped_lock lock(s_Data.mutex);
+	return s_Data.windowSize;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void Statistics::Reset()
+{
+	std::scoped_lock lock(s_Data.mutex);
+
+	for (Statistic& statistic : s_Data.statistics)
+	{
+		std::string name = std::move(statistic.name);
+		statistic = Statistic();
+		statistic.name = std::move(name);
+	}
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+bool Statistics::WriteCSV(const std::filesystem::path& filepath)
+{
+	std::ofstream file(filepath);
+	if (!file.is_open())
+	{
+		ENGINE_ERROR("Could not write statistics to {0}", filepath.string());
+		return false;
+	}
+
+	file << "Name,Frames,Mean,Min,Max,P50,P95,P99\n";
+
+	uint32_t count = GetCount();
+	for (StatId id = 0; id < count; id++)
+	{
+		Summary summary = GetSummary(id);
+		file << '"' << GetName(id) << "\"," << summary.frames << ',' << summary.mean << ',' << summary.min << ',' << summary.max << ','
+			<< summary.p50 << ',' << summary.p95 << ',' << summary.p99 << '\n';
+	}
+	return true;
+}
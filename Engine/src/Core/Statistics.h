@@ -0,0 +1,96 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+
+// Per frame values pushed by the engine's subsystems.
+// Each value is accumulated over a frame and then stored in a rolling window used for the percentiles
+class Statistics
+{
+public:
+	using StatId = uint32_t;
+
+	// Statistics recorded by the engine, more can be added with Register
+	enum Builtin : StatId
+	{
+		FrameTime, // milliseconds
+		FixedUpdates,
+		PhysicsTime, // milliseconds
+		LuaTime, // milliseconds
+		DrawCalls,
+		Quads,
+		BatchBreaks,
+		CulledObjects,
+		AssetLoads,
+		BuiltinCount
+	};
+
+	struct Summary
+	{
+		double last = 0.0;
+
+		// Over every frame since the statistic was registered or reset
+		double mean = 0.0;
+		double min = 0.0;
+		double max = 0.0;
+		uint64_t frames = 0;
+
+		// Over the rolling window
+		double p50 = 0.0;
+		double p95 = 0.0;
+		double p99 = 0.0;
+	};
+
+	// Returns the id of the statistic with the name, adding it if it doesn't exist
+	static StatId Register(const std::string& name);
+	static StatId Find(const std::string& name); // s_InvalidStat if not registered
+	static std::string GetName(StatId id);
+	static uint32_t GetCount();
+
+	// Add to this frame's value
+	static void Add(StatId id, double value);
+	// Replace this frame's value
+	static void Set(StatId id, double value);
+
+	// Store this frame's values and start the next frame at zero
+	static void EndFrame();
+
+	static Summary GetSummary(StatId id);
+	static double GetPercentile(StatId id, double percentile);
+
+	// Values of the last frames in the window, oldest first
+	static std::vector<float> GetHistory(StatId id);
+
+	static void SetWindowSize(uint32_t frames);
+	static uint32_t GetWindowSize();
+
+	// Clear every recorded value, the registered statistics are kept
+	static void Reset();
+
+	// Write the summary of every statistic as comma separated values
+	static bool WriteCSV(const std::filesystem::path& filepath);
+
+	static constexpr StatId s_InvalidStat = UINT32_MAX;
+};
+
+// Adds the time in milliseconds between construction and destruction to a statistic
+class StatisticsTimer
+{
+public:
+	explicit StatisticsTimer(Statistics::StatId id)
+		:m_Id(id), m_Start(std::chrono::steady_clock::now())
+	{
+	}
+
+	~StatisticsTimer()
+	{
+		Statistics::Add(m_Id, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_Start).count());
+	}
+
+private:
+	Statistics::StatId m_Id;
+	std::chrono::steady_clock::time_point m_Start;
+};
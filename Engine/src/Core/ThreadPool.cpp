@@ -0,0 +1,158 @@
+#include "stdafx.h"
+#include "ThreadPool.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <atomic>
+
+struct ThreadPoolData
+{
+	std::vector<std::thread> workers;
+	std::deque<std::function<void()>> jobs;
+	std::mutex mutex;
+	std::condition_variable condition;
+	bool running = false;
+};
+
+static ThreadPoolData s_Data;
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void ThreadPool::Init(uint32_t threadCount)
+{
+	PROFILE_FUNCTION();
+
+	if (s_Data.running)
+		Shutdown();
+
+	if (threadCount == 0)
+	{
+		uint32_t hardwareThreads = std::thread::hardware_concurrency();
+		threadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+	}
+
+	s_Data.running = true;
+	for (uint32_t i = 0; i < threadCount; i++)
+		s_Data.workers.emplace_back(&ThreadPool::WorkerLoop);
+
+	ENGINE_INFO("Thread pool started with {0} worker threads", threadCount);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void ThreadPool::Shutdown()
+{
+	{
+		std::lock_guard lock(s_Data.mutex);
+		s_Data.running = false;
+	}
+	s_Data.condition.notify_all();
+
+	for (std::thread& worker : s_Data.workers)
+	{
+		if (worker.joinable())
+			worker.join();
+	}
+	s_Data.workers.clear();
+	s_Data.jobs.clear();
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+uint32_t ThreadPool::GetThreadCount()
+{
+	return (uint32_t)s_Data.workers.size() + 1;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void ThreadPool::Enqueue(std::function<void()> job)
+{
+	if (s_Data.workers.empty())
+	{
+		job();
+		return;
+	}
+
+	{
+		std::lock_guard lock(s_Data.mutex);
+		s_Data.jobs.emplace_back(std::move(job));
+	}
+	s_Data.condition.notify_one();
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void ThreadPool::ParallelFor(size_t count, size_t minChunkSize, const std::function<void(size_t begin, size_t end)>& func)
+{
+	if (count == 0)
+		return;
+
+	minChunkSize = std::max<size_t>(minChunkSize, 1);
+	size_t threadCount = GetThreadCount();
+
+	if (threadCount == 1 || count <= minChunkSize)
+	{
+		func(0, count);
+		return;
+	}
+
+	// a few chunks per thread so that uneven work is balanced out
+	size_t chunkSize = std::max(minChunkSize, (count + threadCount * 4 - 1) / (threadCount * 4));
+	size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+
+	struct ParallelForState
+	{
+		std::atomic<size_t> nextChunk = 0;
+		std::atomic<size_t> completedChunks = 0;
+	};
+
+	Ref<ParallelForState> state = CreateRef<ParallelForState>();
+
+	auto processChunks = [state, &func, count, chunkSize, chunkCount]()
+	{
+		size_t chunk;
+		while ((chunk = state->nextChunk.fetch_add(1)) < chunkCount)
+		{
+			size_t begin = chunk * chunkSize;
+			func(begin, std::min(begin + chunkSize, count));
+			state->completedChunks.fetch_add(1, std::memory_order_release);
+		}
+	};
+
+	size_t helpers = std::min(threadCount - 1, chunkCount - 1);
+	{
+		std::lock_guard lock(s_Data.mutex);
+		for (size_t i = 0; i < helpers; i++)
+			s_Data.jobs.emplace_back(processChunks);
+	}
+	s_Data.condition.notify_all();
+
+	processChunks();
+
+	while (state->completedChunks.load(std::memory_order_acquire) < chunkCount)
+		std::this_thread::yield();
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void ThreadPool::WorkerLoop()
+{
+	while (true)
+	{
+		std::function<void()> job;
+		{
+			std::unique_lock lock(s_Data.mutex);
+			s_Data.condition.wait(lock, [] { return !s_Data.running || !s_Data.jobs.empty(); });
+
+			if (!s_Data.running)
+				return;
+
+			job = std::move(s_Data.jobs.front());
+			s_Data.jobs.pop_front();
+		}
+		job();
+	}
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <functional>
+#include <cstdint>
+
+class ThreadPool
+{
+public:
+	// Start the worker threads, a thread count of 0 uses one less than the number of hardware threads
+	static void Init(uint32_t threadCount = 0);
+	static void Shutdown();
+
+	// Number of threads that work is split across, including the calling thread
+	static uint32_t GetThreadCount();
+
+	// Queue a job to be run on one of the worker threads, runs immediately if there are no workers
+	static void Enqueue(std::function<void()> job);
+
+	// Split the range [0, count) into chunks and process them across the worker threads and the calling thread.
+	// Returns once every chunk has been processed
+	static void ParallelFor(size_t count, size_t minChunkSize, const std::function<void(size_t begin, size_t end)>& func);
+
+private:
+	static void WorkerLoop();
+};
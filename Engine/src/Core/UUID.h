@@ -28,6 +28,9 @@ public:
 		return std::to_string(m_Lo) + "-" + std::to_string(m_Hi);
 	}
 
+	uint64_t GetLo() const { return m_Lo; }
+	uint64_t GetHi() const { return m_Hi; }
+
 	operator std::string() const { return to_string(); }
 	bool operator==(const Uuid& rhs) const { return (m_Lo == rhs.m_Lo) && (m_Hi == rhs.m_Hi); }
 	bool operator!=(const Uuid& rhs) const { return (m_Lo != rhs.m_Lo) || (m_Hi != rhs.m_Hi); }
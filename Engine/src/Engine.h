@@ -14,6 +14,8 @@
 #include "Core/Asset.h"
 #include "Core/Version.h"
 #include "Core/BoundingBox.h"
+#include "Core/Frustum.h"
+#include "Core/ThreadPool.h"
 
 // Logging
 #include "Logging/Logger.h"
@@ -34,6 +36,7 @@
 #include "Renderer/GraphicsContext.h"
 #include "Renderer/RendererAPI.h"
 #include "Renderer/Texture.h"
+#include "Renderer/TextureAtlas.h"
 #include "Renderer/SubTexture2D.h"
 #include "Renderer/Mesh.h"
 #include "Renderer/FrameBuffer.h"
@@ -0,0 +1,306 @@
+#include "stdafx.h"
+#include "Instrumentor.h"
+
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+// Binary format, little endian:
+//   header     char[8] "PROFILE1"
+//   events     { uint32 nameId, uint32 threadId, int64 startNs, int64 endNs } until the name table
+//   name table { uint32 length, char[length] name } for every interned name in id order
+//   footer     uint64 name count, uint64 event count, uint64 offset of the name table
+
+struct ProfileEvent
+{
+	uint32_t nameId;
+	uint32_t threadId;
+	int64_t start;
+	int64_t end;
+};
+
+// Single producer, single consumer ring, written by the owning thread and drained by the writer thread
+struct ProfileBuffer
+{
+	static constexpr uint64_t s_Capacity = 1 << 15;
+	static constexpr uint64_t s_Mask = s_Capacity - 1;
+
+	alignas(64) std::atomic<uint64_t> head = 0;
+	alignas(64) std::atomic<uint64_t> tail = 0;
+	std::atomic<uint64_t> dropped = 0;
+	uint32_t threadId = 0;
+
+	ProfileEvent events[s_Capacity];
+};
+
+struct InstrumentorData
+{
+	std::mutex mutex; // guards the members up to the writer's, except the buffer contents
+
+	std::vector<Scope<ProfileBuffer>> buffers;
+
+	std::unordered_map<const char*, uint32_t> nameIds;
+	std::vector<const char*> names;
+
+	std::string sessionName;
+	ProfileFormat format = ProfileFormat::ChromeTrace;
+
+	std::thread writer;
+	std::condition_variable wake;
+	bool stopWriter = false;
+
+	// Only touched by the writer thread, or by EndSession once the writer has stopped, so the file is written unlocked
+	std::ofstream outputStream;
+	std::vector<ProfileEvent> pending; // events taken out of the ring buffers by the last drain
+	std::vector<std::string> jsonNames; // escaped copies of the names, filled in as the writer first sees them
+	uint64_t eventCount = 0;
+};
+
+static InstrumentorData s_Data;
+
+// Buffers are owned by s_Data so events from a thread that has exited can still be drained
+static thread_local ProfileBuffer* s_ThreadBuffer = nullptr;
+
+static constexpr std::chrono::milliseconds s_DrainInterval(10);
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static ProfileBuffer* GetThreadBuffer()
+{
+	if (!s_ThreadBuffer)
+	{
+		Scope<ProfileBuffer> buffer = CreateScope<ProfileBuffer>();
+
+		std::scoped_lock lock(s_Data.mutex);
+		buffer->threadId = (uint32_t)s_Data.buffers.size();
+		s_ThreadBuffer = buffer.get();
+		s_Data.buffers.push_back(std::move(buffer));
+	}
+	return s_ThreadBuffer;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static void WriteEvent(const ProfileEvent& event)
+{
+	if (s_Data.format == ProfileFormat::Binary)
+	{
+		s_Data.outputStream.write((const char*)&event, sizeof(ProfileEvent));
+	}
+	else
+	{
+		s_Data.outputStream << ",\n{";
+		s_Data.outputStream << "\"cat\":\"function\",";
+		s_Data.outputStream << "\"dur\":" << (double)(event.end - event.start) / 1000.0 << ',';
+		s_Data.outputStream << "\"name\":\"" << s_Data.jsonNames[event.nameId] << "\",";
+		s_Data.outputStream << "\"ph\":\"X\",";
+		s_Data.outputStream << "\"pid\":0,";
+		s_Data.outputStream << "\"tid\":" << event.threadId << ",";
+		s_Data.outputStream << "\"ts\":" << (double)event.start / 1000.0;
+		s_Data.outputStream << "}";
+	}
+	s_Data.eventCount++;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Write every event recorded so far. The events are copied out of the ring buffers with the mutex held and
+// written after releasing it, so threads registering a buffer or interning a name never wait on the file
+static void DrainBuffers(std::unique_lock<std::mutex>& lock)
+{
+	s_Data.pending.clear();
+	for (Scope<ProfileBuffer>& buffer : s_Data.buffers)
+	{
+		uint64_t tail = buffer->tail.load(std::memory_order_relaxed);
+		uint64_t head = buffer->head.load(std::memory_order_acquire);
+
+		for (; tail != head; tail++)
+		{
+			s_Data.pending.push_back(buffer->events[tail & ProfileBuffer::s_Mask]);
+		}
+
+		buffer->tail.store(tail, std::memory_order_release);
+	}
+
+	if (s_Data.format == ProfileFormat::ChromeTrace)
+	{
+		while (s_Data.jsonNames.size() < s_Data.names.size())
+		{
+			std::string name = s_Data.names[s_Data.jsonNames.size()];
+			std::replace(name.begin(), name.end(), '"', '\'');
+			std::replace(name.begin(), name.end(), '\\', '/');
+			s_Data.jsonNames.push_back(std::move(name));
+		}
+	}
+
+	lock.unlock();
+	for (const ProfileEvent& event : s_Data.pending)
+	{
+		WriteEvent(event);
+	}
+	lock.lock();
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void Instrumentor::BeginSession(const std::string& name, const std::string& filepath, ProfileFormat format)
+{
+	if (!s_Enabled)
+		return;
+
+	if (!s_Data.sessionName.empty())
+	{
+		ENGINE_WARN("Beginning new session before last has ended. Force ending last session...");
+		EndSession(s_Data.sessionName);
+	}
+
+	std::unique_lock lock(s_Data.mutex);
+
+	// Absolute paths don't need an application, which lets tools and benchmarks open sessions
+	std::filesystem::path path = filepath;
+	if (path.is_relative())
+		path = Application::GetWorkingDirectory() / path;
+
+	s_Data.outputStream.open(path, std::ios::binary);
+	if (!s_Data.outputStream.is_open())
+	{
+		ENGINE_ERROR("Instrumentor could not open Results file: {0}", filepath);
+		return;
+	}
+
+	// Discard anything recorded between sessions
+	for (Scope<ProfileBuffer>& buffer : s_Data.buffers)
+	{
+		buffer->tail.store(buffer->head.load(std::memory_order_acquire), std::memory_order_release);
+		buffer->dropped = 0;
+	}
+
+	s_Data.sessionName = name;
+	s_Data.format = format;
+	s_Data.eventCount = 0;
+	s_Data.jsonNames.clear();
+
+	if (format == ProfileFormat::Binary)
+		s_Data.outputStream.write("PROFILE1", 8);
+	else
+		s_Data.outputStream << std::setprecision(3) << std::fixed << "{\"otherData\": {},\"traceEvents\":[{}";
+
+	s_Data.stopWriter = false;
+	s_Data.writer = std::thread(&Instrumentor::WriterLoop);
+
+	s_Recording = true;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void Instrumentor::EndSession(const std::string& name)
+{
+	if (s_Data.sessionName.empty())
+		return;
+
+	if (s_Data.sessionName != name)
+	{
+		ENGINE_WARN("Attempting to end session \"{0}\" but does not match current session \"{1}\"", name, s_Data.sessionName);
+	}
+
+	s_Recording = false;
+
+	{
+		std::scoped_lock lock(s_Data.mutex);
+		s_Data.stopWriter = true;
+	}
+	s_Data.wake.notify_one();
+	s_Data.writer.join();
+
+	std::unique_lock lock(s_Data.mutex);
+	DrainBuffers(lock);
+
+	std::vector<const char*> names = s_Data.names;
+	lock.unlock();
+
+	if (s_Data.format == ProfileFormat::Binary)
+	{
+		uint64_t nameTableOffset = (uint64_t)s_Data.outputStream.tellp();
+		for (const char* internedName : names)
+		{
+			uint32_t length = (uint32_t)strlen(internedName);
+			s_Data.outputStream.write((const char*)&length, sizeof(uint32_t));
+			s_Data.outputStream.write(internedName, length);
+		}
+
+		uint64_t nameCount = names.size();
+		s_Data.outputStream.write((const char*)&nameCount, sizeof(uint64_t));
+		s_Data.outputStream.write((const char*)&s_Data.eventCount, sizeof(uint64_t));
+		s_Data.outputStream.write((const char*)&nameTableOffset, sizeof(uint64_t));
+	}
+	else
+	{
+		s_Data.outputStream << "]}";
+	}
+	s_Data.outputStream.close();
+
+	lock.lock();
+
+	uint64_t dropped = 0;
+	for (Scope<ProfileBuffer>& buffer : s_Data.buffers)
+		dropped += buffer->dropped;
+	if (dropped > 0)
+		ENGINE_WARN("Profiling session \"{0}\" dropped {1} events, the ring buffers were full", s_Data.sessionName, dropped);
+
+	s_Data.sessionName.clear();
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+uint32_t Instrumentor::InternName(const char* name)
+{
+	std::scoped_lock lock(s_Data.mutex);
+
+	auto [it, inserted] = s_Data.nameIds.try_emplace(name, (uint32_t)s_Data.names.size());
+	if (inserted)
+		s_Data.names.push_back(name);
+	return it->second;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void Instrumentor::WriteProfile(uint32_t nameId, int64_t startTicks, int64_t endTicks)
+{
+	ProfileBuffer* buffer = GetThreadBuffer();
+
+	uint64_t head = buffer->head.load(std::memory_order_relaxed);
+	if (head - buffer->tail.load(std::memory_order_acquire) >= ProfileBuffer::s_Capacity)
+	{
+		buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	buffer->events[head & ProfileBuffer::s_Mask] = { nameId, buffer->threadId, startTicks, endTicks };
+	buffer->head.store(head + 1, std::memory_order_release);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+uint64_t Instrumentor::GetDroppedEvents()
+{
+	std::scoped_lock lock(s_Data.mutex);
+
+	uint64_t dropped = 0;
+	for (Scope<ProfileBuffer>& buffer : s_Data.buffers)
+		dropped += buffer->dropped;
+	return dropped;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void Instrumentor::WriterLoop()
+{
+	std::unique_lock lock(s_Data.mutex);
+	while (!s_Data.stopWriter)
+	{
+		DrainBuffers(lock);
+		s_Data.wake.wait_for(lock, s_DrainInterval, [] { return s_Data.stopWriter; });
+	}
+}
@@ -2,209 +2,78 @@
 
 #include <string>
 #include <chrono>
-#include <algorithm>
-#include <fstream>
-#include <iomanip>
-#include <mutex>
-#include <thread>
+#include <atomic>
+#include <cstdint>
 
 #include "Logger.h"
 #include "Core/Application.h"
 
-using FloatingPointMicroSeconds = std::chrono::duration<double, std::micro>;
-
-struct ProfileResult
-{
-	std::string name;
-	FloatingPointMicroSeconds start;
-	std::chrono::microseconds elapsedTime;
-	std::thread::id threadID;
-};
-
-struct InstrumentationSession
+enum class ProfileFormat
 {
-	std::string name;
+	ChromeTrace, // JSON that can be opened in chrome://tracing or Perfetto
+	Binary // Compact records followed by the name table, see Instrumentor.cpp for the layout
 };
 
+// Profile scopes are recorded as fixed size events into a lock-free ring buffer owned by the recording thread.
+// While a session is open a background thread drains the buffers into the session file,
+// so recording a scope never takes a lock or touches the file system
 class Instrumentor
 {
-private:
-	std::mutex m_Mutex;
-	InstrumentationSession* m_CurrentSession;
-	std::ofstream m_OutputStream;
-
-	bool m_IsEnabled = false;
 public:
-	Instrumentor()
-		: m_CurrentSession(nullptr)
-	{
-	}
+	static void BeginSession(const std::string& name, const std::string& filepath = "results.json", ProfileFormat format = ProfileFormat::ChromeTrace);
+	static void EndSession(const std::string& name);
 
-	void BeginSession(const std::string& name, const std::string& filepath = "results.json")
-	{
-		if (!m_IsEnabled)
-			return;
-
-		std::lock_guard lock(m_Mutex);
-		if (m_CurrentSession)
-		{
-			ENGINE_WARN("Beginning new session before last has ended. Force ending last session...");
-			// If there is already a current session, then close it before beginning a new one.
-			// Subsequent profiling output meant for the original session will end up in the new one instead.
-			InternalEndSession(m_CurrentSession->name);
-		}
-
-		m_OutputStream.open(Application::GetWorkingDirectory() / filepath);
-
-		if (m_OutputStream.is_open())
-		{
-			m_CurrentSession = new InstrumentationSession({ name });
-			WriteHeader();
-		}
-		else
-		{
-			ENGINE_ERROR("Instrumentor could not open Results file: {0}", filepath);
-		}
-	}
+	// Returns the id used to record events with this name. Names are matched by address so must outlive the session
+	static uint32_t InternName(const char* name);
 
-	void EndSession(const std::string& name)
-	{
-		if (!m_IsEnabled)
-			return;
-		std::lock_guard lock(m_Mutex);
-		InternalEndSession(name);
-	}
+	// Record a scope on the calling thread, dropped if the thread's buffer is full
+	static void WriteProfile(uint32_t nameId, int64_t startTicks, int64_t endTicks);
 
-	void WriteProfile(const ProfileResult& result)
-	{
-		if (!m_IsEnabled)
-			return;
-
-		std::stringstream json;
-
-		std::string name = result.name;
-		std::replace(name.begin(), name.end(), '"', '\'');
-
-		json << std::setprecision(3) << std::fixed;
-		json << ",\n{";
-		json << "\"cat\":\"function\",";
-		json << "\"dur\":" << (result.elapsedTime.count()) << ',';
-		json << "\"name\":\"" << name << "\",";
-		json << "\"ph\":\"X\",";
-		json << "\"pid\":0,";
-		json << "\"tid\":" << result.threadID << ",";
-		json << "\"ts\":" << result.start.count();
-		json << "}";
-
-		std::lock_guard lock(m_Mutex);
-		if (m_CurrentSession)
-		{
-			m_OutputStream << json.str();
-			m_OutputStream.flush();
-		}
-	}
-
-	static Instrumentor& Get()
-	{
-		static Instrumentor instance;
-		return instance;
-	}
+	// Nanoseconds on the steady clock
+	static int64_t GetTicks() { return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count(); }
 
-	static void Enable()
-	{
-		Get().EnableImpl();
-	}
+	// Events that didn't fit in a buffer since the session began
+	static uint64_t GetDroppedEvents();
 
-	static void Disable()
-	{
-		Get().DisableImpl();
-	}
+	static void Enable() { s_Enabled = true; }
+	static void Disable() { s_Enabled = false; }
+	static bool IsEnabled() { return s_Enabled; }
 
-	static bool IsEnabled()
-	{
-		return Get().IsEnabledImpl();
-	}
+	// Enabled and a session is open
+	static bool IsRecording() { return s_Recording.load(std::memory_order_relaxed); }
 
 private:
-	void WriteHeader()
-	{
-		m_OutputStream << "{\"otherData\": {},\"traceEvents\":[{}";
-		m_OutputStream.flush();
-	}
+	static void WriterLoop();
 
-	void WriteFooter()
-	{
-		m_OutputStream << "]}";
-		m_OutputStream.flush();
-	}
-
-	void InternalEndSession(const std::string& name)
-	{
-		if (m_CurrentSession)
-		{
-			if (m_CurrentSession->name != name)
-			{
-				ENGINE_WARN("Attempting to end session \"{0}\" but does not match current session \"{1}\"", name, m_CurrentSession->name);
-			}
-			WriteFooter();
-			m_OutputStream.close();
-			delete m_CurrentSession;
-			m_CurrentSession = nullptr;
-		}
-	}
-
-	void EnableImpl()
-	{
-		m_IsEnabled = true;
-	}
-
-	void DisableImpl()
-	{
-		m_IsEnabled = false;
-	}
-
-	bool IsEnabledImpl()
-	{
-		return m_IsEnabled;
-	}
+	inline static bool s_Enabled = false;
+	inline static std::atomic<bool> s_Recording = false;
 };
 
 class InstrumentationTimer
 {
 public:
-	InstrumentationTimer(const char* name)
-		: m_Name(name), m_Stopped(false)
+	InstrumentationTimer(uint32_t nameId)
+		: m_NameId(nameId), m_Started(Instrumentor::IsRecording())
 	{
-		if (Instrumentor::IsEnabled())
-		{
-			m_StartTimepoint = std::chrono::steady_clock::now();
-		}
+		if (m_Started)
+			m_StartTicks = Instrumentor::GetTicks();
 	}
 
 	~InstrumentationTimer()
 	{
-		if (Instrumentor::IsEnabled())
-		{
-			if (!m_Stopped)
-				Stop();
-		}
+		if (m_Started)
+			Stop();
 	}
 
 	void Stop()
 	{
-		auto endTimePoint = std::chrono::steady_clock::now();
-		auto highResStart = FloatingPointMicroSeconds{ m_StartTimepoint.time_since_epoch() };
-		auto elapsedTime = std::chrono::time_point_cast<std::chrono::microseconds>(endTimePoint).time_since_epoch()
-			- std::chrono::time_point_cast<std::chrono::microseconds>(m_StartTimepoint).time_since_epoch();
-
-		Instrumentor::Get().WriteProfile({ m_Name, highResStart, elapsedTime, std::this_thread::get_id() });
-
-		m_Stopped = true;
+		Instrumentor::WriteProfile(m_NameId, m_StartTicks, Instrumentor::GetTicks());
+		m_Started = false;
 	}
 private:
-	const char* m_Name;
-	std::chrono::time_point<std::chrono::steady_clock> m_StartTimepoint;
-	bool m_Stopped;
+	uint32_t m_NameId;
+	bool m_Started;
+	int64_t m_StartTicks = 0;
 };
 
 #ifndef DEBUG // You should only profile an application in release
@@ -229,13 +98,18 @@ private:
 	#define FUNC_SIG "FUNC_SIG unknown!"
 #endif
 
-#define PROFILE_BEGIN_SESSION(name, filepath) ::Instrumentor::Get().BeginSession(name, filepath)
-#define PROFILE_END_SESSION(name) ::Instrumentor::Get().EndSession(name)
-#define PROFILE_SCOPE(name) ::InstrumentationTimer timer##__LINE__(name);
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+
+#define PROFILE_BEGIN_SESSION(name, filepath) ::Instrumentor::BeginSession(name, filepath)
+#define PROFILE_END_SESSION(name) ::Instrumentor::EndSession(name)
+// The name is interned once per call site
+#define PROFILE_SCOPE(name) static const uint32_t PROFILE_CONCAT(profileName, __LINE__) = ::Instrumentor::InternName(name); \
+	::InstrumentationTimer PROFILE_CONCAT(timer, __LINE__)(PROFILE_CONCAT(profileName, __LINE__));
 #define PROFILE_FUNCTION() PROFILE_SCOPE(FUNC_SIG)
 #else
 #define PROFILE_BEGIN_SESSION(name, filepath)
 #define PROFILE_END_SESSION(name)
 #define PROFILE_FUNCTION()
 #define PROFILE_SCOPE(name)
-#endif // PROFILE
\ No newline at end of file
+#endif // PROFILE
@@ -1,38 +1,216 @@
 #include "stdafx.h"
 #include "ParticleSystem.h"
 
-ParticleSystem::ParticleSystem()
+#include "Utilities/Random.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define PARTICLES_SSE
+#include <xmmintrin.h>
+#endif
+
+static constexpr size_t s_StreamAlignment = 64;
+static constexpr size_t s_Lanes = 4;
+static constexpr float s_TwoPi = 6.28318530718f;
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+ParticleSystem::ParticleSystem(uint32_t maxParticles)
 {
-	m_ParticlePool.resize(1000);
+	Allocate(maxParticles);
 }
 
+/* ------------------------------------------------------------------------------------------------------------------ */
+
 ParticleSystem::~ParticleSystem()
 {
+	::operator delete(m_Data, std::align_val_t(s_StreamAlignment));
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void ParticleSystem::SetMaxParticles(uint32_t maxParticles)
+{
+	if (maxParticles == m_MaxParticles)
+		return;
+
+	::operator delete(m_Data, std::align_val_t(s_StreamAlignment));
+	Allocate(maxParticles);
 }
 
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void ParticleSystem::Allocate(uint32_t maxParticles)
+{
+	const size_t floatsPerLine = s_StreamAlignment / sizeof(float);
+
+	m_MaxParticles = maxParticles;
+	m_Count = 0;
+	m_Stride = std::max<size_t>(((size_t)maxParticles + floatsPerLine - 1) / floatsPerLine * floatsPerLine, floatsPerLine);
+
+	size_t bytes = m_Stride * StreamCount * sizeof(float);
+	m_Data = (float*)::operator new(bytes, std::align_val_t(s_StreamAlignment));
+
+	// The padding lanes are processed along with the live particles so they must hold valid numbers
+	memset(m_Data, 0, bytes);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
 void ParticleSystem::OnUpdate(float deltaTime)
 {
-	for (Particle particle : m_ParticlePool)
+	PROFILE_FUNCTION();
+
+	if (m_Count == 0)
+		return;
+
+	Integrate(deltaTime);
+	RemoveExpired();
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void ParticleSystem::Integrate(float deltaTime)
+{
+	float* positionX = Stream(PositionX);
+	float* positionY = Stream(PositionY);
+	const float* velocityX = Stream(VelocityX);
+	const float* velocityY = Stream(VelocityY);
+	float* rotation = Stream(Rotation);
+	const float* angularVelocity = Stream(AngularVelocity);
+	float* life = Stream(LifeRemaining);
+	const float* inverseLifeTime = Stream(InverseLifeTime);
+	const float* sizeBegin = Stream(SizeBegin);
+	const float* sizeEnd = Stream(SizeEnd);
+	float* size = Stream(Size);
+
+	// Round up to whole lanes, the streams are padded so this never goes past the end
+	size_t count = (m_Count + s_Lanes - 1) / s_Lanes * s_Lanes;
+
+#ifdef PARTICLES_SSE
+	const __m128 dt = _mm_set1_ps(deltaTime);
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 zero = _mm_setzero_ps();
+
+	for (size_t i = 0; i < count; i += s_Lanes)
 	{
-		if (!particle.Active)
-			continue;
+		__m128 remaining = _mm_sub_ps(_mm_load_ps(life + i), dt);
+		_mm_store_ps(life + i, remaining);
 
-		if (particle.LifeRemaining <= 0.0f)
+		_mm_store_ps(positionX + i, _mm_add_ps(_mm_load_ps(positionX + i), _mm_mul_ps(_mm_load_ps(velocityX + i), dt)));
+		_mm_store_ps(positionY + i, _mm_add_ps(_mm_load_ps(positionY + i), _mm_mul_ps(_mm_load_ps(velocityY + i), dt)));
+		_mm_store_ps(rotation + i, _mm_add_ps(_mm_load_ps(rotation + i), _mm_mul_ps(_mm_load_ps(angularVelocity + i), dt)));
+
+		// Fraction of the lifetime that has passed, 0 when emitted and 1 when expired
+		__m128 t = _mm_sub_ps(one, _mm_mul_ps(_mm_max_ps(remaining, zero), _mm_load_ps(inverseLifeTime + i)));
+
+		__m128 begin = _mm_load_ps(sizeBegin + i);
+		_mm_store_ps(size + i, _mm_add_ps(begin, _mm_mul_ps(_mm_sub_ps(_mm_load_ps(sizeEnd + i), begin), t)));
+
+		for (int channel = 0; channel < 4; channel++)
 		{
-			particle.Active = false;
-			continue;
+			__m128 colourBegin = _mm_load_ps(Stream(ColourBeginR + channel) + i);
+			__m128 colourEnd = _mm_load_ps(Stream(ColourEndR + channel) + i);
+			_mm_store_ps(Stream(ColourR + channel) + i, _mm_add_ps(colourBegin, _mm_mul_ps(_mm_sub_ps(colourEnd, colourBegin), t)));
 		}
+	}
+#else
+	for (size_t i = 0; i < count; i++)
+	{
+		life[i] -= deltaTime;
+		positionX[i] += velocityX[i] * deltaTime;
+		positionY[i] += velocityY[i] * deltaTime;
+		rotation[i] += angularVelocity[i] * deltaTime;
+
+		float t = 1.0f - std::max(life[i], 0.0f) * inverseLifeTime[i];
+		size[i] = sizeBegin[i] + (sizeEnd[i] - sizeBegin[i]) * t;
 
-		particle.LifeRemaining -= deltaTime;
-		particle.Position += particle.Velocity * (float)deltaTime;
-		particle.Rotation += 0.01f * deltaTime;
+		for (int channel = 0; channel < 4; channel++)
+		{
+			float colourBegin = Stream(ColourBeginR + channel)[i];
+			float colourEnd = Stream(ColourEndR + channel)[i];
+			Stream(ColourR + channel)[i] = colourBegin + (colourEnd - colourBegin) * t;
+		}
 	}
+#endif
 }
 
-void ParticleSystem::OnRender(Camera& camera)
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void ParticleSystem::RemoveExpired()
 {
+	const float* life = Stream(LifeRemaining);
+
+	// Walk backwards so the particle moved into a gap has always been checked already
+	size_t block = (m_Count - 1) / s_Lanes * s_Lanes;
+	while (true)
+	{
+#ifdef PARTICLES_SSE
+		int expired = _mm_movemask_ps(_mm_cmple_ps(_mm_load_ps(life + block), _mm_setzero_ps()));
+#else
+		int expired = 0;
+		for (size_t lane = 0; lane < s_Lanes; lane++)
+			expired |= (life[block + lane] <= 0.0f) << lane;
+#endif
+		if (expired != 0)
+		{
+			for (size_t lane = s_Lanes; lane-- > 0;)
+			{
+				size_t index = block + lane;
+				if (index >= m_Count || !(expired & (1 << lane)))
+					continue;
+
+				size_t last = --m_Count;
+				if (index != last)
+				{
+					for (int stream = 0; stream < StreamCount; stream++)
+					{
+						float* data = Stream(stream);
+						data[index] = data[last];
+					}
+				}
+			}
+		}
+
+		if (block == 0)
+			break;
+		block -= s_Lanes;
+	}
 }
 
-void ParticleSystem::Emit(const ParticleProps& particleProps)
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void ParticleSystem::Emit(const ParticleProps& particleProps, uint32_t count)
 {
+	count = std::min(count, m_MaxParticles - m_Count);
+
+	float lifeTime = std::max(particleProps.lifeTime, 0.0001f);
+	const float beginColour[4] = { particleProps.beginColour.r, particleProps.beginColour.g, particleProps.beginColour.b, particleProps.beginColour.a };
+	const float endColour[4] = { particleProps.endColour.r, particleProps.endColour.g, particleProps.endColour.b, particleProps.endColour.a };
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		size_t index = m_Count++;
+
+		Stream(PositionX)[index] = particleProps.position.x;
+		Stream(PositionY)[index] = particleProps.position.y;
+		Stream(VelocityX)[index] = particleProps.velocity.x + particleProps.velocityVariation.x * (Random::Float() - 0.5f);
+		Stream(VelocityY)[index] = particleProps.velocity.y + particleProps.velocityVariation.y * (Random::Float() - 0.5f);
+		Stream(Rotation)[index] = Random::Float() * s_TwoPi;
+		Stream(AngularVelocity)[index] = particleProps.rotationSpeed;
+
+		Stream(LifeRemaining)[index] = lifeTime;
+		Stream(InverseLifeTime)[index] = 1.0f / lifeTime;
+
+		float sizeBegin = std::max(particleProps.sizeBegin + particleProps.sizeVariation * (Random::Float() - 0.5f), 0.0f);
+		Stream(SizeBegin)[index] = sizeBegin;
+		Stream(SizeEnd)[index] = particleProps.sizeEnd;
+		Stream(Size)[index] = sizeBegin;
+
+		for (int channel = 0; channel < 4; channel++)
+		{
+			Stream(ColourBeginR + channel)[index] = beginColour[channel];
+			Stream(ColourEndR + channel)[index] = endColour[channel];
+			Stream(ColourR + channel)[index] = beginColour[channel];
+		}
+	}
 }
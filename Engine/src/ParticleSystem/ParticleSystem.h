@@ -2,51 +2,74 @@
 
 #include "math/Vector2f.h"
 #include "Core/Colour.h"
-#include "Renderer/Camera.h"
-#include "Core/ObjectPool.h"
 #include "Core/core.h"
-#include "Renderer/Shader.h"
 
 struct ParticleProps
 {
 	Vector2f position;
-	Vector2f velocity, velocityVariation;
-	Colour beginColour, endColour;
-	float sizeBegin, sizeEnd, sizeVariation;
-	float lifeTime;
+	Vector2f velocity = { 0.0f, 1.0f }, velocityVariation = { 1.0f, 1.0f };
+	Colour beginColour = Colours::WHITE, endColour = { 1.0f, 1.0f, 1.0f, 0.0f };
+	float sizeBegin = 0.5f, sizeEnd = 0.0f, sizeVariation = 0.25f;
+	float rotationSpeed = 0.0f;
+	float lifeTime = 1.0f;
 };
 
+// Particles are stored as a structure of arrays and kept packed at the front of each array,
+// so updating and drawing only ever touches live particles
 class ParticleSystem
 {
 public:
-	ParticleSystem();
-
+	explicit ParticleSystem(uint32_t maxParticles = 1000);
 	~ParticleSystem();
 
+	ParticleSystem(const ParticleSystem&) = delete;
+	ParticleSystem& operator=(const ParticleSystem&) = delete;
+
+	// Age and move every particle then remove the ones that have expired
 	void OnUpdate(float deltaTime);
-	void OnRender(Camera& camera);
 
-	void Emit(const ParticleProps& particleProps);
-private:
+	// Emit particles with the properties plus a random variation, particles are dropped once the system is full
+	void Emit(const ParticleProps& particleProps, uint32_t count = 1);
 
-	struct Particle
-	{
-		Vector2f Position;
-		Vector2f Velocity;
-		Colour ColourBegin, ColourEnd;
-		float Rotation = 0.0f;
-		float SizeBegin, SizeEnd = 1.0f;
+	void Clear() { m_Count = 0; }
 
-		float LifeTime = 1.0f;
-		float LifeRemaining = 0.0f;
+	// Resizing discards every particle
+	void SetMaxParticles(uint32_t maxParticles);
+	uint32_t GetMaxParticles() const { return m_MaxParticles; }
+	uint32_t GetCount() const { return m_Count; }
 
-		bool Active = false;
+	// Current state of each particle, for rendering
+	const float* GetPositionsX() const { return Stream(PositionX); }
+	const float* GetPositionsY() const { return Stream(PositionY); }
+	const float* GetRotations() const { return Stream(Rotation); }
+	const float* GetSizes() const { return Stream(Size); }
+	const float* GetColours(int channel) const { return Stream(ColourR + channel); }
+
+private:
+	enum StreamIndex
+	{
+		PositionX, PositionY,
+		VelocityX, VelocityY,
+		Rotation, AngularVelocity,
+		LifeRemaining, InverseLifeTime,
+		SizeBegin, SizeEnd, Size,
+		ColourBeginR, ColourBeginG, ColourBeginB, ColourBeginA,
+		ColourEndR, ColourEndG, ColourEndB, ColourEndA,
+		ColourR, ColourG, ColourB, ColourA,
+		StreamCount
 	};
 
-	std::vector<Particle> m_ParticlePool;
+	float* Stream(int stream) { return m_Data + (size_t)stream * m_Stride; }
+	const float* Stream(int stream) const { return m_Data + (size_t)stream * m_Stride; }
+
+	void Allocate(uint32_t maxParticles);
+	void Integrate(float deltaTime);
+	void RemoveExpired();
 
-	uint32_t m_PoolIndex = 999;
+	// Every stream is aligned to a cache line and padded to a whole number of SIMD lanes
+	float* m_Data = nullptr;
+	size_t m_Stride = 0;
 
-	uint32_t m_QuadVA = 0;
-	Scope<Shader> m_ParticleShader;
+	uint32_t m_MaxParticles = 0;
+	uint32_t m_Count = 0;
 };
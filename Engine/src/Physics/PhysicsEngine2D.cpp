@@ -12,7 +12,9 @@
 #include "Scene/Components/TilemapComponent.h"
 #include "Scene/Components/LuaScriptComponent.h"
 #include "Scene/Components/HierarchyComponent.h"
+#include "Scene/EntityPool.h"
 #include "Renderer/Renderer2D.h"
+#include "Core/Statistics.h"
 #include "box2d/box2d.h"
 #include "Utilities/Box2DDebugDraw.h"
 #include "Utilities/Triangulation.h"
@@ -90,9 +92,11 @@ PhysicsEngine2D::~PhysicsEngine2D()
 
 void PhysicsEngine2D::OnFixedUpdate()
 {
+	StatisticsTimer timer(Statistics::PhysicsTime);
+
 	m_Box2DWorld->Step(Application::Get().GetFixedUpdateInterval(), m_VelocityIterations, m_PositionIterations);
 
-	m_Scene->GetRegistry().view<TransformComponent, RigidBody2DComponent>().each([=](auto entity, auto& transformComp, auto& rigidBodyComp)
+	m_Scene->GetRegistry().view<TransformComponent, RigidBody2DComponent>(entt::exclude<PooledMarker>).each([=](auto entity, auto& transformComp, auto& rigidBodyComp)
 		{
 			if (rigidBodyComp.runtimeBody == nullptr
 				|| rigidBodyComp.runtimeBody->GetType() != GetRigidBodyBox2DType(rigidBodyComp.type))
@@ -426,6 +430,40 @@ void PhysicsEngine2D::DestroyEntity(Entity entity)
 		m_Box2DWorld->DestroyBody((b2Body*)colliderComp->runtimeBody);
 }
 
+void PhysicsEngine2D::SetEntityEnabled(Entity entity, bool enabled)
+{
+	b2Body* body = nullptr;
+	if (RigidBody2DComponent* rigidBodyComp = entity.TryGetComponent<RigidBody2DComponent>())
+		body = rigidBodyComp->runtimeBody;
+	else if (BoxCollider2DComponent* boxColliderComp = entity.TryGetComponent<BoxCollider2DComponent>())
+		body = boxColliderComp->runtimeBody;
+	else if (CircleCollider2DComponent* colliderComp = entity.TryGetComponent<CircleCollider2DComponent>())
+		body = colliderComp->runtimeBody;
+	else if (PolygonCollider2DComponent* colliderComp = entity.TryGetComponent<PolygonCollider2DComponent>())
+		body = colliderComp->runtimeBody;
+	else if (CapsuleCollider2DComponent* colliderComp = entity.TryGetComponent<CapsuleCollider2DComponent>())
+		body = colliderComp->runtimeBody;
+	else if (TilemapComponent* colliderComp = entity.TryGetComponent<TilemapComponent>())
+		body = colliderComp->runtimeBody;
+
+	if (body == nullptr)
+	{
+		// Created before the simulation started
+		if (enabled && entity.HasComponent<TransformComponent>())
+			InitializeEntity(entity);
+		return;
+	}
+
+	if (enabled)
+	{
+		TransformComponent& transformComp = entity.GetComponent<TransformComponent>();
+		body->SetTransform(b2Vec2(transformComp.position.x, transformComp.position.y), (float)transformComp.rotation.z);
+		body->SetLinearVelocity(b2Vec2(0.0f, 0.0f));
+		body->SetAngularVelocity(0.0f);
+	}
+	body->SetEnabled(enabled);
+}
+
 void PhysicsEngine2D::SetGravity(Vector2f gravity)
 {
 	m_Box2DWorld->SetGravity(b2Vec2(gravity.x, gravity.y));
@@ -25,6 +25,10 @@ public:
 	void InitializeEntity(Entity entity);
 	void DestroyEntity(Entity entity);
 
+	// Take the entity's body out of the simulation without destroying it. Enabling it again moves it to the
+	// entity's transform and stops it
+	void SetEntityEnabled(Entity entity, bool enabled);
+
 	void SetGravity(Vector2f gravity);
 
 	HitResult2D RayCast(Vector2f begin, Vector2f end);
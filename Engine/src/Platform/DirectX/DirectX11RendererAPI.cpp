@@ -96,6 +96,26 @@ void DirectX11RendererAPI::ClearDepth()
 }
 
 void DirectX11RendererAPI::DrawIndexed(uint32_t indexCount, uint32_t startIndex, uint32_t vertexOffset, bool backFaceCull, DrawMode drawMode)
+{
+	SetRasterizerState(backFaceCull, drawMode);
+
+	g_ImmediateContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	g_ImmediateContext->DrawIndexed(indexCount, startIndex, vertexOffset);
+}
+
+void DirectX11RendererAPI::DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex, uint32_t vertexOffset, bool backFaceCull, DrawMode drawMode)
+{
+	SetRasterizerState(backFaceCull, drawMode);
+
+	g_ImmediateContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	g_ImmediateContext->DrawIndexedInstanced(indexCount, instanceCount, startIndex, vertexOffset, 0);
+}
+
+void DirectX11RendererAPI::DrawLines(uint32_t vertexCount, uint32_t firstVertex)
+{
+}
+
+void DirectX11RendererAPI::SetRasterizerState(bool backFaceCull, DrawMode drawMode)
 {
 	if (!backFaceCull)
 	{
@@ -118,11 +138,4 @@ void DirectX11RendererAPI::DrawIndexed(uint32_t indexCount, uint32_t startIndex,
 			break;
 		}
 	}
-
-	g_ImmediateContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-	g_ImmediateContext->DrawIndexed(indexCount, startIndex, vertexOffset);
 }
-
-void DirectX11RendererAPI::DrawLines(uint32_t vertexCount)
-{
-}
\ No newline at end of file
@@ -16,8 +16,11 @@ public:
 	virtual void ClearDepth() override;
 
 	virtual void DrawIndexed(uint32_t indexCount, uint32_t startIndex = 0, uint32_t vertexOffset = 0, bool backFaceCull = false, DrawMode drawMode = DrawMode::FILL) override;
-	virtual void DrawLines(uint32_t vertexCount) override;
+	virtual void DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex = 0, uint32_t vertexOffset = 0, bool backFaceCull = false, DrawMode drawMode = DrawMode::FILL) override;
+	virtual void DrawLines(uint32_t vertexCount, uint32_t firstVertex) override;
 private:
+	void SetRasterizerState(bool backFaceCull, DrawMode drawMode);
+
 	D3D11_VIEWPORT m_Viewport;
 
 	Colour m_ClearColour;
@@ -3,8 +3,7 @@
 #include "DirectX11Context.h"
 #include "Core/Application.h"
 #include "Logging/Instrumentor.h"
-
-#include <stb/stb_image.h>
+#include "Renderer/ImageLoader.h"
 
 extern ID3D11Device* g_D3dDevice;
 extern ID3D11DeviceContext* g_ImmediateContext;
@@ -95,23 +94,17 @@ void DirectX11Texture2D::NullTexture()
 
 bool DirectX11Texture2D::LoadTextureFromFile()
 {
-	int width, height, channels;
-	unsigned char* data = nullptr;
-	{
-		PROFILE_SCOPE("stbi Load Image Directx11Texture2D(const std::string&)");
-		data = stbi_load(m_Filepath.string().c_str(), &width, &height, &channels, 0);
-	}
+	Image image;
+	bool loaded = ImageLoader::Load(m_Filepath, image);
 
-	CORE_ASSERT(data, "Failed to load image: %s", m_Filepath);
+	CORE_ASSERT(loaded, "Failed to load image: %s", m_Filepath);
 
-	if (!data)
-	{
-		ENGINE_ERROR("stb image failure: {0}", stbi_failure_reason());
+	if (!loaded)
 		return false;
-	}
 
-	m_Width = (uint32_t)width;
-	m_Height = (uint32_t)height;
+	m_Width = image.width;
+	m_Height = image.height;
+	uint32_t channels = image.channels;
 
 	DXGI_FORMAT internalFormat = DXGI_FORMAT_UNKNOWN;
 
@@ -143,7 +136,7 @@ bool DirectX11Texture2D::LoadTextureFromFile()
 
 	ID3D11Texture2D* pTexture = NULL;
 	D3D11_SUBRESOURCE_DATA subresource;
-	subresource.pSysMem = data;
+	subresource.pSysMem = image.pixels.data();
 	subresource.SysMemPitch = desc.Width;
 	subresource.SysMemSlicePitch = 0;
 	g_D3dDevice->CreateTexture2D(&desc, &subresource, &pTexture);
@@ -157,7 +150,5 @@ bool DirectX11Texture2D::LoadTextureFromFile()
 	srvDesc.Texture2D.MostDetailedMip = 0;
 	g_D3dDevice->CreateShaderResourceView(pTexture, &srvDesc, &m_ShaderResourceView);
 	pTexture->Release();
-
-	stbi_image_free(data);
 	return true;
 }
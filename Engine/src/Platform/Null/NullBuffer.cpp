@@ -0,0 +1,90 @@
+#include "stdafx.h"
+#include "NullBuffer.h"
+#include "NullRendererAPI.h"
+
+#include "Renderer/RenderCommand.h"
+
+static void RecordVertexData(const void* data, uint32_t size)
+{
+	if (NullRendererAPI* api = dynamic_cast<NullRendererAPI*>(RenderCommand::GetRendererAPI()))
+		api->RecordVertexData(data, size);
+}
+
+NullVertexBuffer::NullVertexBuffer(uint32_t size)
+	:m_Size(size)
+{
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void NullVertexBuffer::SetLayout(const BufferLayout& layout)
+{
+	m_Layout = layout;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+const BufferLayout& NullVertexBuffer::GetLayout() const
+{
+	return m_Layout;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void NullVertexBuffer::SetData(const void* data, uint32_t size, uint32_t offset)
+{
+	CORE_ASSERT(offset + size <= m_Size, "Vertex buffer data out of range");
+	RecordVertexData(data, size);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void NullVertexBuffer::SetData(const void* data)
+{
+	RecordVertexData(data, m_Size);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+uint32_t NullVertexBuffer::GetSize()
+{
+	return m_Size;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void NullVertexBuffer::Bind() const
+{
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void NullVertexBuffer::UnBind() const
+{
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+NullIndexBuffer::NullIndexBuffer(uint32_t count)
+	:m_Count(count)
+{
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void NullIndexBuffer::Bind() const
+{
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void NullIndexBuffer::UnBind() const
+{
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+uint32_t NullIndexBuffer::GetCount() const
+{
+	return m_Count;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Renderer/Buffer.h"
+
+// Buffers for the None renderer API, vertex data is hashed into the renderer API's recording then discarded
+class NullVertexBuffer : public VertexBuffer
+{
+public:
+	NullVertexBuffer(uint32_t size);
+	~NullVertexBuffer() = default;
+
+	// Inherited via VertexBuffer
+	virtual void SetLayout(const BufferLayout& layout) override;
+	virtual const BufferLayout& GetLayout() const override;
+	virtual void SetData(const void* data, uint32_t size, uint32_t offset) override;
+	virtual void SetData(const void* data) override;
+	virtual uint32_t GetSize() override;
+	virtual void Bind() const override;
+	virtual void UnBind() const override;
+private:
+	uint32_t m_Size;
+	BufferLayout m_Layout;
+};
+
+class NullIndexBuffer : public IndexBuffer
+{
+public:
+	NullIndexBuffer(uint32_t count);
+	~NullIndexBuffer() = default;
+
+	// Inherited via IndexBuffer
+	virtual void Bind() const override;
+	virtual void UnBind() const override;
+	virtual uint32_t GetCount() const override;
+
+private:
+	uint32_t m_Count;
+};
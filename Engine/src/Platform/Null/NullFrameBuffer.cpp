@@ -0,0 +1,59 @@
+#include "stdafx.h"
+#include "NullFrameBuffer.h"
+
+NullFrameBuffer::NullFrameBuffer(const FrameBufferSpecification& specification)
+	:m_Specification(specification)
+{
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void NullFrameBuffer::Bind()
+{
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void NullFrameBuffer::UnBind()
+{
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void NullFrameBuffer::Generate()
+{
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void NullFrameBuffer::Destroy()
+{
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void NullFrameBuffer::Resize(uint32_t width, uint32_t height)
+{
+	m_Specification.width = width;
+	m_Specification.height = height;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+int NullFrameBuffer::ReadPixel(uint32_t attachmentIndex, int x, int y)
+{
+	return -1;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+uint32_t NullFrameBuffer::GetColourAttachment(size_t index)
+{
+	return 0;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void NullFrameBuffer::ClearAttachment(size_t index, int value)
+{
+}
@@ -0,0 +1,25 @@
+#include "stdafx.h"
+#include "NullPipeline.h"
+
+NullPipeline::NullPipeline(const Spec& spec)
+{
+	m_Specification = spec;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void NullPipeline::Invalidate()
+{
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void NullPipeline::SetUniformBuffer(Ref<UniformBuffer> uniformBuffer, uint32_t binding, uint32_t set)
+{
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void NullPipeline::Bind()
+{
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "Renderer/Pipeline.h"
+
+class NullPipeline : public Pipeline
+{
+public:
+	NullPipeline(const Spec& spec);
+	virtual ~NullPipeline() = default;
+
+	virtual void Invalidate() override;
+	virtual void SetUniformBuffer(Ref<UniformBuffer> uniformBuffer, uint32_t binding, uint32_t set = 0) override;
+
+	virtual void Bind() override;
+};
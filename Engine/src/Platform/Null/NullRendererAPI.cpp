@@ -0,0 +1,131 @@
+#include "stdafx.h"
+#include "NullRendererAPI.h"
+
+bool NullRendererAPI::Init()
+{
+	ClearRecording();
+	return true;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void NullRendererAPI::SetClearColour(const Colour& colour)
+{
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void NullRendererAPI::SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height)
+{
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void NullRendererAPI::Clear()
+{
+	// Clearing the screen starts a new frame, only the draw calls since then are kept
+	m_DrawCalls.clear();
+	m_LineDrawCount = 0;
+	m_ClearCount++;
+	SignalFences();
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void NullRendererAPI::ClearColour()
+{
+	m_ClearCount++;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void NullRendererAPI::ClearDepth()
+{
+	m_ClearCount++;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void NullRendererAPI::DrawIndexed(uint32_t indexCount, uint32_t indexStart, uint32_t vertexOffset, bool backFaceCull, DrawMode drawMode)
+{
+	m_DrawCalls.push_back({ indexCount, indexStart, vertexOffset, 1, backFaceCull, drawMode, m_VertexDataHash });
+	m_VertexDataHash = s_HashSeed;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void NullRendererAPI::DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex, uint32_t vertexOffset, bool backFaceCull, DrawMode drawMode)
+{
+	m_DrawCalls.push_back({ indexCount, startIndex, vertexOffset, instanceCount, backFaceCull, drawMode, m_VertexDataHash });
+	m_VertexDataHash = s_HashSeed;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void NullRendererAPI::DrawLines(uint32_t vertexCount, uint32_t firstVertex)
+{
+	m_LineDrawCount++;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+uint64_t NullRendererAPI::InsertFence()
+{
+	m_Fences[m_NextFence] = false;
+	return m_NextFence++;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+bool NullRendererAPI::WaitFence(uint64_t fence)
+{
+	auto it = m_Fences.find(fence);
+	if (it == m_Fences.end() || it->second)
+		return false;
+
+	it->second = true;
+	m_FenceStallCount++;
+	return true;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void NullRendererAPI::DeleteFence(uint64_t fence)
+{
+	m_Fences.erase(fence);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void NullRendererAPI::SignalFences()
+{
+	for (auto& [fence, signalled] : m_Fences)
+		signalled = true;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void NullRendererAPI::ClearRecording()
+{
+	m_DrawCalls.clear();
+	m_LineDrawCount = 0;
+	m_ClearCount = 0;
+	m_FenceStallCount = 0;
+	m_VertexDataHash = s_HashSeed;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// FNV-1a, continued across uploads until the next draw
+void NullRendererAPI::RecordVertexData(const void* data, uint32_t size)
+{
+	if (!data)
+		return;
+
+	const uint8_t* bytes = static_cast<const uint8_t*>(data);
+	for (uint32_t i = 0; i < size; i++)
+	{
+		m_VertexDataHash ^= bytes[i];
+		m_VertexDataHash *= 1099511628211ull;
+	}
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Renderer/RendererAPI.h"
+
+// Renderer API that draws nothing and records the calls made to it
+class NullRendererAPI : public RendererAPI
+{
+public:
+	struct DrawCall
+	{
+		uint32_t indexCount = 0;
+		uint32_t startIndex = 0;
+		uint32_t vertexOffset = 0;
+		uint32_t instanceCount = 1;
+		bool backFaceCull = true;
+		DrawMode drawMode = DrawMode::FILL;
+		uint64_t vertexDataHash = 0; // of the vertex data uploaded since the previous draw
+	};
+
+	virtual bool Init() override;
+	virtual void SetClearColour(const Colour& colour) override;
+	virtual void SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height) override;
+	virtual void Clear() override;
+	virtual void ClearColour() override;
+	virtual void ClearDepth() override;
+
+	virtual void DrawIndexed(uint32_t indexCount, uint32_t indexStart = 0, uint32_t vertexOffset = 0, bool backFaceCull = false, DrawMode drawMode = DrawMode::FILL) override;
+	virtual void DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex = 0, uint32_t vertexOffset = 0, bool backFaceCull = false, DrawMode drawMode = DrawMode::FILL) override;
+	virtual void DrawLines(uint32_t vertexCount, uint32_t firstVertex) override;
+
+	// Fences stay pending until the next clear or SignalFences, waiting on a pending fence is recorded as a stall
+	virtual uint64_t InsertFence() override;
+	virtual bool WaitFence(uint64_t fence) override;
+	virtual void DeleteFence(uint64_t fence) override;
+
+	const std::vector<DrawCall>& GetDrawCalls() const { return m_DrawCalls; }
+	uint32_t GetLineDrawCount() const { return m_LineDrawCount; }
+	uint32_t GetClearCount() const { return m_ClearCount; }
+	uint32_t GetFenceStallCount() const { return m_FenceStallCount; }
+	size_t GetFenceCount() const { return m_Fences.size(); }
+
+	void SignalFences();
+	void ClearRecording();
+
+	// Called by the null vertex buffers so tests can compare the vertices two code paths upload
+	void RecordVertexData(const void* data, uint32_t size);
+
+private:
+	std::vector<DrawCall> m_DrawCalls;
+	uint32_t m_LineDrawCount = 0;
+	uint32_t m_ClearCount = 0;
+	uint64_t m_VertexDataHash = s_HashSeed;
+
+	static constexpr uint64_t s_HashSeed = 14695981039346656037ull;
+
+	std::unordered_map<uint64_t, bool> m_Fences; // signalled
+	uint64_t m_NextFence = 1;
+	uint32_t m_FenceStallCount = 0;
+};
@@ -0,0 +1,26 @@
+#include "stdafx.h"
+#include "NullShader.h"
+
+NullShader::NullShader(const std::string& name)
+	:m_Name(name)
+{
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void NullShader::Bind() const
+{
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void NullShader::UnBind() const
+{
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+std::string NullShader::GetName() const
+{
+	return m_Name;
+}
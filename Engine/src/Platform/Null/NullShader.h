@@ -0,0 +1,19 @@
+#pragma once
+
+#include "Renderer/Shader.h"
+
+// Shader for the None renderer API, nothing is compiled
+class NullShader : public Shader
+{
+public:
+	NullShader(const std::string& name);
+	virtual ~NullShader() = default;
+
+	virtual void Bind() const override;
+	virtual void UnBind() const override;
+
+	virtual std::string GetName() const override;
+
+private:
+	std::string m_Name;
+};
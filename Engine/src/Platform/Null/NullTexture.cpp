@@ -0,0 +1,157 @@
+#include "stdafx.h"
+#include "NullTexture.h"
+
+#include <atomic>
+
+#include <stb/stb_image.h>
+
+static uint32_t NextRendererID()
+{
+	static std::atomic<uint32_t> s_NextID = 1;
+	return s_NextID++;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+NullTexture2D::NullTexture2D(uint32_t width, uint32_t height)
+	:m_Width(width), m_Height(height), m_RendererID(NextRendererID())
+{
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+NullTexture2D::NullTexture2D(const std::filesystem::path& filepath)
+	:m_Width(0), m_Height(0), m_RendererID(NextRendererID())
+{
+	m_Filepath = filepath;
+
+	if (!ReadImageSize())
+	{
+		ENGINE_ERROR("Failed to read image size {0}", filepath);
+		m_Width = m_Height = 4;
+	}
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void NullTexture2D::SetData(const void* data)
+{
+	m_Filepath = "";
+	m_Generation++;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+bool NullTexture2D::SetRegion(uint32_t x, uint32_t y, const Texture& texture, uint32_t border)
+{
+	if (x < border || y < border || x + texture.GetWidth() + border > m_Width || y + texture.GetHeight() + border > m_Height)
+		return false;
+
+	m_Generation++;
+	return true;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void NullTexture2D::Bind(uint32_t slot) const
+{
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+std::string NullTexture2D::GetName() const
+{
+	return m_Filepath.filename().string();
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+uint32_t NullTexture2D::GetRendererID() const
+{
+	return m_RendererID;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void NullTexture2D::Reload()
+{
+	if (!m_Filepath.empty())
+		ReadImageSize();
+	m_Generation++;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+bool NullTexture2D::operator==(const Texture& other) const
+{
+	return m_RendererID == other.GetRendererID();
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+bool NullTexture2D::ReadImageSize()
+{
+	// Only the header is read, the pixels are never needed
+	int width, height, channels;
+	if (!stbi_info(m_Filepath.string().c_str(), &width, &height, &channels))
+		return false;
+
+	m_Width = (uint32_t)width;
+	m_Height = (uint32_t)height;
+	return true;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+NullTexture2DArray::NullTexture2DArray(uint32_t width, uint32_t height, uint32_t layers, FilterMethod filterMethod, WrapMethod wrapMethod)
+	:m_Width(width), m_Height(height), m_Layers(layers), m_RendererID(NextRendererID())
+{
+	m_FilterMethod = filterMethod;
+	m_WrapMethod = wrapMethod;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void NullTexture2DArray::SetData(const void* data)
+{
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+bool NullTexture2DArray::SetLayer(uint32_t layer, const Texture& texture)
+{
+	return layer < m_Layers && texture.GetWidth() == m_Width && texture.GetHeight() == m_Height;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void NullTexture2DArray::Bind(uint32_t slot) const
+{
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+std::string NullTexture2DArray::GetName() const
+{
+	return "Texture Array";
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+uint32_t NullTexture2DArray::GetRendererID() const
+{
+	return m_RendererID;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void NullTexture2DArray::Reload()
+{
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+bool NullTexture2DArray::operator==(const Texture& other) const
+{
+	return m_RendererID == other.GetRendererID();
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Renderer/Texture.h"
+
+// Texture for the None renderer API, only the size is kept so sprites and tilemaps lay out as they would on the GPU
+class NullTexture2D : public Texture2D
+{
+public:
+	NullTexture2D(uint32_t width, uint32_t height);
+	NullTexture2D(const std::filesystem::path& filepath);
+	virtual ~NullTexture2D() = default;
+
+	virtual uint32_t GetWidth() const override { return m_Width; }
+	virtual uint32_t GetHeight() const override { return m_Height; }
+
+	virtual void SetData(const void* data) override;
+	virtual bool SetRegion(uint32_t x, uint32_t y, const Texture& texture, uint32_t border = 0) override;
+
+	virtual void Bind(uint32_t slot) const override;
+
+	virtual std::string GetName() const override;
+
+	virtual uint32_t GetRendererID() const override;
+
+	virtual void Reload() override;
+
+	virtual bool operator==(const Texture& other) const override;
+private:
+	bool ReadImageSize();
+
+	uint32_t m_Width, m_Height;
+
+	uint32_t m_RendererID;
+};
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Texture array for the None renderer API, every layer can be set so quads batch the same as on the GPU
+class NullTexture2DArray : public Texture2DArray
+{
+public:
+	NullTexture2DArray(uint32_t width, uint32_t height, uint32_t layers, FilterMethod filterMethod, WrapMethod wrapMethod);
+	virtual ~NullTexture2DArray() = default;
+
+	virtual uint32_t GetWidth() const override { return m_Width; }
+	virtual uint32_t GetHeight() const override { return m_Height; }
+	virtual uint32_t GetLayerCount() const override { return m_Layers; }
+
+	virtual void SetData(const void* data) override;
+	virtual bool SetLayer(uint32_t layer, const Texture& texture) override;
+
+	virtual void Bind(uint32_t slot) const override;
+
+	virtual std::string GetName() const override;
+
+	virtual uint32_t GetRendererID() const override;
+
+	virtual void Reload() override;
+
+	virtual bool operator==(const Texture& other) const override;
+private:
+	uint32_t m_Width, m_Height, m_Layers;
+
+	uint32_t m_RendererID;
+};
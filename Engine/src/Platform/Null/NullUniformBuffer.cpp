@@ -0,0 +1,14 @@
+#include "stdafx.h"
+#include "NullUniformBuffer.h"
+
+NullUniformBuffer::NullUniformBuffer(uint32_t size, uint32_t binding)
+	:m_Size(size), m_Binding(binding)
+{
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void NullUniformBuffer::SetData(const void* data, uint32_t size, uint32_t offset)
+{
+	CORE_ASSERT(offset + size <= m_Size, "Uniform buffer data out of range");
+}
@@ -5,13 +5,23 @@
 #include "Logging/Instrumentor.h"
 #include <glad/glad.h>
 
-OpenGLVertexBuffer::OpenGLVertexBuffer(uint32_t size)
+OpenGLVertexBuffer::OpenGLVertexBuffer(uint32_t size, bool persistent)
 	:m_Size(size)
 {
 	PROFILE_FUNCTION();
     glGenBuffers(1, &m_RendererID);
     glBindBuffer(GL_ARRAY_BUFFER, m_RendererID);
-    glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+	if (persistent)
+	{
+		// Mapped for the life of the buffer, coherent so writes don't need flushing before a draw
+		const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glBufferStorage(GL_ARRAY_BUFFER, size, nullptr, flags);
+		m_MappedData = glMapBufferRange(GL_ARRAY_BUFFER, 0, size, flags);
+	}
+	else
+	{
+		glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+	}
 	m_VertexArray = CreateRef<OpenGLVertexArray>();
 }
 
@@ -37,6 +47,12 @@ void OpenGLVertexBuffer::SetData(const void* data, uint32_t size, uint32_t offse
 	CORE_ASSERT(size <= m_Size, "Size must be less than the buffer size");
 
 	PROFILE_FUNCTION();
+	if (m_MappedData)
+	{
+		// Immutable storage can only be written through the mapping
+		memcpy((uint8_t*)m_MappedData + offset, data, size);
+		return;
+	}
 	glBindBuffer(GL_ARRAY_BUFFER, m_RendererID);
 	glBufferSubData(GL_ARRAY_BUFFER, offset, size, data);
 }
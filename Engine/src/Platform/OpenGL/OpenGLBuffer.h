@@ -6,7 +6,7 @@
 class OpenGLVertexBuffer : public VertexBuffer
 {
 public:
-	OpenGLVertexBuffer(uint32_t size);
+	OpenGLVertexBuffer(uint32_t size, bool persistent = false);
 	OpenGLVertexBuffer(void* vertices, uint32_t size);
 	~OpenGLVertexBuffer();
 
@@ -20,10 +20,12 @@ public:
 	virtual void UnBind() const override;
 
 	virtual uint32_t GetSize() override { return m_Size; }
+	virtual void* GetMappedData() override { return m_MappedData; }
 private:
 	uint32_t m_RendererID;
 	BufferLayout m_Layout;
 	uint32_t m_Size;
+	void* m_MappedData = nullptr;
 
 	Ref<OpenGLVertexArray> m_VertexArray;
 };
@@ -63,26 +63,67 @@ void OpenGLRendererAPI::ClearDepth()
 	glClear(GL_DEPTH_BUFFER_BIT);
 }
 
+static GLenum DrawModeToOpenGLMode(DrawMode drawMode)
+{
+	switch (drawMode)
+	{
+	case DrawMode::POINTS: return GL_POINTS;
+	case DrawMode::WIREFRAME: return GL_LINES;
+	case DrawMode::FILL: return GL_TRIANGLES;
+	default: return GL_TRIANGLES;
+	}
+}
+
+// The start index is an offset into the bound index buffer, the same for instanced and single draws
+static const void* IndexBufferOffset(uint32_t startIndex)
+{
+	return (const void*)((size_t)startIndex * sizeof(uint32_t));
+}
+
 void OpenGLRendererAPI::DrawIndexed(uint32_t indexCount, uint32_t indexStart, uint32_t vertexOffset, bool backFaceCull, DrawMode drawMode)
 {
 	if (!backFaceCull)
 		glDisable(GL_CULL_FACE);
 
-	GLuint mode;
-	switch (drawMode)
-	{
-	case DrawMode::POINTS: mode = GL_POINTS; break;
-	case DrawMode::WIREFRAME: mode = GL_LINES; break;
-	case DrawMode::FILL: mode = GL_TRIANGLES; break;
-	default: mode = GL_TRIANGLES; break;
-	}
+	glDrawElementsBaseVertex(DrawModeToOpenGLMode(drawMode), indexCount, GL_UNSIGNED_INT, IndexBufferOffset(indexStart), vertexOffset);
+	if (!backFaceCull)
+		glEnable(GL_CULL_FACE);
+}
 
-	glDrawRangeElementsBaseVertex(mode, indexStart, indexStart + indexCount, indexCount, GL_UNSIGNED_INT, nullptr, vertexOffset);
+void OpenGLRendererAPI::DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex, uint32_t vertexOffset, bool backFaceCull, DrawMode drawMode)
+{
+	if (!backFaceCull)
+		glDisable(GL_CULL_FACE);
+
+	glDrawElementsInstancedBaseVertex(DrawModeToOpenGLMode(drawMode), indexCount, GL_UNSIGNED_INT, IndexBufferOffset(startIndex), instanceCount, vertexOffset);
 	if (!backFaceCull)
 		glEnable(GL_CULL_FACE);
 }
 
-void OpenGLRendererAPI::DrawLines(uint32_t vertexCount)
+void OpenGLRendererAPI::DrawLines(uint32_t vertexCount, uint32_t firstVertex)
+{
+	glDrawArrays(GL_LINES, firstVertex, vertexCount);
+}
+
+uint64_t OpenGLRendererAPI::InsertFence()
+{
+	return (uint64_t)(uintptr_t)glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+bool OpenGLRendererAPI::WaitFence(uint64_t fence)
+{
+	GLsync sync = (GLsync)(uintptr_t)fence;
+	if (glClientWaitSync(sync, 0, 0) != GL_TIMEOUT_EXPIRED)
+		return false;
+
+	// Flush the first time round so the fence is sure to be reached
+	GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+	while (glClientWaitSync(sync, flags, 1000000) == GL_TIMEOUT_EXPIRED)
+		flags = 0;
+	return true;
+}
+
+void OpenGLRendererAPI::DeleteFence(uint64_t fence)
 {
-	glDrawArrays(GL_LINES, 0, vertexCount);
+	glDeleteSync((GLsync)(uintptr_t)fence);
 }
\ No newline at end of file
@@ -13,5 +13,10 @@ public:
 	virtual void ClearDepth() override;
 
 	virtual void DrawIndexed(uint32_t indexCount, uint32_t indexStart = 0, uint32_t vertexOffset = 0, bool backFaceCull = false, DrawMode drawMode = DrawMode::FILL) override;
-	virtual void DrawLines(uint32_t vertexCount) override;
+	virtual void DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex = 0, uint32_t vertexOffset = 0, bool backFaceCull = false, DrawMode drawMode = DrawMode::FILL) override;
+	virtual void DrawLines(uint32_t vertexCount, uint32_t firstVertex) override;
+
+	virtual uint64_t InsertFence() override;
+	virtual bool WaitFence(uint64_t fence) override;
+	virtual void DeleteFence(uint64_t fence) override;
 };
\ No newline at end of file
@@ -2,45 +2,82 @@
 #include "OpenGLTexture.h"
 #include "Core/Application.h"
 #include "Logging/Instrumentor.h"
+#include "Renderer/ImageLoader.h"
 
-#include <stb/stb_image.h>
 #include <filesystem>
 
-void OpenGLTexture2D::SetFilteringAndWrappingMethod()
+static void SetFilteringAndWrappingMethod(GLuint rendererID, Texture::FilterMethod filterMethod, Texture::WrapMethod wrapMethod)
 {
-	switch (m_FilterMethod)
+	switch (filterMethod)
 	{
 	case Texture::FilterMethod::Linear:
-		glTextureParameteri(m_RendererID, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTextureParameteri(m_RendererID, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTextureParameteri(rendererID, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTextureParameteri(rendererID, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 		break;
 	case Texture::FilterMethod::Nearest:
-		glTextureParameteri(m_RendererID, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-		glTextureParameteri(m_RendererID, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTextureParameteri(rendererID, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTextureParameteri(rendererID, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 		break;
 	default:
 		break;
 	}
 
-	switch (m_WrapMethod)
+	switch (wrapMethod)
 	{
 	case Texture::WrapMethod::Clamp:
-		glTextureParameteri(m_RendererID, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-		glTextureParameteri(m_RendererID, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTextureParameteri(rendererID, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTextureParameteri(rendererID, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 		break;
 	case Texture::WrapMethod::Mirror:
-		glTextureParameteri(m_RendererID, GL_TEXTURE_WRAP_S, GL_MIRRORED_REPEAT);
-		glTextureParameteri(m_RendererID, GL_TEXTURE_WRAP_T, GL_MIRRORED_REPEAT);
+		glTextureParameteri(rendererID, GL_TEXTURE_WRAP_S, GL_MIRRORED_REPEAT);
+		glTextureParameteri(rendererID, GL_TEXTURE_WRAP_T, GL_MIRRORED_REPEAT);
 		break;
 	case Texture::WrapMethod::Repeat:
-		glTextureParameteri(m_RendererID, GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glTextureParameteri(m_RendererID, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		glTextureParameteri(rendererID, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTextureParameteri(rendererID, GL_TEXTURE_WRAP_T, GL_REPEAT);
 		break;
 	default:
 		break;
 	}
 }
 
+// Copy an RGBA8 compatible texture into part of another, without leaving the GPU when the formats match
+static bool CopyTextureImage(const OpenGLTexture2D& source, GLuint destination, GLenum target, uint32_t x, uint32_t y, uint32_t z)
+{
+	const GLsizei width = (GLsizei)source.GetWidth();
+	const GLsizei height = (GLsizei)source.GetHeight();
+
+	switch (source.GetInternalFormat())
+	{
+	case GL_RGBA8:
+		glCopyImageSubData(source.GetRendererID(), GL_TEXTURE_2D, 0, 0, 0, 0,
+			destination, target, 0, x, y, z, width, height, 1);
+		return true;
+	case GL_R8UI:
+	case GL_R16UI:
+	case GL_R32UI:
+		return false;
+	default:
+	{
+		// Converted to 8 bit RGBA as it is read back
+		std::vector<uint8_t> pixels((size_t)width * height * 4);
+		glPixelStorei(GL_PACK_ALIGNMENT, 4);
+		glGetTextureImage(source.GetRendererID(), 0, GL_RGBA, GL_UNSIGNED_BYTE, (GLsizei)pixels.size(), pixels.data());
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		if (target == GL_TEXTURE_2D_ARRAY)
+			glTextureSubImage3D(destination, 0, x, y, z, width, height, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+		else
+			glTextureSubImage2D(destination, 0, x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+		return true;
+	}
+	}
+}
+
+void OpenGLTexture2D::SetFilteringAndWrappingMethod()
+{
+	::SetFilteringAndWrappingMethod(m_RendererID, m_FilterMethod, m_WrapMethod);
+}
+
 OpenGLTexture2D::OpenGLTexture2D(uint32_t width, uint32_t height, Format format, const void* pixels)
 	:m_Width(width), m_Height(height)
 {
@@ -106,10 +143,41 @@ void OpenGLTexture2D::SetData(const void* data)
 	PROFILE_FUNCTION();
 
 	m_Filepath = "";
+	m_Generation++;
 
 	glTextureSubImage2D(m_RendererID, 0, 0, 0, m_Width, m_Height, m_DataFormat, m_Type, data);
 }
 
+bool OpenGLTexture2D::SetRegion(uint32_t x, uint32_t y, const Texture& texture, uint32_t border)
+{
+	PROFILE_FUNCTION();
+
+	const OpenGLTexture2D* texture2D = dynamic_cast<const OpenGLTexture2D*>(&texture);
+	if (!texture2D || m_InternalFormat != GL_RGBA8 || x < border || y < border
+		|| x + texture2D->GetWidth() + border > m_Width || y + texture2D->GetHeight() + border > m_Height)
+		return false;
+
+	if (!CopyTextureImage(*texture2D, m_RendererID, GL_TEXTURE_2D, x, y, 0))
+		return false;
+
+	// Spread the edges out from the copy one texel at a time, the columns first so the rows carry the corners
+	const GLsizei width = (GLsizei)texture2D->GetWidth();
+	const GLsizei height = (GLsizei)texture2D->GetHeight();
+	for (uint32_t i = 1; i <= border; i++)
+	{
+		glCopyImageSubData(m_RendererID, GL_TEXTURE_2D, 0, x, y, 0, m_RendererID, GL_TEXTURE_2D, 0, x - i, y, 0, 1, height, 1);
+		glCopyImageSubData(m_RendererID, GL_TEXTURE_2D, 0, x + width - 1, y, 0, m_RendererID, GL_TEXTURE_2D, 0, x + width - 1 + i, y, 0, 1, height, 1);
+	}
+	for (uint32_t i = 1; i <= border; i++)
+	{
+		glCopyImageSubData(m_RendererID, GL_TEXTURE_2D, 0, x - border, y, 0, m_RendererID, GL_TEXTURE_2D, 0, x - border, y - i, 0, width + 2 * border, 1, 1);
+		glCopyImageSubData(m_RendererID, GL_TEXTURE_2D, 0, x - border, y + height - 1, 0, m_RendererID, GL_TEXTURE_2D, 0, x - border, y + height - 1 + i, 0, width + 2 * border, 1, 1);
+	}
+
+	m_Generation++;
+	return true;
+}
+
 void OpenGLTexture2D::Bind(uint32_t slot) const
 {
 	PROFILE_FUNCTION();
@@ -184,24 +252,17 @@ bool OpenGLTexture2D::LoadTextureFromFile()
 {
 	PROFILE_FUNCTION();
 
-	int width, height, channels;
-	stbi_set_flip_vertically_on_load(1);
-	stbi_uc* data = nullptr;
-	{
-		PROFILE_SCOPE("stbi Load Image OpenGLTexture2D(const std::string&)");
-		data = stbi_load(m_Filepath.string().c_str(), &width, &height, &channels, 0);
-	}
+	Image image;
+	bool loaded = ImageLoader::Load(m_Filepath, image);
 
-	CORE_ASSERT(data, "Failed to load image! " + m_Filepath.string());
+	CORE_ASSERT(loaded, "Failed to load image! " + m_Filepath.string());
 
-	if (!data)
-	{
-		ENGINE_ERROR("stb image failure: {0}", stbi_failure_reason());
+	if (!loaded)
 		return false;
-	}
 
-	m_Width = (uint32_t)width;
-	m_Height = (uint32_t)height;
+	m_Width = image.width;
+	m_Height = image.height;
+	uint32_t channels = image.channels;
 
 	GLenum internalFormat = 0, dataFormat = 0;
 	if (channels == 4)
@@ -242,9 +303,84 @@ bool OpenGLTexture2D::LoadTextureFromFile()
 	else
 		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
-	glTextureSubImage2D(m_RendererID, 0, 0, 0, m_Width, m_Height, m_DataFormat, m_Type, data);
-
-	stbi_image_free(data);
+	glTextureSubImage2D(m_RendererID, 0, 0, 0, m_Width, m_Height, m_DataFormat, m_Type, image.pixels.data());
+	m_Generation++;
 
 	return true;
 }
+
+OpenGLTexture2DArray::OpenGLTexture2DArray(uint32_t width, uint32_t height, uint32_t layers, FilterMethod filterMethod, WrapMethod wrapMethod)
+	:m_Width(width), m_Height(height), m_Layers(layers)
+{
+	PROFILE_FUNCTION();
+
+	m_FilterMethod = filterMethod;
+	m_WrapMethod = wrapMethod;
+
+	glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &m_RendererID);
+	glTextureStorage3D(m_RendererID, 1, GL_RGBA8, m_Width, m_Height, m_Layers);
+	::SetFilteringAndWrappingMethod(m_RendererID, m_FilterMethod, m_WrapMethod);
+}
+
+OpenGLTexture2DArray::~OpenGLTexture2DArray()
+{
+	PROFILE_FUNCTION();
+	if (Application::Get().IsRunning())
+		glDeleteTextures(1, &m_RendererID);
+}
+
+void OpenGLTexture2DArray::SetData(const void* data)
+{
+	PROFILE_FUNCTION();
+
+	glTextureSubImage3D(m_RendererID, 0, 0, 0, 0, m_Width, m_Height, m_Layers, GL_RGBA, GL_UNSIGNED_BYTE, data);
+	m_Generation++;
+}
+
+bool OpenGLTexture2DArray::SetLayer(uint32_t layer, const Texture& texture)
+{
+	PROFILE_FUNCTION();
+
+	const OpenGLTexture2D* texture2D = dynamic_cast<const OpenGLTexture2D*>(&texture);
+	if (!texture2D || layer >= m_Layers || texture2D->GetWidth() != m_Width || texture2D->GetHeight() != m_Height)
+		return false;
+
+	return CopyTextureImage(*texture2D, m_RendererID, GL_TEXTURE_2D_ARRAY, 0, 0, layer);
+}
+
+void OpenGLTexture2DArray::Bind(uint32_t slot) const
+{
+	PROFILE_FUNCTION();
+	glBindTextureUnit(slot, m_RendererID);
+}
+
+std::string OpenGLTexture2DArray::GetName() const
+{
+	return "Texture Array";
+}
+
+uint32_t OpenGLTexture2DArray::GetRendererID() const
+{
+	return m_RendererID;
+}
+
+void OpenGLTexture2DArray::Reload()
+{
+}
+
+bool OpenGLTexture2DArray::operator==(const Texture& other) const
+{
+	return m_RendererID == other.GetRendererID();
+}
+
+void OpenGLTexture2DArray::SetFilterMethod(FilterMethod filterMethod)
+{
+	m_FilterMethod = filterMethod;
+	::SetFilteringAndWrappingMethod(m_RendererID, m_FilterMethod, m_WrapMethod);
+}
+
+void OpenGLTexture2DArray::SetWrapMethod(WrapMethod wrapMethod)
+{
+	m_WrapMethod = wrapMethod;
+	::SetFilteringAndWrappingMethod(m_RendererID, m_FilterMethod, m_WrapMethod);
+}
@@ -14,6 +14,7 @@ public:
 	virtual uint32_t GetHeight() const override { return m_Height; }
 
 	virtual void SetData(const void* data) override;
+	virtual bool SetRegion(uint32_t x, uint32_t y, const Texture& texture, uint32_t border = 0) override;
 
 	virtual void Bind(uint32_t slot) const override;
 
@@ -27,6 +28,8 @@ public:
 
 	virtual void SetFilterMethod(FilterMethod filterMethod) override;
 	virtual void SetWrapMethod(WrapMethod wrapMethod) override;
+
+	GLenum GetInternalFormat() const { return m_InternalFormat; }
 private:
 	// sets the texture to be the null texture
 	void NullTexture();
@@ -40,3 +43,34 @@ private:
 
 	GLenum m_InternalFormat, m_DataFormat, m_Type;
 };
+
+class OpenGLTexture2DArray : public Texture2DArray
+{
+public:
+	OpenGLTexture2DArray(uint32_t width, uint32_t height, uint32_t layers, FilterMethod filterMethod, WrapMethod wrapMethod);
+	virtual ~OpenGLTexture2DArray();
+
+	virtual uint32_t GetWidth() const override { return m_Width; }
+	virtual uint32_t GetHeight() const override { return m_Height; }
+	virtual uint32_t GetLayerCount() const override { return m_Layers; }
+
+	virtual void SetData(const void* data) override;
+	virtual bool SetLayer(uint32_t layer, const Texture& texture) override;
+
+	virtual void Bind(uint32_t slot) const override;
+
+	virtual std::string GetName() const override;
+
+	virtual uint32_t GetRendererID() const override;
+
+	virtual void Reload() override;
+
+	virtual bool operator==(const Texture& other) const override;
+
+	virtual void SetFilterMethod(FilterMethod filterMethod) override;
+	virtual void SetWrapMethod(WrapMethod wrapMethod) override;
+private:
+	uint32_t m_Width, m_Height, m_Layers;
+
+	uint32_t m_RendererID;
+};
@@ -0,0 +1,107 @@
+#include "stdafx.h"
+#include "SoftwareBuffer.h"
+#include "SoftwareRasterizer.h"
+
+SoftwareVertexBuffer::SoftwareVertexBuffer(uint32_t size)
+	:m_Data(size, 0)
+{
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+SoftwareVertexBuffer::SoftwareVertexBuffer(void* vertices, uint32_t size)
+	:m_Data((uint8_t*)vertices, (uint8_t*)vertices + size)
+{
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+SoftwareVertexBuffer::~SoftwareVertexBuffer()
+{
+	SoftwareRasterizer::Unbind(this);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareVertexBuffer::SetLayout(const BufferLayout& layout)
+{
+	m_Layout = layout;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+const BufferLayout& SoftwareVertexBuffer::GetLayout() const
+{
+	return m_Layout;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareVertexBuffer::SetData(const void* data, uint32_t size, uint32_t offset)
+{
+	CORE_ASSERT(offset + size <= m_Data.size(), "Vertex buffer data out of range");
+	memcpy(m_Data.data() + offset, data, size);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareVertexBuffer::SetData(const void* data)
+{
+	memcpy(m_Data.data(), data, m_Data.size());
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+uint32_t SoftwareVertexBuffer::GetSize()
+{
+	return (uint32_t)m_Data.size();
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareVertexBuffer::Bind() const
+{
+	SoftwareRasterizer::BindVertexBuffer(this);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareVertexBuffer::UnBind() const
+{
+	SoftwareRasterizer::BindVertexBuffer(nullptr);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+SoftwareIndexBuffer::SoftwareIndexBuffer(uint32_t* indices, uint32_t count)
+	:m_Indices(indices, indices + count)
+{
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+SoftwareIndexBuffer::~SoftwareIndexBuffer()
+{
+	SoftwareRasterizer::Unbind(this);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareIndexBuffer::Bind() const
+{
+	SoftwareRasterizer::BindIndexBuffer(this);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareIndexBuffer::UnBind() const
+{
+	SoftwareRasterizer::BindIndexBuffer(nullptr);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+uint32_t SoftwareIndexBuffer::GetCount() const
+{
+	return (uint32_t)m_Indices.size();
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Renderer/Buffer.h"
+
+// Buffers held in system memory for the software renderer
+class SoftwareVertexBuffer : public VertexBuffer
+{
+public:
+	SoftwareVertexBuffer(uint32_t size);
+	SoftwareVertexBuffer(void* vertices, uint32_t size);
+	~SoftwareVertexBuffer();
+
+	// Inherited via VertexBuffer
+	virtual void SetLayout(const BufferLayout& layout) override;
+	virtual const BufferLayout& GetLayout() const override;
+	virtual void SetData(const void* data, uint32_t size, uint32_t offset) override;
+	virtual void SetData(const void* data) override;
+	virtual uint32_t GetSize() override;
+	virtual void* GetMappedData() override { return m_Data.data(); }
+	virtual void Bind() const override;
+	virtual void UnBind() const override;
+
+	const uint8_t* GetData() const { return m_Data.data(); }
+	size_t GetDataSize() const { return m_Data.size(); }
+private:
+	std::vector<uint8_t> m_Data;
+	BufferLayout m_Layout;
+};
+
+class SoftwareIndexBuffer : public IndexBuffer
+{
+public:
+	SoftwareIndexBuffer(uint32_t* indices, uint32_t count);
+	~SoftwareIndexBuffer();
+
+	// Inherited via IndexBuffer
+	virtual void Bind() const override;
+	virtual void UnBind() const override;
+	virtual uint32_t GetCount() const override;
+
+	const uint32_t* GetData() const { return m_Indices.data(); }
+	size_t GetDataCount() const { return m_Indices.size(); }
+
+private:
+	std::vector<uint32_t> m_Indices;
+};
@@ -0,0 +1,171 @@
+#include "stdafx.h"
+#include "SoftwareFrameBuffer.h"
+#include "SoftwareRasterizer.h"
+
+#include <fstream>
+
+SoftwareFrameBuffer::SoftwareFrameBuffer(const FrameBufferSpecification& specification)
+	:m_Specification(specification)
+{
+	for (const FrameBufferTextureSpecification& attachment : m_Specification.attachments.attachments)
+	{
+		if (FrameBuffer::IsDepthFormat(attachment.textureFormat))
+			m_HasDepth = true;
+		else
+			m_Attachments.push_back({ attachment.textureFormat, {} });
+	}
+
+	Generate();
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+SoftwareFrameBuffer::~SoftwareFrameBuffer()
+{
+	SoftwareRasterizer::Unbind(this);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareFrameBuffer::Bind()
+{
+	SoftwareRasterizer::BindTarget(this);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareFrameBuffer::UnBind()
+{
+	SoftwareRasterizer::BindTarget(nullptr);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareFrameBuffer::Generate()
+{
+	const size_t size = (size_t)m_Specification.width * m_Specification.height;
+	for (Attachment& attachment : m_Attachments)
+		attachment.pixels.assign(size, 0);
+
+	if (m_HasDepth)
+		m_Depth.assign(size, 1.0f);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareFrameBuffer::Destroy()
+{
+	for (Attachment& attachment : m_Attachments)
+		attachment.pixels.clear();
+	m_Depth.clear();
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareFrameBuffer::Resize(uint32_t width, uint32_t height)
+{
+	if (width == 0 || height == 0 || width > 8192 || height > 8192)
+	{
+		ENGINE_WARN("Attempted to resize frame buffer to {0}, {1}", width, height);
+		return;
+	}
+
+	m_Specification.width = width;
+	m_Specification.height = height;
+
+	Generate();
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+int SoftwareFrameBuffer::ReadPixel(uint32_t attachmentIndex, int x, int y)
+{
+	CORE_ASSERT(attachmentIndex < m_Attachments.size(), "Trying to access attachment that does not exist!");
+	if (x < 0 || y < 0 || x >= (int)m_Specification.width || y >= (int)m_Specification.height)
+		return -1;
+
+	return (int)m_Attachments[attachmentIndex].pixels[(size_t)y * m_Specification.width + x];
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+uint32_t SoftwareFrameBuffer::GetColourAttachment(size_t index)
+{
+	CORE_ASSERT(index < m_Attachments.size(), "Index out of range");
+	return 0;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareFrameBuffer::ClearAttachment(size_t index, int value)
+{
+	CORE_ASSERT(index < m_Attachments.size(), "Trying to access attachment that does not exist!");
+	std::fill(m_Attachments[index].pixels.begin(), m_Attachments[index].pixels.end(), (uint32_t)value);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareFrameBuffer::Clear(const Colour& colour, bool clearColour, bool clearDepth)
+{
+	if (clearColour)
+	{
+		auto toByte = [](float value) { return (uint32_t)(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f); };
+		uint32_t packed = toByte(colour.r) | (toByte(colour.g) << 8) | (toByte(colour.b) << 16) | (toByte(colour.a) << 24);
+
+		// Integer attachments aren't cleared by the clear colour, the same as glClear
+		for (Attachment& attachment : m_Attachments)
+		{
+			if (attachment.format != FrameBufferTextureFormat::RED_INTEGER)
+				std::fill(attachment.pixels.begin(), attachment.pixels.end(), packed);
+		}
+	}
+
+	if (clearDepth)
+		std::fill(m_Depth.begin(), m_Depth.end(), 1.0f);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+bool SoftwareFrameBuffer::WriteImage(const std::filesystem::path& filepath, size_t attachmentIndex) const
+{
+	if (attachmentIndex >= m_Attachments.size() || IsIntegerAttachment(attachmentIndex))
+	{
+		ENGINE_ERROR("Frame buffer attachment {0} can't be written as an image", attachmentIndex);
+		return false;
+	}
+
+	std::ofstream file(filepath, std::ios::out | std::ios::binary);
+	if (!file.good())
+	{
+		ENGINE_ERROR("Could not open {0} to write", filepath);
+		return false;
+	}
+
+	// TGA images start from the bottom left corner the same as the frame buffer
+	uint8_t header[18] = {};
+	header[2] = 2; // uncompressed true colour
+	header[12] = (uint8_t)(m_Specification.width & 0xff);
+	header[13] = (uint8_t)(m_Specification.width >> 8);
+	header[14] = (uint8_t)(m_Specification.height & 0xff);
+	header[15] = (uint8_t)(m_Specification.height >> 8);
+	header[16] = 32;
+	header[17] = 8; // alpha bits
+	file.write((const char*)header, sizeof(header));
+
+	const std::vector<uint32_t>& pixels = m_Attachments[attachmentIndex].pixels;
+	std::vector<uint8_t> row((size_t)m_Specification.width * 4);
+	for (uint32_t y = 0; y < m_Specification.height; y++)
+	{
+		for (uint32_t x = 0; x < m_Specification.width; x++)
+		{
+			uint32_t pixel = pixels[(size_t)y * m_Specification.width + x];
+			row[x * 4 + 0] = (uint8_t)((pixel >> 16) & 0xff);
+			row[x * 4 + 1] = (uint8_t)((pixel >> 8) & 0xff);
+			row[x * 4 + 2] = (uint8_t)(pixel & 0xff);
+			row[x * 4 + 3] = (uint8_t)(pixel >> 24);
+		}
+		file.write((const char*)row.data(), row.size());
+	}
+
+	return file.good();
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Renderer/FrameBuffer.h"
+#include "Core/Colour.h"
+
+// Frame buffer held in system memory for the software renderer, rows are stored from the bottom up as OpenGL does
+class SoftwareFrameBuffer : public FrameBuffer
+{
+public:
+	SoftwareFrameBuffer(const FrameBufferSpecification& specification);
+	virtual ~SoftwareFrameBuffer();
+
+	virtual void Bind() override;
+	virtual void UnBind() override;
+
+	virtual void Generate() override;
+	virtual void Destroy() override;
+
+	virtual void Resize(uint32_t width, uint32_t height) override;
+
+	virtual int ReadPixel(uint32_t attachmentIndex, int x, int y) override;
+
+	// There are no GPU textures, 0 is always returned
+	virtual uint32_t GetColourAttachment(size_t index = 0) override;
+
+	virtual const FrameBufferSpecification& GetSpecification() const override { return m_Specification; }
+
+	virtual void ClearAttachment(size_t index, int value) override;
+
+	// Clear every RGBA attachment to the colour and the depth to 1
+	void Clear(const Colour& colour, bool clearColour, bool clearDepth);
+
+	uint32_t GetWidth() const { return m_Specification.width; }
+	uint32_t GetHeight() const { return m_Specification.height; }
+
+	size_t GetColourAttachmentCount() const { return m_Attachments.size(); }
+	bool IsIntegerAttachment(size_t index) const { return m_Attachments[index].format == FrameBufferTextureFormat::RED_INTEGER; }
+
+	// RGBA with red in the lowest byte, or signed integers for RED_INTEGER attachments
+	uint32_t* GetAttachmentData(size_t index) { return m_Attachments[index].pixels.data(); }
+	const uint32_t* GetAttachmentData(size_t index) const { return m_Attachments[index].pixels.data(); }
+	float* GetDepthData() { return m_Depth.empty() ? nullptr : m_Depth.data(); }
+
+	// Write an RGBA attachment as an uncompressed 32 bit TGA image
+	bool WriteImage(const std::filesystem::path& filepath, size_t attachmentIndex = 0) const;
+
+private:
+	struct Attachment
+	{
+		FrameBufferTextureFormat format;
+		std::vector<uint32_t> pixels;
+	};
+
+	FrameBufferSpecification m_Specification;
+	std::vector<Attachment> m_Attachments;
+	std::vector<float> m_Depth;
+	bool m_HasDepth = false;
+};
@@ -0,0 +1,1171 @@
+#include "stdafx.h"
+#include "SoftwareRasterizer.h"
+#include "SoftwareBuffer.h"
+#include "SoftwareTexture.h"
+#include "SoftwareFrameBuffer.h"
+
+#include "Core/ThreadPool.h"
+#include "Logging/Instrumentor.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SOFTWARE_RASTERIZER_SSE
+#include <emmintrin.h>
+#endif
+
+using Program = SoftwareShader::Program;
+
+static constexpr uint32_t s_MaxVaryings = 9;
+static constexpr uint32_t s_MaxClipVertices = 12;
+static constexpr int s_SubpixelBits = 4;
+static constexpr int s_SubpixelScale = 1 << s_SubpixelBits;
+static constexpr int s_TileSize = 64;
+static constexpr size_t s_TrianglesPerChunk = 8192;
+static constexpr size_t s_TrianglesPerSetupBlock = 256;
+static constexpr uint32_t s_LineUniformBinding = 3; // the Line block of Renderer2D_Line.frag
+
+// Edges longer than this can't be stepped across a tile in 32 bit lanes
+static constexpr int64_t s_MaxSimdEdgeDelta = (int64_t)1 << 18;
+static constexpr int64_t s_SimdEdgeClamp = (int64_t)1 << 30;
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+struct ClipVertex
+{
+	float position[4];
+	float varyings[s_MaxVaryings];
+};
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+struct ShadedVertex
+{
+	ClipVertex clip;
+	float texIndex;
+	int entityId;
+};
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+struct ScreenVertex
+{
+	int64_t x, y; // fixed point
+	float z;
+	float invW;
+	float varyings[s_MaxVaryings]; // divided by w
+};
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Value of an attribute across the triangle relative to its first vertex, in pixels
+struct Gradient
+{
+	float base, dx, dy;
+
+	float At(float x, float y) const { return base + dx * x + dy * y; }
+};
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+struct Triangle
+{
+	// Edge functions in fixed point, C is biased so that a sample is inside when every edge is >= 0
+	int64_t A[3], B[3], C[3];
+	int minX, minY, maxX, maxY; // inclusive pixel bounds
+	bool simd;
+
+	float originX, originY;
+	Gradient z;
+	Gradient invW;
+	Gradient varyings[s_MaxVaryings];
+
+	float texIndex;
+	int entityId;
+};
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+struct RenderTarget
+{
+	uint32_t* colour = nullptr;
+	int32_t* entity = nullptr;
+	float* depth = nullptr;
+	int width = 0;
+	int height = 0;
+
+	// Viewport clipped to the target
+	int minX = 0, minY = 0, maxX = -1, maxY = -1;
+};
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+struct RasterizerData
+{
+	const SoftwareVertexBuffer* vertexBuffer = nullptr;
+	const SoftwareIndexBuffer* indexBuffer = nullptr;
+	Program program = Program::None;
+	std::array<const SoftwareTexture2D*, SoftwareRasterizer::MaxTextureSlots> textures = {};
+	std::array<const SoftwareTexture2DArray*, SoftwareRasterizer::MaxTextureSlots> textureArrays = {};
+	std::array<std::vector<uint8_t>, SoftwareRasterizer::MaxUniformBindings> uniforms;
+
+	Scope<SoftwareFrameBuffer> backBuffer;
+	SoftwareFrameBuffer* target = nullptr;
+
+	int viewportX = 0, viewportY = 0;
+	int viewportWidth = 0, viewportHeight = 0;
+	Colour clearColour;
+
+	int lineCaps = 0; // u_Caps of the line being drawn
+
+	std::vector<ShadedVertex> vertices;
+	std::vector<std::vector<Triangle>> setupBlocks;
+	std::vector<Triangle> triangles;
+	std::vector<std::vector<uint32_t>> bins;
+	std::vector<uint32_t> activeTiles;
+};
+
+static RasterizerData s_Data;
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static uint32_t VaryingCount(Program program)
+{
+	switch (program)
+	{
+	case Program::Quad:
+	case Program::QuadArray:
+	case Program::Text:
+		return 6; // colour, texture coordinates
+	case Program::Circle:
+		return 9; // colour, local position, thickness, fade
+	case Program::Line:
+		return 8; // colour, texture coordinates, width, length
+	case Program::HairLine:
+		return 4; // colour
+	default:
+		return 0;
+	}
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static void ReadAttribute(const uint8_t* vertex, const std::vector<BufferElement>& elements, size_t location, void* destination, size_t size)
+{
+	if (location < elements.size())
+		memcpy(destination, vertex + elements[location].offset, std::min(size, (size_t)elements[location].size));
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Multiply by a column major matrix, as the shaders do with the camera uniform buffer
+static void Transform(const float* matrix, const float* position, float* result)
+{
+#ifdef SOFTWARE_RASTERIZER_SSE
+	__m128 xy = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(matrix), _mm_set1_ps(position[0])), _mm_mul_ps(_mm_loadu_ps(matrix + 4), _mm_set1_ps(position[1])));
+	__m128 zw = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(matrix + 8), _mm_set1_ps(position[2])), _mm_loadu_ps(matrix + 12));
+	_mm_storeu_ps(result, _mm_add_ps(xy, zw));
+#else
+	for (int row = 0; row < 4; row++)
+		result[row] = matrix[row] * position[0] + matrix[4 + row] * position[1] + matrix[8 + row] * position[2] + matrix[12 + row];
+#endif
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static void ShadeVertex(Program program, const uint8_t* vertex, const std::vector<BufferElement>& elements, const float* viewProjection, ShadedVertex& out)
+{
+	float position[3] = { 0.0f, 0.0f, 0.0f };
+	float* varyings = out.clip.varyings;
+	out.texIndex = 0.0f;
+	out.entityId = -1;
+
+	ReadAttribute(vertex, elements, 0, position, sizeof(position));
+
+	switch (program)
+	{
+	case Program::Quad:
+	case Program::QuadArray:
+	case Program::Text:
+		ReadAttribute(vertex, elements, 1, varyings, sizeof(float) * 4);
+		ReadAttribute(vertex, elements, 2, varyings + 4, sizeof(float) * 2);
+		ReadAttribute(vertex, elements, 3, &out.texIndex, sizeof(float));
+		ReadAttribute(vertex, elements, 4, &out.entityId, sizeof(int));
+		break;
+	case Program::Circle:
+		ReadAttribute(vertex, elements, 2, varyings, sizeof(float) * 4);
+		ReadAttribute(vertex, elements, 1, varyings + 4, sizeof(float) * 3);
+		ReadAttribute(vertex, elements, 3, varyings + 7, sizeof(float));
+		ReadAttribute(vertex, elements, 4, varyings + 8, sizeof(float));
+		ReadAttribute(vertex, elements, 5, &out.entityId, sizeof(int));
+		break;
+	case Program::Line:
+		ReadAttribute(vertex, elements, 1, varyings, sizeof(float) * 4);
+		ReadAttribute(vertex, elements, 2, varyings + 4, sizeof(float) * 2);
+		ReadAttribute(vertex, elements, 3, varyings + 6, sizeof(float));
+		ReadAttribute(vertex, elements, 4, varyings + 7, sizeof(float));
+		break;
+	case Program::HairLine:
+		ReadAttribute(vertex, elements, 1, varyings, sizeof(float) * 4);
+		ReadAttribute(vertex, elements, 2, &out.entityId, sizeof(int));
+		break;
+	default:
+		break;
+	}
+
+	// The line vertices are already in clip space
+	if (program == Program::Line)
+	{
+		out.clip.position[0] = position[0];
+		out.clip.position[1] = position[1];
+		out.clip.position[2] = position[2];
+		out.clip.position[3] = 1.0f;
+	}
+	else
+	{
+		Transform(viewProjection, position, out.clip.position);
+	}
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static void ShadeVertices(Program program, uint32_t first, uint32_t count)
+{
+	PROFILE_FUNCTION();
+
+	const SoftwareVertexBuffer* vertexBuffer = s_Data.vertexBuffer;
+	const std::vector<BufferElement>& elements = vertexBuffer->GetLayout().GetElements();
+	const uint32_t stride = vertexBuffer->GetLayout().GetStride();
+	const uint8_t* data = vertexBuffer->GetData();
+
+	float viewProjection[16] = { 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f };
+	const std::vector<uint8_t>& camera = s_Data.uniforms[0];
+	if (camera.size() >= sizeof(viewProjection))
+		memcpy(viewProjection, camera.data(), sizeof(viewProjection));
+
+	s_Data.vertices.resize(count);
+	ThreadPool::ParallelFor(count, 1024, [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+				ShadeVertex(program, data + (size_t)(first + i) * stride, elements, viewProjection, s_Data.vertices[i]);
+		});
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static float PlaneDistance(const ClipVertex& vertex, int plane)
+{
+	const float* p = vertex.position;
+	switch (plane)
+	{
+	case 0: return p[3] + p[0];
+	case 1: return p[3] - p[0];
+	case 2: return p[3] + p[1];
+	case 3: return p[3] - p[1];
+	case 4: return p[3] + p[2];
+	default: return p[3] - p[2];
+	}
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static uint32_t Outcode(const ClipVertex& vertex)
+{
+	uint32_t code = 0;
+	for (int plane = 0; plane < 6; plane++)
+	{
+		if (PlaneDistance(vertex, plane) < 0.0f)
+			code |= 1 << plane;
+	}
+	return code;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static ClipVertex Lerp(const ClipVertex& a, const ClipVertex& b, float t, uint32_t varyingCount)
+{
+	ClipVertex result;
+	for (int i = 0; i < 4; i++)
+		result.position[i] = a.position[i] + (b.position[i] - a.position[i]) * t;
+	for (uint32_t i = 0; i < varyingCount; i++)
+		result.varyings[i] = a.varyings[i] + (b.varyings[i] - a.varyings[i]) * t;
+	return result;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Sutherland-Hodgman against the planes the vertices are outside of, returns the number of vertices left
+static uint32_t ClipPolygon(ClipVertex* polygon, uint32_t count, uint32_t planes, uint32_t varyingCount)
+{
+	ClipVertex scratch[s_MaxClipVertices];
+
+	for (int plane = 0; plane < 6 && count > 0; plane++)
+	{
+		if (!(planes & (1 << plane)))
+			continue;
+
+		uint32_t outputCount = 0;
+		for (uint32_t i = 0; i < count; i++)
+		{
+			const ClipVertex& current = polygon[i];
+			const ClipVertex& next = polygon[(i + 1) % count];
+			float currentDistance = PlaneDistance(current, plane);
+			float nextDistance = PlaneDistance(next, plane);
+
+			if (currentDistance >= 0.0f)
+				scratch[outputCount++] = current;
+
+			if ((currentDistance >= 0.0f) != (nextDistance >= 0.0f))
+				scratch[outputCount++] = Lerp(current, next, currentDistance / (currentDistance - nextDistance), varyingCount);
+		}
+
+		count = outputCount;
+		std::copy(scratch, scratch + count, polygon);
+	}
+	return count;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static ScreenVertex ToScreen(const ClipVertex& vertex, uint32_t varyingCount)
+{
+	ScreenVertex result;
+	result.invW = 1.0f / vertex.position[3];
+
+	float x = (vertex.position[0] * result.invW * 0.5f + 0.5f) * (float)s_Data.viewportWidth + (float)s_Data.viewportX;
+	float y = (vertex.position[1] * result.invW * 0.5f + 0.5f) * (float)s_Data.viewportHeight + (float)s_Data.viewportY;
+	result.x = (int64_t)std::llround(x * (float)s_SubpixelScale);
+	result.y = (int64_t)std::llround(y * (float)s_SubpixelScale);
+	result.z = vertex.position[2] * result.invW * 0.5f + 0.5f;
+
+	for (uint32_t i = 0; i < varyingCount; i++)
+		result.varyings[i] = vertex.varyings[i] * result.invW;
+	return result;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static int64_t FloorDiv(int64_t value, int64_t divisor)
+{
+	return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static void SetupTriangle(const ScreenVertex* v0, const ScreenVertex* v1, const ScreenVertex* v2, const ShadedVertex& provoking,
+	uint32_t varyingCount, bool backFaceCull, const RenderTarget& target, std::vector<Triangle>& output)
+{
+	int64_t area2 = (v1->x - v0->x) * (v2->y - v0->y) - (v2->x - v0->x) * (v1->y - v0->y);
+	if (area2 == 0)
+		return;
+
+	// Counter-clockwise triangles face the camera
+	if (area2 < 0)
+	{
+		if (backFaceCull)
+			return;
+		std::swap(v1, v2);
+		area2 = -area2;
+	}
+
+	// Pixel centres covered by the bounds of the triangle
+	int64_t minX = std::min({ v0->x, v1->x, v2->x });
+	int64_t minY = std::min({ v0->y, v1->y, v2->y });
+	int64_t maxX = std::max({ v0->x, v1->x, v2->x });
+	int64_t maxY = std::max({ v0->y, v1->y, v2->y });
+
+	Triangle triangle;
+	triangle.minX = std::max((int)FloorDiv(minX - s_SubpixelScale / 2 + s_SubpixelScale - 1, s_SubpixelScale), target.minX);
+	triangle.minY = std::max((int)FloorDiv(minY - s_SubpixelScale / 2 + s_SubpixelScale - 1, s_SubpixelScale), target.minY);
+	triangle.maxX = std::min((int)FloorDiv(maxX - s_SubpixelScale / 2, s_SubpixelScale), target.maxX);
+	triangle.maxY = std::min((int)FloorDiv(maxY - s_SubpixelScale / 2, s_SubpixelScale), target.maxY);
+	if (triangle.minX > triangle.maxX || triangle.minY > triangle.maxY)
+		return;
+
+	const ScreenVertex* vertices[3] = { v0, v1, v2 };
+	triangle.simd = true;
+	for (int edge = 0; edge < 3; edge++)
+	{
+		const ScreenVertex* a = vertices[(edge + 1) % 3];
+		const ScreenVertex* b = vertices[(edge + 2) % 3];
+		triangle.A[edge] = a->y - b->y;
+		triangle.B[edge] = b->x - a->x;
+		triangle.C[edge] = a->x * b->y - a->y * b->x;
+
+		// Samples exactly on an edge belong to one of the triangles sharing it
+		if (!(triangle.A[edge] > 0 || (triangle.A[edge] == 0 && triangle.B[edge] < 0)))
+			triangle.C[edge] -= 1;
+
+		if (std::abs(triangle.A[edge]) >= s_MaxSimdEdgeDelta || std::abs(triangle.B[edge]) >= s_MaxSimdEdgeDelta)
+			triangle.simd = false;
+	}
+
+	triangle.originX = (float)v0->x / (float)s_SubpixelScale;
+	triangle.originY = (float)v0->y / (float)s_SubpixelScale;
+
+	// Gradients of the barycentric weights of the second and third vertices per pixel
+	const double scale = (double)s_SubpixelScale / (double)area2;
+	const double b1dx = (double)triangle.A[1] * scale, b1dy = (double)triangle.B[1] * scale;
+	const double b2dx = (double)triangle.A[2] * scale, b2dy = (double)triangle.B[2] * scale;
+
+	auto makeGradient = [&](float q0, float q1, float q2)
+	{
+		double d1 = (double)q1 - (double)q0;
+		double d2 = (double)q2 - (double)q0;
+		return Gradient{ q0, (float)(d1 * b1dx + d2 * b2dx), (float)(d1 * b1dy + d2 * b2dy) };
+	};
+
+	triangle.z = makeGradient(v0->z, v1->z, v2->z);
+	triangle.invW = makeGradient(v0->invW, v1->invW, v2->invW);
+	for (uint32_t i = 0; i < varyingCount; i++)
+		triangle.varyings[i] = makeGradient(v0->varyings[i], v1->varyings[i], v2->varyings[i]);
+
+	triangle.texIndex = provoking.texIndex;
+	triangle.entityId = provoking.entityId;
+
+	output.push_back(triangle);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static void SetupTriangles(const uint32_t* indices, size_t triangleCount, uint32_t firstVertex, uint32_t varyingCount, bool backFaceCull, const RenderTarget& target)
+{
+	PROFILE_FUNCTION();
+
+	size_t blockCount = (triangleCount + s_TrianglesPerSetupBlock - 1) / s_TrianglesPerSetupBlock;
+	if (s_Data.setupBlocks.size() < blockCount)
+		s_Data.setupBlocks.resize(blockCount);
+
+	ThreadPool::ParallelFor(blockCount, 1, [&](size_t beginBlock, size_t endBlock)
+		{
+			for (size_t block = beginBlock; block < endBlock; block++)
+			{
+				std::vector<Triangle>& output = s_Data.setupBlocks[block];
+				output.clear();
+
+				size_t end = std::min((block + 1) * s_TrianglesPerSetupBlock, triangleCount);
+				for (size_t t = block * s_TrianglesPerSetupBlock; t < end; t++)
+				{
+					const ShadedVertex* corners[3];
+					for (int i = 0; i < 3; i++)
+						corners[i] = &s_Data.vertices[indices[t * 3 + i] - firstVertex];
+
+					uint32_t codes[3] = { Outcode(corners[0]->clip), Outcode(corners[1]->clip), Outcode(corners[2]->clip) };
+					if (codes[0] & codes[1] & codes[2])
+						continue;
+
+					// Flat attributes come from the last vertex, as OpenGL does
+					const ShadedVertex& provoking = *corners[2];
+
+					if ((codes[0] | codes[1] | codes[2]) == 0)
+					{
+						ScreenVertex screen[3];
+						for (int i = 0; i < 3; i++)
+							screen[i] = ToScreen(corners[i]->clip, varyingCount);
+						SetupTriangle(&screen[0], &screen[1], &screen[2], provoking, varyingCount, backFaceCull, target, output);
+						continue;
+					}
+
+					ClipVertex polygon[s_MaxClipVertices] = { corners[0]->clip, corners[1]->clip, corners[2]->clip };
+					uint32_t count = ClipPolygon(polygon, 3, codes[0] | codes[1] | codes[2], varyingCount);
+					if (count < 3)
+						continue;
+
+					ScreenVertex screen[s_MaxClipVertices];
+					for (uint32_t i = 0; i < count; i++)
+						screen[i] = ToScreen(polygon[i], varyingCount);
+
+					for (uint32_t i = 1; i + 1 < count; i++)
+						SetupTriangle(&screen[0], &screen[i], &screen[i + 1], provoking, varyingCount, backFaceCull, target, output);
+				}
+			}
+		});
+
+	s_Data.triangles.clear();
+	for (size_t block = 0; block < blockCount; block++)
+		s_Data.triangles.insert(s_Data.triangles.end(), s_Data.setupBlocks[block].begin(), s_Data.setupBlocks[block].end());
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Largest value an edge function can take over the pixel centres of a rectangle
+static int64_t MaxEdgeValue(const Triangle& triangle, int edge, int minX, int minY, int maxX, int maxY)
+{
+	int x = triangle.A[edge] >= 0 ? maxX : minX;
+	int y = triangle.B[edge] >= 0 ? maxY : minY;
+	return triangle.A[edge] * ((int64_t)x * s_SubpixelScale + s_SubpixelScale / 2)
+		+ triangle.B[edge] * ((int64_t)y * s_SubpixelScale + s_SubpixelScale / 2) + triangle.C[edge];
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static void BinTriangles(const RenderTarget& target)
+{
+	PROFILE_FUNCTION();
+
+	const int tilesWide = (target.width + s_TileSize - 1) / s_TileSize;
+	const int tilesHigh = (target.height + s_TileSize - 1) / s_TileSize;
+	s_Data.bins.resize((size_t)tilesWide * tilesHigh);
+	for (uint32_t tile : s_Data.activeTiles)
+		s_Data.bins[tile].clear();
+	s_Data.activeTiles.clear();
+
+	for (uint32_t index = 0; index < (uint32_t)s_Data.triangles.size(); index++)
+	{
+		const Triangle& triangle = s_Data.triangles[index];
+		for (int tileY = triangle.minY / s_TileSize; tileY <= triangle.maxY / s_TileSize; tileY++)
+		{
+			for (int tileX = triangle.minX / s_TileSize; tileX <= triangle.maxX / s_TileSize; tileX++)
+			{
+				int minX = std::max(tileX * s_TileSize, triangle.minX);
+				int minY = std::max(tileY * s_TileSize, triangle.minY);
+				int maxX = std::min(tileX * s_TileSize + s_TileSize - 1, triangle.maxX);
+				int maxY = std::min(tileY * s_TileSize + s_TileSize - 1, triangle.maxY);
+
+				if (MaxEdgeValue(triangle, 0, minX, minY, maxX, maxY) < 0
+					|| MaxEdgeValue(triangle, 1, minX, minY, maxX, maxY) < 0
+					|| MaxEdgeValue(triangle, 2, minX, minY, maxX, maxY) < 0)
+					continue;
+
+				uint32_t tile = (uint32_t)(tileY * tilesWide + tileX);
+				if (s_Data.bins[tile].empty())
+					s_Data.activeTiles.push_back(tile);
+				s_Data.bins[tile].push_back(index);
+			}
+		}
+	}
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static float SmoothStep(float edge0, float edge1, float x)
+{
+	if (edge0 == edge1)
+		return x < edge0 ? 0.0f : 1.0f;
+	float t = std::clamp((x - edge0) / (edge1 - edge0), 0.0f, 1.0f);
+	return t * t * (3.0f - 2.0f * t);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static const SoftwareTexture2D* SlotTexture(float texIndex)
+{
+	int slot = (int)texIndex;
+	if (slot < 0 || slot >= (int)SoftwareRasterizer::MaxTextureSlots)
+		return nullptr;
+	return s_Data.textures[slot];
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Decodes the index written by Renderer2D in texture array mode, the same as Renderer2D_QuadArray.frag.
+// Below 16 is a texture slot, above is (array << 10 | layer) + 16 with the arrays bound from slot 16
+static Colour SampleSlotOrLayer(float texIndex, float u, float v)
+{
+	int packed = (int)texIndex;
+	if (packed < 16)
+	{
+		const SoftwareTexture2D* texture = SlotTexture(texIndex);
+		return texture ? texture->Sample(u, v) : Colour(0.0f, 0.0f, 0.0f, 1.0f);
+	}
+
+	packed -= 16;
+	int slot = 16 + (packed >> 10);
+	const SoftwareTexture2DArray* textureArray = slot < (int)SoftwareRasterizer::MaxTextureSlots ? s_Data.textureArrays[slot] : nullptr;
+	return textureArray ? textureArray->Sample(u, v, (uint32_t)(packed & 1023)) : Colour(0.0f, 0.0f, 0.0f, 1.0f);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// CalculateD of Renderer2D_Line.frag, the distance from the end of a line used to shape the cap
+static float LineCapDistance(float dx, float dy, float width)
+{
+	switch (s_Data.lineCaps)
+	{
+	case 1: return std::max(dx, dy);
+	case 2: return std::sqrt(dx * dx + dy * dy);
+	case 3: return dx + dy;
+	default: return width;
+	}
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static void Interpolate(const Triangle& triangle, float x, float y, uint32_t count, float* varyings)
+{
+	float w = 1.0f / triangle.invW.At(x, y);
+	for (uint32_t i = 0; i < count; i++)
+		varyings[i] = triangle.varyings[i].At(x, y) * w;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Fragment stages of the Renderer2D shaders, return false to discard
+template<Program P>
+static bool ShadeFragment(const Triangle& triangle, float x, float y, const float* varyings, Colour& colour)
+{
+	const Colour vertexColour(varyings[0], varyings[1], varyings[2], varyings[3]);
+
+	if constexpr (P == Program::Quad)
+	{
+		const SoftwareTexture2D* texture = SlotTexture(triangle.texIndex);
+		Colour texel = texture ? texture->Sample(varyings[4], varyings[5]) : Colour(0.0f, 0.0f, 0.0f, 1.0f);
+		colour = Colour(texel.r * vertexColour.r, texel.g * vertexColour.g, texel.b * vertexColour.b, texel.a * vertexColour.a);
+		return colour.a > 0.0001f;
+	}
+	else if constexpr (P == Program::QuadArray)
+	{
+		Colour texel = SampleSlotOrLayer(triangle.texIndex, varyings[4], varyings[5]);
+		colour = Colour(texel.r * vertexColour.r, texel.g * vertexColour.g, texel.b * vertexColour.b, texel.a * vertexColour.a);
+		return colour.a > 0.0001f;
+	}
+	else if constexpr (P == Program::Circle)
+	{
+		float length = std::sqrt(varyings[4] * varyings[4] + varyings[5] * varyings[5] + varyings[6] * varyings[6]);
+		float distance = 1.0f - length;
+		float thickness = varyings[7];
+		float fade = varyings[8];
+		float alpha = SmoothStep(0.0f, fade, distance) * SmoothStep(thickness + fade, thickness, distance);
+		if (alpha <= 0.0001f)
+			return false;
+
+		colour = vertexColour;
+		colour.a *= alpha;
+		return true;
+	}
+	else if constexpr (P == Program::Line)
+	{
+		// Past either end of the line the fragment is kept if it is inside the cap
+		float u = varyings[4];
+		float width = varyings[6];
+		float length = varyings[7];
+		float dx = u < 0.0f ? -u : u - length;
+		if (dx > 0.0f && LineCapDistance(dx, std::abs(varyings[5]), width) > 0.5f * width)
+			return false;
+
+		colour = vertexColour;
+		return true;
+	}
+	else if constexpr (P == Program::Text)
+	{
+		const SoftwareTexture2D* texture = SlotTexture(triangle.texIndex);
+		Colour msd = texture ? texture->Sample(varyings[4], varyings[5]) : Colour(0.0f, 0.0f, 0.0f, 1.0f);
+		float distance = std::max(std::min(msd.r, msd.g), std::min(std::max(msd.r, msd.g), msd.b));
+
+		// fwidth from the neighbouring pixels
+		float right[s_MaxVaryings], up[s_MaxVaryings];
+		Interpolate(triangle, x + 1.0f, y, 6, right);
+		Interpolate(triangle, x, y + 1.0f, 6, up);
+		float widthU = std::max(std::abs(right[4] - varyings[4]) + std::abs(up[4] - varyings[4]), 1e-6f);
+		float widthV = std::max(std::abs(right[5] - varyings[5]) + std::abs(up[5] - varyings[5]), 1e-6f);
+
+		float textureWidth = texture ? (float)texture->GetWidth() : 1.0f;
+		float textureHeight = texture ? (float)texture->GetHeight() : 1.0f;
+		float screenPxRange = std::max(0.5f * ((2.0f / textureWidth) / widthU + (2.0f / textureHeight) / widthV), 1.0f);
+		float opacity = std::clamp(screenPxRange * (distance - 0.5f) + 0.5f, 0.0f, 1.0f);
+
+		colour = vertexColour;
+		colour.a *= opacity;
+		return colour.a > 0.0001f;
+	}
+	else
+	{
+		colour = vertexColour;
+		return true;
+	}
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Alpha blending into an 8 bit RGBA pixel, the alpha channel is blended with the same factors as the colour
+static void Blend(uint32_t& destination, const Colour& source)
+{
+	constexpr float toFloat = 1.0f / 255.0f;
+	float alpha = std::clamp(source.a, 0.0f, 1.0f);
+	float inverse = 1.0f - alpha;
+
+	float r = std::clamp(source.r, 0.0f, 1.0f) * alpha + (float)(destination & 0xff) * toFloat * inverse;
+	float g = std::clamp(source.g, 0.0f, 1.0f) * alpha + (float)((destination >> 8) & 0xff) * toFloat * inverse;
+	float b = std::clamp(source.b, 0.0f, 1.0f) * alpha + (float)((destination >> 16) & 0xff) * toFloat * inverse;
+	float a = alpha * alpha + (float)(destination >> 24) * toFloat * inverse;
+
+	auto toByte = [](float value) { return (uint32_t)(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f); };
+	destination = toByte(r) | (toByte(g) << 8) | (toByte(b) << 16) | (toByte(a) << 24);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+template<Program P>
+static void ShadePixel(const Triangle& triangle, int px, int py, const RenderTarget& target)
+{
+	constexpr uint32_t varyingCount = P == Program::Circle ? 9 : P == Program::Line ? 8 : 6;
+
+	const size_t index = (size_t)py * target.width + px;
+	const float x = (float)px + 0.5f - triangle.originX;
+	const float y = (float)py + 0.5f - triangle.originY;
+
+	const float z = triangle.z.At(x, y);
+	if (target.depth && !(z < target.depth[index]))
+		return;
+
+	float varyings[s_MaxVaryings];
+	Interpolate(triangle, x, y, varyingCount, varyings);
+
+	Colour colour;
+	if (!ShadeFragment<P>(triangle, x, y, varyings, colour))
+		return;
+
+	if (target.depth)
+		target.depth[index] = z;
+	if (target.colour)
+		Blend(target.colour[index], colour);
+
+	// The line shader has no entity id output
+	if (P != Program::Line && target.entity)
+		target.entity[index] = triangle.entityId;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+template<Program P>
+static void RasterizeTriangle(const Triangle& triangle, int minX, int minY, int maxX, int maxY, const RenderTarget& target)
+{
+	const int64_t sampleX = (int64_t)minX * s_SubpixelScale + s_SubpixelScale / 2;
+
+	for (int py = minY; py <= maxY; py++)
+	{
+		const int64_t sampleY = (int64_t)py * s_SubpixelScale + s_SubpixelScale / 2;
+		int64_t e0 = triangle.A[0] * sampleX + triangle.B[0] * sampleY + triangle.C[0];
+		int64_t e1 = triangle.A[1] * sampleX + triangle.B[1] * sampleY + triangle.C[1];
+		int64_t e2 = triangle.A[2] * sampleX + triangle.B[2] * sampleY + triangle.C[2];
+
+#ifdef SOFTWARE_RASTERIZER_SSE
+		if (triangle.simd)
+		{
+			// Four pixels at a time in 32 bit lanes, the clamp keeps the sign of values too large to step exactly
+			const int32_t a0 = (int32_t)(triangle.A[0] * s_SubpixelScale);
+			const int32_t a1 = (int32_t)(triangle.A[1] * s_SubpixelScale);
+			const int32_t a2 = (int32_t)(triangle.A[2] * s_SubpixelScale);
+			const __m128i lane = _mm_setr_epi32(0, 1, 2, 3);
+			const __m128i step0 = _mm_setr_epi32(0, a0, a0 * 2, a0 * 3);
+			const __m128i step1 = _mm_setr_epi32(0, a1, a1 * 2, a1 * 3);
+			const __m128i step2 = _mm_setr_epi32(0, a2, a2 * 2, a2 * 3);
+
+			for (int px = minX; px <= maxX; px += 4)
+			{
+				__m128i edge0 = _mm_add_epi32(_mm_set1_epi32((int32_t)std::clamp(e0, -s_SimdEdgeClamp, s_SimdEdgeClamp)), step0);
+				__m128i edge1 = _mm_add_epi32(_mm_set1_epi32((int32_t)std::clamp(e1, -s_SimdEdgeClamp, s_SimdEdgeClamp)), step1);
+				__m128i edge2 = _mm_add_epi32(_mm_set1_epi32((int32_t)std::clamp(e2, -s_SimdEdgeClamp, s_SimdEdgeClamp)), step2);
+				__m128i outside = _mm_or_si128(_mm_or_si128(edge0, edge1), edge2);
+				outside = _mm_or_si128(outside, _mm_cmpgt_epi32(lane, _mm_set1_epi32(maxX - px)));
+
+				int mask = ~_mm_movemask_ps(_mm_castsi128_ps(outside)) & 0xf;
+				while (mask)
+				{
+					int bit = 0;
+					while (!(mask & (1 << bit)))
+						bit++;
+					mask &= ~(1 << bit);
+					ShadePixel<P>(triangle, px + bit, py, target);
+				}
+
+				e0 += triangle.A[0] * s_SubpixelScale * 4;
+				e1 += triangle.A[1] * s_SubpixelScale * 4;
+				e2 += triangle.A[2] * s_SubpixelScale * 4;
+			}
+			continue;
+		}
+#endif
+
+		for (int px = minX; px <= maxX; px++)
+		{
+			if ((e0 | e1 | e2) >= 0)
+				ShadePixel<P>(triangle, px, py, target);
+
+			e0 += triangle.A[0] * s_SubpixelScale;
+			e1 += triangle.A[1] * s_SubpixelScale;
+			e2 += triangle.A[2] * s_SubpixelScale;
+		}
+	}
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+template<Program P>
+static void RasterizeTiles(const RenderTarget& target)
+{
+	PROFILE_FUNCTION();
+
+	const int tilesWide = (target.width + s_TileSize - 1) / s_TileSize;
+
+	// Each tile is owned by one thread and draws its triangles in submission order
+	ThreadPool::ParallelFor(s_Data.activeTiles.size(), 1, [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				uint32_t tile = s_Data.activeTiles[i];
+				int tileMinX = (int)(tile % tilesWide) * s_TileSize;
+				int tileMinY = (int)(tile / tilesWide) * s_TileSize;
+
+				for (uint32_t index : s_Data.bins[tile])
+				{
+					const Triangle& triangle = s_Data.triangles[index];
+					RasterizeTriangle<P>(triangle,
+						std::max(tileMinX, triangle.minX), std::max(tileMinY, triangle.minY),
+						std::min(tileMinX + s_TileSize - 1, triangle.maxX), std::min(tileMinY + s_TileSize - 1, triangle.maxY),
+						target);
+				}
+			}
+		});
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static RenderTarget GetRenderTarget()
+{
+	RenderTarget target;
+	SoftwareFrameBuffer* frameBuffer = s_Data.target ? s_Data.target : s_Data.backBuffer.get();
+	if (!frameBuffer || frameBuffer->GetColourAttachmentCount() == 0)
+		return target;
+
+	target.width = (int)frameBuffer->GetWidth();
+	target.height = (int)frameBuffer->GetHeight();
+
+	// Fragment outputs are written to the attachment at the same location
+	if (!frameBuffer->IsIntegerAttachment(0))
+		target.colour = frameBuffer->GetAttachmentData(0);
+	if (frameBuffer->GetColourAttachmentCount() > 1 && frameBuffer->IsIntegerAttachment(1))
+		target.entity = (int32_t*)frameBuffer->GetAttachmentData(1);
+	target.depth = frameBuffer->GetDepthData();
+
+	target.minX = std::max(s_Data.viewportX, 0);
+	target.minY = std::max(s_Data.viewportY, 0);
+	target.maxX = std::min(s_Data.viewportX + s_Data.viewportWidth, target.width) - 1;
+	target.maxY = std::min(s_Data.viewportY + s_Data.viewportHeight, target.height) - 1;
+	return target;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareRasterizer::Init(uint32_t width, uint32_t height)
+{
+	FrameBufferSpecification specification;
+	specification.width = width;
+	specification.height = height;
+	specification.attachments = { FrameBufferTextureFormat::RGBA8, FrameBufferTextureFormat::Depth };
+	specification.swapChainTarget = true;
+
+	s_Data.backBuffer = CreateScope<SoftwareFrameBuffer>(specification);
+	s_Data.target = nullptr;
+	SetViewport(0, 0, width, height);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareRasterizer::Shutdown()
+{
+	s_Data.backBuffer.reset();
+	s_Data = RasterizerData();
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareRasterizer::BindVertexBuffer(const SoftwareVertexBuffer* vertexBuffer)
+{
+	s_Data.vertexBuffer = vertexBuffer;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareRasterizer::BindIndexBuffer(const SoftwareIndexBuffer* indexBuffer)
+{
+	s_Data.indexBuffer = indexBuffer;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareRasterizer::BindProgram(SoftwareShader::Program program)
+{
+	s_Data.program = program;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareRasterizer::BindTexture(uint32_t slot, const SoftwareTexture2D* texture)
+{
+	if (slot < MaxTextureSlots)
+		s_Data.textures[slot] = texture;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareRasterizer::BindTextureArray(uint32_t slot, const SoftwareTexture2DArray* textureArray)
+{
+	if (slot < MaxTextureSlots)
+		s_Data.textureArrays[slot] = textureArray;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareRasterizer::SetUniformData(uint32_t binding, const void* data, uint32_t size, uint32_t offset)
+{
+	if (binding >= MaxUniformBindings)
+		return;
+
+	std::vector<uint8_t>& uniform = s_Data.uniforms[binding];
+	if (uniform.size() < (size_t)offset + size)
+		uniform.resize((size_t)offset + size, 0);
+	memcpy(uniform.data() + offset, data, size);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareRasterizer::Unbind(const SoftwareVertexBuffer* vertexBuffer)
+{
+	if (s_Data.vertexBuffer == vertexBuffer)
+		s_Data.vertexBuffer = nullptr;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareRasterizer::Unbind(const SoftwareIndexBuffer* indexBuffer)
+{
+	if (s_Data.indexBuffer == indexBuffer)
+		s_Data.indexBuffer = nullptr;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareRasterizer::Unbind(const SoftwareTexture2D* texture)
+{
+	for (const SoftwareTexture2D*& slot : s_Data.textures)
+	{
+		if (slot == texture)
+			slot = nullptr;
+	}
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareRasterizer::Unbind(const SoftwareTexture2DArray* textureArray)
+{
+	for (const SoftwareTexture2DArray*& slot : s_Data.textureArrays)
+	{
+		if (slot == textureArray)
+			slot = nullptr;
+	}
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareRasterizer::Unbind(const SoftwareFrameBuffer* frameBuffer)
+{
+	if (s_Data.target == frameBuffer)
+		s_Data.target = nullptr;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareRasterizer::BindTarget(SoftwareFrameBuffer* frameBuffer)
+{
+	s_Data.target = frameBuffer;
+	if (frameBuffer)
+		SetViewport(0, 0, frameBuffer->GetWidth(), frameBuffer->GetHeight());
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+SoftwareFrameBuffer* SoftwareRasterizer::GetBackBuffer()
+{
+	return s_Data.backBuffer.get();
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+bool SoftwareRasterizer::IsBackBufferBound()
+{
+	return s_Data.target == nullptr;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareRasterizer::SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height)
+{
+	s_Data.viewportX = (int)x;
+	s_Data.viewportY = (int)y;
+	s_Data.viewportWidth = (int)width;
+	s_Data.viewportHeight = (int)height;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareRasterizer::SetClearColour(const Colour& colour)
+{
+	s_Data.clearColour = colour;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareRasterizer::Clear(bool colour, bool depth)
+{
+	PROFILE_FUNCTION();
+
+	SoftwareFrameBuffer* frameBuffer = s_Data.target ? s_Data.target : s_Data.backBuffer.get();
+	if (frameBuffer)
+		frameBuffer->Clear(s_Data.clearColour, colour, depth);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareRasterizer::DrawIndexed(uint32_t indexCount, uint32_t startIndex, uint32_t vertexOffset, bool backFaceCull)
+{
+	PROFILE_FUNCTION();
+
+	const Program program = s_Data.program;
+	if (program == Program::None || program == Program::HairLine || !s_Data.vertexBuffer || !s_Data.indexBuffer)
+		return;
+
+	const RenderTarget target = GetRenderTarget();
+	if (target.minX > target.maxX || target.minY > target.maxY)
+		return;
+
+	const size_t availableIndices = s_Data.indexBuffer->GetDataCount();
+	if (indexCount == 0)
+		indexCount = s_Data.indexBuffer->GetCount();
+	if ((size_t)startIndex + indexCount > availableIndices)
+	{
+		ENGINE_ERROR("Draw call reads past the end of the index buffer");
+		return;
+	}
+	indexCount -= indexCount % 3;
+	if (indexCount == 0)
+		return;
+
+	// Offset the indices by the base vertex and shade every vertex they reference once
+	std::vector<uint32_t> indices(s_Data.indexBuffer->GetData() + startIndex, s_Data.indexBuffer->GetData() + startIndex + indexCount);
+	uint32_t minIndex = UINT32_MAX, maxIndex = 0;
+	for (uint32_t& index : indices)
+	{
+		index += vertexOffset;
+		minIndex = std::min(minIndex, index);
+		maxIndex = std::max(maxIndex, index);
+	}
+
+	const uint32_t stride = s_Data.vertexBuffer->GetLayout().GetStride();
+	if (stride == 0 || ((size_t)maxIndex + 1) * stride > s_Data.vertexBuffer->GetDataSize())
+	{
+		ENGINE_ERROR("Draw call reads past the end of the vertex buffer");
+		return;
+	}
+
+	ShadeVertices(program, minIndex, maxIndex - minIndex + 1);
+
+	if (program == Program::Line)
+	{
+		const std::vector<uint8_t>& line = s_Data.uniforms[s_LineUniformBinding];
+		s_Data.lineCaps = 0;
+		if (line.size() >= sizeof(int))
+			memcpy(&s_Data.lineCaps, line.data(), sizeof(int));
+	}
+
+	const uint32_t varyingCount = VaryingCount(program);
+	const size_t triangleCount = indexCount / 3;
+
+	// Chunks are drawn one after another which keeps the order of overlapping triangles
+	for (size_t first = 0; first < triangleCount; first += s_TrianglesPerChunk)
+	{
+		size_t count = std::min(s_TrianglesPerChunk, triangleCount - first);
+		SetupTriangles(indices.data() + first * 3, count, minIndex, varyingCount, backFaceCull, target);
+		BinTriangles(target);
+
+		switch (program)
+		{
+		case Program::Quad: RasterizeTiles<Program::Quad>(target); break;
+		case Program::QuadArray: RasterizeTiles<Program::QuadArray>(target); break;
+		case Program::Circle: RasterizeTiles<Program::Circle>(target); break;
+		case Program::Line: RasterizeTiles<Program::Line>(target); break;
+		case Program::Text: RasterizeTiles<Program::Text>(target); break;
+		default: break;
+		}
+	}
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareRasterizer::DrawLines(uint32_t vertexCount, uint32_t firstVertex)
+{
+	PROFILE_FUNCTION();
+
+	const Program program = s_Data.program;
+	if (program == Program::None || !s_Data.vertexBuffer)
+		return;
+
+	const RenderTarget target = GetRenderTarget();
+	if (target.minX > target.maxX || target.minY > target.maxY)
+		return;
+
+	const uint32_t stride = s_Data.vertexBuffer->GetLayout().GetStride();
+	vertexCount -= vertexCount % 2;
+	if (vertexCount == 0 || stride == 0 || ((size_t)firstVertex + vertexCount) * stride > s_Data.vertexBuffer->GetDataSize())
+		return;
+
+	ShadeVertices(program, firstVertex, vertexCount);
+
+	const uint32_t varyingCount = VaryingCount(program);
+
+	// Hair lines are few enough that they are drawn on one thread
+	for (uint32_t i = 0; i < vertexCount; i += 2)
+	{
+		const ShadedVertex& start = s_Data.vertices[i];
+		const ShadedVertex& end = s_Data.vertices[i + 1];
+
+		// Clip the segment to the view volume
+		float t0 = 0.0f, t1 = 1.0f;
+		bool visible = true;
+		for (int plane = 0; plane < 6 && visible; plane++)
+		{
+			float d0 = PlaneDistance(start.clip, plane);
+			float d1 = PlaneDistance(end.clip, plane);
+			if (d0 < 0.0f && d1 < 0.0f)
+				visible = false;
+			else if (d0 < 0.0f)
+				t0 = std::max(t0, d0 / (d0 - d1));
+			else if (d1 < 0.0f)
+				t1 = std::min(t1, d0 / (d0 - d1));
+		}
+		if (!visible || t0 >= t1)
+			continue;
+
+		ScreenVertex a = ToScreen(Lerp(start.clip, end.clip, t0, varyingCount), varyingCount);
+		ScreenVertex b = ToScreen(Lerp(start.clip, end.clip, t1, varyingCount), varyingCount);
+
+		float ax = (float)a.x / (float)s_SubpixelScale, ay = (float)a.y / (float)s_SubpixelScale;
+		float dx = (float)b.x / (float)s_SubpixelScale - ax, dy = (float)b.y / (float)s_SubpixelScale - ay;
+		int steps = (int)std::ceil(std::max(std::abs(dx), std::abs(dy)));
+
+		// The last pixel is left for the next segment
+		for (int step = 0; step < steps; step++)
+		{
+			float t = ((float)step + 0.5f) / (float)steps;
+			int px = (int)std::floor(ax + dx * t);
+			int py = (int)std::floor(ay + dy * t);
+			if (px < target.minX || px > target.maxX || py < target.minY || py > target.maxY)
+				continue;
+
+			size_t index = (size_t)py * target.width + px;
+			float z = a.z + (b.z - a.z) * t;
+			if (target.depth && !(z < target.depth[index]))
+				continue;
+
+			float invW = a.invW + (b.invW - a.invW) * t;
+			float colour[4];
+			for (int c = 0; c < 4; c++)
+				colour[c] = (a.varyings[c] + (b.varyings[c] - a.varyings[c]) * t) / invW;
+
+			if (target.depth)
+				target.depth[index] = z;
+			if (target.colour)
+				Blend(target.colour[index], Colour(colour[0], colour[1], colour[2], colour[3]));
+			if (target.entity)
+				target.entity[index] = end.entityId;
+		}
+	}
+}
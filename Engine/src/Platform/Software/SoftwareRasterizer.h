@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Core/Colour.h"
+#include "SoftwareShader.h"
+
+class SoftwareVertexBuffer;
+class SoftwareIndexBuffer;
+class SoftwareTexture2D;
+class SoftwareTexture2DArray;
+class SoftwareFrameBuffer;
+
+// Pipeline state and draw calls of the software renderer.
+// Follows the OpenGL state the engine sets up: depth test less, alpha blending, counter-clockwise front faces,
+// a bottom left origin and a 0 to 1 depth range. Draws are split into 64x64 pixel tiles which are
+// rasterised in parallel, each tile keeps the submission order so the output is the same on any thread count
+class SoftwareRasterizer
+{
+public:
+	static constexpr uint32_t MaxTextureSlots = 32;
+	static constexpr uint32_t MaxUniformBindings = 8;
+
+	static void Init(uint32_t width, uint32_t height);
+	static void Shutdown();
+
+	static void BindVertexBuffer(const SoftwareVertexBuffer* vertexBuffer);
+	static void BindIndexBuffer(const SoftwareIndexBuffer* indexBuffer);
+	static void BindProgram(SoftwareShader::Program program);
+	static void BindTexture(uint32_t slot, const SoftwareTexture2D* texture);
+	static void BindTextureArray(uint32_t slot, const SoftwareTexture2DArray* textureArray);
+	static void SetUniformData(uint32_t binding, const void* data, uint32_t size, uint32_t offset);
+
+	// Clear any binding to a resource that is being destroyed
+	static void Unbind(const SoftwareVertexBuffer* vertexBuffer);
+	static void Unbind(const SoftwareIndexBuffer* indexBuffer);
+	static void Unbind(const SoftwareTexture2D* texture);
+	static void Unbind(const SoftwareTexture2DArray* textureArray);
+	static void Unbind(const SoftwareFrameBuffer* frameBuffer);
+
+	// Render into a frame buffer, nullptr renders into the back buffer
+	static void BindTarget(SoftwareFrameBuffer* frameBuffer);
+	static SoftwareFrameBuffer* GetBackBuffer();
+	static bool IsBackBufferBound();
+
+	static void SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height);
+	static void SetClearColour(const Colour& colour);
+	static void Clear(bool colour, bool depth);
+
+	static void DrawIndexed(uint32_t indexCount, uint32_t startIndex, uint32_t vertexOffset, bool backFaceCull);
+	static void DrawLines(uint32_t vertexCount, uint32_t firstVertex);
+};
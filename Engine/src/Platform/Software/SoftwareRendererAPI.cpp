@@ -0,0 +1,100 @@
+#include "stdafx.h"
+#include "SoftwareRendererAPI.h"
+#include "SoftwareRasterizer.h"
+#include "SoftwareFrameBuffer.h"
+
+#include "Logging/Instrumentor.h"
+
+SoftwareRendererAPI::SoftwareRendererAPI(uint32_t width, uint32_t height)
+	:m_Width(width), m_Height(height)
+{
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+SoftwareRendererAPI::~SoftwareRendererAPI()
+{
+	SoftwareRasterizer::Shutdown();
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+bool SoftwareRendererAPI::Init()
+{
+	PROFILE_FUNCTION();
+
+	SoftwareRasterizer::Init(m_Width, m_Height);
+	return true;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareRendererAPI::SetClearColour(const Colour& colour)
+{
+	SoftwareRasterizer::SetClearColour(colour);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareRendererAPI::SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height)
+{
+	// Without a window the back buffer follows the viewport, as the window would when it is resized
+	SoftwareFrameBuffer* backBuffer = SoftwareRasterizer::GetBackBuffer();
+	if (backBuffer && SoftwareRasterizer::IsBackBufferBound() && (x + width != backBuffer->GetWidth() || y + height != backBuffer->GetHeight()))
+		backBuffer->Resize(x + width, y + height);
+
+	SoftwareRasterizer::SetViewport(x, y, width, height);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareRendererAPI::Clear()
+{
+	SoftwareRasterizer::Clear(true, true);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareRendererAPI::ClearColour()
+{
+	SoftwareRasterizer::Clear(true, false);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareRendererAPI::ClearDepth()
+{
+	SoftwareRasterizer::Clear(false, true);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareRendererAPI::DrawIndexed(uint32_t indexCount, uint32_t indexStart, uint32_t vertexOffset, bool backFaceCull, DrawMode drawMode)
+{
+	if (drawMode != DrawMode::FILL)
+		return;
+
+	SoftwareRasterizer::DrawIndexed(indexCount, indexStart, vertexOffset, backFaceCull);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareRendererAPI::DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex, uint32_t vertexOffset, bool backFaceCull, DrawMode drawMode)
+{
+	// Instanced draws read per instance data in the 3D shaders, which the software renderer doesn't run
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareRendererAPI::DrawLines(uint32_t vertexCount, uint32_t firstVertex)
+{
+	SoftwareRasterizer::DrawLines(vertexCount, firstVertex);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+bool SoftwareRendererAPI::SaveBackBuffer(const std::filesystem::path& filepath)
+{
+	SoftwareFrameBuffer* backBuffer = SoftwareRasterizer::GetBackBuffer();
+	return backBuffer && backBuffer->WriteImage(filepath);
+}
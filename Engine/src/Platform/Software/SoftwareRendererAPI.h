@@ -0,0 +1,27 @@
+#pragma once
+
+#include "Renderer/RendererAPI.h"
+
+// Renderer API that rasterises on the CPU into a frame buffer in system memory, needs no GPU or window
+class SoftwareRendererAPI : public RendererAPI
+{
+public:
+	SoftwareRendererAPI(uint32_t width = 1920, uint32_t height = 1080);
+	virtual ~SoftwareRendererAPI();
+
+	virtual bool Init() override;
+	virtual void SetClearColour(const Colour& colour) override;
+	virtual void SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height) override;
+	virtual void Clear() override;
+	virtual void ClearColour() override;
+	virtual void ClearDepth() override;
+
+	virtual void DrawIndexed(uint32_t indexCount, uint32_t indexStart = 0, uint32_t vertexOffset = 0, bool backFaceCull = false, DrawMode drawMode = DrawMode::FILL) override;
+	virtual void DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex = 0, uint32_t vertexOffset = 0, bool backFaceCull = false, DrawMode drawMode = DrawMode::FILL) override;
+	virtual void DrawLines(uint32_t vertexCount, uint32_t firstVertex) override;
+
+	virtual bool SaveBackBuffer(const std::filesystem::path& filepath) override;
+
+private:
+	uint32_t m_Width, m_Height;
+};
@@ -0,0 +1,43 @@
+#include "stdafx.h"
+#include "SoftwareShader.h"
+#include "SoftwareRasterizer.h"
+
+SoftwareShader::SoftwareShader(const std::string& name)
+	:m_Name(name), m_Program(Program::None)
+{
+	if (name == "Renderer2D_Quad")
+		m_Program = Program::Quad;
+	else if (name == "Renderer2D_QuadArray")
+		m_Program = Program::QuadArray;
+	else if (name == "Renderer2D_Circle")
+		m_Program = Program::Circle;
+	else if (name == "Renderer2D_Line")
+		m_Program = Program::Line;
+	else if (name == "Renderer2D_HairLine")
+		m_Program = Program::HairLine;
+	else if (name == "Renderer2D_Text")
+		m_Program = Program::Text;
+	else
+		ENGINE_WARN("Shader {0} is not supported by the software renderer", name);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareShader::Bind() const
+{
+	SoftwareRasterizer::BindProgram(m_Program);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareShader::UnBind() const
+{
+	SoftwareRasterizer::BindProgram(Program::None);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+std::string SoftwareShader::GetName() const
+{
+	return m_Name;
+}
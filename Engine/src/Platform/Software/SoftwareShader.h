@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Renderer/Shader.h"
+
+// The software renderer can't run GLSL, each of the Renderer2D shaders is matched by name to a built in program
+class SoftwareShader : public Shader
+{
+public:
+	enum class Program
+	{
+		None = 0, // not supported, draws using it are skipped
+		Quad,
+		QuadArray,
+		Circle,
+		Line,
+		HairLine,
+		Text
+	};
+
+	SoftwareShader(const std::string& name);
+	virtual ~SoftwareShader() = default;
+
+	virtual void Bind() const override;
+	virtual void UnBind() const override;
+
+	virtual std::string GetName() const override;
+
+	Program GetProgram() const { return m_Program; }
+
+private:
+	std::string m_Name;
+	Program m_Program;
+};
@@ -0,0 +1,412 @@
+#include "stdafx.h"
+#include "SoftwareTexture.h"
+#include "SoftwareRasterizer.h"
+
+#include "Logging/Instrumentor.h"
+
+#include "Renderer/ImageLoader.h"
+
+#include <atomic>
+
+static uint32_t NextRendererID()
+{
+	static std::atomic<uint32_t> s_NextID = 1;
+	return s_NextID++;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static uint8_t ToByte(float value)
+{
+	return (uint8_t)(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static float HalfToFloat(uint16_t half)
+{
+	uint32_t sign = (uint32_t)(half & 0x8000) << 16;
+	uint32_t exponent = (half >> 10) & 0x1f;
+	uint32_t mantissa = half & 0x3ff;
+
+	float value;
+	if (exponent == 0)
+		value = std::ldexp((float)mantissa, -24);
+	else if (exponent == 31)
+		value = mantissa ? NAN : INFINITY;
+	else
+		value = std::ldexp((float)(mantissa | 0x400), (int)exponent - 25);
+
+	return sign ? -value : value;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static uint32_t PackRGBA(uint8_t r, uint8_t g, uint8_t b, uint8_t a)
+{
+	return (uint32_t)r | ((uint32_t)g << 8) | ((uint32_t)b << 16) | ((uint32_t)a << 24);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+SoftwareTexture2D::SoftwareTexture2D(uint32_t width, uint32_t height, Format format, const void* pixels)
+	:m_Width(width), m_Height(height), m_Format(format), m_RendererID(NextRendererID())
+{
+	PROFILE_FUNCTION();
+
+	if (!pixels)
+		m_Filepath = "NO DATA";
+
+	m_Pixels.resize((size_t)m_Width * m_Height, 0);
+	if (pixels)
+		SetData(pixels);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+SoftwareTexture2D::SoftwareTexture2D(const std::filesystem::path& filepath)
+	:m_Width(0), m_Height(0), m_Format(Format::RGBA), m_RendererID(NextRendererID())
+{
+	PROFILE_FUNCTION();
+
+	m_Filepath = filepath;
+
+	if (!std::filesystem::exists(filepath) || !LoadTextureFromFile())
+		NullTexture();
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+SoftwareTexture2D::~SoftwareTexture2D()
+{
+	SoftwareRasterizer::Unbind(this);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareTexture2D::SetData(const void* data)
+{
+	PROFILE_FUNCTION();
+
+	m_Filepath = "";
+	m_Generation++;
+
+	const size_t count = (size_t)m_Width * m_Height;
+	const uint8_t* bytes = (const uint8_t*)data;
+	const float* floats = (const float*)data;
+	const uint16_t* halves = (const uint16_t*)data;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		switch (m_Format)
+		{
+		case Format::RED:
+		case Format::RED8UI:
+			m_Pixels[i] = PackRGBA(bytes[i], 0, 0, 255); break;
+		case Format::RED16UI:
+			m_Pixels[i] = PackRGBA((uint8_t)(halves[i] >> 8), 0, 0, 255); break;
+		case Format::RED32UI:
+			m_Pixels[i] = PackRGBA((uint8_t)(((const uint32_t*)data)[i] >> 24), 0, 0, 255); break;
+		case Format::RED32F:
+			m_Pixels[i] = PackRGBA(ToByte(floats[i]), 0, 0, 255); break;
+		case Format::RG8:
+			m_Pixels[i] = PackRGBA(bytes[i * 2], bytes[i * 2 + 1], 0, 255); break;
+		case Format::RG16F:
+			m_Pixels[i] = PackRGBA(ToByte(HalfToFloat(halves[i * 2])), ToByte(HalfToFloat(halves[i * 2 + 1])), 0, 255); break;
+		case Format::RG32F:
+			m_Pixels[i] = PackRGBA(ToByte(floats[i * 2]), ToByte(floats[i * 2 + 1]), 0, 255); break;
+		case Format::RGB:
+			m_Pixels[i] = PackRGBA(bytes[i * 3], bytes[i * 3 + 1], bytes[i * 3 + 2], 255); break;
+		case Format::RGBA16F:
+			m_Pixels[i] = PackRGBA(ToByte(HalfToFloat(halves[i * 4])), ToByte(HalfToFloat(halves[i * 4 + 1])),
+				ToByte(HalfToFloat(halves[i * 4 + 2])), ToByte(HalfToFloat(halves[i * 4 + 3]))); break;
+		case Format::RGBA32F:
+			m_Pixels[i] = PackRGBA(ToByte(floats[i * 4]), ToByte(floats[i * 4 + 1]), ToByte(floats[i * 4 + 2]), ToByte(floats[i * 4 + 3])); break;
+		default:
+			m_Pixels[i] = ((const uint32_t*)data)[i]; break;
+		}
+	}
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+bool SoftwareTexture2D::SetRegion(uint32_t x, uint32_t y, const Texture& texture, uint32_t border)
+{
+	PROFILE_FUNCTION();
+
+	const SoftwareTexture2D* texture2D = dynamic_cast<const SoftwareTexture2D*>(&texture);
+	if (!texture2D || texture2D->m_Width == 0 || texture2D->m_Height == 0 || x < border || y < border
+		|| x + texture2D->m_Width + border > m_Width || y + texture2D->m_Height + border > m_Height)
+		return false;
+
+	// Rows past the top and bottom repeat the edge rows, texels past the sides repeat the edge columns
+	const int64_t width = (int64_t)texture2D->m_Width;
+	const int64_t height = (int64_t)texture2D->m_Height;
+	for (int64_t row = -(int64_t)border; row < height + border; row++)
+	{
+		const uint32_t* source = &texture2D->m_Pixels[(size_t)std::clamp<int64_t>(row, 0, height - 1) * texture2D->m_Width];
+		uint32_t* destination = &m_Pixels[(size_t)(y + row) * m_Width + x];
+
+		for (int64_t column = -(int64_t)border; column < 0; column++)
+			destination[column] = source[0];
+		memcpy(destination, source, texture2D->m_Width * sizeof(uint32_t));
+		for (int64_t column = width; column < width + border; column++)
+			destination[column] = source[width - 1];
+	}
+
+	m_Generation++;
+	return true;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareTexture2D::Bind(uint32_t slot) const
+{
+	SoftwareRasterizer::BindTexture(slot, this);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+std::string SoftwareTexture2D::GetName() const
+{
+	return m_Filepath.filename().string();
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+uint32_t SoftwareTexture2D::GetRendererID() const
+{
+	return m_RendererID;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareTexture2D::Reload()
+{
+	if (!m_Filepath.empty() && m_Filepath != "NO DATA" && m_Filepath != "NULL")
+		LoadTextureFromFile();
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+bool SoftwareTexture2D::operator==(const Texture& other) const
+{
+	return m_RendererID == other.GetRendererID();
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+Colour SoftwareTexture2D::Sample(float u, float v) const
+{
+	if (m_Width == 0 || m_Height == 0)
+		return Colour(0.0f, 0.0f, 0.0f, 1.0f);
+
+	float x = u * (float)m_Width;
+	float y = v * (float)m_Height;
+
+	if (m_FilterMethod == FilterMethod::Nearest)
+		return Texel((int)std::floor(x), (int)std::floor(y));
+
+	x -= 0.5f;
+	y -= 0.5f;
+	int x0 = (int)std::floor(x);
+	int y0 = (int)std::floor(y);
+	float fx = x - (float)x0;
+	float fy = y - (float)y0;
+
+	Colour c00 = Texel(x0, y0);
+	Colour c10 = Texel(x0 + 1, y0);
+	Colour c01 = Texel(x0, y0 + 1);
+	Colour c11 = Texel(x0 + 1, y0 + 1);
+
+	auto lerp = [](const Colour& a, const Colour& b, float t)
+	{
+		return Colour(a.r + (b.r - a.r) * t, a.g + (b.g - a.g) * t, a.b + (b.b - a.b) * t, a.a + (b.a - a.a) * t);
+	};
+	return lerp(lerp(c00, c10, fx), lerp(c01, c11, fx), fy);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+Colour SoftwareTexture2D::Texel(int x, int y) const
+{
+	auto wrap = [this](int coordinate, int size)
+	{
+		switch (m_WrapMethod)
+		{
+		case WrapMethod::Clamp:
+			return std::clamp(coordinate, 0, size - 1);
+		case WrapMethod::Mirror:
+		{
+			int period = coordinate % (size * 2);
+			if (period < 0)
+				period += size * 2;
+			return period < size ? period : size * 2 - 1 - period;
+		}
+		case WrapMethod::Repeat:
+		default:
+		{
+			int wrapped = coordinate % size;
+			return wrapped < 0 ? wrapped + size : wrapped;
+		}
+		}
+	};
+
+	uint32_t pixel = m_Pixels[(size_t)wrap(y, (int)m_Height) * m_Width + (size_t)wrap(x, (int)m_Width)];
+	constexpr float scale = 1.0f / 255.0f;
+	return Colour((float)(pixel & 0xff) * scale, (float)((pixel >> 8) & 0xff) * scale,
+		(float)((pixel >> 16) & 0xff) * scale, (float)(pixel >> 24) * scale);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareTexture2D::NullTexture()
+{
+	m_Filepath = "NULL";
+	m_Width = m_Height = 4;
+	m_Format = Format::RGBA;
+
+	m_FilterMethod = FilterMethod::Nearest;
+	m_WrapMethod = WrapMethod::Repeat;
+
+	m_Pixels.resize(16);
+	for (uint32_t i = 0; i < 4; i++)
+	{
+		for (uint32_t j = 0; j < 4; j++)
+		{
+			m_Pixels[i * 4 + j] = ((i + j) % 2) ? 0xffff00ff : 0xff000000;
+		}
+	}
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+bool SoftwareTexture2D::LoadTextureFromFile()
+{
+	PROFILE_FUNCTION();
+
+	Image image;
+	if (!ImageLoader::Load(m_Filepath, image, 4))
+		return false;
+
+	m_Width = image.width;
+	m_Height = image.height;
+	m_Format = Format::RGBA;
+	m_Pixels.resize((size_t)m_Width * m_Height);
+	memcpy(m_Pixels.data(), image.pixels.data(), m_Pixels.size() * sizeof(uint32_t));
+	m_Generation++;
+	return true;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+SoftwareTexture2DArray::SoftwareTexture2DArray(uint32_t width, uint32_t height, uint32_t layers, FilterMethod filterMethod, WrapMethod wrapMethod)
+	:m_Width(width), m_Height(height), m_RendererID(NextRendererID())
+{
+	PROFILE_FUNCTION();
+
+	m_FilterMethod = filterMethod;
+	m_WrapMethod = wrapMethod;
+
+	m_Layers.reserve(layers);
+	for (uint32_t i = 0; i < layers; i++)
+	{
+		m_Layers.push_back(CreateScope<SoftwareTexture2D>(m_Width, m_Height, Format::RGBA, nullptr));
+		m_Layers.back()->SetFilterMethod(m_FilterMethod);
+		m_Layers.back()->SetWrapMethod(m_WrapMethod);
+	}
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+SoftwareTexture2DArray::~SoftwareTexture2DArray()
+{
+	SoftwareRasterizer::Unbind(this);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareTexture2DArray::SetData(const void* data)
+{
+	PROFILE_FUNCTION();
+
+	const size_t layerSize = (size_t)m_Width * m_Height * sizeof(uint32_t);
+	for (size_t i = 0; i < m_Layers.size(); i++)
+		m_Layers[i]->SetData((const uint8_t*)data + i * layerSize);
+	m_Generation++;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+bool SoftwareTexture2DArray::SetLayer(uint32_t layer, const Texture& texture)
+{
+	PROFILE_FUNCTION();
+
+	const SoftwareTexture2D* texture2D = dynamic_cast<const SoftwareTexture2D*>(&texture);
+	if (!texture2D || layer >= m_Layers.size() || texture2D->GetWidth() != m_Width || texture2D->GetHeight() != m_Height)
+		return false;
+
+	m_Layers[layer]->SetData(texture2D->GetPixels().data());
+	return true;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareTexture2DArray::Bind(uint32_t slot) const
+{
+	SoftwareRasterizer::BindTextureArray(slot, this);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+std::string SoftwareTexture2DArray::GetName() const
+{
+	return "Texture Array";
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+uint32_t SoftwareTexture2DArray::GetRendererID() const
+{
+	return m_RendererID;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareTexture2DArray::Reload()
+{
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+bool SoftwareTexture2DArray::operator==(const Texture& other) const
+{
+	return m_RendererID == other.GetRendererID();
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareTexture2DArray::SetFilterMethod(FilterMethod filterMethod)
+{
+	m_FilterMethod = filterMethod;
+	for (Scope<SoftwareTexture2D>& layer : m_Layers)
+		layer->SetFilterMethod(filterMethod);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareTexture2DArray::SetWrapMethod(WrapMethod wrapMethod)
+{
+	m_WrapMethod = wrapMethod;
+	for (Scope<SoftwareTexture2D>& layer : m_Layers)
+		layer->SetWrapMethod(wrapMethod);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+Colour SoftwareTexture2DArray::Sample(float u, float v, uint32_t layer) const
+{
+	if (layer >= m_Layers.size())
+		return Colour(0.0f, 0.0f, 0.0f, 1.0f);
+	return m_Layers[layer]->Sample(u, v);
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "Renderer/Texture.h"
+#include "Core/Colour.h"
+
+// Texture held in system memory for the software renderer.
+// Every format is stored as 8 bit RGBA with the first row at the bottom, as OpenGL does
+class SoftwareTexture2D : public Texture2D
+{
+public:
+	SoftwareTexture2D(uint32_t width, uint32_t height, Format format, const void* pixels);
+	SoftwareTexture2D(const std::filesystem::path& filepath);
+	virtual ~SoftwareTexture2D();
+
+	virtual uint32_t GetWidth() const override { return m_Width; }
+	virtual uint32_t GetHeight() const override { return m_Height; }
+
+	virtual void SetData(const void* data) override;
+	virtual bool SetRegion(uint32_t x, uint32_t y, const Texture& texture, uint32_t border = 0) override;
+
+	virtual void Bind(uint32_t slot) const override;
+
+	virtual std::string GetName() const override;
+
+	virtual uint32_t GetRendererID() const override;
+
+	virtual void Reload() override;
+
+	virtual bool operator==(const Texture& other) const override;
+
+	// Sample with the texture's filter and wrap methods, as texture() does in a shader
+	Colour Sample(float u, float v) const;
+
+	const std::vector<uint32_t>& GetPixels() const { return m_Pixels; }
+
+private:
+	// sets the texture to be the null texture
+	void NullTexture();
+
+	bool LoadTextureFromFile();
+
+	Colour Texel(int x, int y) const;
+
+	uint32_t m_Width, m_Height;
+	Format m_Format;
+
+	uint32_t m_RendererID;
+
+	std::vector<uint32_t> m_Pixels; // RGBA, red in the lowest byte
+};
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Each layer is a software texture sharing the array's filter and wrap methods
+class SoftwareTexture2DArray : public Texture2DArray
+{
+public:
+	SoftwareTexture2DArray(uint32_t width, uint32_t height, uint32_t layers, FilterMethod filterMethod, WrapMethod wrapMethod);
+	virtual ~SoftwareTexture2DArray();
+
+	virtual uint32_t GetWidth() const override { return m_Width; }
+	virtual uint32_t GetHeight() const override { return m_Height; }
+	virtual uint32_t GetLayerCount() const override { return (uint32_t)m_Layers.size(); }
+
+	virtual void SetData(const void* data) override;
+	virtual bool SetLayer(uint32_t layer, const Texture& texture) override;
+
+	virtual void Bind(uint32_t slot) const override;
+
+	virtual std::string GetName() const override;
+
+	virtual uint32_t GetRendererID() const override;
+
+	virtual void Reload() override;
+
+	virtual bool operator==(const Texture& other) const override;
+
+	virtual void SetFilterMethod(FilterMethod filterMethod) override;
+	virtual void SetWrapMethod(WrapMethod wrapMethod) override;
+
+	Colour Sample(float u, float v, uint32_t layer) const;
+
+private:
+	uint32_t m_Width, m_Height;
+
+	uint32_t m_RendererID;
+
+	std::vector<Scope<SoftwareTexture2D>> m_Layers;
+};
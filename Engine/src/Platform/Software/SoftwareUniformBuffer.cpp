@@ -0,0 +1,16 @@
+#include "stdafx.h"
+#include "SoftwareUniformBuffer.h"
+#include "SoftwareRasterizer.h"
+
+SoftwareUniformBuffer::SoftwareUniformBuffer(uint32_t size, uint32_t binding)
+	:m_Size(size), m_Binding(binding)
+{
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SoftwareUniformBuffer::SetData(const void* data, uint32_t size, uint32_t offset)
+{
+	CORE_ASSERT(offset + size <= m_Size, "Uniform buffer data out of range");
+	SoftwareRasterizer::SetUniformData(m_Binding, data, size, offset);
+}
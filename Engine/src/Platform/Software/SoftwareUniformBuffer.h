@@ -0,0 +1,16 @@
+#pragma once
+
+#include "Renderer/UniformBuffer.h"
+
+class SoftwareUniformBuffer : public UniformBuffer
+{
+public:
+	SoftwareUniformBuffer(uint32_t size, uint32_t binding);
+	virtual ~SoftwareUniformBuffer() = default;
+
+	// Inherited via UniformBuffer
+	virtual void SetData(const void* data, uint32_t size, uint32_t offset) override;
+private:
+	uint32_t m_Size = 0;
+	uint32_t m_Binding = 0;
+};
@@ -37,6 +37,10 @@ void VulkanRendererAPI::DrawIndexed(uint32_t indexCount, uint32_t startIndex, ui
 {
 }
 
-void VulkanRendererAPI::DrawLines(uint32_t vertexCount)
+void VulkanRendererAPI::DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex, uint32_t vertexOffset, bool backFaceCull, DrawMode drawMode)
+{
+}
+
+void VulkanRendererAPI::DrawLines(uint32_t vertexCount, uint32_t firstVertex)
 {
 }
\ No newline at end of file
@@ -15,7 +15,8 @@ public:
 	virtual void ClearColour()override;
 	virtual void ClearDepth()override;
 	virtual void DrawIndexed(uint32_t indexCount, uint32_t startIndex, uint32_t vertexOffset, bool backFaceCull, DrawMode drawMode) override;
-	virtual void DrawLines(uint32_t vertexCount) override;
+	virtual void DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex, uint32_t vertexOffset, bool backFaceCull, DrawMode drawMode) override;
+	virtual void DrawLines(uint32_t vertexCount, uint32_t firstVertex) override;
 private:
 	Colour m_ClearColour;
 };
@@ -0,0 +1,128 @@
+#include "stdafx.h"
+#include "AtlasPacker.h"
+
+AtlasPacker::AtlasPacker(uint32_t width, uint32_t height)
+{
+	Reset(width, height);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void AtlasPacker::Reset(uint32_t width, uint32_t height)
+{
+	m_Width = width;
+	m_Height = height;
+	Clear();
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void AtlasPacker::Clear()
+{
+	m_UsedArea = 0;
+	m_Skyline.clear();
+	m_Skyline.push_back({ 0, 0, m_Width });
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+bool AtlasPacker::Insert(uint32_t width, uint32_t height, Rect& rect)
+{
+	if (width == 0 || height == 0 || width > m_Width || height > m_Height)
+		return false;
+
+	// Lowest top edge, ties go to the narrowest level to leave the wide ones free
+	size_t bestIndex = m_Skyline.size();
+	uint32_t bestTop = UINT32_MAX;
+	uint32_t bestWidth = UINT32_MAX;
+	uint32_t bestY = 0;
+
+	for (size_t i = 0; i < m_Skyline.size(); i++)
+	{
+		uint32_t y;
+		if (!Fits(i, width, height, y))
+			continue;
+
+		uint32_t top = y + height;
+		if (top < bestTop || (top == bestTop && m_Skyline[i].width < bestWidth))
+		{
+			bestIndex = i;
+			bestTop = top;
+			bestWidth = m_Skyline[i].width;
+			bestY = y;
+		}
+	}
+
+	if (bestIndex == m_Skyline.size())
+		return false;
+
+	rect = { m_Skyline[bestIndex].x, bestY, width, height };
+	AddLevel(bestIndex, rect);
+	m_UsedArea += (uint64_t)width * height;
+	return true;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+float AtlasPacker::GetOccupancy() const
+{
+	if (m_Width == 0 || m_Height == 0)
+		return 0.0f;
+	return (float)((double)m_UsedArea / ((double)m_Width * m_Height));
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// The rectangle rests on the highest of the levels it spans starting from the level at index
+bool AtlasPacker::Fits(size_t index, uint32_t width, uint32_t height, uint32_t& y) const
+{
+	if (m_Skyline[index].x + width > m_Width)
+		return false;
+
+	y = 0;
+	uint32_t widthLeft = width;
+	for (size_t i = index; widthLeft > 0; i++)
+	{
+		y = std::max(y, m_Skyline[i].y);
+		if (y + height > m_Height)
+			return false;
+		widthLeft -= std::min(widthLeft, m_Skyline[i].width);
+	}
+	return true;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void AtlasPacker::AddLevel(size_t index, const Rect& rect)
+{
+	m_Skyline.insert(m_Skyline.begin() + index, { rect.x, rect.y + rect.height, rect.width });
+
+	// Cut the levels now under the new one
+	const uint32_t right = rect.x + rect.width;
+	size_t i = index + 1;
+	while (i < m_Skyline.size() && m_Skyline[i].x < right)
+	{
+		uint32_t overlap = right - m_Skyline[i].x;
+		if (m_Skyline[i].width <= overlap)
+		{
+			m_Skyline.erase(m_Skyline.begin() + i);
+			continue;
+		}
+
+		m_Skyline[i].x += overlap;
+		m_Skyline[i].width -= overlap;
+		break;
+	}
+
+	// Merge neighbouring levels at the same height
+	for (size_t j = 0; j + 1 < m_Skyline.size();)
+	{
+		if (m_Skyline[j].y == m_Skyline[j + 1].y)
+		{
+			m_Skyline[j].width += m_Skyline[j + 1].width;
+			m_Skyline.erase(m_Skyline.begin() + j + 1);
+		}
+		else
+			j++;
+	}
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Skyline bottom-left rectangle packer (Jylanki, "A Thousand Ways to Pack the Bin", 2010)
+// Rectangles are added one at a time and can't be removed on their own, clear and insert the ones left to reclaim space
+class AtlasPacker
+{
+public:
+	struct Rect
+	{
+		uint32_t x = 0, y = 0, width = 0, height = 0;
+	};
+
+	AtlasPacker(uint32_t width = 0, uint32_t height = 0);
+
+	void Reset(uint32_t width, uint32_t height);
+	void Clear();
+
+	// Returns false if there is no room for the rectangle
+	bool Insert(uint32_t width, uint32_t height, Rect& rect);
+
+	uint32_t GetWidth() const { return m_Width; }
+	uint32_t GetHeight() const { return m_Height; }
+
+	// Area of the rectangles inserted since the last clear
+	uint64_t GetUsedArea() const { return m_UsedArea; }
+	float GetOccupancy() const;
+
+private:
+	struct SkylineNode
+	{
+		uint32_t x, y, width;
+	};
+
+	bool Fits(size_t index, uint32_t width, uint32_t height, uint32_t& y) const;
+	void AddLevel(size_t index, const Rect& rect);
+
+	uint32_t m_Width = 0, m_Height = 0;
+	uint64_t m_UsedArea = 0;
+	std::vector<SkylineNode> m_Skyline;
+};
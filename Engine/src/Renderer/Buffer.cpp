@@ -9,14 +9,17 @@
 #include "Platform/DirectX/DirectX11Buffer.h"
 #endif // __WINDOWS__
 #include "Platform/Vulkan/VulkanBuffer.h"
+#include "Platform/Null/NullBuffer.h"
+#include "Platform/Software/SoftwareBuffer.h"
 
 Ref<VertexBuffer> VertexBuffer::Create(uint32_t size)
 {
 	switch (Renderer::GetAPI())
 	{
 	case RendererAPI::API::None:
-		CORE_ASSERT(false, "Could not create vertex buffer: None Renderer API is not supported")
-			return nullptr;
+		return CreateRef<NullVertexBuffer>(size);
+	case RendererAPI::API::Software:
+		return CreateRef<SoftwareVertexBuffer>(size);
 	case RendererAPI::API::OpenGL:
 		return CreateRef<OpenGLVertexBuffer>(size);
 #ifdef __WINDOWS__
@@ -46,8 +49,9 @@ Ref<VertexBuffer> VertexBuffer::Create(void* vertices, uint32_t size)
 	switch (Renderer::GetAPI())
 	{
 	case RendererAPI::API::None:
-		CORE_ASSERT(false, "Could not create vertex buffer: None Renderer API is not supported")
-			return nullptr;
+		return CreateRef<NullVertexBuffer>(size);
+	case RendererAPI::API::Software:
+		return CreateRef<SoftwareVertexBuffer>(vertices, size);
 	case RendererAPI::API::OpenGL:
 		return CreateRef<OpenGLVertexBuffer>(vertices, size);
 #ifdef __WINDOWS__
@@ -72,12 +76,24 @@ Ref<VertexBuffer> VertexBuffer::Create(void* vertices, uint32_t size)
 
 /* ------------------------------------------------------------------------------------------------------------------ */
 
+Ref<VertexBuffer> VertexBuffer::CreateStreaming(uint32_t size)
+{
+	// Software buffers are in system memory so they are always mapped, the other APIs copy the data in
+	if (Renderer::GetAPI() == RendererAPI::API::OpenGL)
+		return CreateRef<OpenGLVertexBuffer>(size, true);
+	return Create(size);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
 Ref<IndexBuffer> IndexBuffer::Create(uint32_t* indices, uint32_t size)
 {
 	switch (Renderer::GetAPI())
 	{
 	case RendererAPI::API::None:
-		break;
+		return CreateRef<NullIndexBuffer>(size);
+	case RendererAPI::API::Software:
+		return CreateRef<SoftwareIndexBuffer>(indices, size);
 	case RendererAPI::API::OpenGL:
 		return CreateRef<OpenGLIndexBuffer>(indices, size);
 #ifdef __WINDOWS__
@@ -123,11 +123,18 @@ public:
 
 	virtual uint32_t GetSize() = 0;
 
+	// Memory that writes go straight to the buffer through, it stays mapped while the buffer exists.
+	// Null if the buffer wasn't created for streaming or the API can't map it
+	virtual void* GetMappedData() { return nullptr; }
+
 	virtual void Bind() const = 0;
 	virtual void UnBind() const = 0;
 
 	static Ref<VertexBuffer> Create(uint32_t size);
 	static Ref<VertexBuffer> Create(void* vertices, uint32_t size);
+
+	// A buffer that is rewritten every frame, kept mapped if the API supports it
+	static Ref<VertexBuffer> CreateStreaming(uint32_t size);
 };
 
 /* ------------------------------------------------------------------------------------------------------------------ */
@@ -3,22 +3,200 @@
 
 #include "UI/MSDFData.h"
 #include "Logging/Instrumentor.h"
+#include "Core/ThreadPool.h"
+
+#include <mutex>
+
+// Generator settings shared by the main atlas and the glyphs generated later
+static const double s_GlyphScale = 40.0;
+static const double s_GlyphPixelRange = 2.0;
+static const double s_GlyphMiterLimit = 1.0;
+
+static const uint32_t s_GlyphPageSize = 1024;
+static const uint32_t s_MaxGlyphPages = 8;
+static const uint32_t s_GlyphPadding = 1;
+
+static const char s_CacheMagic[4] = { 'F', 'N', 'T', 'C' };
+static const uint32_t s_CacheVersion = 1;
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+struct GeneratedGlyph
+{
+	char32_t codepoint = 0;
+	bool loaded = false; // false if the font doesn't have the glyph
+	msdf_atlas::GlyphGeometry geometry;
+	int width = 0, height = 0;
+	std::vector<uint8_t> pixels;
+};
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Shared with the worker threads so a font can be destroyed while its glyphs are generating
+struct GlyphRequests
+{
+	std::mutex mutex;
+	std::vector<GeneratedGlyph> generated;
+};
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// The cache is the header followed by the glyphs, the kerning pairs, the main atlas pixels and the page pixels
+struct FontCacheHeader
+{
+	char magic[4];
+	uint32_t version;
+	uint64_t hash;
+	double geometryScale;
+	double ascenderY, descenderY, lineHeight;
+	uint32_t atlasWidth, atlasHeight;
+	uint32_t pageCount;
+	uint32_t glyphCount;
+	uint32_t kerningCount;
+	uint32_t padding;
+};
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+struct FontCacheGlyph
+{
+	uint32_t codepoint;
+	AtlasPacker::Rect rect; // in its page, for glyphs that aren't in the main atlas
+	Font::Glyph glyph;
+};
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+struct FontCacheKerning
+{
+	uint32_t first, second;
+	double advance;
+};
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static uint64_t KerningKey(char32_t first, char32_t second)
+{
+	return ((uint64_t)first << 32) | (uint64_t)second;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static uint64_t HashBytes(uint64_t hash, const void* data, size_t size)
+{
+	// FNV-1a
+	const uint8_t* bytes = (const uint8_t*)data;
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= bytes[i];
+		hash *= 0x100000001b3ull;
+	}
+	return hash;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Hash the contents of the font file and everything that changes the generated glyphs, 0 if the file can't be read
+static uint64_t HashFont(const std::filesystem::path& filepath)
+{
+	PROFILE_FUNCTION();
+
+	std::ifstream file(filepath, std::ios::in | std::ios::binary | std::ios::ate);
+	if (!file)
+		return 0;
+
+	std::vector<char> contents((size_t)file.tellg());
+	file.seekg(0);
+	if (!file.read(contents.data(), contents.size()))
+		return 0;
+
+	uint64_t hash = HashBytes(0xcbf29ce484222325ull, contents.data(), contents.size());
+
+	const double settings[] = { s_GlyphScale, s_GlyphPixelRange, s_GlyphMiterLimit };
+	const uint32_t layout[] = { s_CacheVersion, s_GlyphPageSize, s_GlyphPadding };
+	hash = HashBytes(hash, settings, sizeof(settings));
+	hash = HashBytes(hash, layout, sizeof(layout));
+	return hash != 0 ? hash : 1;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static std::filesystem::path CachePath(const std::filesystem::path& fontPath)
+{
+	std::filesystem::path cachePath = fontPath;
+	cachePath.replace_extension(".fontcache");
+	return cachePath;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static uint8_t DistanceToByte(float distance)
+{
+	return (uint8_t)std::clamp(distance * 256.0f, 0.0f, 255.0f);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Rasterise the multi-channel signed distance field of a glyph into 8 bit RGBA
+static void GenerateGlyph(GeneratedGlyph& glyph)
+{
+	glyph.geometry.edgeColoring(msdfgen::edgeColoringInkTrap, 3.0, 0);
+	glyph.geometry.wrapBox(s_GlyphScale, s_GlyphPixelRange / s_GlyphScale, s_GlyphMiterLimit);
+	glyph.geometry.getBoxSize(glyph.width, glyph.height);
+	if (glyph.width <= 0 || glyph.height <= 0)
+		return;
+
+	msdfgen::Bitmap<float, 4> bitmap(glyph.width, glyph.height);
+
+	msdf_atlas::GeneratorAttributes generatorAttributes;
+	generatorAttributes.config.overlapSupport = true;
+	generatorAttributes.scanlinePass = true;
+	msdf_atlas::mtsdfGenerator(bitmap, glyph.geometry, generatorAttributes);
+
+	glyph.pixels.resize((size_t)glyph.width * glyph.height * 4);
+	uint8_t* pixel = glyph.pixels.data();
+	for (int y = 0; y < glyph.height; y++)
+	{
+		for (int x = 0; x < glyph.width; x++)
+		{
+			const float* channels = bitmap(x, y);
+			for (int channel = 0; channel < 4; channel++)
+				*pixel++ = DistanceToByte(channels[channel]);
+		}
+	}
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Fonts can be loaded from any thread
+static std::mutex s_FontsMutex;
 
 Font::Font()
 {
+	std::scoped_lock lock(s_FontsMutex);
+	s_Fonts.push_back(this);
 }
 
 Font::Font(const std::filesystem::path& filepath)
 {
+	{
+		std::scoped_lock lock(s_FontsMutex);
+		s_Fonts.push_back(this);
+	}
 	Load(filepath);
 }
 
 Font::~Font()
 {
-	delete m_MSDFData;
+	if (m_CacheDirty)
+		SaveCache();
+
+	std::scoped_lock lock(s_FontsMutex);
+	s_Fonts.erase(std::find(s_Fonts.begin(), s_Fonts.end(), this));
 }
 
 Ref<Font> Font::s_DefaultFont;
+std::vector<Font*> Font::s_Fonts;
 
 void Font::Init()
 {
@@ -40,44 +218,87 @@ bool Font::Load(const std::filesystem::path& filepath)
 		return false;
 	}
 
+	if (m_CacheDirty)
+		SaveCache();
+
+	m_Glyphs.clear();
+	m_Kerning.clear();
+	m_GlyphOrder.clear();
+	m_GlyphRects.clear();
 	m_TextureAtlas.reset();
+	m_TextureAtlasPixels.clear();
+	m_GlyphPages.clear();
+	m_RequestedGlyphs.clear();
+	m_GlyphRequests = CreateRef<GlyphRequests>(); // drop any glyphs still generating for the previous font
+	m_CacheDirty = false;
+	m_Generation++;
 
-	// Try Loading the atlas cache
-	std::filesystem::path cachePath = filepath;
-	cachePath.replace_extension(".png");
-	if (std::filesystem::exists(cachePath))
+	m_Hash = HashFont(filepath);
+	if (m_Hash == 0)
 	{
-		m_TextureAtlas = Texture2D::Create(cachePath);
-		m_TextureAtlas->SetFilterMethod(Texture::FilterMethod::Linear);
+		ENGINE_ERROR("Could not read font: {0}", filepath);
+		return false;
 	}
 
+	m_Filepath = filepath;
+
+	if (LoadCache())
+		return true;
+
+	if (!Generate())
+		return false;
+
+	SaveCache();
+	return true;
+}
+
+const Font::Glyph* Font::GetGlyph(char32_t codepoint) const
+{
+	auto it = m_Glyphs.find(codepoint);
+	return it != m_Glyphs.end() ? &it->second : nullptr;
+}
+
+bool Font::GetAdvance(double& advance, char32_t codepoint, char32_t nextCodepoint) const
+{
+	const Glyph* glyph = GetGlyph(codepoint);
+	if (!glyph || !GetGlyph(nextCodepoint))
+		return false;
+
+	advance = glyph->advance;
+	auto it = m_Kerning.find(KerningKey(codepoint, nextCodepoint));
+	if (it != m_Kerning.end())
+		advance += it->second;
+	return true;
+}
+
+// Bake the ASCII glyphs into the main atlas
+bool Font::Generate()
+{
+	PROFILE_FUNCTION();
+
 	msdfgen::FreetypeHandle* ftHandle = msdfgen::initializeFreetype();
-	msdfgen::FontHandle* fontHandle = msdfgen::loadFont(ftHandle, filepath.string().c_str());
+	msdfgen::FontHandle* fontHandle = msdfgen::loadFont(ftHandle, m_Filepath.string().c_str());
 
 	if (!ftHandle || !fontHandle)
 	{
-		ENGINE_ERROR("Could not load font: {0}", filepath);
+		ENGINE_ERROR("Could not load font: {0}", m_Filepath);
 		msdfgen::destroyFont(fontHandle);
 		msdfgen::deinitializeFreetype(ftHandle);
 		return false;
-	}	
-
-	m_Filepath = filepath;
+	}
 
-	if (m_MSDFData)
-		delete m_MSDFData;
-	m_MSDFData = new MSDFData();
-	m_MSDFData->fontGeometry = msdf_atlas::FontGeometry(&m_MSDFData->glyphs);
+	MSDFData msdfData;
+	msdfData.fontGeometry = msdf_atlas::FontGeometry(&msdfData.glyphs);
 
 	int glyphsLoaded = -1;
 
-	glyphsLoaded = m_MSDFData->fontGeometry.loadCharset(fontHandle, 1.0f, msdf_atlas::Charset::ASCII);
+	glyphsLoaded = msdfData.fontGeometry.loadCharset(fontHandle, 1.0f, msdf_atlas::Charset::ASCII);
 
 	ASSERT(glyphsLoaded >= 0, "Could not load any glyphs from the font");
 
-	m_MSDFData->fontGeometry.setName(m_Filepath.string().c_str());
+	msdfData.fontGeometry.setName(m_Filepath.string().c_str());
 
-	for (msdf_atlas::GlyphGeometry& glyph : m_MSDFData->glyphs)
+	for (msdf_atlas::GlyphGeometry& glyph : msdfData.glyphs)
 	{
 		glyph.edgeColoring(msdfgen::edgeColoringInkTrap, 3.0, 0);
 	}
@@ -86,18 +307,15 @@ bool Font::Load(const std::filesystem::path& filepath)
 
 	atlasPacker.setDimensionsConstraint(msdf_atlas::TightAtlasPacker::DimensionsConstraint::MULTIPLE_OF_FOUR_SQUARE);
 	atlasPacker.setPadding(0);
-	atlasPacker.setScale(40);
-	atlasPacker.setPixelRange(2.0);
-	atlasPacker.setMiterLimit(1.0);
-	if (int remaining = atlasPacker.pack(m_MSDFData->glyphs.data(), (int)m_MSDFData->glyphs.size()))
+	atlasPacker.setScale(s_GlyphScale);
+	atlasPacker.setPixelRange(s_GlyphPixelRange);
+	atlasPacker.setMiterLimit(s_GlyphMiterLimit);
+	if (int remaining = atlasPacker.pack(msdfData.glyphs.data(), (int)msdfData.glyphs.size()))
 	{
 		ASSERT(remaining >= 0, "Remaining cannot be negative");
-		ENGINE_ERROR("Could not fit {0} out of {1} glyphs into the atlas.", remaining, (int)m_MSDFData->glyphs.size());
+		ENGINE_ERROR("Could not fit {0} out of {1} glyphs into the atlas.", remaining, (int)msdfData.glyphs.size());
 	}
 
-	if (m_TextureAtlas)
-		return true;
-
 	int width = 0, height = 0;
 	atlasPacker.getDimensions(width, height);
 	ASSERT(width > 0 && height > 0, "Area of font atlas cannot be zero");
@@ -112,17 +330,336 @@ bool Font::Load(const std::filesystem::path& filepath)
 	generatorAttributes.scanlinePass = true;
 	generator.setAttributes(generatorAttributes);
 	generator.setThreadCount(8);
-	generator.generate(m_MSDFData->glyphs.data(), (int)m_MSDFData->glyphs.size());
+	generator.generate(msdfData.glyphs.data(), (int)msdfData.glyphs.size());
 
 	msdfgen::BitmapConstRef<float, bytes> bitmap = (msdfgen::BitmapConstRef<float, bytes>)generator.atlasStorage();
 
-	m_TextureAtlas = Texture2D::Create(bitmap.width, bitmap.height, Texture::Format::RGBA32F, (void*)bitmap.pixels);
+	// Stored as 8 bit so the cache stays small, the same precision the png cache had
+	m_TextureAtlasPixels.resize((size_t)bitmap.width * bitmap.height * bytes);
+	for (size_t i = 0; i < m_TextureAtlasPixels.size(); i++)
+		m_TextureAtlasPixels[i] = DistanceToByte(bitmap.pixels[i]);
+
+	m_TextureAtlas = Texture2D::Create(bitmap.width, bitmap.height, Texture::Format::RGBA, m_TextureAtlasPixels.data());
 	m_TextureAtlas->SetFilterMethod(Texture::FilterMethod::Linear);
 
+	const msdfgen::FontMetrics& metrics = msdfData.fontGeometry.getMetrics();
+	m_Metrics.ascenderY = metrics.ascenderY;
+	m_Metrics.descenderY = metrics.descenderY;
+	m_Metrics.lineHeight = metrics.lineHeight;
+	m_GeometryScale = msdfData.fontGeometry.getGeometryScale();
+
+	std::unordered_map<int, char32_t> codepoints;
+	for (const msdf_atlas::GlyphGeometry& glyph : msdfData.glyphs)
+	{
+		AddGlyph(glyph.getCodepoint(), glyph, 0);
+		codepoints[glyph.getIndex()] = glyph.getCodepoint();
+	}
+
+	// The kerning is keyed by glyph index
+	for (const auto& [pair, advance] : msdfData.fontGeometry.getKerning())
+	{
+		auto first = codepoints.find(pair.first);
+		auto second = codepoints.find(pair.second);
+		if (first != codepoints.end() && second != codepoints.end())
+			m_Kerning[KerningKey(first->second, second->second)] = advance;
+	}
+
 	msdfgen::destroyFont(fontHandle);
 	msdfgen::deinitializeFreetype(ftHandle);
+	return true;
+}
+
+void Font::AddGlyph(char32_t codepoint, const msdf_atlas::GlyphGeometry& geometry, uint32_t atlas)
+{
+	Glyph& glyph = m_Glyphs[codepoint];
+	glyph.advance = geometry.getAdvance();
+	geometry.getQuadPlaneBounds(glyph.planeLeft, glyph.planeBottom, glyph.planeRight, glyph.planeTop);
+	geometry.getQuadAtlasBounds(glyph.atlasLeft, glyph.atlasBottom, glyph.atlasRight, glyph.atlasTop);
+	glyph.atlas = atlas;
+	m_GlyphOrder.push_back(codepoint);
+}
+
+void Font::RequestGlyphs(const std::vector<char32_t>& codepoints)
+{
+	if (!m_GlyphRequests)
+		return;
+
+	std::vector<char32_t> newCodepoints;
+	for (char32_t codepoint : codepoints)
+	{
+		if (m_RequestedGlyphs.insert(codepoint).second)
+			newCodepoints.push_back(codepoint);
+	}
+
+	if (newCodepoints.empty())
+		return;
+
+	ThreadPool::Enqueue([requests = m_GlyphRequests, filepath = m_Filepath, geometryScale = m_GeometryScale, codepoints = std::move(newCodepoints)]()
+		{
+			PROFILE_SCOPE("Generate Glyphs");
+
+			// Each job opens the font itself as FreeType handles can't be shared between threads
+			msdfgen::FreetypeHandle* ftHandle = msdfgen::initializeFreetype();
+			msdfgen::FontHandle* fontHandle = ftHandle ? msdfgen::loadFont(ftHandle, filepath.string().c_str()) : nullptr;
+
+			std::vector<GeneratedGlyph> glyphs(codepoints.size());
+			for (size_t i = 0; i < codepoints.size(); i++)
+			{
+				GeneratedGlyph& glyph = glyphs[i];
+				glyph.codepoint = codepoints[i];
+				glyph.loaded = fontHandle && glyph.geometry.load(fontHandle, geometryScale, codepoints[i]);
+				if (glyph.loaded)
+					GenerateGlyph(glyph);
+			}
+
+			if (fontHandle)
+				msdfgen::destroyFont(fontHandle);
+			if (ftHandle)
+				msdfgen::deinitializeFreetype(ftHandle);
+
+			std::scoped_lock lock(requests->mutex);
+			std::move(glyphs.begin(), glyphs.end(), std::back_inserter(requests->generated));
+		});
+}
+
+void Font::AddGeneratedGlyphs()
+{
+	PROFILE_FUNCTION();
+
+	std::scoped_lock lock(s_FontsMutex);
+	for (Font* font : s_Fonts)
+		font->AddGlyphs();
+}
+
+void Font::AddGlyphs()
+{
+	if (!m_GlyphRequests)
+		return;
 
-	// Cache the texture to png file
-	msdfgen::savePng(bitmap, cachePath.string().c_str());
+	std::vector<GeneratedGlyph> generated;
+	{
+		std::scoped_lock lock(m_GlyphRequests->mutex);
+		generated.swap(m_GlyphRequests->generated);
+	}
+
+	if (generated.empty())
+		return;
+
+	for (GeneratedGlyph& glyph : generated)
+	{
+		// Glyphs the font doesn't have stay requested so they aren't generated again
+		if (!glyph.loaded)
+			continue;
+
+		uint32_t atlas = 0;
+		if (glyph.width > 0 && glyph.height > 0)
+		{
+			uint32_t pageIndex;
+			AtlasPacker::Rect rect;
+			if (!PlaceGlyph(glyph.geometry, pageIndex, rect))
+			{
+				ENGINE_WARN("Font atlas of {0} is full, could not add glyph U+{1:04X}", m_Filepath, (uint32_t)glyph.codepoint);
+				continue;
+			}
+
+			GlyphPage& page = m_GlyphPages[pageIndex];
+			for (int row = 0; row < glyph.height; row++)
+			{
+				memcpy(&page.pixels[(((size_t)rect.y + row) * s_GlyphPageSize + rect.x) * 4],
+					&glyph.pixels[(size_t)row * glyph.width * 4], (size_t)glyph.width * 4);
+			}
+
+			// Copy just the new glyph into the page
+			Ref<Texture2D> glyphTexture = Texture2D::Create(glyph.width, glyph.height, Texture::Format::RGBA, glyph.pixels.data());
+			if (!glyphTexture || !page.texture->SetRegion(rect.x, rect.y, *glyphTexture))
+				page.texture->SetData(page.pixels.data());
+
+			m_GlyphRects[glyph.codepoint] = rect;
+			atlas = pageIndex + 1;
+		}
+
+		AddGlyph(glyph.codepoint, glyph.geometry, atlas);
+		m_CacheDirty = true;
+	}
+
+	m_Generation++;
+}
+
+// Pack the glyph's box into the first page with room for it, adding a page if they are all full
+bool Font::PlaceGlyph(msdf_atlas::GlyphGeometry& glyph, uint32_t& pageIndex, AtlasPacker::Rect& rect)
+{
+	int width, height;
+	glyph.getBoxSize(width, height);
+
+	for (pageIndex = 0; pageIndex < (uint32_t)m_GlyphPages.size(); pageIndex++)
+	{
+		if (m_GlyphPages[pageIndex].packer.Insert(width + s_GlyphPadding, height + s_GlyphPadding, rect))
+			break;
+	}
+
+	if (pageIndex == (uint32_t)m_GlyphPages.size())
+	{
+		if (m_GlyphPages.size() >= s_MaxGlyphPages)
+			return false;
+		AddGlyphPage(nullptr);
+		if (!m_GlyphPages.back().packer.Insert(width + s_GlyphPadding, height + s_GlyphPadding, rect))
+			return false;
+	}
+
+	glyph.placeBox(rect.x, rect.y);
 	return true;
-}
\ No newline at end of file
+}
+
+void Font::AddGlyphPage(const uint8_t* pixels)
+{
+	GlyphPage& page = m_GlyphPages.emplace_back();
+	page.packer.Reset(s_GlyphPageSize, s_GlyphPageSize);
+	if (pixels)
+		page.pixels.assign(pixels, pixels + (size_t)s_GlyphPageSize * s_GlyphPageSize * 4);
+	else
+		page.pixels.resize((size_t)s_GlyphPageSize * s_GlyphPageSize * 4, 0);
+
+	page.texture = Texture2D::Create(s_GlyphPageSize, s_GlyphPageSize, Texture::Format::RGBA, page.pixels.data());
+	page.texture->SetFilterMethod(Texture::FilterMethod::Linear);
+	page.texture->SetWrapMethod(Texture::WrapMethod::Clamp);
+}
+
+// Read the glyphs, kerning and atlases in one go, nothing is generated if the cache matches the font file
+bool Font::LoadCache()
+{
+	PROFILE_FUNCTION();
+
+	std::ifstream file(CachePath(m_Filepath), std::ios::in | std::ios::binary | std::ios::ate);
+	if (!file)
+		return false;
+
+	std::vector<uint8_t> contents((size_t)file.tellg());
+	file.seekg(0);
+	if (contents.size() < sizeof(FontCacheHeader) || !file.read((char*)contents.data(), contents.size()))
+		return false;
+
+	FontCacheHeader header;
+	memcpy(&header, contents.data(), sizeof(header));
+	if (memcmp(header.magic, s_CacheMagic, sizeof(header.magic)) != 0 || header.version != s_CacheVersion
+		|| header.hash != m_Hash || header.pageCount > s_MaxGlyphPages)
+	{
+		ENGINE_TRACE("Font cache of {0} is out of date", m_Filepath);
+		return false;
+	}
+
+	const size_t atlasSize = (size_t)header.atlasWidth * header.atlasHeight * 4;
+	const size_t pageSize = (size_t)s_GlyphPageSize * s_GlyphPageSize * 4;
+	const size_t expectedSize = sizeof(FontCacheHeader) + header.glyphCount * sizeof(FontCacheGlyph)
+		+ header.kerningCount * sizeof(FontCacheKerning) + atlasSize + header.pageCount * pageSize;
+	if (contents.size() != expectedSize || atlasSize == 0)
+	{
+		ENGINE_WARN("Font cache of {0} is corrupt", m_Filepath);
+		return false;
+	}
+
+	const uint8_t* data = contents.data() + sizeof(FontCacheHeader);
+
+	m_GeometryScale = header.geometryScale;
+	m_Metrics.ascenderY = header.ascenderY;
+	m_Metrics.descenderY = header.descenderY;
+	m_Metrics.lineHeight = header.lineHeight;
+
+	// Pack the generated glyphs again in the same order so glyphs added later go around them
+	std::vector<AtlasPacker> packers(header.pageCount, AtlasPacker(s_GlyphPageSize, s_GlyphPageSize));
+	for (uint32_t i = 0; i < header.glyphCount; i++, data += sizeof(FontCacheGlyph))
+	{
+		FontCacheGlyph cached;
+		memcpy(&cached, data, sizeof(cached));
+
+		const char32_t codepoint = (char32_t)cached.codepoint;
+		if (cached.glyph.atlas > header.pageCount)
+			return false;
+
+		m_Glyphs[codepoint] = cached.glyph;
+		m_GlyphOrder.push_back(codepoint);
+		m_RequestedGlyphs.insert(codepoint);
+
+		if (cached.glyph.atlas > 0)
+		{
+			AtlasPacker& packer = packers[cached.glyph.atlas - 1];
+			AtlasPacker::Rect rect;
+			if (packer.GetWidth() > 0 && (!packer.Insert(cached.rect.width + s_GlyphPadding, cached.rect.height + s_GlyphPadding, rect)
+				|| rect.x != cached.rect.x || rect.y != cached.rect.y))
+			{
+				packer.Reset(0, 0); // can't tell where the free space is, leave the page as it is
+			}
+			m_GlyphRects[codepoint] = cached.rect;
+		}
+	}
+
+	for (uint32_t i = 0; i < header.kerningCount; i++, data += sizeof(FontCacheKerning))
+	{
+		FontCacheKerning kerning;
+		memcpy(&kerning, data, sizeof(kerning));
+		m_Kerning[KerningKey(kerning.first, kerning.second)] = kerning.advance;
+	}
+
+	m_TextureAtlasPixels.assign(data, data + atlasSize);
+	data += atlasSize;
+	m_TextureAtlas = Texture2D::Create(header.atlasWidth, header.atlasHeight, Texture::Format::RGBA, m_TextureAtlasPixels.data());
+	m_TextureAtlas->SetFilterMethod(Texture::FilterMethod::Linear);
+
+	for (uint32_t i = 0; i < header.pageCount; i++, data += pageSize)
+	{
+		AddGlyphPage(data);
+		m_GlyphPages.back().packer = packers[i];
+	}
+	return true;
+}
+
+void Font::SaveCache() const
+{
+	PROFILE_FUNCTION();
+
+	if (!m_TextureAtlas || m_TextureAtlasPixels.empty())
+		return;
+
+	FontCacheHeader header = {};
+	memcpy(header.magic, s_CacheMagic, sizeof(header.magic));
+	header.version = s_CacheVersion;
+	header.hash = m_Hash;
+	header.geometryScale = m_GeometryScale;
+	header.ascenderY = m_Metrics.ascenderY;
+	header.descenderY = m_Metrics.descenderY;
+	header.lineHeight = m_Metrics.lineHeight;
+	header.atlasWidth = m_TextureAtlas->GetWidth();
+	header.atlasHeight = m_TextureAtlas->GetHeight();
+	header.pageCount = (uint32_t)m_GlyphPages.size();
+	header.glyphCount = (uint32_t)m_GlyphOrder.size();
+	header.kerningCount = (uint32_t)m_Kerning.size();
+
+	std::vector<FontCacheGlyph> glyphs(m_GlyphOrder.size());
+	for (size_t i = 0; i < m_GlyphOrder.size(); i++)
+	{
+		const char32_t codepoint = m_GlyphOrder[i];
+		glyphs[i].codepoint = (uint32_t)codepoint;
+		glyphs[i].glyph = m_Glyphs.at(codepoint);
+		auto rect = m_GlyphRects.find(codepoint);
+		if (rect != m_GlyphRects.end())
+			glyphs[i].rect = rect->second;
+	}
+
+	std::vector<FontCacheKerning> kerning;
+	kerning.reserve(m_Kerning.size());
+	for (const auto& [key, advance] : m_Kerning)
+		kerning.push_back({ (uint32_t)(key >> 32), (uint32_t)key, advance });
+
+	std::ofstream file(CachePath(m_Filepath), std::ios::out | std::ios::binary);
+	if (!file)
+	{
+		ENGINE_WARN("Could not write font cache for {0}", m_Filepath);
+		return;
+	}
+
+	file.write((const char*)&header, sizeof(header));
+	file.write((const char*)glyphs.data(), glyphs.size() * sizeof(FontCacheGlyph));
+	file.write((const char*)kerning.data(), kerning.size() * sizeof(FontCacheKerning));
+	file.write((const char*)m_TextureAtlasPixels.data(), m_TextureAtlasPixels.size());
+	for (const GlyphPage& page : m_GlyphPages)
+		file.write((const char*)page.pixels.data(), page.pixels.size());
+}
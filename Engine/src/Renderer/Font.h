@@ -3,29 +3,102 @@
 #include "Core/Asset.h"
 #include "cereal/access.hpp"
 #include "Texture.h"
+#include "AtlasPacker.h"
 
-struct MSDFData;
+#include <unordered_map>
+#include <unordered_set>
+
+struct GlyphRequests;
+
+namespace msdf_atlas { class GlyphGeometry; }
 
 class Font : public Asset
 {
 public:
+	// Scaled so the distance from the descender to the ascender is one unit before the layout normalises it
+	struct Metrics
+	{
+		double ascenderY = 0.0;
+		double descenderY = 0.0;
+		double lineHeight = 0.0;
+	};
+
+	struct Glyph
+	{
+		double advance = 0.0;
+		double planeLeft = 0.0, planeBottom = 0.0, planeRight = 0.0, planeTop = 0.0;
+		double atlasLeft = 0.0, atlasBottom = 0.0, atlasRight = 0.0, atlasTop = 0.0; // in pixels
+		uint32_t atlas = 0; // 0 is the main atlas, glyphs generated after the font was loaded are in the pages after it
+	};
+
 	Font();
 	Font(const std::filesystem::path& filepath);
+	Font(const Font&) = delete;
+	Font& operator=(const Font&) = delete;
 	~Font();
 
 	// Inherited via Asset
 	virtual bool Load(const std::filesystem::path& filepath) override;
 
 	Ref<Texture2D> GetFontAtlas() const { return m_TextureAtlas; }
-	const MSDFData* GetMSDFData() const { return m_MSDFData; }
+	const Ref<Texture2D>& GetAtlas(uint32_t index) const { return index == 0 ? m_TextureAtlas : m_GlyphPages[index - 1].texture; }
+
+	const Metrics& GetMetrics() const { return m_Metrics; }
+	const Glyph* GetGlyph(char32_t codepoint) const;
+
+	// Advance from one glyph to the next including kerning, false if either glyph is missing
+	bool GetAdvance(double& advance, char32_t codepoint, char32_t nextCodepoint) const;
+
+	// Generate glyphs that aren't in the atlas on a worker thread, they are added to the font at the start of a later frame.
+	// Codepoints that have been requested before are ignored
+	void RequestGlyphs(const std::vector<char32_t>& codepoints);
+
+	// Changes whenever glyphs are added or the font is reloaded
+	uint32_t GetGeneration() const { return m_Generation; }
 
 	static void Init();
 	static void Shutdown();
 
+	// Add the glyphs that have finished generating to their fonts
+	static void AddGeneratedGlyphs();
+
 	static Ref<Font> GetDefaultFont() { return s_DefaultFont; }
 private:
+	struct GlyphPage
+	{
+		Ref<Texture2D> texture;
+		AtlasPacker packer;
+		std::vector<uint8_t> pixels; // kept for the cache
+	};
+
+	bool Generate();
+	void AddGlyphs();
+	void AddGlyph(char32_t codepoint, const msdf_atlas::GlyphGeometry& geometry, uint32_t atlas);
+	bool PlaceGlyph(msdf_atlas::GlyphGeometry& glyph, uint32_t& pageIndex, AtlasPacker::Rect& rect);
+	void AddGlyphPage(const uint8_t* pixels);
+
+	bool LoadCache();
+	void SaveCache() const;
+
+	uint64_t m_Hash = 0; // of the font file and the generator settings
+	double m_GeometryScale = 1.0;
+	Metrics m_Metrics;
+
+	std::unordered_map<char32_t, Glyph> m_Glyphs;
+	std::unordered_map<uint64_t, double> m_Kerning;
+	std::vector<char32_t> m_GlyphOrder; // the main atlas glyphs then the generated glyphs in the order they were packed
+	std::unordered_map<char32_t, AtlasPacker::Rect> m_GlyphRects; // of the generated glyphs in their pages
+
 	Ref<Texture2D> m_TextureAtlas;
-	MSDFData* m_MSDFData = nullptr;
+	std::vector<uint8_t> m_TextureAtlasPixels;
+	std::vector<GlyphPage> m_GlyphPages;
+
+	std::unordered_set<char32_t> m_RequestedGlyphs;
+	Ref<GlyphRequests> m_GlyphRequests;
+	bool m_CacheDirty = false;
+
+	uint32_t m_Generation = 0;
 
 	static Ref<Font> s_DefaultFont;
-};
\ No newline at end of file
+	static std::vector<Font*> s_Fonts;
+};
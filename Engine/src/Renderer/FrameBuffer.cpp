@@ -7,11 +7,17 @@
 #include "Platform/DirectX/DirectX11FrameBuffer.h"
 #endif // __WINDOWS__
 #include "Platform/Vulkan/VulkanFrameBuffer.h"
+#include "Platform/Null/NullFrameBuffer.h"
+#include "Platform/Software/SoftwareFrameBuffer.h"
 
 Ref<FrameBuffer> FrameBuffer::Create(const FrameBufferSpecification& specification)
 {
 	switch (Renderer::GetAPI())
 	{
+	case RendererAPI::API::None:
+		return CreateRef<NullFrameBuffer>(specification);
+	case RendererAPI::API::Software:
+		return CreateRef<SoftwareFrameBuffer>(specification);
 #ifdef __WINDOWS__
 	case RendererAPI::API::Directx11:
 		ENGINE_WARN("Could not create Frame Buffer: DirectX is not currently supported");
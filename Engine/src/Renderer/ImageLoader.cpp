@@ -0,0 +1,189 @@
+#include "stdafx.h"
+#include "ImageLoader.h"
+
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+#include "stb/stb_image.h"
+
+#include "Renderer.h"
+#include "Core/ThreadPool.h"
+
+struct PrefetchedImage
+{
+	enum class State { Queued, Decoding, Decoded };
+
+	std::atomic<State> state = State::Queued;
+	std::mutex mutex;
+	std::condition_variable decoded;
+	Image image;
+	bool loaded = false;
+};
+
+struct ImageLoaderData
+{
+	std::mutex mutex;
+	std::unordered_map<std::string, Ref<PrefetchedImage>> prefetched;
+};
+
+static ImageLoaderData s_Data;
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static bool Decode(const std::filesystem::path& filepath, Image& image)
+{
+	PROFILE_FUNCTION();
+
+	// The flip is per thread so images can be decoded on several threads at once. DirectX textures start at the top row
+	stbi_set_flip_vertically_on_load_thread(Renderer::GetAPI() != RendererAPI::API::Directx11);
+
+	int width, height, channels;
+	stbi_uc* data = stbi_load(filepath.string().c_str(), &width, &height, &channels, 0);
+	if (!data)
+	{
+		ENGINE_ERROR("stb image failure: {0} {1}", stbi_failure_reason(), filepath);
+		return false;
+	}
+
+	image.width = (uint32_t)width;
+	image.height = (uint32_t)height;
+	image.channels = (uint32_t)channels;
+	image.pixels.assign(data, data + (size_t)width * height * channels);
+
+	stbi_image_free(data);
+	return true;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Grey values are spread across red, green and blue, alpha is opaque when the image has none
+static void ConvertChannels(Image& image, uint32_t channels)
+{
+	if (image.channels == channels)
+		return;
+
+	const size_t pixelCount = (size_t)image.width * image.height;
+	const bool hasAlpha = image.channels == 2 || image.channels == 4;
+
+	std::vector<uint8_t> pixels(pixelCount * channels);
+	for (size_t i = 0; i < pixelCount; i++)
+	{
+		const uint8_t* in = &image.pixels[i * image.channels];
+		uint8_t* out = &pixels[i * channels];
+
+		uint8_t r = in[0], g = in[0], b = in[0];
+		if (image.channels >= 3)
+		{
+			g = in[1];
+			b = in[2];
+		}
+		uint8_t a = hasAlpha ? in[image.channels - 1] : 255;
+
+		if (channels >= 3)
+		{
+			out[0] = r;
+			out[1] = g;
+			out[2] = b;
+		}
+		else
+		{
+			out[0] = (uint8_t)((r * 77 + g * 150 + b * 29) >> 8);
+		}
+
+		if (channels == 2 || channels == 4)
+			out[channels - 1] = a;
+	}
+
+	image.pixels = std::move(pixels);
+	image.channels = channels;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Only one of the worker and the thread loading the image decodes it
+static void DecodePrefetched(PrefetchedImage& prefetched, const std::filesystem::path& filepath)
+{
+	PrefetchedImage::State expected = PrefetchedImage::State::Queued;
+	if (!prefetched.state.compare_exchange_strong(expected, PrefetchedImage::State::Decoding))
+		return;
+
+	bool loaded = Decode(filepath, prefetched.image);
+	{
+		std::lock_guard lock(prefetched.mutex);
+		prefetched.loaded = loaded;
+		prefetched.state = PrefetchedImage::State::Decoded;
+	}
+	prefetched.decoded.notify_all();
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void ImageLoader::Prefetch(const std::vector<std::filesystem::path>& filepaths)
+{
+	PROFILE_FUNCTION();
+
+	// Nothing is gained without workers to decode on, and the null renderer never reads the pixels
+	if (ThreadPool::GetThreadCount() <= 1 || Renderer::GetAPI() == RendererAPI::API::None)
+		return;
+
+	for (const std::filesystem::path& filepath : filepaths)
+	{
+		Ref<PrefetchedImage> prefetched = CreateRef<PrefetchedImage>();
+		{
+			std::lock_guard lock(s_Data.mutex);
+			if (!s_Data.prefetched.try_emplace(filepath.string(), prefetched).second)
+				continue;
+		}
+
+		ThreadPool::Enqueue([prefetched, filepath]()
+			{
+				DecodePrefetched(*prefetched, filepath);
+			});
+	}
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+bool ImageLoader::Load(const std::filesystem::path& filepath, Image& image, uint32_t channels)
+{
+	PROFILE_FUNCTION();
+
+	Ref<PrefetchedImage> prefetched;
+	{
+		std::lock_guard lock(s_Data.mutex);
+		if (auto it = s_Data.prefetched.find(filepath.string()); it != s_Data.prefetched.end())
+		{
+			prefetched = it->second;
+			s_Data.prefetched.erase(it);
+		}
+	}
+
+	bool loaded;
+	if (prefetched)
+	{
+		// Decode it here if no worker has started on it yet, otherwise wait for the worker
+		DecodePrefetched(*prefetched, filepath);
+
+		std::unique_lock lock(prefetched->mutex);
+		prefetched->decoded.wait(lock, [&prefetched]() { return prefetched->state == PrefetchedImage::State::Decoded; });
+		loaded = prefetched->loaded;
+		image = std::move(prefetched->image);
+	}
+	else
+	{
+		loaded = Decode(filepath, image);
+	}
+
+	if (loaded && channels != 0)
+		ConvertChannels(image, channels);
+	return loaded;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void ImageLoader::ClearPrefetched()
+{
+	std::lock_guard lock(s_Data.mutex);
+	s_Data.prefetched.clear();
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <filesystem>
+#include <vector>
+
+// The pixels of an image file, 8 bits per channel with the bottom row first except on DirectX
+struct Image
+{
+	std::vector<uint8_t> pixels;
+	uint32_t width = 0;
+	uint32_t height = 0;
+	uint32_t channels = 0;
+};
+
+// Decodes image files for textures. Images can be prefetched so they are decoded on the worker threads while the
+// main thread does something else, the texture then only has to upload the pixels
+class ImageLoader
+{
+public:
+	// Start decoding the images on the worker threads
+	static void Prefetch(const std::vector<std::filesystem::path>& filepaths);
+
+	// Decode the image, or take it from the prefetched images. A channel count of 0 keeps the channels of the file,
+	// otherwise the image is converted to that many channels
+	static bool Load(const std::filesystem::path& filepath, Image& image, uint32_t channels = 0);
+
+	// Drop prefetched images that were never loaded
+	static void ClearPrefetched();
+};
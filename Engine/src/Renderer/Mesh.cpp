@@ -32,7 +32,7 @@ Mesh::Mesh(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& ind
 Mesh::Mesh(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, const std::vector<Submesh>& submeshes, const std::vector<Ref<Material>>& materials)
 	:m_Vertices(vertices), m_Indices(indices), m_Submeshes(submeshes), m_Materials(materials)
 {
-	m_VertexBuffer = VertexBuffer::Create(m_Vertices.data(), (uint32_t)indices.size());
+	m_VertexBuffer = VertexBuffer::Create(m_Vertices.data(), (uint32_t)(m_Vertices.size() * sizeof(Vertex)));
 	m_VertexBuffer->SetLayout(s_StaticMeshLayout);
 	m_IndexBuffer = IndexBuffer::Create(m_Indices.data(), (uint32_t)indices.size());
 
@@ -3,6 +3,7 @@
 #include "Renderer.h"
 
 #include "Platform/OpenGL/OpenGLPipeline.h"
+#include "Platform/Null/NullPipeline.h"
 #ifdef __WINDOWS__
 #include "Platform/DirectX/DirectX11Pipeline.h"
 #endif // __WINDOWS__
@@ -12,7 +13,8 @@ Ref<Pipeline> Pipeline::Create(const Spec& spec)
 	switch (Renderer::GetAPI())
 	{
 	case RendererAPI::API::None:
-		break;
+	case RendererAPI::API::Software:
+		return CreateRef<NullPipeline>(spec);
 	case RendererAPI::API::OpenGL:
 		return CreateRef<OpenGLPipeline>(spec);
 #ifdef __WINDOWS__
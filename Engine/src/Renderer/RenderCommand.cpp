@@ -8,15 +8,21 @@
 #include "Platform/DirectX/DirectX11RendererAPI.h"
 #endif // __WINDOWS__
 #include "Platform/Vulkan/VulkanRendererAPI.h"
+#include "Platform/Null/NullRendererAPI.h"
+#include "Platform/Software/SoftwareRendererAPI.h"
 
 Scope<RendererAPI> RenderCommand::s_RendererAPI = nullptr;
 
-int RenderCommand::CreateRendererAPI()
+int RenderCommand::CreateRendererAPI(bool headless, bool software)
 {
 	PROFILE_FUNCTION();
 	Settings::SetDefaultValue("Renderer", "API", "OpenGL");
 
 	std::string api = Settings::GetValue("Renderer", "API");
+	if (headless && software)
+		api = "Software";
+	else if (headless && api != "Software")
+		api = "None";
 	if (api == "OpenGL")
 	{
 		RendererAPI::s_API = RendererAPI::API::OpenGL;
@@ -46,12 +52,22 @@ int RenderCommand::CreateRendererAPI()
 		s_RendererAPI = CreateScope<VulkanRendererAPI>();
 		return 0;
 	}
+	else if (api == "Software")
+	{
+		if (!headless)
+		{
+			ENGINE_ERROR("The Software API can only be used in headless mode");
+			return 1;
+		}
+		RendererAPI::s_API = RendererAPI::API::Software;
+		s_RendererAPI = CreateScope<SoftwareRendererAPI>();
+		return 0;
+	}
 	else if (api == "None")
 	{
 		RendererAPI::s_API = RendererAPI::API::None;
-		CORE_ASSERT(false, "API of none is not currently supported!");
-		s_RendererAPI = nullptr;
-		return 1;
+		s_RendererAPI = CreateScope<NullRendererAPI>();
+		return 0;
 	}
 
 	ENGINE_ERROR("API: {0} is not recognised!", api);
@@ -5,8 +5,8 @@
 class RenderCommand
 {
 public:
-	// Create a Renderer API object
-	static int CreateRendererAPI();
+	// Create a Renderer API object, headless uses the None API unless the Software API is selected or software is set
+	static int CreateRendererAPI(bool headless = false, bool software = false);
 
 	// Initialise the Renderer
 	inline static bool Init()
@@ -48,9 +48,43 @@ public:
 		s_RendererAPI->DrawIndexed(indexCount, startIndex, vertexOffset, backFaceCull, drawMode);
 	}
 
-	inline static void DrawLines(uint32_t vertexCount = 0)
+	// Draws the same primitives instanceCount times, per instance data is read by the shader
+	inline static void DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex = 0, uint32_t vertexOffset = 0, bool backFaceCull = true, DrawMode drawMode = DrawMode::FILL)
 	{
-		s_RendererAPI->DrawLines(vertexCount);
+		s_RendererAPI->DrawIndexedInstanced(indexCount, instanceCount, startIndex, vertexOffset, backFaceCull, drawMode);
+	}
+
+	inline static void DrawLines(uint32_t vertexCount = 0, uint32_t firstVertex = 0)
+	{
+		s_RendererAPI->DrawLines(vertexCount, firstVertex);
+	}
+
+	// Mark the commands submitted so far so the CPU can wait for the GPU to finish them
+	inline static uint64_t InsertFence()
+	{
+		return s_RendererAPI->InsertFence();
+	}
+
+	inline static bool WaitFence(uint64_t fence)
+	{
+		return s_RendererAPI->WaitFence(fence);
+	}
+
+	inline static void DeleteFence(uint64_t fence)
+	{
+		s_RendererAPI->DeleteFence(fence);
+	}
+
+	// Write the back buffer to an image file, returns false if the API can't read it back
+	inline static bool SaveBackBuffer(const std::filesystem::path& filepath)
+	{
+		return s_RendererAPI->SaveBackBuffer(filepath);
+	}
+
+	// The active Renderer API, used to inspect the calls recorded by the null API
+	inline static RendererAPI* GetRendererAPI()
+	{
+		return s_RendererAPI.get();
 	}
 private:
 	static Scope<RendererAPI> s_RendererAPI;
@@ -0,0 +1,75 @@
+#include "stdafx.h"
+#include "RenderQueue.h"
+
+#include <cstring>
+
+uint64_t RenderQueue::MakeSortKey(Pass pass, uint32_t shaderId, uint32_t materialId, uint32_t meshId, uint32_t submeshIndex, float depth)
+{
+	// The bits of a positive float sort in the same order as the float
+	float clampedDepth = depth > 0.0f ? depth : 0.0f;
+	uint32_t depthBits;
+	memcpy(&depthBits, &clampedDepth, sizeof(uint32_t));
+
+	uint64_t key = (uint64_t)pass << 62;
+	if (pass == Pass::Opaque)
+	{
+		key |= (uint64_t)(shaderId & 0x3FF) << 52;
+		key |= (uint64_t)(materialId & 0x3FFF) << 38;
+		key |= (uint64_t)(meshId & 0x3FFF) << 24;
+		key |= (uint64_t)(submeshIndex & 0xFF) << 16;
+		key |= (uint64_t)(depthBits >> 16);
+	}
+	else
+	{
+		key |= (uint64_t)(~depthBits) << 30;
+		key |= (uint64_t)(shaderId & 0xFF) << 22;
+		key |= (uint64_t)(materialId & 0xFF) << 14;
+		key |= (uint64_t)(meshId & 0xFF) << 6;
+		key |= (uint64_t)(submeshIndex & 0x3F);
+	}
+	return key;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void RenderQueue::Submit(const DrawCommand& command)
+{
+	m_SortedEntries.push_back({ command.sortKey, (uint32_t)m_Commands.size() });
+	m_Commands.push_back(command);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void RenderQueue::Sort()
+{
+	PROFILE_FUNCTION();
+
+	// Least significant digit radix sort, one byte at a time
+	m_Scratch.resize(m_SortedEntries.size());
+	for (uint32_t shift = 0; shift < 64; shift += 8)
+	{
+		size_t counts[257] = { 0 };
+		for (const SortEntry& entry : m_SortedEntries)
+			counts[((entry.key >> shift) & 0xFF) + 1]++;
+
+		// Every key has the same byte so this pass wouldn't move anything
+		if (counts[((m_SortedEntries.empty() ? 0 : m_SortedEntries.front().key >> shift) & 0xFF) + 1] == m_SortedEntries.size())
+			continue;
+
+		for (size_t i = 1; i < 257; i++)
+			counts[i] += counts[i - 1];
+
+		for (const SortEntry& entry : m_SortedEntries)
+			m_Scratch[counts[(entry.key >> shift) & 0xFF]++] = entry;
+
+		std::swap(m_SortedEntries, m_Scratch);
+	}
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void RenderQueue::Clear()
+{
+	m_Commands.clear();
+	m_SortedEntries.clear();
+}
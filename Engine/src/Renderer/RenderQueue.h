@@ -0,0 +1,95 @@
+#pragma once
+
+#include "math/Matrix.h"
+
+class Mesh;
+class Material;
+class Shader;
+
+// A single draw of a range of a mesh
+struct DrawCommand
+{
+	uint64_t sortKey = 0;
+	Mesh* mesh = nullptr;
+	Material* material = nullptr;
+	Shader* shader = nullptr;
+	Shader* instancedShader = nullptr; // null if the material's shader has no instanced variant
+	uint32_t indexCount = 0;
+	uint32_t startIndex = 0;
+	uint32_t vertexOffset = 0;
+	Matrix4x4 transform;
+	int entityId = -1;
+};
+
+// Draw commands ordered by a packed 64 bit key so that commands sharing state are drawn together
+class RenderQueue
+{
+public:
+	enum class Pass : uint8_t
+	{
+		Opaque = 0,
+		Transparent = 1
+	};
+
+	// Opaque:      | pass 2 | shader 10 | material 14 | mesh 14 | submesh 8 | depth 16 | grouped by state then front to back
+	// Transparent: | pass 2 | inverted depth 32 | shader 8 | material 8 | mesh 8 | submesh 6 | back to front
+	// Ids wider than their field wrap, which only costs redundant binds and broken batches
+	static uint64_t MakeSortKey(Pass pass, uint32_t shaderId, uint32_t materialId, uint32_t meshId, uint32_t submeshIndex, float depth);
+
+	void Submit(const DrawCommand& command);
+	void Sort();
+	void Clear();
+
+	bool Empty() const { return m_Commands.empty(); }
+	size_t Size() const { return m_Commands.size(); }
+
+	// Visit the commands in key order, Sort must have been called since the last Submit
+	template<typename Func>
+	void ForEach(Func func) const
+	{
+		for (const SortEntry& entry : m_SortedEntries)
+			func(m_Commands[entry.index]);
+	}
+
+	// Visit runs of consecutive commands that draw the same range of a mesh with the same material
+	// Each run can be drawn as one instanced draw, runs are split at maxBatchSize
+	template<typename Func>
+	void ForEachBatch(size_t maxBatchSize, Func func) const
+	{
+		std::vector<const DrawCommand*> batch;
+		for (const SortEntry& entry : m_SortedEntries)
+		{
+			const DrawCommand* command = &m_Commands[entry.index];
+			if (!batch.empty() && (batch.size() >= maxBatchSize || !CanBatch(*batch.front(), *command)))
+			{
+				func(batch);
+				batch.clear();
+			}
+			batch.push_back(command);
+		}
+
+		if (!batch.empty())
+			func(batch);
+	}
+
+	static bool CanBatch(const DrawCommand& a, const DrawCommand& b)
+	{
+		return a.mesh == b.mesh
+			&& a.material == b.material
+			&& a.shader == b.shader
+			&& a.indexCount == b.indexCount
+			&& a.startIndex == b.startIndex
+			&& a.vertexOffset == b.vertexOffset;
+	}
+
+private:
+	struct SortEntry
+	{
+		uint64_t key;
+		uint32_t index;
+	};
+
+	std::vector<DrawCommand> m_Commands;
+	std::vector<SortEntry> m_SortedEntries;
+	std::vector<SortEntry> m_Scratch;
+};
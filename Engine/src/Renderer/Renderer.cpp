@@ -2,23 +2,15 @@
 #include "Renderer.h"
 #include "Renderer2D.h"
 #include "RenderCommand.h"
+#include "RenderQueue.h"
 
 #include "FrameBuffer.h"
 #include "UniformBuffer.h"
 #include "Texture.h"
 
 #include "Core/core.h"
-
-struct Command
-{
-	Mesh* mesh = nullptr;
-	Material* material = nullptr;
-	uint32_t indexCount = 0;
-	uint32_t startIndex = 0;
-	uint32_t vertexOffset = 0;
-	Matrix4x4 transform;
-	int entityId = -1;
-};
+#include "Core/Frustum.h"
+#include "Core/Statistics.h"
 
 struct RendererData
 {
@@ -27,6 +19,26 @@ struct RendererData
 	Ref<Texture> mixMapTexture;
 
 	DrawMode drawMode = DrawMode::FILL;
+
+	// Counts at the start of the scene, the difference at the end is added to the frame statistics
+	uint32_t drawCallsAtBegin = 0;
+	uint32_t quadsAtBegin = 0;
+	uint32_t batchBreaksAtBegin = 0;
+
+	struct MaterialState
+	{
+		uint32_t id;
+		Shader* shader;
+		Shader* instancedShader;
+	};
+
+	// Small ids for the sort keys, handed out in the order things are first submitted each scene
+	std::unordered_map<const Material*, MaterialState> materialIds;
+	std::unordered_map<const Shader*, uint32_t> shaderIds;
+	std::unordered_map<const Mesh*, uint32_t> meshIds;
+
+	// Instanced variant of each shader, null if there isn't one
+	std::unordered_map<std::string, Ref<Shader>> instancedShaders;
 };
 
 struct SceneData
@@ -46,11 +58,26 @@ struct SceneData
 		int entityId = -1;
 	}ModelBuffer;
 
+	typedef struct ALIGNED_(16) tagINSTANCEALIGNED16
+	{
+		Matrix4x4 modelMatrix;
+		Colour colour;
+		int entityId = -1;
+		int padding[3] = { 0 };
+	}InstanceData;
+
+	// Must match the size of the array in the instanced shaders
+	static constexpr uint32_t s_MaxInstances = 128;
+
 	ConstantBuffer constantBuffer;
 	ModelBuffer modelBuffer;
+	InstanceData instanceBuffer[s_MaxInstances];
+
+	Frustum frustum;
 
 	Ref<UniformBuffer> constantUniformBuffer;
 	Ref<UniformBuffer> modelUniformBuffer;
+	Ref<UniformBuffer> instanceUniformBuffer;
 };
 
 /* ------------------------------------------------------------------------------------------------------------------ */
@@ -59,48 +86,138 @@ RendererData s_RendererData;
 SceneData s_SceneData;
 ShaderLibrary s_ShaderLibrary;
 
-std::vector<Command> s_OpaqueRenderQueue;
-std::vector<Command> s_TransparentRenderQueue;
+RenderQueue s_RenderQueue;
+Renderer::Stats s_Stats;
 
 /* ------------------------------------------------------------------------------------------------------------------ */
 
-void RenderCommandForQueue(const std::vector<Command>& renderQueue)
+static Shader* GetInstancedShader(const std::string& shaderName)
 {
-	for (const auto& command : renderQueue)
+	auto it = s_RendererData.instancedShaders.find(shaderName);
+	if (it != s_RendererData.instancedShaders.end())
+		return it->second.get();
+
+	// The null API compiles nothing, so every shader has an instanced variant and the batching can be checked against it
+	Ref<Shader> shader;
+	RendererAPI::API api = Renderer::GetAPI();
+	if (api == RendererAPI::API::None
+		|| ((api == RendererAPI::API::OpenGL || api == RendererAPI::API::Vulkan)
+			&& std::filesystem::exists(SHADER_DIRECTORY / (shaderName + "Instanced.vert"))))
 	{
-		Ref<Shader> shader;
-		if (s_RendererData.drawMode == DrawMode::WIREFRAME)
-		{
-			//TODO write wireframe geometry shader
-			//shader = s_ShaderLibrary.Load("Wireframe");
-		}
-		else {
-			shader = s_ShaderLibrary.Load(command.material->GetShader());
-		}
+		shader = s_ShaderLibrary.Load(shaderName + "Instanced");
+	}
+	s_RendererData.instancedShaders[shaderName] = shader;
+	return shader.get();
+}
 
-		if (!shader)
-			return;
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void RenderCommandForQueue(const RenderQueue& renderQueue)
+{
+	Shader* boundShader = nullptr;
+	Material* boundMaterial = nullptr;
+	Mesh* boundMesh = nullptr;
+
+	renderQueue.ForEachBatch(SceneData::s_MaxInstances, [&](const std::vector<const DrawCommand*>& batch)
+		{
+			const DrawCommand& command = *batch.front();
+
+			// Repeated draws of the same mesh range and material are drawn as one instanced draw
+			bool instanced = batch.size() > 1 && command.instancedShader != nullptr;
+
+			Shader* shader = instanced ? command.instancedShader : command.shader;
+			if (s_RendererData.drawMode == DrawMode::WIREFRAME)
+			{
+				//TODO write wireframe geometry shader
+				//shader = s_ShaderLibrary.Load("Wireframe").get();
+				shader = nullptr;
+			}
+
+			if (!shader)
+				return;
+
+			if (shader != boundShader)
+			{
+				shader->Bind();
+				boundShader = shader;
+				s_Stats.shaderBinds++;
+			}
+			else
+				s_Stats.stateChangesAvoided++;
+
+			// Materials can bind to any slot, so the defaults are restored whenever the material changes
+			if (command.material != boundMaterial)
+			{
+				s_RendererData.whiteTexture->Bind(0);
+				s_RendererData.normalTexture->Bind(1);
+				s_RendererData.mixMapTexture->Bind(2);
+
+				if (s_RendererData.drawMode == DrawMode::FILL)
+					command.material->BindTextures();
+				boundMaterial = command.material;
+				s_Stats.materialBinds++;
+			}
+			else
+				s_Stats.stateChangesAvoided++;
+
+			if (command.mesh != boundMesh)
+			{
+				if (boundMesh)
+				{
+					boundMesh->GetIndexBuffer()->UnBind();
+					boundMesh->GetVertexBuffer()->UnBind();
+				}
+				command.mesh->GetVertexBuffer()->Bind();
+				command.mesh->GetIndexBuffer()->Bind();
+				boundMesh = command.mesh;
+				s_Stats.meshBinds++;
+			}
+			else
+				s_Stats.stateChangesAvoided++;
+
+			// The rest of the batch shares the shader, material and mesh of the first draw, so each skips all three
+			s_Stats.stateChangesAvoided += 3 * (uint32_t)(batch.size() - 1);
+
+			s_SceneData.modelBuffer.colour = command.material->GetTint();
+			s_SceneData.modelBuffer.textureOffset = command.material->GetTextureOffset();
+			s_SceneData.modelBuffer.tilingFactor = command.material->GetTilingFactor();
+
+			if (instanced)
+			{
+				for (size_t i = 0; i < batch.size(); i++)
+				{
+					s_SceneData.instanceBuffer[i].modelMatrix = batch[i]->transform.GetTranspose();
+					s_SceneData.instanceBuffer[i].colour = batch[i]->material->GetTint();
+					s_SceneData.instanceBuffer[i].entityId = batch[i]->entityId;
+				}
+				s_SceneData.instanceUniformBuffer->SetData(s_SceneData.instanceBuffer, (uint32_t)(sizeof(SceneData::InstanceData) * batch.size()));
+
+				s_SceneData.modelBuffer.modelMatrix = Matrix4x4();
+				s_SceneData.modelBuffer.entityId = -1;
+				s_SceneData.modelUniformBuffer->SetData(&s_SceneData.modelBuffer, sizeof(SceneData::ModelBuffer));
+
+				RenderCommand::DrawIndexedInstanced(command.indexCount, (uint32_t)batch.size(), command.startIndex, command.vertexOffset, !command.material->IsTwoSided(), s_RendererData.drawMode);
+				s_Stats.drawCalls++;
+				s_Stats.instancedDrawCalls++;
+				s_Stats.instances += (uint32_t)batch.size();
+				return;
+			}
+
+			for (const DrawCommand* drawCommand : batch)
+			{
+				s_SceneData.modelBuffer.modelMatrix = drawCommand->transform.GetTranspose();
+				s_SceneData.modelBuffer.entityId = drawCommand->entityId;
+				s_SceneData.modelUniformBuffer->SetData(&s_SceneData.modelBuffer, sizeof(SceneData::ModelBuffer));
+
+				RenderCommand::DrawIndexed(drawCommand->indexCount, drawCommand->startIndex, drawCommand->vertexOffset, !drawCommand->material->IsTwoSided(), s_RendererData.drawMode);
+				s_Stats.drawCalls++;
+			}
+		});
 
-		shader->Bind();
-		s_SceneData.modelBuffer.modelMatrix = command.transform.GetTranspose();
-		s_SceneData.modelBuffer.colour = command.material->GetTint();
-		s_SceneData.modelBuffer.textureOffset = command.material->GetTextureOffset();
-		s_SceneData.modelBuffer.tilingFactor = command.material->GetTilingFactor();
-		s_SceneData.modelBuffer.entityId = command.entityId;
-		s_SceneData.modelUniformBuffer->SetData(&s_SceneData.modelBuffer, sizeof(SceneData::ModelBuffer));
-
-		s_RendererData.whiteTexture->Bind(0);
-		s_RendererData.normalTexture->Bind(1);
-		s_RendererData.mixMapTexture->Bind(2);
-
-		if (s_RendererData.drawMode == DrawMode::FILL)
-			command.material->BindTextures();
-
-		command.mesh->GetVertexBuffer()->Bind();
-		command.mesh->GetIndexBuffer()->Bind();
-		RenderCommand::DrawIndexed(command.indexCount, command.startIndex, command.vertexOffset, !command.material->IsTwoSided(), s_RendererData.drawMode);
-		command.mesh->GetIndexBuffer()->UnBind();
-		command.mesh->GetVertexBuffer()->UnBind();
+	if (boundMesh)
+	{
+		boundMesh->GetIndexBuffer()->UnBind();
+		boundMesh->GetVertexBuffer()->UnBind();
 	}
 }
 
@@ -110,6 +227,7 @@ bool Renderer::Init()
 {
 	s_SceneData.constantUniformBuffer = UniformBuffer::Create(sizeof(SceneData::ConstantBuffer), 0);
 	s_SceneData.modelUniformBuffer = UniformBuffer::Create(sizeof(SceneData::ModelBuffer), 1);
+	s_SceneData.instanceUniformBuffer = UniformBuffer::Create(sizeof(SceneData::instanceBuffer), 2);
 
 	uint32_t whiteTextureData = Colour(Colours::WHITE).HexValue();
 	s_RendererData.whiteTexture = Texture2D::Create(1, 1, Texture2D::Format::RGBA, &whiteTextureData);
@@ -132,6 +250,9 @@ bool Renderer::Init()
 void Renderer::Shutdown()
 {
 	Renderer2D::Shutdown();
+
+	// Which shaders have an instanced variant depends on the API
+	s_RendererData.instancedShaders.clear();
 }
 
 /* ------------------------------------------------------------------------------------------------------------------ */
@@ -145,11 +266,17 @@ void Renderer::OnWindowResize(uint32_t width, uint32_t height)
 
 void Renderer::BeginScene(const Matrix4x4& transform, const Matrix4x4& projection)
 {
-	s_SceneData.constantBuffer.viewProjectionMatrix = (projection * Matrix4x4::Inverse(transform)).GetTranspose();
+	Matrix4x4 viewProjection = projection * Matrix4x4::Inverse(transform);
+	s_SceneData.frustum = Frustum(viewProjection);
+	s_SceneData.constantBuffer.viewProjectionMatrix = viewProjection.GetTranspose();
 	s_SceneData.constantBuffer.eyePosition = transform.ExtractTranslation();
 
 	s_SceneData.constantUniformBuffer->SetData(&s_SceneData.constantBuffer, sizeof(SceneData::ConstantBuffer));
 	Renderer2D::BeginScene();
+
+	s_RendererData.drawCallsAtBegin = s_Stats.drawCalls + Renderer2D::GetStats().drawCalls;
+	s_RendererData.quadsAtBegin = Renderer2D::GetStats().quadCount;
+	s_RendererData.batchBreaksAtBegin = Renderer2D::GetStats().batchBreaks;
 }
 
 /* ------------------------------------------------------------------------------------------------------------------ */
@@ -157,27 +284,19 @@ void Renderer::BeginScene(const Matrix4x4& transform, const Matrix4x4& projectio
 void Renderer::EndScene()
 {
 	Renderer2D::EndScene();
-	//TODO: frustum culling
 
-	// Sort the opqaue front to back to reduce over draw
-	std::sort(s_OpaqueRenderQueue.begin(), s_OpaqueRenderQueue.end(), [](Command& a, Command& b)
-		{
-			return Vector3f::Distance(s_SceneData.constantBuffer.eyePosition, a.transform.ExtractTranslation()) <
-				Vector3f::Distance(s_SceneData.constantBuffer.eyePosition, b.transform.ExtractTranslation());
-		});
+	// Opaque commands are grouped by state, transparent commands are drawn back to front
+	s_RenderQueue.Sort();
+	RenderCommandForQueue(s_RenderQueue);
 
-	// Sort the transparent back to front to render transparent correctly
-	std::sort(s_TransparentRenderQueue.begin(), s_TransparentRenderQueue.end(), [](Command& a, Command& b)
-		{
-			return Vector3f::Distance(s_SceneData.constantBuffer.eyePosition, a.transform.ExtractTranslation()) <
-				Vector3f::Distance(s_SceneData.constantBuffer.eyePosition, b.transform.ExtractTranslation());
-		});
+	s_RenderQueue.Clear();
+	s_RendererData.materialIds.clear();
+	s_RendererData.shaderIds.clear();
+	s_RendererData.meshIds.clear();
 
-	RenderCommandForQueue(s_OpaqueRenderQueue);
-	RenderCommandForQueue(s_TransparentRenderQueue);
-
-	s_OpaqueRenderQueue.clear();
-	s_TransparentRenderQueue.clear();
+	Statistics::Add(Statistics::DrawCalls, (double)(s_Stats.drawCalls + Renderer2D::GetStats().drawCalls - s_RendererData.drawCallsAtBegin));
+	Statistics::Add(Statistics::Quads, (double)(Renderer2D::GetStats().quadCount - s_RendererData.quadsAtBegin));
+	Statistics::Add(Statistics::BatchBreaks, (double)(Renderer2D::GetStats().batchBreaks - s_RendererData.batchBreaksAtBegin));
 }
 
 /* ------------------------------------------------------------------------------------------------------------------ */
@@ -189,9 +308,41 @@ void Renderer::SetDrawMode(DrawMode drawMode)
 
 /* ------------------------------------------------------------------------------------------------------------------ */
 
-void Renderer::Submit(const Ref<Mesh> mesh, const Ref<Material> material, const Matrix4x4& transform, int entityId, uint32_t indexCount, uint32_t startIndex, uint32_t vertexOffset)
+const Renderer::Stats& Renderer::GetStats()
+{
+	return s_Stats;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void Renderer::ResetStats()
+{
+	s_Stats = Stats();
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+const Frustum& Renderer::GetFrustum()
+{
+	return s_SceneData.frustum;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void Renderer::Submit(const Ref<Mesh> mesh, const Ref<Material> material, const Matrix4x4& transform, int entityId, uint32_t indexCount, uint32_t startIndex, uint32_t vertexOffset, uint32_t submeshIndex)
 {
-	Command command;
+	// Submeshes are culled by the caller
+	if (indexCount == 0)
+	{
+		if (!s_SceneData.frustum.Intersects(mesh->GetBounds().Transform(transform)))
+		{
+			Renderer2D::AddCullingStats(0, 1);
+			return;
+		}
+		Renderer2D::AddCullingStats(1, 0);
+	}
+
+	DrawCommand command;
 	command.entityId = entityId;
 	command.indexCount = indexCount ? indexCount : mesh->GetIndexCount();
 	command.startIndex = startIndex;
@@ -200,28 +351,60 @@ void Renderer::Submit(const Ref<Mesh> mesh, const Ref<Material> material, const
 	command.mesh = mesh.get();
 	command.transform = transform;
 
-	if (material->IsTransparent())
-	{
-		s_TransparentRenderQueue.push_back(command);
-	}
-	else
+	// Look the shader up once per material rather than once per draw
+	auto materialIt = s_RendererData.materialIds.find(command.material);
+	if (materialIt == s_RendererData.materialIds.end())
 	{
-		s_OpaqueRenderQueue.push_back(command);
+		RendererData::MaterialState state;
+		state.id = (uint32_t)s_RendererData.materialIds.size();
+		state.shader = s_ShaderLibrary.Load(command.material->GetShader()).get();
+		state.instancedShader = GetInstancedShader(command.material->GetShader());
+		materialIt = s_RendererData.materialIds.emplace(command.material, state).first;
 	}
+	command.shader = materialIt->second.shader;
+	command.instancedShader = materialIt->second.instancedShader;
+
+	uint32_t shaderId = s_RendererData.shaderIds.emplace(command.shader, (uint32_t)s_RendererData.shaderIds.size()).first->second;
+	uint32_t meshId = s_RendererData.meshIds.emplace(command.mesh, (uint32_t)s_RendererData.meshIds.size()).first->second;
+
+	float depth = Vector3f::Distance(s_SceneData.constantBuffer.eyePosition, transform.ExtractTranslation());
+	RenderQueue::Pass pass = command.material->IsTransparent() ? RenderQueue::Pass::Transparent : RenderQueue::Pass::Opaque;
+	// The submesh keeps the draws of each range of a mesh together so they can be instanced
+	command.sortKey = RenderQueue::MakeSortKey(pass, shaderId, materialIt->second.id, meshId, submeshIndex, depth);
+
+	s_RenderQueue.Submit(command);
 }
 
 void Renderer::Submit(const Ref<Mesh> mesh, const Matrix4x4& transform, int entityId)
 {
-	for (const auto& submesh : mesh->GetSubmeshes())
+	const std::vector<Submesh>& submeshes = mesh->GetSubmeshes();
+	for (uint32_t i = 0; i < (uint32_t)submeshes.size(); i++)
 	{
-		Submit(mesh, mesh->GetMaterials()[submesh.materialIndex], transform * submesh.transform, entityId, submesh.indexCount, submesh.firstIndex, submesh.vertexOffset);
+		const Submesh& submesh = submeshes[i];
+		Matrix4x4 submeshTransform = transform * submesh.transform;
+		if (!s_SceneData.frustum.Intersects(submesh.boundingBox.Transform(submeshTransform)))
+		{
+			Renderer2D::AddCullingStats(0, 1);
+			continue;
+		}
+		Renderer2D::AddCullingStats(1, 0);
+		Submit(mesh, mesh->GetMaterials()[submesh.materialIndex], submeshTransform, entityId, submesh.indexCount, submesh.firstIndex, submesh.vertexOffset, i);
 	}
 }
 
 void Renderer::Submit(const Ref<Mesh> mesh, const std::vector<Ref<Material>>& materials, const Matrix4x4& transform, int entityId)
 {
-	for (const auto& submesh : mesh->GetSubmeshes())
+	const std::vector<Submesh>& submeshes = mesh->GetSubmeshes();
+	for (uint32_t i = 0; i < (uint32_t)submeshes.size(); i++)
 	{
-		Submit(mesh, materials[submesh.materialIndex], transform * submesh.transform, entityId, submesh.indexCount, submesh.firstIndex, submesh.vertexOffset);
+		const Submesh& submesh = submeshes[i];
+		Matrix4x4 submeshTransform = transform * submesh.transform;
+		if (!s_SceneData.frustum.Intersects(submesh.boundingBox.Transform(submeshTransform)))
+		{
+			Renderer2D::AddCullingStats(0, 1);
+			continue;
+		}
+		Renderer2D::AddCullingStats(1, 0);
+		Submit(mesh, materials[submesh.materialIndex], submeshTransform, entityId, submesh.indexCount, submesh.firstIndex, submesh.vertexOffset, i);
 	}
 }
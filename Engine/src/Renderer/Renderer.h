@@ -6,6 +6,8 @@
 #include "Material.h"
 #include "Mesh.h"
 
+#include "Core/Frustum.h"
+
 #include "Scene/Components/StaticMeshComponent.h"
 
 class Renderer
@@ -19,9 +21,26 @@ public:
 
 	static void SetDrawMode(DrawMode drawMode);
 
-	static void Submit(const Ref<Mesh> mesh, const Ref<Material> material, const Matrix4x4& transform = Matrix4x4(), int entityId = -1, uint32_t indexCount = 0, uint32_t startIndex = 0, uint32_t vertexOffset = 0);
+	// Frustum of the camera passed to the last BeginScene
+	static const Frustum& GetFrustum();
+
+	static void Submit(const Ref<Mesh> mesh, const Ref<Material> material, const Matrix4x4& transform = Matrix4x4(), int entityId = -1, uint32_t indexCount = 0, uint32_t startIndex = 0, uint32_t vertexOffset = 0, uint32_t submeshIndex = 0);
 	static void Submit(const Ref<Mesh> mesh, const Matrix4x4& transform = Matrix4x4(), int entityId = -1);
 	static void Submit(const Ref<Mesh> mesh, const std::vector<Ref<Material>>& materials, const Matrix4x4& transform = Matrix4x4(), int entityId = -1);
 
+	struct Stats
+	{
+		uint32_t drawCalls = 0;
+		uint32_t instancedDrawCalls = 0;
+		uint32_t instances = 0; // commands drawn by instanced draw calls
+		uint32_t shaderBinds = 0;
+		uint32_t materialBinds = 0;
+		uint32_t meshBinds = 0;
+		uint32_t stateChangesAvoided = 0; // shader, material and mesh binds skipped per draw because the state was already bound
+	};
+
+	static const Stats& GetStats();
+	static void ResetStats();
+
 	inline static RendererAPI::API GetAPI() { return RendererAPI::GetAPI(); }
 };
\ No newline at end of file
@@ -6,9 +6,12 @@
 
 #include "RenderCommand.h"
 #include "UniformBuffer.h"
+#include "TextureAtlas.h"
+#include "TextLayout.h"
+#include "StreamingVertexBuffer.h"
 #include "Core/Asset.h"
-
-#include "Renderer/UI/MSDFData.h"
+#include "Core/Statistics.h"
+#include "Core/Settings.h"
 
 struct QuadVertex
 {
@@ -49,6 +52,13 @@ struct LineVertex
 	int EntityId;
 };
 
+// The Line uniform block of Renderer2D_Line.frag
+struct LineBuffer
+{
+	int caps = (int)Renderer2D::LineCaps::Butt;
+	int padding[3] = { 0 };
+};
+
 /* ------------------------------------------------------------------------------------------------------------------ */
 
 struct TextVertex
@@ -74,6 +84,33 @@ struct HairLineVertex
 
 /* ------------------------------------------------------------------------------------------------------------------ */
 
+// Texture array holding textures of one size and sampler state
+struct TextureArrayPage
+{
+	Ref<Texture2DArray> textureArray;
+	uint32_t width, height;
+	Texture::FilterMethod filterMethod;
+	Texture::WrapMethod wrapMethod;
+
+	std::vector<uint32_t> freeLayers;
+	std::vector<uint32_t> releasedLayers; // free again from the next batch, the current batch may still draw them
+
+	uint32_t batchIndex = 0; // quad batch the array was last bound in
+	uint32_t batchSlot = 0;
+};
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+struct TextureArrayEntry
+{
+	std::weak_ptr<Texture> texture; // expired if the address has been reused by another texture
+	uint32_t generation = 0;
+	uint32_t page = UINT32_MAX; // UINT32_MAX if the texture can't be copied into an array
+	uint32_t layer = 0;
+};
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
 struct Renderer2DData
 {
 	const uint32_t maxQuads = 10000;
@@ -81,30 +118,42 @@ struct Renderer2DData
 	const uint32_t maxIndices = maxQuads * 6;
 	static const size_t maxTexturesSlots = 32; //TODO query the hardware to calculate the maximum number of textures
 
+	// Texture array batching splits the 32 slots between textures and arrays, see Renderer2D_QuadArray.frag
+	static const uint32_t maxArrayModeTextureSlots = 16;
+	static const uint32_t maxArraySlots = 16;
+	static const uint32_t firstArrayLayers = 8;
+	static const uint32_t maxArrayLayers = 256;
+	static const uint32_t maxArrayTextureSize = 2048;
+	static const size_t maxArrayBytes = 256 * 1024 * 1024;
+
 	const uint32_t maxLines = 10000;
 	const uint32_t maxLineVertices = maxLines * 4;
 	const uint32_t maxLineIndices = maxLines * 6;
 
-	Ref<VertexBuffer> quadVertexBuffer;
+	Scope<StreamingVertexBuffer> quadVertexBuffer;
 	Ref<IndexBuffer> quadIndexBuffer;
 	Ref<Shader> quadShader;
+	Ref<Shader> quadArrayShader;
 	Ref<Texture> whiteTexture;
 
-	Ref<VertexBuffer> circleVertexBuffer;
+	Scope<StreamingVertexBuffer> circleVertexBuffer;
 	Ref<Shader> circleShader;
 
-	Ref<VertexBuffer> lineVertexBuffer;
+	Scope<StreamingVertexBuffer> lineVertexBuffer;
 	Ref<IndexBuffer> lineIndexBuffer;
 	Ref<Shader> lineShader;
+	Ref<UniformBuffer> lineUniformBuffer;
+	LineBuffer lineBuffer;
 
-	Ref<VertexBuffer> textVertexBuffer;
+	Scope<StreamingVertexBuffer> textVertexBuffer;
 	Ref<IndexBuffer> textIndexBuffer;
 	Ref<Shader> textShader;
 
-	Ref<VertexBuffer> hairLineVertexBuffer;
+	Scope<StreamingVertexBuffer> hairLineVertexBuffer;
 	Ref<Shader> hairLineShader;
 
 	uint32_t quadIndexCount = 0;
+	uint32_t quadBatchIndex = 0; // incremented each time the quad batch is restarted
 	QuadVertex* quadVertexBufferBase = nullptr;
 	QuadVertex* quadVertexBufferPtr = nullptr;
 
@@ -127,6 +176,16 @@ struct Renderer2DData
 	std::array<Ref<Texture>, maxTexturesSlots> textureSlots;
 	uint32_t textureSlotIndex = 1;
 
+	Renderer2D::TextureBatching textureBatching = Renderer2D::TextureBatching::Slots;
+	Renderer2D::TextureBatching requestedTextureBatching = Renderer2D::TextureBatching::Slots;
+	bool textureArraysSupported = false;
+
+	std::vector<TextureArrayPage> arrayPages;
+	std::unordered_map<const Texture*, TextureArrayEntry> arrayEntries;
+	std::array<Ref<Texture2DArray>, maxArraySlots> arraySlots;
+	uint32_t arraySlotIndex = 0;
+	uint32_t scenesSinceSweep = 0;
+
 	std::array<Ref<Texture>, maxTexturesSlots> fontAtlasSlots;
 	uint32_t fontAtlasSlotIndex = 1;
 
@@ -147,7 +206,7 @@ bool Renderer2D::Init()
 
 	// Quads --------------------------------------------------------------------------------------------
 
-	s_Data.quadVertexBuffer = VertexBuffer::Create(s_Data.maxVertices * sizeof(QuadVertex));
+	s_Data.quadVertexBuffer = CreateScope<StreamingVertexBuffer>(s_Data.maxVertices * (uint32_t)sizeof(QuadVertex));
 
 	s_Data.quadVertexBuffer->SetLayout({
 			{ShaderDataType::Float3, "a_Position"},
@@ -157,8 +216,6 @@ bool Renderer2D::Init()
 			{ShaderDataType::Int, "a_EntityId"}
 		});
 
-	s_Data.quadVertexBufferBase = new QuadVertex[s_Data.maxVertices];
-
 	uint32_t* quadIndices = new uint32_t[s_Data.maxIndices];
 
 	uint32_t offset = 0;
@@ -180,7 +237,7 @@ bool Renderer2D::Init()
 
 	// Circles ------------------------------------------------------------------------------------------
 
-	s_Data.circleVertexBuffer = VertexBuffer::Create(s_Data.maxVertices * sizeof(CircleVertex));
+	s_Data.circleVertexBuffer = CreateScope<StreamingVertexBuffer>(s_Data.maxVertices * (uint32_t)sizeof(CircleVertex));
 
 	s_Data.circleVertexBuffer->SetLayout({
 			{ShaderDataType::Float3, "a_WorldPosition"},
@@ -191,11 +248,9 @@ bool Renderer2D::Init()
 			{ShaderDataType::Int, "a_EntityId"}
 		});
 
-	s_Data.circleVertexBufferBase = new CircleVertex[s_Data.maxVertices];
-
 	// Lines --------------------------------------------------------------------------------------------
 
-	s_Data.lineVertexBuffer = VertexBuffer::Create(s_Data.maxLineVertices * sizeof(LineVertex));
+	s_Data.lineVertexBuffer = CreateScope<StreamingVertexBuffer>(s_Data.maxLineVertices * (uint32_t)sizeof(LineVertex));
 
 	s_Data.lineVertexBuffer->SetLayout({
 		{ShaderDataType::Float3, "a_clipCoord"},
@@ -204,7 +259,6 @@ bool Renderer2D::Init()
 		{ShaderDataType::Float, "a_width"},
 		{ShaderDataType::Float, "a_height"}
 		});
-	s_Data.lineVertexBufferBase = new LineVertex[s_Data.maxLineVertices];
 
 	uint32_t* lineIndices = new uint32_t[s_Data.maxLineIndices];
 	offset = 0;
@@ -224,8 +278,10 @@ bool Renderer2D::Init()
 	s_Data.lineIndexBuffer = IndexBuffer::Create(lineIndices, s_Data.maxLineIndices);
 	delete[] lineIndices;
 
+	s_Data.lineUniformBuffer = UniformBuffer::Create(sizeof(LineBuffer), 3);
+
 	// Text ------------------------------------------------------------------------------------------
-	s_Data.textVertexBuffer = VertexBuffer::Create(s_Data.maxVertices * sizeof(TextVertex));
+	s_Data.textVertexBuffer = CreateScope<StreamingVertexBuffer>(s_Data.maxVertices * (uint32_t)sizeof(TextVertex));
 
 	s_Data.textVertexBuffer->SetLayout({
 		{ShaderDataType::Float3, "a_position"},
@@ -234,7 +290,6 @@ bool Renderer2D::Init()
 		{ShaderDataType::Float, "a_texIndex"},
 		{ShaderDataType::Int, "a_EntityId"}
 		});
-	s_Data.textVertexBufferBase = new TextVertex[s_Data.maxVertices];
 
 	uint32_t* textIndices = new uint32_t[s_Data.maxIndices];
 	offset = 0;
@@ -256,7 +311,7 @@ bool Renderer2D::Init()
 
 	// Hair Lines ------------------------------------------------------------------------------------
 
-	s_Data.hairLineVertexBuffer = VertexBuffer::Create(s_Data.maxVertices * sizeof(HairLineVertex));
+	s_Data.hairLineVertexBuffer = CreateScope<StreamingVertexBuffer>(s_Data.maxVertices * (uint32_t)sizeof(HairLineVertex));
 
 	s_Data.hairLineVertexBuffer->SetLayout({
 			{ShaderDataType::Float3, "a_LocalPosition"},
@@ -264,8 +319,6 @@ bool Renderer2D::Init()
 			{ShaderDataType::Int, "a_EntityId"}
 		});
 
-	s_Data.hairLineVertexBufferBase = new HairLineVertex[s_Data.maxVertices];
-
 	// Textures & Shaders -------------------------------------------------------------------------------
 
 	s_Data.whiteTexture = Texture2D::Create(1, 1);
@@ -278,6 +331,23 @@ bool Renderer2D::Init()
 	s_Data.hairLineShader = Shader::Create("Renderer2D_HairLine");
 	s_Data.textShader = Shader::Create("Renderer2D_Text");
 
+	// Texture arrays --------------------------------------------------------------------------------
+
+	s_Data.textureArraysSupported = Texture2DArray::Create(1, 1, 1, Texture::FilterMethod::Nearest, Texture::WrapMethod::Repeat) != nullptr;
+	if (s_Data.textureArraysSupported)
+		s_Data.quadArrayShader = Shader::Create("Renderer2D_QuadArray");
+
+	// Sprite atlas -----------------------------------------------------------------------------------
+
+	TextureAtlas::Init();
+	Settings::SetDefaultBool("Renderer", "Sprite_Atlas", false);
+	TextureAtlas::SetEnabled(Settings::GetBool("Renderer", "Sprite_Atlas"));
+
+	Settings::SetDefaultValue("Renderer", "Texture_Batching", "Slots");
+	std::string textureBatching = Settings::GetValue("Renderer", "Texture_Batching");
+	if (textureBatching == "Arrays")
+		SetTextureBatching(TextureBatching::Arrays);
+
 	// set the texture slot at [0] to white texture
 	s_Data.textureSlots[0] = s_Data.whiteTexture;
 
@@ -295,6 +365,51 @@ bool Renderer2D::Init()
 
 void Renderer2D::Shutdown()
 {
+	TextureAtlas::Shutdown();
+	TextLayout::ClearCache();
+	s_Data.arrayEntries.clear();
+	s_Data.arrayPages.clear();
+	s_Data.arraySlots.fill(nullptr);
+
+	s_Data.quadVertexBuffer.reset();
+	s_Data.circleVertexBuffer.reset();
+	s_Data.lineVertexBuffer.reset();
+	s_Data.lineUniformBuffer.reset();
+	s_Data.textVertexBuffer.reset();
+	s_Data.hairLineVertexBuffer.reset();
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void Renderer2D::SetTextureBatching(TextureBatching textureBatching)
+{
+	if (textureBatching == TextureBatching::Arrays && !(s_Data.textureArraysSupported && s_Data.quadArrayShader))
+	{
+		ENGINE_WARN("Texture arrays are not supported by the renderer API, quads will be batched with texture slots");
+		textureBatching = TextureBatching::Slots;
+	}
+	s_Data.requestedTextureBatching = textureBatching;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+Renderer2D::TextureBatching Renderer2D::GetTextureBatching()
+{
+	return s_Data.requestedTextureBatching;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void Renderer2D::SetLineCaps(LineCaps lineCaps)
+{
+	s_Data.lineBuffer.caps = (int)lineCaps;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+Renderer2D::LineCaps Renderer2D::GetLineCaps()
+{
+	return (LineCaps)s_Data.lineBuffer.caps;
 }
 
 /* ------------------------------------------------------------------------------------------------------------------ */
@@ -309,6 +424,28 @@ void Renderer2D::BeginScene()
 {
 	PROFILE_FUNCTION();
 
+	s_Data.textureBatching = s_Data.requestedTextureBatching;
+
+	TextureAtlas::NewFrame();
+	Font::AddGeneratedGlyphs();
+
+	// Give the layers of destroyed textures back to their arrays
+	if (s_Data.textureBatching == TextureBatching::Arrays && ++s_Data.scenesSinceSweep >= 60)
+	{
+		s_Data.scenesSinceSweep = 0;
+		for (auto it = s_Data.arrayEntries.begin(); it != s_Data.arrayEntries.end();)
+		{
+			if (it->second.texture.expired())
+			{
+				if (it->second.page != UINT32_MAX)
+					s_Data.arrayPages[it->second.page].releasedLayers.push_back(it->second.layer);
+				it = s_Data.arrayEntries.erase(it);
+			}
+			else
+				++it;
+		}
+	}
+
 	StartQuadsBatch();
 	StartCirclesBatch();
 	StartLinesBatch();
@@ -336,7 +473,7 @@ void Renderer2D::FlushQuads()
 	if (s_Data.quadIndexCount == 0)
 		return;
 	uint32_t dataSize = (uint32_t)((uint8_t*)s_Data.quadVertexBufferPtr - (uint8_t*)s_Data.quadVertexBufferBase);
-	s_Data.quadVertexBuffer->SetData(s_Data.quadVertexBufferBase, dataSize);
+	uint32_t firstVertex = s_Data.quadVertexBuffer->Commit(dataSize);
 
 	for (uint32_t i = 0; i < s_Data.textureSlotIndex; i++)
 	{
@@ -344,9 +481,22 @@ void Renderer2D::FlushQuads()
 	}
 	s_Data.quadVertexBuffer->Bind();
 	s_Data.quadIndexBuffer->Bind();
-	s_Data.quadShader->Bind();
 
-	RenderCommand::DrawIndexed(s_Data.quadIndexCount, 0U, 0U, false);
+	if (s_Data.textureBatching == TextureBatching::Arrays)
+	{
+		for (uint32_t i = 0; i < s_Data.arraySlotIndex; i++)
+		{
+			s_Data.arraySlots[i]->Bind(Renderer2DData::maxArrayModeTextureSlots + i);
+		}
+		s_Data.quadArrayShader->Bind();
+	}
+	else
+	{
+		s_Data.quadShader->Bind();
+	}
+
+	RenderCommand::DrawIndexed(s_Data.quadIndexCount, 0U, firstVertex, false);
+	s_Data.quadVertexBuffer->Fence();
 
 	s_Data.quadVertexBuffer->UnBind();
 	s_Data.quadIndexBuffer->UnBind();
@@ -358,12 +508,13 @@ void Renderer2D::FlushCircles()
 	if (s_Data.circleIndexCount == 0)
 		return;
 	uint32_t dataSize = (uint32_t)((uint8_t*)s_Data.circleVertexBufferPtr - (uint8_t*)s_Data.circleVertexBufferBase);
-	s_Data.circleVertexBuffer->SetData(s_Data.circleVertexBufferBase, dataSize);
+	uint32_t firstVertex = s_Data.circleVertexBuffer->Commit(dataSize);
 
 	s_Data.circleVertexBuffer->Bind();
 	s_Data.quadIndexBuffer->Bind();
 	s_Data.circleShader->Bind();
-	RenderCommand::DrawIndexed(s_Data.circleIndexCount, 0U, 0U, false);
+	RenderCommand::DrawIndexed(s_Data.circleIndexCount, 0U, firstVertex, false);
+	s_Data.circleVertexBuffer->Fence();
 	s_Data.quadIndexBuffer->UnBind();
 	s_Data.circleVertexBuffer->UnBind();
 	s_Data.statistics.drawCalls++;
@@ -374,12 +525,14 @@ void Renderer2D::FlushLines()
 	if (s_Data.lineIndexCount == 0)
 		return;
 	uint32_t dataSize = (uint32_t)((uint8_t*)s_Data.lineVertexBufferPtr - (uint8_t*)s_Data.lineVertexBufferBase);
-	s_Data.lineVertexBuffer->SetData(s_Data.lineVertexBufferBase, dataSize);
+	uint32_t firstVertex = s_Data.lineVertexBuffer->Commit(dataSize);
 
+	s_Data.lineUniformBuffer->SetData(&s_Data.lineBuffer, sizeof(LineBuffer));
 	s_Data.lineVertexBuffer->Bind();
 	s_Data.lineIndexBuffer->Bind();
 	s_Data.lineShader->Bind();
-	RenderCommand::DrawIndexed(s_Data.lineIndexCount, 0U, 0U, false);
+	RenderCommand::DrawIndexed(s_Data.lineIndexCount, 0U, firstVertex, false);
+	s_Data.lineVertexBuffer->Fence();
 	s_Data.lineVertexBuffer->UnBind();
 	s_Data.lineIndexBuffer->UnBind();
 	s_Data.statistics.drawCalls++;
@@ -390,12 +543,13 @@ void Renderer2D::FlushHairLines()
 	if (s_Data.hairLineVertexCount == 0)
 		return;
 	uint32_t dataSize = (uint32_t)((uint8_t*)s_Data.hairLineVertexBufferPtr - (uint8_t*)s_Data.hairLineVertexBufferBase);
-	s_Data.hairLineVertexBuffer->SetData(s_Data.hairLineVertexBufferBase, dataSize);
+	uint32_t firstVertex = s_Data.hairLineVertexBuffer->Commit(dataSize);
 
 	s_Data.hairLineVertexBuffer->Bind();
 	s_Data.quadIndexBuffer->Bind();
 	s_Data.hairLineShader->Bind();
-	RenderCommand::DrawLines(s_Data.hairLineVertexCount);
+	RenderCommand::DrawLines(s_Data.hairLineVertexCount, firstVertex);
+	s_Data.hairLineVertexBuffer->Fence();
 	s_Data.hairLineVertexBuffer->UnBind();
 	s_Data.quadIndexBuffer->UnBind();
 	s_Data.statistics.drawCalls++;
@@ -406,7 +560,7 @@ void Renderer2D::FlushText()
 	if (s_Data.textIndexCount == 0)
 		return;
 	uint32_t dataSize = (uint32_t)((uint8_t*)s_Data.textVertexBufferPtr - (uint8_t*)s_Data.textVertexBufferBase);
-	s_Data.textVertexBuffer->SetData(s_Data.textVertexBufferBase, dataSize);
+	uint32_t firstVertex = s_Data.textVertexBuffer->Commit(dataSize);
 
 	for (uint32_t i = 0; i < s_Data.fontAtlasSlotIndex; i++)
 	{
@@ -417,7 +571,8 @@ void Renderer2D::FlushText()
 	s_Data.textVertexBuffer->Bind();
 	s_Data.textIndexBuffer->Bind();
 	s_Data.textShader->Bind();
-	RenderCommand::DrawIndexed(s_Data.textIndexCount);
+	RenderCommand::DrawIndexed(s_Data.textIndexCount, 0U, firstVertex);
+	s_Data.textVertexBuffer->Fence();
 	s_Data.textVertexBuffer->UnBind();
 	s_Data.textIndexBuffer->UnBind();
 	s_Data.statistics.drawCalls++;
@@ -428,69 +583,301 @@ void Renderer2D::FlushText()
 void Renderer2D::StartQuadsBatch()
 {
 	s_Data.quadIndexCount = 0;
+	s_Data.quadBatchIndex++;
+	s_Data.quadVertexBufferBase = (QuadVertex*)s_Data.quadVertexBuffer->Begin();
 	s_Data.quadVertexBufferPtr = s_Data.quadVertexBufferBase;
+	if (s_Data.quadVertexBuffer->Stalled())
+		s_Data.statistics.bufferStalls++;
 
 	s_Data.textureSlotIndex = 1;
+
+	for (uint32_t i = 0; i < s_Data.arraySlotIndex; i++)
+		s_Data.arraySlots[i] = nullptr;
+	s_Data.arraySlotIndex = 0;
+
+	for (TextureArrayPage& page : s_Data.arrayPages)
+	{
+		page.freeLayers.insert(page.freeLayers.end(), page.releasedLayers.begin(), page.releasedLayers.end());
+		page.releasedLayers.clear();
+	}
 }
 
 void Renderer2D::StartCirclesBatch()
 {
 	s_Data.circleIndexCount = 0;
+	s_Data.circleVertexBufferBase = (CircleVertex*)s_Data.circleVertexBuffer->Begin();
 	s_Data.circleVertexBufferPtr = s_Data.circleVertexBufferBase;
+	if (s_Data.circleVertexBuffer->Stalled())
+		s_Data.statistics.bufferStalls++;
 }
 
 void Renderer2D::StartLinesBatch()
 {
 	s_Data.lineIndexCount = 0;
+	s_Data.lineVertexBufferBase = (LineVertex*)s_Data.lineVertexBuffer->Begin();
 	s_Data.lineVertexBufferPtr = s_Data.lineVertexBufferBase;
+	if (s_Data.lineVertexBuffer->Stalled())
+		s_Data.statistics.bufferStalls++;
 }
 
 void Renderer2D::StartTextBatch()
 {
 	s_Data.textIndexCount = 0;
+	s_Data.textVertexBufferBase = (TextVertex*)s_Data.textVertexBuffer->Begin();
 	s_Data.textVertexBufferPtr = s_Data.textVertexBufferBase;
+	if (s_Data.textVertexBuffer->Stalled())
+		s_Data.statistics.bufferStalls++;
+
+	for (uint32_t i = 1; i < s_Data.fontAtlasSlotIndex; i++)
+		s_Data.fontAtlasSlots[i] = nullptr;
+	s_Data.fontAtlasSlotIndex = 1;
 }
 
 void Renderer2D::StartHairLinesBatch()
 {
 	s_Data.hairLineVertexCount = 0;
+	s_Data.hairLineVertexBufferBase = (HairLineVertex*)s_Data.hairLineVertexBuffer->Begin();
 	s_Data.hairLineVertexBufferPtr = s_Data.hairLineVertexBufferBase;
+	if (s_Data.hairLineVertexBuffer->Stalled())
+		s_Data.statistics.bufferStalls++;
 }
 
 /* ------------------------------------------------------------------------------------------------------------------ */
 
 void Renderer2D::NextQuadsBatch()
 {
+	s_Data.statistics.batchBreaks++;
 	FlushQuads();
 	StartQuadsBatch();
 }
 
 void Renderer2D::NextCirclesBatch()
 {
+	s_Data.statistics.batchBreaks++;
 	FlushCircles();
 	StartCirclesBatch();
 }
 
 void Renderer2D::NextLinesBatch()
 {
+	s_Data.statistics.batchBreaks++;
 	FlushLines();
 	StartLinesBatch();
 }
 
 void Renderer2D::NextTextBatch()
 {
+	s_Data.statistics.batchBreaks++;
 	FlushText();
 	StartTextBatch();
 }
 
 void Renderer2D::NextHairLinesBatch()
 {
+	s_Data.statistics.batchBreaks++;
 	FlushHairLines();
 	StartHairLinesBatch();
 }
 
 /* ------------------------------------------------------------------------------------------------------------------ */
 
+static bool InUnitSquare(const Vector2f* texCoords)
+{
+	for (size_t i = 0; i < 4; i++)
+	{
+		if (texCoords[i].x < 0.0f || texCoords[i].x > 1.0f || texCoords[i].y < 0.0f || texCoords[i].y > 1.0f)
+			return false;
+	}
+	return true;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Swap the texture for its page of the sprite atlas and remap the texture coordinates, unless they wrap
+static const Ref<Texture>& AtlasTexture(const Ref<Texture>& texture, Vector2f* texCoords)
+{
+	if (!TextureAtlas::IsEnabled() || !InUnitSquare(texCoords))
+		return texture;
+
+	const TextureAtlas::Region* region = TextureAtlas::Find(texture);
+	if (!region)
+		return texture;
+
+	for (size_t i = 0; i < 4; i++)
+		texCoords[i] = region->Remap(texCoords[i]);
+	return region->page;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+float Renderer2D::GetQuadTextureIndex(const Ref<Texture>& texture)
+{
+	if (s_Data.textureBatching == TextureBatching::Arrays)
+		return GetQuadArrayIndex(texture);
+	return GetQuadSlotIndex(texture, Renderer2DData::maxTexturesSlots);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Find the slot the texture is bound to in the current quad batch, adding it if there is room or starting a new batch if not
+float Renderer2D::GetQuadSlotIndex(const Ref<Texture>& texture, uint32_t maxSlots)
+{
+	for (uint32_t i = 1; i < s_Data.textureSlotIndex; i++)
+	{
+		if (*s_Data.textureSlots[i].get() == *texture.get())
+			return (float)i;
+	}
+
+	if (s_Data.textureSlotIndex >= maxSlots)
+	{
+		s_Data.statistics.textureBatchBreaks++;
+		NextQuadsBatch();
+	}
+
+	float textureIndex = (float)s_Data.textureSlotIndex;
+	s_Data.textureSlots[s_Data.textureSlotIndex] = texture;
+	s_Data.textureSlotIndex++;
+	return textureIndex;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Find the slot the font atlas is bound to in the current text batch, starting a new batch if they are all taken
+float Renderer2D::GetFontAtlasIndex(const Ref<Texture2D>& fontAtlas)
+{
+	for (uint32_t i = 1; i < s_Data.fontAtlasSlotIndex; i++)
+	{
+		if (*s_Data.fontAtlasSlots[i].get() == *fontAtlas.get())
+			return (float)i;
+	}
+
+	if (s_Data.fontAtlasSlotIndex >= Renderer2DData::maxTexturesSlots)
+	{
+		s_Data.statistics.textureBatchBreaks++;
+		NextTextBatch();
+	}
+
+	float textureIndex = (float)s_Data.fontAtlasSlotIndex;
+	s_Data.fontAtlasSlots[s_Data.fontAtlasSlotIndex] = fontAtlas;
+	s_Data.fontAtlasSlotIndex++;
+	return textureIndex;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Copy the texture into a free layer of an array with the same size and sampler state, making a new array if they are all full
+static void AddToTextureArray(const Texture& texture, TextureArrayEntry& entry)
+{
+	PROFILE_FUNCTION();
+
+	entry.generation = texture.GetGeneration();
+	entry.page = UINT32_MAX;
+
+	const uint32_t width = texture.GetWidth();
+	const uint32_t height = texture.GetHeight();
+	if (width == 0 || height == 0 || width > Renderer2DData::maxArrayTextureSize || height > Renderer2DData::maxArrayTextureSize)
+		return;
+
+	uint32_t layers = Renderer2DData::firstArrayLayers;
+	uint32_t pageIndex = UINT32_MAX;
+	for (uint32_t i = 0; i < (uint32_t)s_Data.arrayPages.size(); i++)
+	{
+		const TextureArrayPage& page = s_Data.arrayPages[i];
+		if (page.width != width || page.height != height || page.filterMethod != texture.GetFilterMethod() || page.wrapMethod != texture.GetWrapMethod())
+			continue;
+
+		if (!page.freeLayers.empty())
+		{
+			pageIndex = i;
+			break;
+		}
+		layers = std::max(layers, page.textureArray->GetLayerCount() * 2);
+	}
+
+	if (pageIndex == UINT32_MAX)
+	{
+		const size_t layerBytes = (size_t)width * height * 4;
+		layers = (uint32_t)std::clamp(std::min((size_t)layers, Renderer2DData::maxArrayBytes / layerBytes), (size_t)1, (size_t)Renderer2DData::maxArrayLayers);
+
+		Ref<Texture2DArray> textureArray = Texture2DArray::Create(width, height, layers, texture.GetFilterMethod(), texture.GetWrapMethod());
+		if (!textureArray)
+			return;
+
+		TextureArrayPage& page = s_Data.arrayPages.emplace_back();
+		page.textureArray = textureArray;
+		page.width = width;
+		page.height = height;
+		page.filterMethod = texture.GetFilterMethod();
+		page.wrapMethod = texture.GetWrapMethod();
+		for (uint32_t layer = layers; layer > 0; layer--)
+			page.freeLayers.push_back(layer - 1);
+		pageIndex = (uint32_t)s_Data.arrayPages.size() - 1;
+	}
+
+	TextureArrayPage& page = s_Data.arrayPages[pageIndex];
+	uint32_t layer = page.freeLayers.back();
+	if (!page.textureArray->SetLayer(layer, texture))
+		return;
+
+	page.freeLayers.pop_back();
+	entry.page = pageIndex;
+	entry.layer = layer;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Index of the texture's array layer, packed as (array slot << 10 | layer) + 16. The texture is looked up by address
+// so finding it is constant time, arrays are bound once per batch and the batch only breaks when 16 are bound
+float Renderer2D::GetQuadArrayIndex(const Ref<Texture>& texture)
+{
+	auto [it, inserted] = s_Data.arrayEntries.try_emplace(texture.get());
+	TextureArrayEntry& entry = it->second;
+
+	if (inserted || entry.texture.expired())
+	{
+		if (!inserted && entry.page != UINT32_MAX)
+			s_Data.arrayPages[entry.page].releasedLayers.push_back(entry.layer);
+
+		entry.texture = texture;
+		AddToTextureArray(*texture, entry);
+	}
+	else if (entry.generation != texture->GetGeneration())
+	{
+		// The pixels have changed, copy them again. The texture may have changed size so it could need another array
+		if (entry.page != UINT32_MAX && s_Data.arrayPages[entry.page].textureArray->SetLayer(entry.layer, *texture))
+		{
+			entry.generation = texture->GetGeneration();
+		}
+		else
+		{
+			if (entry.page != UINT32_MAX)
+				s_Data.arrayPages[entry.page].releasedLayers.push_back(entry.layer);
+			AddToTextureArray(*texture, entry);
+		}
+	}
+
+	if (entry.page == UINT32_MAX)
+		return GetQuadSlotIndex(texture, Renderer2DData::maxArrayModeTextureSlots);
+
+	TextureArrayPage* page = &s_Data.arrayPages[entry.page];
+	if (page->batchIndex != s_Data.quadBatchIndex)
+	{
+		if (s_Data.arraySlotIndex >= Renderer2DData::maxArraySlots)
+		{
+			s_Data.statistics.textureBatchBreaks++;
+			NextQuadsBatch();
+		}
+
+		page->batchIndex = s_Data.quadBatchIndex;
+		page->batchSlot = s_Data.arraySlotIndex;
+		s_Data.arraySlots[s_Data.arraySlotIndex++] = page->textureArray;
+	}
+
+	return (float)(Renderer2DData::maxArrayModeTextureSlots + ((page->batchSlot << 10) | entry.layer));
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
 void Renderer2D::DrawQuad(const Vector2f& position, const Vector2f& size, const Ref<Texture2D>& texture, const float& rotation, const Colour& colour, float tilingFactor)
 {
 	DrawQuad(Vector3f(position.x, position.y, 0.0f), size, texture, rotation, colour, tilingFactor);
@@ -613,34 +1000,16 @@ void Renderer2D::DrawQuad(const Matrix4x4& transform, const Ref<Texture>& textur
 	}
 
 	float textureIndex = 0.0f;
-	const Vector2f texCoords[] = { {0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f,1.0f} , {0.0f,1.0f} };
-
-	if (texture) {
-		for (uint32_t i = 1; i < s_Data.textureSlotIndex; i++)
-		{
-			if (*s_Data.textureSlots[i].get() == *texture.get())
-			{
-				textureIndex = (float)i;
-				break;
-			}
-		}
+	Vector2f texCoords[] = { {0.0f, 0.0f}, {tilingFactor, 0.0f}, {tilingFactor, tilingFactor} , {0.0f, tilingFactor} };
 
-		if (textureIndex == 0.0f)
-		{
-			if (s_Data.textureSlotIndex >= Renderer2DData::maxTexturesSlots)
-				NextQuadsBatch();
-
-			textureIndex = (float)s_Data.textureSlotIndex;
-			s_Data.textureSlots[s_Data.textureSlotIndex] = texture;
-			s_Data.textureSlotIndex++;
-		}
-	}
+	if (texture)
+		textureIndex = GetQuadTextureIndex(AtlasTexture(texture, texCoords));
 
 	for (size_t i = 0; i < 4; i++)
 	{
 		s_Data.quadVertexBufferPtr->position = transform * s_Data.quadVertexPositions[i];
 		s_Data.quadVertexBufferPtr->colour = colour;
-		s_Data.quadVertexBufferPtr->texCoords = tilingFactor * texCoords[i];
+		s_Data.quadVertexBufferPtr->texCoords = texCoords[i];
 		s_Data.quadVertexBufferPtr->texIndex = textureIndex;
 		s_Data.quadVertexBufferPtr->EntityId = entityId;
 		s_Data.quadVertexBufferPtr++;
@@ -666,29 +1035,11 @@ void Renderer2D::DrawQuad(const Matrix4x4& transform, const Ref<SubTexture2D>& s
 	}
 
 	float textureIndex = 0.0f;
-	const Vector2f* texCoords = subtexture->GetTextureCoordinates();
+	Vector2f texCoords[4];
+	std::copy_n(subtexture->GetTextureCoordinates(), 4, texCoords);
 
 	if (subtexture->GetTexture())
-	{
-		for (uint32_t i = 1; i < s_Data.textureSlotIndex; i++)
-		{
-			if (*s_Data.textureSlots[i].get() == *subtexture->GetTexture().get())
-			{
-				textureIndex = (float)i;
-				break;
-			}
-		}
-
-		if (textureIndex == 0.0f)
-		{
-			if (s_Data.textureSlotIndex >= Renderer2DData::maxTexturesSlots)
-				NextQuadsBatch();
-
-			textureIndex = (float)s_Data.textureSlotIndex;
-			s_Data.textureSlots[s_Data.textureSlotIndex] = subtexture->GetTexture();
-			s_Data.textureSlotIndex++;
-		}
-	}
+		textureIndex = GetQuadTextureIndex(AtlasTexture(subtexture->GetTexture(), texCoords));
 
 	for (size_t i = 0; i < 4; i++)
 	{
@@ -753,6 +1104,271 @@ void Renderer2D::DrawCircle(const Matrix4x4& transform, const CircleRendererComp
 
 /* ------------------------------------------------------------------------------------------------------------------ */
 
+void Renderer2D::DrawParticles(const ParticleSystem& particleSystem, float depth, int entityId)
+{
+	PROFILE_FUNCTION();
+
+	const float* positionX = particleSystem.GetPositionsX();
+	const float* positionY = particleSystem.GetPositionsY();
+	const float* rotation = particleSystem.GetRotations();
+	const float* size = particleSystem.GetSizes();
+	const float* colour[4] = { particleSystem.GetColours(0), particleSystem.GetColours(1), particleSystem.GetColours(2), particleSystem.GetColours(3) };
+
+	const Vector2f texCoords[] = { {0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f,1.0f} , {0.0f,1.0f} };
+
+	uint32_t count = particleSystem.GetCount();
+	uint32_t index = 0;
+	while (index < count)
+	{
+		if (s_Data.quadIndexCount >= s_Data.maxIndices)
+			NextQuadsBatch();
+
+		// Fill as much of the current batch as the particles need
+		uint32_t batchStart = index;
+		uint32_t batchEnd = std::min(count, index + (s_Data.maxIndices - s_Data.quadIndexCount) / 6);
+		for (; index < batchEnd; index++)
+		{
+			float halfSize = size[index] * 0.5f;
+			float c = cosf(rotation[index]) * halfSize;
+			float s = sinf(rotation[index]) * halfSize;
+			Colour particleColour(colour[0][index], colour[1][index], colour[2][index], colour[3][index]);
+
+			for (size_t i = 0; i < 4; i++)
+			{
+				float x = s_Data.quadVertexPositions[i].x * 2.0f;
+				float y = s_Data.quadVertexPositions[i].y * 2.0f;
+
+				s_Data.quadVertexBufferPtr->position = Vector3f(positionX[index] + x * c - y * s, positionY[index] + x * s + y * c, depth);
+				s_Data.quadVertexBufferPtr->colour = particleColour;
+				s_Data.quadVertexBufferPtr->texCoords = texCoords[i];
+				s_Data.quadVertexBufferPtr->texIndex = 0.0f;
+				s_Data.quadVertexBufferPtr->EntityId = entityId;
+				s_Data.quadVertexBufferPtr++;
+			}
+		}
+
+		s_Data.quadIndexCount += (batchEnd - batchStart) * 6;
+		s_Data.statistics.quadCount += batchEnd - batchStart;
+	}
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void Renderer2D::Submit(SubmissionContext& context)
+{
+	PROFILE_FUNCTION();
+
+	// Slot of each of the context's textures in the current batch, forgotten whenever the batch is restarted.
+	// A texture in the sprite atlas has a second slot for its page, used by the quads whose texture coordinates don't wrap
+	std::vector<float> textureSlots(context.m_Textures.size(), -1.0f);
+	std::vector<float> atlasSlots(context.m_Textures.size(), -1.0f);
+	uint32_t slotsBatch = s_Data.quadBatchIndex;
+
+	std::vector<const TextureAtlas::Region*> atlasRegions(context.m_Textures.size(), nullptr);
+	if (TextureAtlas::IsEnabled())
+	{
+		for (size_t i = 0; i < context.m_Textures.size(); i++)
+			atlasRegions[i] = TextureAtlas::Find(context.m_Textures[i]);
+	}
+
+	const QuadVertex* quadVertex = context.m_QuadVertices.data();
+	for (uint32_t texture : context.m_QuadTextures)
+	{
+		if (s_Data.quadIndexCount >= s_Data.maxIndices)
+			NextQuadsBatch();
+
+		Vector2f texCoords[4];
+		for (size_t i = 0; i < 4; i++)
+			texCoords[i] = quadVertex[i].texCoords;
+
+		float textureIndex = 0.0f;
+		if (texture != 0)
+		{
+			if (slotsBatch != s_Data.quadBatchIndex)
+			{
+				std::fill(textureSlots.begin(), textureSlots.end(), -1.0f);
+				std::fill(atlasSlots.begin(), atlasSlots.end(), -1.0f);
+				slotsBatch = s_Data.quadBatchIndex;
+			}
+
+			const TextureAtlas::Region* region = atlasRegions[texture - 1];
+			if (region && !InUnitSquare(texCoords))
+				region = nullptr;
+
+			std::vector<float>& slots = region ? atlasSlots : textureSlots;
+			if (slots[texture - 1] < 0.0f)
+			{
+				textureIndex = GetQuadTextureIndex(region ? region->page : context.m_Textures[texture - 1]);
+				if (slotsBatch != s_Data.quadBatchIndex)
+				{
+					std::fill(textureSlots.begin(), textureSlots.end(), -1.0f);
+					std::fill(atlasSlots.begin(), atlasSlots.end(), -1.0f);
+					slotsBatch = s_Data.quadBatchIndex;
+				}
+				slots[texture - 1] = textureIndex;
+			}
+			else
+			{
+				textureIndex = slots[texture - 1];
+			}
+
+			if (region)
+			{
+				for (size_t i = 0; i < 4; i++)
+					texCoords[i] = region->Remap(texCoords[i]);
+			}
+		}
+
+		for (size_t i = 0; i < 4; i++)
+		{
+			*s_Data.quadVertexBufferPtr = *quadVertex++;
+			s_Data.quadVertexBufferPtr->texCoords = texCoords[i];
+			s_Data.quadVertexBufferPtr->texIndex = textureIndex;
+			s_Data.quadVertexBufferPtr++;
+		}
+
+		s_Data.quadIndexCount += 6;
+		s_Data.statistics.quadCount++;
+	}
+
+	// Circles don't use textures so they can be copied in runs up to the end of each batch
+	size_t circleVertexCount = context.m_CircleVertices.size();
+	size_t offset = 0;
+	while (offset < circleVertexCount)
+	{
+		if (s_Data.circleIndexCount >= s_Data.maxIndices)
+			NextCirclesBatch();
+
+		size_t count = std::min(circleVertexCount - offset, (size_t)(s_Data.maxIndices - s_Data.circleIndexCount) / 6 * 4);
+		memcpy(s_Data.circleVertexBufferPtr, context.m_CircleVertices.data() + offset, count * sizeof(CircleVertex));
+		s_Data.circleVertexBufferPtr += count;
+		s_Data.circleIndexCount += (uint32_t)(count / 4 * 6);
+		s_Data.statistics.quadCount += (uint32_t)(count / 4);
+		offset += count;
+	}
+
+	context.Clear();
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+Renderer2D::SubmissionContext::SubmissionContext() = default;
+Renderer2D::SubmissionContext::~SubmissionContext() = default;
+Renderer2D::SubmissionContext::SubmissionContext(SubmissionContext&& other) noexcept = default;
+Renderer2D::SubmissionContext& Renderer2D::SubmissionContext::operator=(SubmissionContext&& other) noexcept = default;
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void Renderer2D::SubmissionContext::DrawQuad(const Matrix4x4& transform, const Colour& colour, int entityId)
+{
+	const Vector2f texCoords[] = { {0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f,1.0f} , {0.0f,1.0f} };
+	AddQuad(transform, texCoords, colour, 0, entityId);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void Renderer2D::SubmissionContext::DrawQuad(const Matrix4x4& transform, const Ref<Texture>& texture, const Colour& colour, float tilingFactor, int entityId)
+{
+	const Vector2f texCoords[] = { tilingFactor * Vector2f(0.0f, 0.0f), tilingFactor * Vector2f(1.0f, 0.0f), tilingFactor * Vector2f(1.0f, 1.0f), tilingFactor * Vector2f(0.0f, 1.0f) };
+	AddQuad(transform, texCoords, colour, texture ? GetTextureIndex(texture) : 0, entityId);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void Renderer2D::SubmissionContext::DrawQuad(const Matrix4x4& transform, const Ref<SubTexture2D>& subtexture, const Colour& colour, int entityId)
+{
+	if (!subtexture)
+		return;
+
+	uint32_t texture = subtexture->GetTexture() ? GetTextureIndex(subtexture->GetTexture()) : 0;
+	AddQuad(transform, subtexture->GetTextureCoordinates(), colour, texture, entityId);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void Renderer2D::SubmissionContext::DrawSprite(const Matrix4x4& transform, const SpriteComponent& spriteComp, int entityId)
+{
+	if (spriteComp.texture)
+	{
+		DrawQuad(transform, spriteComp.texture, spriteComp.tint, spriteComp.tilingFactor, entityId);
+	}
+	else
+	{
+		DrawQuad(transform, spriteComp.tint, entityId);
+	}
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void Renderer2D::SubmissionContext::DrawCircle(const Matrix4x4& transform, const Colour& colour, float thickness, float fade, int entityId)
+{
+	for (size_t i = 0; i < 4; i++)
+	{
+		CircleVertex& vertex = m_CircleVertices.emplace_back();
+		vertex.worldPosition = transform * s_Data.quadVertexPositions[i];
+		vertex.localPosition = s_Data.quadVertexPositions[i] * 2.0f;
+		vertex.colour = colour;
+		vertex.thickness = thickness;
+		vertex.fade = fade;
+		vertex.EntityId = entityId;
+	}
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void Renderer2D::SubmissionContext::DrawCircle(const Matrix4x4& transform, const CircleRendererComponent& circleComp, int entityId)
+{
+	DrawCircle(transform, circleComp.colour, circleComp.thickness, circleComp.fade, entityId);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void Renderer2D::SubmissionContext::Clear()
+{
+	m_QuadVertices.clear();
+	m_QuadTextures.clear();
+	m_Textures.clear();
+	m_TextureIndices.clear();
+	m_CircleVertices.clear();
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+bool Renderer2D::SubmissionContext::Empty() const
+{
+	return m_QuadTextures.empty() && m_CircleVertices.empty();
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Textures are looked up by address, two texture objects that compare equal still end up sharing a slot
+// when the context is submitted since the batch's texture slots are matched by value
+uint32_t Renderer2D::SubmissionContext::GetTextureIndex(const Ref<Texture>& texture)
+{
+	auto [it, inserted] = m_TextureIndices.try_emplace(texture.get(), (uint32_t)m_Textures.size() + 1);
+	if (inserted)
+		m_Textures.push_back(texture);
+	return it->second;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void Renderer2D::SubmissionContext::AddQuad(const Matrix4x4& transform, const Vector2f* texCoords, const Colour& colour, uint32_t texture, int entityId)
+{
+	for (size_t i = 0; i < 4; i++)
+	{
+		QuadVertex& vertex = m_QuadVertices.emplace_back();
+		vertex.position = transform * s_Data.quadVertexPositions[i];
+		vertex.colour = colour;
+		vertex.texCoords = texCoords[i];
+		vertex.texIndex = 0.0f;
+		vertex.EntityId = entityId;
+	}
+	m_QuadTextures.push_back(texture);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
 void Renderer2D::DrawLine(const Vector2f& start, const Vector2f& end, const float& thickness, const Colour& colour)
 {
 	if (s_Data.lineIndexCount >= s_Data.maxLineIndices)
@@ -836,7 +1452,7 @@ void Renderer2D::DrawLine(const Vector2f& start, const Vector2f& end, const floa
 
 void Renderer2D::DrawHairLine(const Vector3f& start, const Vector3f& end, const Colour& colour, int entityId)
 {
-	if (s_Data.hairLineVertexCount >= s_Data.maxLineIndices)
+	if (s_Data.hairLineVertexCount >= s_Data.maxVertices)
 		NextHairLinesBatch();
 	s_Data.hairLineVertexBufferPtr->position = start;
 	s_Data.hairLineVertexBufferPtr->colour = colour;
@@ -953,168 +1569,76 @@ void Renderer2D::DrawString(const std::string& text, const Ref<Font> font, float
 	if (text.empty() || font == nullptr)
 		return;
 
-	if (s_Data.textIndexCount >= s_Data.maxIndices)
-	{
-		NextTextBatch();
-	}
-
-	float textureIndex = 0.0f;
-
-	Ref<Texture2D> fontAtlas = font->GetFontAtlas();
-
-	ASSERT(fontAtlas, "Font atlas cannot be null");
-	ASSERT(font->GetMSDFData(), "MSDF Data  cannot be null");
-
-	for (uint32_t i = 1; i < s_Data.fontAtlasSlotIndex; i++)
-	{
-		if (*s_Data.fontAtlasSlots[i].get() == *fontAtlas.get())
-		{
-			textureIndex = (float)i;
-			break;
-		}
-	}
-
-	if (textureIndex == 0.0f)
-	{
-		textureIndex = (float)s_Data.fontAtlasSlotIndex;
-		s_Data.fontAtlasSlots[s_Data.fontAtlasSlotIndex] = fontAtlas;
-		s_Data.fontAtlasSlotIndex++;
-	}
-
-	const msdf_atlas::FontGeometry& fontGeometry = font->GetMSDFData()->fontGeometry;
-	const msdfgen::FontMetrics& metrics = fontGeometry.getMetrics();
-
-	std::vector<int> nextLines;
-	double x = 0.0;
-	double fsScale = 1 / (metrics.ascenderY - metrics.descenderY);
-	double y = -fsScale * metrics.ascenderY;
-	int lastSpace = -1;
-
-	std::u32string utf32string;
-	utf32string.resize(text.size());
-	std::transform(text.begin(), text.end(), utf32string.begin(), [](char c) -> unsigned char {return c; });
-
-	for (int i = 0; i < utf32string.size(); i++)
-	{
-		char32_t character = utf32string[i];
-		if (character == '\n')
-		{
-			x = 0;
-			y -= fsScale * metrics.lineHeight;
-			continue;
-		}
-
-		auto glyph = fontGeometry.getGlyph(character);
-		if (!glyph)
-			glyph = fontGeometry.getGlyph('?');
-		if (!glyph)
-			continue;
+	DrawString(*TextLayout::Get(text, font, maxWidth), transform, colour, entityId);
+}
 
-		if (character != ' ' && character != '\t')
-		{
-			double pl, pb, pr, pt;
-			glyph->getQuadPlaneBounds(pl, pb, pr, pt);
-			Vector2f quadMin((float)pl, (float)pb);
-			Vector2f quadMax((float)pr, (float)pt);
+void Renderer2D::DrawString(const TextLayout& layout, const Matrix4x4& transform, const Colour& colour, int entityId)
+{
+	PROFILE_FUNCTION();
 
-			quadMin = quadMin * (float)fsScale;
-			quadMax = quadMax * (float)fsScale;
-			quadMin += Vector2f((float)x, (float)y);
-			quadMax += Vector2f((float)x, (float)y);
+	const std::vector<TextLayout::Glyph>& glyphs = layout.GetGlyphs();
+	if (glyphs.empty())
+		return;
 
-			if (quadMax.x > maxWidth && lastSpace != -1)
-			{
-				i = lastSpace;
-				nextLines.emplace_back(lastSpace);
-				lastSpace = -1;
-				x = 0;
-				y -= fsScale * metrics.lineHeight;
-			}
-		}
-		else
-		{
-			lastSpace = i;
-		}
+	const std::vector<Ref<Texture2D>>& atlases = layout.GetFontAtlases();
+	uint32_t atlas = glyphs.front().atlas;
+	float textureIndex = GetFontAtlasIndex(atlases[atlas]);
 
-		double advance = glyph->getAdvance();
-		fontGeometry.getAdvance(advance, character, utf32string[i + 1]);
-		x += fsScale * advance;
-	}
+	// The transform is affine, so each corner is the origin plus the transformed axes scaled by its local position
+	const Vector3f origin = transform * Vector3f(0.0f, 0.0f, 0.0f);
+	const Vector3f axisX = transform * Vector3f(1.0f, 0.0f, 0.0f) - origin;
+	const Vector3f axisY = transform * Vector3f(0.0f, 1.0f, 0.0f) - origin;
 
-	x = 0.0;
-	fsScale = 1 / (metrics.ascenderY - metrics.descenderY);
-	y = 0.0;
-	for (int i = 0; i < utf32string.size(); i++)
+	for (const TextLayout::Glyph& glyph : glyphs)
 	{
-		char32_t character = utf32string[i];
-
-		if (character == '\n' || std::any_of(nextLines.begin(), nextLines.end(), [&i](int line) { return i == line; }))
+		if (s_Data.textIndexCount >= s_Data.maxIndices)
 		{
-			x = 0;
-			y -= fsScale * metrics.lineHeight;
-			continue;
+			NextTextBatch();
+			textureIndex = GetFontAtlasIndex(atlases[glyph.atlas]);
 		}
-		if (character == '\t')
+		else if (glyph.atlas != atlas)
 		{
-			double advance = fontGeometry.getGlyph(' ')->getAdvance();
-			x += fsScale * (advance * 4);
-			continue;
+			textureIndex = GetFontAtlasIndex(atlases[glyph.atlas]);
 		}
-		auto glyph = fontGeometry.getGlyph(character);
-		if (!glyph)
-			glyph = fontGeometry.getGlyph('?');
-		if (!glyph)
-			continue;
-
-		double l, b, r, t;
-		glyph->getQuadAtlasBounds(l, b, r, t);
-
-		double pl, pb, pr, pt;
-		glyph->getQuadPlaneBounds(pl, pb, pr, pt);
+		atlas = glyph.atlas;
 
-		pl *= fsScale, pb *= fsScale, pr *= fsScale, pt *= fsScale;
-		pl += x, pb += y, pr += x, pt += y;
+		const Vector3f left = origin + axisX * glyph.planeMin.x;
+		const Vector3f right = origin + axisX * glyph.planeMax.x;
+		const Vector3f bottom = axisY * glyph.planeMin.y;
+		const Vector3f top = axisY * glyph.planeMax.y;
 
-		double texelWidth = 1.0 / fontAtlas->GetWidth();
-		double texelHeight = 1.0 / fontAtlas->GetHeight();
-		l *= texelWidth, b *= texelHeight, r *= texelWidth, t *= texelHeight;
-
-		s_Data.textVertexBufferPtr->position = transform * Vector3f((float)pl, (float)pb, 0.0f);
+		s_Data.textVertexBufferPtr->position = left + bottom;
 		s_Data.textVertexBufferPtr->colour = colour;
-		s_Data.textVertexBufferPtr->texCoords = Vector2f((float)l, (float)b);
+		s_Data.textVertexBufferPtr->texCoords = glyph.texCoordsMin;
 		s_Data.textVertexBufferPtr->texIndex = textureIndex;
 		s_Data.textVertexBufferPtr->EntityId = entityId;
 		s_Data.textVertexBufferPtr++;
 
-		s_Data.textVertexBufferPtr->position = transform * Vector3f((float)pr, (float)pb, 0.0f);
+		s_Data.textVertexBufferPtr->position = right + bottom;
 		s_Data.textVertexBufferPtr->colour = colour;
-		s_Data.textVertexBufferPtr->texCoords = Vector2f((float)r, (float)b);
+		s_Data.textVertexBufferPtr->texCoords = Vector2f(glyph.texCoordsMax.x, glyph.texCoordsMin.y);
 		s_Data.textVertexBufferPtr->texIndex = textureIndex;
 		s_Data.textVertexBufferPtr->EntityId = entityId;
 		s_Data.textVertexBufferPtr++;
 
-		s_Data.textVertexBufferPtr->position = transform * Vector3f((float)pr, (float)pt, 0.0f);
+		s_Data.textVertexBufferPtr->position = right + top;
 		s_Data.textVertexBufferPtr->colour = colour;
-		s_Data.textVertexBufferPtr->texCoords = Vector2f((float)r, (float)t);
+		s_Data.textVertexBufferPtr->texCoords = glyph.texCoordsMax;
 		s_Data.textVertexBufferPtr->texIndex = textureIndex;
 		s_Data.textVertexBufferPtr->EntityId = entityId;
 		s_Data.textVertexBufferPtr++;
 
-		s_Data.textVertexBufferPtr->position = transform * Vector3f((float)pl, (float)pt, 0.0f);
+		s_Data.textVertexBufferPtr->position = left + top;
 		s_Data.textVertexBufferPtr->colour = colour;
-		s_Data.textVertexBufferPtr->texCoords = Vector2f((float)l, (float)t);
+		s_Data.textVertexBufferPtr->texCoords = Vector2f(glyph.texCoordsMin.x, glyph.texCoordsMax.y);
 		s_Data.textVertexBufferPtr->texIndex = textureIndex;
 		s_Data.textVertexBufferPtr->EntityId = entityId;
 		s_Data.textVertexBufferPtr++;
 
 		s_Data.textIndexCount += 6;
-
-		double advance = glyph->getAdvance();
-		fontGeometry.getAdvance(advance, character, utf32string[i + 1]);
-		x += fsScale * advance;
-
-		s_Data.statistics.quadCount++;
 	}
+
+	s_Data.statistics.quadCount += (uint32_t)glyphs.size();
 }
 
 /* ------------------------------------------------------------------------------------------------------------------ */
@@ -1136,4 +1660,14 @@ const Renderer2D::Stats& Renderer2D::GetStats()
 void Renderer2D::ResetStats()
 {
 	memset(&s_Data.statistics, 0, sizeof(Stats));
-}
\ No newline at end of file
+}
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void Renderer2D::AddCullingStats(uint32_t visible, uint32_t culled)
+{
+	s_Data.statistics.visibleCount += visible;
+	s_Data.statistics.culledCount += culled;
+
+	if (culled > 0)
+		Statistics::Add(Statistics::CulledObjects, (double)culled);
+}
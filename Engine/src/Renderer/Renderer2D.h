@@ -1,21 +1,88 @@
 #pragma once
 
+#include <unordered_map>
+
 #include "Camera.h"
 
 #include "Texture.h"
 #include "SubTexture2D.h"
 #include "Core/Colour.h"
 #include "Renderer/Font.h"
+#include "Renderer/TextLayout.h"
 
 #include "Scene/Components/SpriteComponent.h"
 #include "Scene/Components/CircleRendererComponent.h"
+#include "ParticleSystem/ParticleSystem.h"
+
+struct QuadVertex;
+struct CircleVertex;
 
 class Renderer2D
 {
 public:
+	// Records quads and circles without touching the shared batches, so each worker thread can fill its own.
+	// Submitting the contexts in a fixed order produces the same vertices and batches as drawing directly
+	class SubmissionContext
+	{
+	public:
+		SubmissionContext();
+		~SubmissionContext();
+		SubmissionContext(SubmissionContext&& other) noexcept;
+		SubmissionContext& operator=(SubmissionContext&& other) noexcept;
+
+		void DrawQuad(const Matrix4x4& transform, const Colour& colour = Colours::WHITE, int entityId = -1);
+		void DrawQuad(const Matrix4x4& transform, const Ref<Texture>& texture, const Colour& colour = Colours::WHITE, float tilingFactor = 1.0f, int entityId = -1);
+		void DrawQuad(const Matrix4x4& transform, const Ref<SubTexture2D>& subtexture, const Colour& colour = Colours::WHITE, int entityId = -1);
+		void DrawSprite(const Matrix4x4& transform, const SpriteComponent& spriteComp, int entityId);
+
+		void DrawCircle(const Matrix4x4& transform, const Colour& colour, float thickness = 1.0f, float fade = 0.005f, int entityId = -1);
+		void DrawCircle(const Matrix4x4& transform, const CircleRendererComponent& circleComp, int entityId = -1);
+
+		void Clear();
+		bool Empty() const;
+
+	private:
+		friend class Renderer2D;
+
+		uint32_t GetTextureIndex(const Ref<Texture>& texture);
+		void AddQuad(const Matrix4x4& transform, const Vector2f* texCoords, const Colour& colour, uint32_t texture, int entityId);
+
+		std::vector<QuadVertex> m_QuadVertices;
+		std::vector<uint32_t> m_QuadTextures; // index into m_Textures + 1 for each quad, 0 for untextured
+		std::vector<Ref<Texture>> m_Textures;
+		std::unordered_map<const Texture*, uint32_t> m_TextureIndices;
+		std::vector<CircleVertex> m_CircleVertices;
+	};
+
+
+	// How textured quads share a batch. Slots binds up to 32 textures per batch, Arrays copies textures
+	// into texture arrays by size and sampler state so a batch can draw hundreds of textures
+	enum class TextureBatching
+	{
+		Slots,
+		Arrays
+	};
+
+	// How the ends of thick lines are drawn, the values are u_Caps in Renderer2D_Line.frag
+	enum class LineCaps
+	{
+		Butt = 0, // cut off at the end points
+		Square, // extended by half the width
+		Round,
+		Triangle
+	};
+
 	static bool Init();
 	static void Shutdown();
 
+	// Takes effect from the next scene, Arrays falls back to Slots if the renderer API has no texture arrays
+	static void SetTextureBatching(TextureBatching textureBatching);
+	static TextureBatching GetTextureBatching();
+
+	// Applies to the lines in the next flush
+	static void SetLineCaps(LineCaps lineCaps);
+	static LineCaps GetLineCaps();
+
 	static void OnWindowResize(uint32_t width, uint32_t height);
 	static void BeginScene();
 	static void EndScene();
@@ -56,6 +123,12 @@ public:
 	static void DrawCircle(const Matrix4x4& transform, const Colour& colour, float thickness = 1.0f, float fade = 0.005f, int entityId = -1);
 	static void DrawCircle(const Matrix4x4& transform, const CircleRendererComponent& circleComp, int entityId = -1);
 
+	// Particles, written straight into the quad batch
+	static void DrawParticles(const ParticleSystem& particleSystem, float depth = 0.0f, int entityId = -1);
+
+	// Append the quads and circles recorded in a context to the batches, the context is cleared afterwards
+	static void Submit(SubmissionContext& context);
+
 	// Line
 	static void DrawLine(const Vector2f& start, const Vector2f& end, const float& thickness = 1.0f, const Colour& colour = Colours::WHITE);
 
@@ -78,6 +151,7 @@ public:
 	static void DrawString(const std::string& text, const Ref<Font> font, float maxWidth, const Vector2f& position, const float& rotation, const Colour & = Colours::WHITE, int entityId = -1);
 	static void DrawString(const std::string& text, const Ref<Font> font, float maxWidth, const Vector3f& position, const float& rotation, const Colour & = Colours::WHITE, int entityId = -1);
 	static void DrawString(const std::string& text, const Ref<Font> font, float maxWidth, const Matrix4x4& transform, const Colour & = Colours::WHITE, int entityId = -1);
+	static void DrawString(const TextLayout& layout, const Matrix4x4& transform, const Colour & = Colours::WHITE, int entityId = -1);
 
 	struct Stats
 	{
@@ -85,6 +159,11 @@ public:
 		uint32_t quadCount = 0;
 		uint32_t lineCount = 0;
 		uint32_t hairLineCount = 0;
+		uint32_t visibleCount = 0;
+		uint32_t culledCount = 0;
+		uint32_t batchBreaks = 0; // batches flushed before the end of the scene
+		uint32_t textureBatchBreaks = 0; // of which ran out of texture slots
+		uint32_t bufferStalls = 0; // batches that waited for the GPU to finish with their vertex buffer region
 
 		uint32_t GetTotalVertexCount() { return quadCount * 4; }
 		uint32_t GetTotalIndexCount() { return quadCount * 6; }
@@ -92,8 +171,14 @@ public:
 
 	static const Stats& GetStats();
 	static void ResetStats();
+	static void AddCullingStats(uint32_t visible, uint32_t culled);
 
 private:
+	static float GetQuadTextureIndex(const Ref<Texture>& texture);
+	static float GetQuadSlotIndex(const Ref<Texture>& texture, uint32_t maxSlots);
+	static float GetQuadArrayIndex(const Ref<Texture>& texture);
+	static float GetFontAtlasIndex(const Ref<Texture2D>& fontAtlas);
+
 	static void StartQuadsBatch();
 	static void StartCirclesBatch();
 	static void StartLinesBatch();
@@ -19,7 +19,8 @@ public:
 		OpenGL = 1,
 		Directx11,
 		Metal,
-		Vulkan
+		Vulkan,
+		Software
 	};
 
 public:
@@ -32,7 +33,18 @@ public:
 	virtual void ClearDepth() = 0;
 
 	virtual void DrawIndexed(uint32_t indexCount = 0, uint32_t startIndex = 0, uint32_t vertexOffset = 0, bool backFaceCull = true, DrawMode drawMode = DrawMode::FILL) = 0;
-	virtual void DrawLines(uint32_t vertexCount = 0) = 0;
+	virtual void DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex = 0, uint32_t vertexOffset = 0, bool backFaceCull = true, DrawMode drawMode = DrawMode::FILL) = 0;
+	virtual void DrawLines(uint32_t vertexCount = 0, uint32_t firstVertex = 0) = 0;
+
+	// Fences mark the commands submitted so far, waiting on one blocks until the GPU has finished them.
+	// APIs that have finished the commands by the time they return don't need fences and return 0
+	virtual uint64_t InsertFence() { return 0; }
+	// Returns true if the GPU hadn't reached the fence yet
+	virtual bool WaitFence(uint64_t fence) { return false; }
+	virtual void DeleteFence(uint64_t fence) {}
+
+	// Write the last rendered frame to an image, only APIs that render into system memory support this
+	virtual bool SaveBackBuffer(const std::filesystem::path& filepath) { return false; }
 
 	inline static API GetAPI() { return s_API; }
 protected:
@@ -7,13 +7,17 @@
 #include "Platform/DirectX/DirectX11Shader.h"
 #endif // __WINDOWS__
 #include "Platform/Vulkan/VulkanShader.h"
+#include "Platform/Null/NullShader.h"
+#include "Platform/Software/SoftwareShader.h"
 
 Ref<Shader> Shader::Create(const std::string& name, const std::filesystem::path& fileDirectory)
 {
 	switch (Renderer::GetAPI())
 	{
 	case RendererAPI::API::None:
-		break;
+		return CreateRef<NullShader>(name);
+	case RendererAPI::API::Software:
+		return CreateRef<SoftwareShader>(name);
 	case RendererAPI::API::OpenGL:
 		return CreateRef<OpenGLShader>(name, fileDirectory);
 #ifdef __WINDOWS__
@@ -43,7 +47,9 @@ Ref<Shader> Shader::Create(const std::string& name, const std::string& vertexSha
 	switch (Renderer::GetAPI())
 	{
 	case RendererAPI::API::None:
-		break;
+		return CreateRef<NullShader>(name);
+	case RendererAPI::API::Software:
+		return CreateRef<SoftwareShader>(name);
 	case RendererAPI::API::OpenGL:
 		return CreateRef<OpenGLShader>(vertexShaderSrc, fragmentShaderSrc);
 #ifdef __WINDOWS__
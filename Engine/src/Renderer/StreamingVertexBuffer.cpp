@@ -0,0 +1,79 @@
+#include "stdafx.h"
+#include "StreamingVertexBuffer.h"
+
+#include "RenderCommand.h"
+
+StreamingVertexBuffer::StreamingVertexBuffer(uint32_t regionSize, uint32_t regionCount)
+	:m_RegionSize(regionSize), m_RegionCount(std::max(regionCount, 1u)), m_Fences(m_RegionCount, 0)
+{
+	PROFILE_FUNCTION();
+
+	m_VertexBuffer = VertexBuffer::CreateStreaming(m_RegionSize * m_RegionCount);
+	m_MappedData = (uint8_t*)m_VertexBuffer->GetMappedData();
+	if (!m_MappedData)
+		m_Staging.resize(m_RegionSize);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+StreamingVertexBuffer::~StreamingVertexBuffer()
+{
+	for (uint64_t fence : m_Fences)
+	{
+		if (fence != 0)
+			RenderCommand::DeleteFence(fence);
+	}
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void* StreamingVertexBuffer::Begin()
+{
+	m_Stalled = false;
+
+	// Nothing has been drawn from the region yet so it can be written over
+	if (m_Drawn)
+	{
+		m_Drawn = false;
+		m_Region = (m_Region + 1) % m_RegionCount;
+
+		uint64_t& fence = m_Fences[m_Region];
+		if (fence != 0)
+		{
+			PROFILE_SCOPE("StreamingVertexBuffer wait");
+			m_Stalled = RenderCommand::WaitFence(fence);
+			RenderCommand::DeleteFence(fence);
+			fence = 0;
+		}
+	}
+
+	if (m_MappedData)
+		return m_MappedData + (size_t)m_Region * m_RegionSize;
+	return m_Staging.data();
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+uint32_t StreamingVertexBuffer::Commit(uint32_t size)
+{
+	CORE_ASSERT(size <= m_RegionSize, "Streaming vertex buffer region overflowed");
+
+	const uint32_t offset = m_Region * m_RegionSize;
+	if (!m_MappedData)
+		m_VertexBuffer->SetData(m_Staging.data(), size, offset);
+
+	const uint32_t stride = m_VertexBuffer->GetLayout().GetStride();
+	return stride != 0 ? offset / stride : 0;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void StreamingVertexBuffer::Fence()
+{
+	// The region can be drawn from again before moving on, only the last fence needs waiting for
+	uint64_t& fence = m_Fences[m_Region];
+	if (fence != 0)
+		RenderCommand::DeleteFence(fence);
+	fence = RenderCommand::InsertFence();
+	m_Drawn = true;
+}
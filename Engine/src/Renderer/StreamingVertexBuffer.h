@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Buffer.h"
+
+// A vertex buffer split into regions that are filled in turn, so vertices can be written to one region while the GPU
+// is still drawing from the others. Vertices go straight into the buffer when it can be mapped, otherwise they are
+// staged and copied into the region when it is committed
+class StreamingVertexBuffer
+{
+public:
+	StreamingVertexBuffer(uint32_t regionSize, uint32_t regionCount = 3);
+	~StreamingVertexBuffer();
+
+	void SetLayout(const BufferLayout& layout) { m_VertexBuffer->SetLayout(layout); }
+
+	// Where to write the next batch of vertices. Moves on to the next region if the current one has been drawn from,
+	// waiting for the GPU to finish with it if it is still in use
+	void* Begin();
+
+	// Make the first size bytes written since Begin visible to the GPU, returns the index of the first vertex of the region
+	uint32_t Commit(uint32_t size);
+
+	// Called after the draw calls that read from the current region
+	void Fence();
+
+	void Bind() const { m_VertexBuffer->Bind(); }
+	void UnBind() const { m_VertexBuffer->UnBind(); }
+
+	const Ref<VertexBuffer>& GetVertexBuffer() const { return m_VertexBuffer; }
+	bool IsMapped() const { return m_MappedData != nullptr; }
+
+	// Whether the last call to Begin had to wait for the GPU
+	bool Stalled() const { return m_Stalled; }
+
+private:
+	Ref<VertexBuffer> m_VertexBuffer;
+	uint8_t* m_MappedData = nullptr;
+	std::vector<uint8_t> m_Staging;
+
+	uint32_t m_RegionSize;
+	uint32_t m_RegionCount;
+	uint32_t m_Region = 0;
+	bool m_Drawn = false; // from the current region since Begin
+	bool m_Stalled = false;
+
+	std::vector<uint64_t> m_Fences; // of the last draw from each region, 0 once the GPU has finished with it
+};
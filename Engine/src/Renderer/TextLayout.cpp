@@ -0,0 +1,247 @@
+#include "stdafx.h"
+#include "TextLayout.h"
+
+#include <list>
+
+#include "Utilities/StringUtils.h"
+
+struct TextLayoutCacheEntry
+{
+	uint64_t key;
+	Ref<TextLayout> layout;
+};
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+struct TextLayoutCache
+{
+	size_t capacity = 1024;
+
+	// Most recently used at the front
+	std::list<TextLayoutCacheEntry> list;
+	std::unordered_map<uint64_t, std::list<TextLayoutCacheEntry>::iterator> map;
+
+	TextLayout::Stats stats;
+};
+
+static TextLayoutCache s_Cache;
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static uint64_t CacheKey(const std::string& text, const Font* font, float maxWidth)
+{
+	uint32_t widthBits;
+	memcpy(&widthBits, &maxWidth, sizeof(widthBits));
+
+	uint64_t key = std::hash<std::string>()(text);
+	key ^= std::hash<const void*>()(font) + 0x9e3779b97f4a7c15ull + (key << 6) + (key >> 2);
+	key ^= (uint64_t)widthBits + 0x9e3779b97f4a7c15ull + (key << 6) + (key >> 2);
+	return key;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+TextLayout::TextLayout(const std::string& text, const Ref<Font>& font, float maxWidth)
+	:m_Text(text), m_Font(font), m_MaxWidth(maxWidth)
+{
+	PROFILE_FUNCTION();
+
+	if (text.empty() || font == nullptr)
+		return;
+
+	m_FontGeneration = font->GetGeneration();
+
+	ASSERT(font->GetFontAtlas(), "Font atlas cannot be null");
+
+	const Font::Metrics& metrics = font->GetMetrics();
+
+	std::vector<int> nextLines;
+	double x = 0.0;
+	double fsScale = 1 / (metrics.ascenderY - metrics.descenderY);
+	double y = -fsScale * metrics.ascenderY;
+	int lastSpace = -1;
+
+	std::u32string utf32string = DecodeUtf8(text);
+	std::vector<char32_t> missingGlyphs;
+
+	// Find where the lines wrap
+	for (int i = 0; i < utf32string.size(); i++)
+	{
+		char32_t character = utf32string[i];
+		if (character == '\n')
+		{
+			x = 0;
+			y -= fsScale * metrics.lineHeight;
+			continue;
+		}
+
+		const Font::Glyph* glyph = font->GetGlyph(character);
+		if (!glyph)
+		{
+			if (character >= ' ')
+				missingGlyphs.push_back(character);
+			glyph = font->GetGlyph('?');
+		}
+		if (!glyph)
+			continue;
+
+		if (character != ' ' && character != '\t')
+		{
+			Vector2f quadMin((float)glyph->planeLeft, (float)glyph->planeBottom);
+			Vector2f quadMax((float)glyph->planeRight, (float)glyph->planeTop);
+
+			quadMin = quadMin * (float)fsScale;
+			quadMax = quadMax * (float)fsScale;
+			quadMin += Vector2f((float)x, (float)y);
+			quadMax += Vector2f((float)x, (float)y);
+
+			if (quadMax.x > maxWidth && lastSpace != -1)
+			{
+				i = lastSpace;
+				nextLines.emplace_back(lastSpace);
+				lastSpace = -1;
+				x = 0;
+				y -= fsScale * metrics.lineHeight;
+			}
+		}
+		else
+		{
+			lastSpace = i;
+		}
+
+		double advance = glyph->advance;
+		font->GetAdvance(advance, character, utf32string[i + 1]);
+		x += fsScale * advance;
+	}
+
+	// Shown as '?' until they have been generated, the layout no longer matches once they are added to the font
+	if (!missingGlyphs.empty())
+		font->RequestGlyphs(missingGlyphs);
+
+	// Place the glyphs, the wrapping spaces are in ascending order
+	m_Glyphs.reserve(utf32string.size());
+
+	size_t nextLine = 0;
+	x = 0.0;
+	y = 0.0;
+	for (int i = 0; i < utf32string.size(); i++)
+	{
+		char32_t character = utf32string[i];
+
+		if (nextLine < nextLines.size() && nextLines[nextLine] == i)
+		{
+			nextLine++;
+			x = 0;
+			y -= fsScale * metrics.lineHeight;
+			continue;
+		}
+		if (character == '\n')
+		{
+			x = 0;
+			y -= fsScale * metrics.lineHeight;
+			continue;
+		}
+		if (character == '\t')
+		{
+			double advance = font->GetGlyph(' ')->advance;
+			x += fsScale * (advance * 4);
+			continue;
+		}
+		const Font::Glyph* glyph = font->GetGlyph(character);
+		if (!glyph)
+			glyph = font->GetGlyph('?');
+		if (!glyph)
+			continue;
+
+		const Ref<Texture2D>& atlas = font->GetAtlas(glyph->atlas);
+		uint32_t atlasIndex = 0;
+		while (atlasIndex < m_FontAtlases.size() && m_FontAtlases[atlasIndex] != atlas)
+			atlasIndex++;
+		if (atlasIndex == m_FontAtlases.size())
+			m_FontAtlases.push_back(atlas);
+
+		double l = glyph->atlasLeft, b = glyph->atlasBottom, r = glyph->atlasRight, t = glyph->atlasTop;
+		double pl = glyph->planeLeft, pb = glyph->planeBottom, pr = glyph->planeRight, pt = glyph->planeTop;
+
+		pl *= fsScale, pb *= fsScale, pr *= fsScale, pt *= fsScale;
+		pl += x, pb += y, pr += x, pt += y;
+
+		const double texelWidth = 1.0 / atlas->GetWidth();
+		const double texelHeight = 1.0 / atlas->GetHeight();
+		l *= texelWidth, b *= texelHeight, r *= texelWidth, t *= texelHeight;
+
+		Glyph& quad = m_Glyphs.emplace_back();
+		quad.planeMin = Vector2f((float)pl, (float)pb);
+		quad.planeMax = Vector2f((float)pr, (float)pt);
+		quad.texCoordsMin = Vector2f((float)l, (float)b);
+		quad.texCoordsMax = Vector2f((float)r, (float)t);
+		quad.atlas = atlasIndex;
+
+		m_Bounds.Merge(Vector3f(quad.planeMin.x, quad.planeMin.y, 0.0f));
+		m_Bounds.Merge(Vector3f(quad.planeMax.x, quad.planeMax.y, 0.0f));
+
+		double advance = glyph->advance;
+		font->GetAdvance(advance, character, utf32string[i + 1]);
+		x += fsScale * advance;
+	}
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+bool TextLayout::Matches(const std::string& text, const Ref<Font>& font, float maxWidth) const
+{
+	return m_Font == font && m_MaxWidth == maxWidth && m_Text == text
+		&& (font == nullptr || m_FontGeneration == font->GetGeneration());
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+Ref<TextLayout> TextLayout::Get(const std::string& text, const Ref<Font>& font, float maxWidth)
+{
+	const uint64_t key = CacheKey(text, font.get(), maxWidth);
+
+	auto it = s_Cache.map.find(key);
+	if (it != s_Cache.map.end())
+	{
+		s_Cache.list.splice(s_Cache.list.begin(), s_Cache.list, it->second);
+		if (it->second->layout->Matches(text, font, maxWidth))
+		{
+			s_Cache.stats.hits++;
+			return it->second->layout;
+		}
+
+		// A different string with the same hash, or the font has been reloaded
+		s_Cache.stats.misses++;
+		it->second->layout = CreateRef<TextLayout>(text, font, maxWidth);
+		return it->second->layout;
+	}
+
+	s_Cache.stats.misses++;
+	Ref<TextLayout> layout = CreateRef<TextLayout>(text, font, maxWidth);
+	s_Cache.list.push_front({ key, layout });
+	s_Cache.map[key] = s_Cache.list.begin();
+
+	if (s_Cache.list.size() > s_Cache.capacity)
+	{
+		s_Cache.map.erase(s_Cache.list.back().key);
+		s_Cache.list.pop_back();
+	}
+	return layout;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void TextLayout::ClearCache()
+{
+	s_Cache.map.clear();
+	s_Cache.list.clear();
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+TextLayout::Stats TextLayout::GetStats()
+{
+	Stats stats = s_Cache.stats;
+	stats.layouts = (uint32_t)s_Cache.list.size();
+	return stats;
+}
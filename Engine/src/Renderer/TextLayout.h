@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Renderer/Font.h"
+#include "Core/BoundingBox.h"
+
+#include "math/Vector2f.h"
+
+// Glyph quads of a string positioned in local space, wrapped to a maximum width.
+// Layouts are shared through a cache so static text is only laid out once
+class TextLayout
+{
+public:
+	struct Glyph
+	{
+		Vector2f planeMin, planeMax;
+		Vector2f texCoordsMin, texCoordsMax;
+		uint32_t atlas; // index into the font atlases of the layout
+	};
+
+	TextLayout(const std::string& text, const Ref<Font>& font, float maxWidth);
+
+	// Whether the layout was built from the same text, font and width, and the font hasn't changed since
+	bool Matches(const std::string& text, const Ref<Font>& font, float maxWidth) const;
+
+	const std::vector<Glyph>& GetGlyphs() const { return m_Glyphs; }
+	const Ref<Font>& GetFont() const { return m_Font; }
+	const std::vector<Ref<Texture2D>>& GetFontAtlases() const { return m_FontAtlases; }
+
+	// Local space box enclosing the glyph quads, invalid if there are none
+	const BoundingBox& GetBounds() const { return m_Bounds; }
+
+	// Get the layout from the cache, laying the text out if it isn't there
+	static Ref<TextLayout> Get(const std::string& text, const Ref<Font>& font, float maxWidth);
+	static void ClearCache();
+
+	struct Stats
+	{
+		uint32_t layouts = 0;
+		uint32_t hits = 0;
+		uint32_t misses = 0;
+	};
+
+	static Stats GetStats();
+
+private:
+	std::string m_Text;
+	Ref<Font> m_Font;
+	uint32_t m_FontGeneration = 0;
+	float m_MaxWidth;
+
+	std::vector<Ref<Texture2D>> m_FontAtlases;
+
+	std::vector<Glyph> m_Glyphs;
+	BoundingBox m_Bounds;
+};
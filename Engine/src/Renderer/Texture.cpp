@@ -2,18 +2,23 @@
 #include "Texture.h"
 
 #include "Renderer.h"
+#include "Core/Statistics.h"
 #include "Platform/OpenGL/OpenGLTexture.h"
 #ifdef __WINDOWS__
 #include "Platform/DirectX/DirectX11Texture.h"
 #endif // __WINDOWS__
 #include "Platform/Vulkan/VulkanTexture.h"
+#include "Platform/Null/NullTexture.h"
+#include "Platform/Software/SoftwareTexture.h"
 
 Ref<Texture2D> Texture2D::Create(uint32_t width, uint32_t height, Format format, const void* pixels)
 {
 	switch (Renderer::GetAPI())
 	{
 	case RendererAPI::API::None:
-		break;
+		return CreateRef<NullTexture2D>(width, height);
+	case RendererAPI::API::Software:
+		return CreateRef<SoftwareTexture2D>(width, height, format, pixels);
 	case RendererAPI::API::OpenGL:
 		return CreateRef<OpenGLTexture2D>(width, height, format, pixels);
 #ifdef __WINDOWS__
@@ -42,7 +47,9 @@ Ref<Texture2D> Texture2D::Create(const std::filesystem::path& filepath)
 	switch (Renderer::GetAPI())
 	{
 	case RendererAPI::API::None:
-		break;
+		return CreateRef<NullTexture2D>(filepath);
+	case RendererAPI::API::Software:
+		return CreateRef<SoftwareTexture2D>(filepath);
 	case RendererAPI::API::OpenGL:
 		return CreateRef<OpenGLTexture2D>(filepath);
 #ifdef __WINDOWS__
@@ -66,6 +73,25 @@ Ref<Texture2D> Texture2D::Create(const std::filesystem::path& filepath)
 
 /* ------------------------------------------------------------------------------------------------------------------ */
 
+Ref<Texture2DArray> Texture2DArray::Create(uint32_t width, uint32_t height, uint32_t layers, FilterMethod filterMethod, WrapMethod wrapMethod)
+{
+	switch (Renderer::GetAPI())
+	{
+	case RendererAPI::API::None:
+		return CreateRef<NullTexture2DArray>(width, height, layers, filterMethod, wrapMethod);
+	case RendererAPI::API::Software:
+		return CreateRef<SoftwareTexture2DArray>(width, height, layers, filterMethod, wrapMethod);
+	case RendererAPI::API::OpenGL:
+		return CreateRef<OpenGLTexture2DArray>(width, height, layers, filterMethod, wrapMethod);
+	default:
+		break;
+	}
+
+	return nullptr;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
 bool Texture2D::Load(const std::filesystem::path& filepath)
 {
 	return (Texture2D::Create(filepath) == nullptr);
@@ -88,6 +114,7 @@ Ref<Texture2D> TextureLibrary2D::Load(const std::filesystem::path& path)
 
 	Ref<Texture2D> texture = Texture2D::Create(path);
 	Add(texture);
+	Statistics::Add(Statistics::AssetLoads, 1.0);
 	return texture;
 }
 
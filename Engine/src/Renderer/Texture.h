@@ -72,18 +72,44 @@ public:
 
 	virtual bool operator==(const Texture& other) const = 0;
 
+	// Incremented whenever the pixels are replaced, so copies of the texture know when they are stale
+	uint32_t GetGeneration() const { return m_Generation; }
+
 	FilterMethod m_FilterMethod = FilterMethod::Nearest;
 	WrapMethod m_WrapMethod = WrapMethod::Repeat;
+
+protected:
+	uint32_t m_Generation = 0;
 };
 
 class Texture2D :public Texture
 {
 public:
 	virtual bool Load(const std::filesystem::path& filepath) override;
+
+	// Copy the whole of another texture into this one with its bottom left corner at x, y, then repeat its edge texels
+	// border texels out from each side. Returns false if the renderer API or the texture's format doesn't support it
+	virtual bool SetRegion(uint32_t x, uint32_t y, const Texture& texture, uint32_t border = 0) { return false; }
+
 	static Ref<Texture2D> Create(uint32_t width, uint32_t height, Format format = Format::RGBA, const void* pixels = nullptr);
 	static Ref<Texture2D> Create(const std::filesystem::path& filepath);
 };
 
+// Layers of 8 bit RGBA images of the same size and sampler state, sampled through a single binding
+class Texture2DArray : public Texture
+{
+public:
+	virtual bool Load(const std::filesystem::path& filepath) override { return false; }
+
+	virtual uint32_t GetLayerCount() const = 0;
+
+	// Copy a texture of the same size into a layer, returns false if the texture can't be copied
+	virtual bool SetLayer(uint32_t layer, const Texture& texture) = 0;
+
+	// Returns nullptr if the renderer API doesn't support texture arrays
+	static Ref<Texture2DArray> Create(uint32_t width, uint32_t height, uint32_t layers, FilterMethod filterMethod, WrapMethod wrapMethod);
+};
+
 class TextureLibrary2D
 {
 public:
@@ -0,0 +1,358 @@
+#include "stdafx.h"
+#include "TextureAtlas.h"
+#include "AtlasPacker.h"
+
+static const uint32_t s_InvalidPage = UINT32_MAX;
+
+// Gutter around each texture on all four sides, filled with its edge texels so linear filtering at the edge of a
+// region blends with the texture itself rather than its neighbours or the empty page
+static const uint32_t s_Padding = 1;
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+struct AtlasPage
+{
+	Ref<Texture2D> texture;
+	AtlasPacker packer;
+	Texture::FilterMethod filterMethod;
+	uint64_t liveArea = 0; // of the textures still in the page, the packer also counts the ones removed since it was cleared
+};
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+struct AtlasEntry
+{
+	std::weak_ptr<Texture> texture; // expired if the address has been reused by another texture
+	uint32_t generation = 0;
+	uint32_t page = s_InvalidPage;
+	bool rejected = false; // the texture can't go in the atlas, not tried again until its pixels change
+	uint32_t failedFrame = 0; // the pages were full, not tried again until the next frame
+	uint32_t lastUsedFrame = 0;
+	AtlasPacker::Rect rect;
+	TextureAtlas::Region region;
+};
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+struct TextureAtlasData
+{
+	uint32_t pageSize = 2048;
+	uint32_t maxPages = 4;
+	uint32_t maxTextureSize = 256;
+	bool enabled = false;
+
+	uint32_t frame = 1;
+	uint64_t requestedArea = 0; // of the textures that didn't fit this frame
+
+	std::vector<AtlasPage> pages;
+	std::unordered_map<const Texture*, AtlasEntry> entries;
+
+	TextureAtlas::Stats stats;
+};
+
+static TextureAtlasData s_Data;
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static uint64_t RectArea(const AtlasPacker::Rect& rect)
+{
+	return (uint64_t)rect.width * rect.height;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static void ClearPage(AtlasPage& page)
+{
+	std::vector<uint32_t> pixels((size_t)s_Data.pageSize * s_Data.pageSize, 0);
+	page.texture->SetData(pixels.data());
+	page.packer.Clear();
+	page.liveArea = 0;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Copy the texture into a packed rectangle of the page
+static bool PlaceEntry(uint32_t pageIndex, const AtlasPacker::Rect& rect, const Texture& texture, AtlasEntry& entry)
+{
+	AtlasPage& page = s_Data.pages[pageIndex];
+	if (!page.texture->SetRegion(rect.x + s_Padding, rect.y + s_Padding, texture, s_Padding))
+		return false;
+
+	const float size = (float)s_Data.pageSize;
+	entry.page = pageIndex;
+	entry.rect = rect;
+	entry.region.page = page.texture;
+	entry.region.offset = Vector2f((float)(rect.x + s_Padding) / size, (float)(rect.y + s_Padding) / size);
+	entry.region.scale = Vector2f((float)texture.GetWidth() / size, (float)texture.GetHeight() / size);
+
+	page.liveArea += RectArea(rect);
+	return true;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static void RemoveEntry(AtlasEntry& entry)
+{
+	if (entry.page != s_InvalidPage)
+		s_Data.pages[entry.page].liveArea -= RectArea(entry.rect);
+	entry.page = s_InvalidPage;
+	entry.region.page.reset();
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static void AddEntry(const Texture& texture, AtlasEntry& entry)
+{
+	PROFILE_FUNCTION();
+
+	entry.generation = texture.GetGeneration();
+	entry.page = s_InvalidPage;
+	entry.rejected = false;
+
+	const uint32_t width = texture.GetWidth() + 2 * s_Padding;
+	const uint32_t height = texture.GetHeight() + 2 * s_Padding;
+	if (texture.GetWidth() == 0 || texture.GetHeight() == 0 || texture.GetWidth() > s_Data.maxTextureSize || texture.GetHeight() > s_Data.maxTextureSize)
+	{
+		entry.rejected = true;
+		return;
+	}
+
+	AtlasPacker::Rect rect;
+	uint32_t pageIndex = s_InvalidPage;
+	for (uint32_t i = 0; i < (uint32_t)s_Data.pages.size(); i++)
+	{
+		if (s_Data.pages[i].filterMethod == texture.GetFilterMethod() && s_Data.pages[i].packer.Insert(width, height, rect))
+		{
+			pageIndex = i;
+			break;
+		}
+	}
+
+	if (pageIndex == s_InvalidPage && s_Data.pages.size() < s_Data.maxPages)
+	{
+		Ref<Texture2D> pageTexture = Texture2D::Create(s_Data.pageSize, s_Data.pageSize, Texture::Format::RGBA);
+		if (!pageTexture)
+		{
+			entry.rejected = true;
+			return;
+		}
+
+		AtlasPage& page = s_Data.pages.emplace_back();
+		page.texture = pageTexture;
+		page.texture->SetFilterMethod(texture.GetFilterMethod());
+		page.texture->SetWrapMethod(Texture::WrapMethod::Clamp);
+		page.filterMethod = texture.GetFilterMethod();
+		page.packer.Reset(s_Data.pageSize, s_Data.pageSize);
+		ClearPage(page);
+
+		pageIndex = (uint32_t)s_Data.pages.size() - 1;
+		page.packer.Insert(width, height, rect);
+	}
+
+	if (pageIndex == s_InvalidPage)
+	{
+		entry.failedFrame = s_Data.frame;
+		s_Data.requestedArea += (uint64_t)width * height;
+		return;
+	}
+
+	if (!PlaceEntry(pageIndex, rect, texture, entry))
+	{
+		entry.rejected = true;
+		return;
+	}
+
+	s_Data.stats.insertions++;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Pack the textures left in the page again from an empty page, tallest first
+static void Defragment(uint32_t pageIndex)
+{
+	PROFILE_FUNCTION();
+
+	AtlasPage& page = s_Data.pages[pageIndex];
+
+	std::vector<AtlasEntry*> entries;
+	for (auto& [key, entry] : s_Data.entries)
+	{
+		if (entry.page == pageIndex)
+			entries.push_back(&entry);
+	}
+	std::sort(entries.begin(), entries.end(), [](const AtlasEntry* a, const AtlasEntry* b) { return a->rect.height > b->rect.height; });
+
+	ClearPage(page);
+
+	for (AtlasEntry* entry : entries)
+	{
+		Ref<Texture> texture = entry->texture.lock();
+		AtlasPacker::Rect rect;
+		entry->page = s_InvalidPage;
+		if (!texture || !page.packer.Insert(entry->rect.width, entry->rect.height, rect) || !PlaceEntry(pageIndex, rect, *texture, *entry))
+		{
+			entry->region.page.reset();
+			s_Data.stats.evictions++;
+		}
+	}
+
+	s_Data.stats.defragmentations++;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void TextureAtlas::Init(uint32_t pageSize, uint32_t maxPages, uint32_t maxTextureSize)
+{
+	Clear();
+	s_Data.pageSize = pageSize;
+	s_Data.maxPages = maxPages;
+	s_Data.maxTextureSize = std::min(maxTextureSize, pageSize - 2 * s_Padding);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void TextureAtlas::Shutdown()
+{
+	Clear();
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void TextureAtlas::SetEnabled(bool enabled)
+{
+	s_Data.enabled = enabled;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+bool TextureAtlas::IsEnabled()
+{
+	return s_Data.enabled;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void TextureAtlas::NewFrame()
+{
+	PROFILE_FUNCTION();
+
+	s_Data.frame++;
+
+	if (s_Data.requestedArea == 0 && s_Data.frame % 60 != 0)
+		return;
+
+	// Textures that have been destroyed go first, then the ones drawn longest ago until there is room for the
+	// textures that didn't fit. Anything drawn in the last frame is kept as it is probably still on screen
+	std::vector<std::unordered_map<const Texture*, AtlasEntry>::iterator> candidates;
+	for (auto it = s_Data.entries.begin(); it != s_Data.entries.end();)
+	{
+		if (it->second.texture.expired())
+		{
+			RemoveEntry(it->second);
+			it = s_Data.entries.erase(it);
+			continue;
+		}
+		if (it->second.page != s_InvalidPage && it->second.lastUsedFrame + 1 < s_Data.frame)
+			candidates.push_back(it);
+		++it;
+	}
+
+	if (s_Data.requestedArea == 0)
+		return;
+	std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) { return a->second.lastUsedFrame < b->second.lastUsedFrame; });
+
+	// The packer fills around 90% of a page with random sizes, aim for the pages to be no more than 80% full
+	const uint64_t usableArea = (uint64_t)s_Data.pageSize * s_Data.pageSize * 4 / 5;
+	uint64_t freeArea = (s_Data.maxPages - s_Data.pages.size()) * usableArea;
+	for (const AtlasPage& page : s_Data.pages)
+		freeArea += page.liveArea < usableArea ? usableArea - page.liveArea : 0;
+
+	for (auto& it : candidates)
+	{
+		if (freeArea >= s_Data.requestedArea)
+			break;
+		freeArea += RectArea(it->second.rect);
+		RemoveEntry(it->second);
+		s_Data.entries.erase(it);
+		s_Data.stats.evictions++;
+	}
+
+	// Reclaim the holes left by removed textures
+	for (uint32_t i = 0; i < (uint32_t)s_Data.pages.size(); i++)
+	{
+		if (s_Data.pages[i].packer.GetUsedArea() > s_Data.pages[i].liveArea)
+			Defragment(i);
+	}
+
+	s_Data.requestedArea = 0;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+const TextureAtlas::Region* TextureAtlas::Find(const Ref<Texture>& texture)
+{
+	if (!s_Data.enabled || !texture)
+		return nullptr;
+
+	auto [it, inserted] = s_Data.entries.try_emplace(texture.get());
+	AtlasEntry& entry = it->second;
+	entry.lastUsedFrame = s_Data.frame;
+
+	if (inserted || entry.texture.expired())
+	{
+		RemoveEntry(entry);
+		entry.texture = texture;
+		AddEntry(*texture, entry);
+	}
+	else if (entry.generation != texture->GetGeneration())
+	{
+		// The pixels have changed, copy them again if the texture is still the same size
+		if (entry.page != s_InvalidPage && entry.rect.width == texture->GetWidth() + 2 * s_Padding
+			&& entry.rect.height == texture->GetHeight() + 2 * s_Padding
+			&& s_Data.pages[entry.page].texture->SetRegion(entry.rect.x + s_Padding, entry.rect.y + s_Padding, *texture, s_Padding))
+		{
+			entry.generation = texture->GetGeneration();
+		}
+		else
+		{
+			RemoveEntry(entry);
+			AddEntry(*texture, entry);
+		}
+	}
+	else if (entry.page == s_InvalidPage && !entry.rejected && entry.failedFrame != s_Data.frame)
+	{
+		AddEntry(*texture, entry);
+	}
+
+	return entry.page != s_InvalidPage ? &entry.region : nullptr;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void TextureAtlas::Clear()
+{
+	s_Data.entries.clear();
+	s_Data.pages.clear();
+	s_Data.requestedArea = 0;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+TextureAtlas::Stats TextureAtlas::GetStats()
+{
+	Stats stats = s_Data.stats;
+	stats.pages = (uint32_t)s_Data.pages.size();
+
+	uint64_t liveArea = 0;
+	for (const AtlasPage& page : s_Data.pages)
+		liveArea += page.liveArea;
+	for (const auto& [key, entry] : s_Data.entries)
+	{
+		if (entry.page != s_InvalidPage)
+			stats.textures++;
+	}
+
+	if (!s_Data.pages.empty())
+		stats.occupancy = (float)((double)liveArea / ((double)s_Data.pages.size() * s_Data.pageSize * s_Data.pageSize));
+	return stats;
+}
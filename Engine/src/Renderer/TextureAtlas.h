@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Texture.h"
+#include "math/Vector2f.h"
+
+// Packs small textures into shared pages at runtime so the sprites, sprite sheets and tilesets drawn by Renderer2D
+// can share a batch. Textures are added the first time they are drawn. When the pages run out of room the textures
+// drawn longest ago are evicted and the pages repacked at the start of the next scene
+class TextureAtlas
+{
+public:
+	// Where a texture is in a page, texture coordinates map to offset + uv * scale
+	struct Region
+	{
+		Ref<Texture> page;
+		Vector2f offset;
+		Vector2f scale;
+
+		Vector2f Remap(const Vector2f& texCoords) const { return Vector2f(offset.x + texCoords.x * scale.x, offset.y + texCoords.y * scale.y); }
+	};
+
+	struct Stats
+	{
+		uint32_t pages = 0;
+		uint32_t textures = 0;
+		uint32_t insertions = 0;
+		uint32_t evictions = 0;
+		uint32_t defragmentations = 0;
+		float occupancy = 0.0f; // of all of the pages
+	};
+
+	static void Init(uint32_t pageSize = 2048, uint32_t maxPages = 4, uint32_t maxTextureSize = 256);
+	static void Shutdown();
+
+	static void SetEnabled(bool enabled);
+	static bool IsEnabled();
+
+	// Call before anything is drawn in a scene, evicts textures and repacks the pages if they ran out of room
+	static void NewFrame();
+
+	// The region of the texture, adding it to a page if there is room. Returns nullptr if the texture isn't in the atlas
+	static const Region* Find(const Ref<Texture>& texture);
+
+	// Remove every texture and page
+	static void Clear();
+
+	static Stats GetStats();
+};
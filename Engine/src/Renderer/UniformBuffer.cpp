@@ -7,13 +7,17 @@
 #include "Platform/DirectX/DirectX11UniformBuffer.h"
 #endif // __WINDOWS__
 #include "Platform/Vulkan/VulkanUniformBuffer.h"
+#include "Platform/Null/NullUniformBuffer.h"
+#include "Platform/Software/SoftwareUniformBuffer.h"
 
 Ref<UniformBuffer> UniformBuffer::Create(uint32_t size, uint32_t binding)
 {
 	switch (Renderer::GetAPI())
 	{
 	case RendererAPI::API::None:
-		break;
+		return CreateRef<NullUniformBuffer>(size, binding);
+	case RendererAPI::API::Software:
+		return CreateRef<SoftwareUniformBuffer>(size, binding);
 	case RendererAPI::API::OpenGL:
 		return CreateRef<OpenGLUniformBuffer>(size, binding);
 #ifdef __WINDOWS__
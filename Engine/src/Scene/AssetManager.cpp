@@ -1,6 +1,8 @@
 #include "stdafx.h"
 #include "AssetManager.h"
 
+#include "Renderer/ImageLoader.h"
+
 AssetManager* AssetManager::s_Instance = nullptr;
 
 
@@ -12,3 +14,18 @@ AssetManager& AssetManager::Get()
 	}
 	return *s_Instance;
 }
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void AssetManager::PrefetchTextures(const std::vector<std::filesystem::path>& filepaths)
+{
+	PROFILE_FUNCTION();
+
+	std::vector<std::filesystem::path> unloaded;
+	for (const std::filesystem::path& filepath : filepaths)
+	{
+		if (!filepath.empty() && !AssetManager::Get().m_Textures.Exists(filepath.filename().string()))
+			unloaded.push_back(filepath);
+	}
+	ImageLoader::Prefetch(unloaded);
+}
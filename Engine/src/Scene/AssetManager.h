@@ -25,6 +25,9 @@ public:
 		return AssetManager::Get().m_Textures.Load(filepath);
 	}
 
+	// Start decoding the textures that are not loaded yet on the worker threads
+	static void PrefetchTextures(const std::vector<std::filesystem::path>& filepaths);
+
 	static void CleanUp()
 	{
 		AssetManager::Get().m_Assets.CleanUnused();
@@ -0,0 +1,1482 @@
+#include "stdafx.h"
+#include "BinarySceneSerializer.h"
+
+#include "Scene/Entity.h"
+#include "Components.h"
+#include "SceneSerializer.h"
+#include "Core/Version.h"
+#include "Utilities/MappedFile.h"
+#include "Utilities/SerializationUtils.h"
+#include "AssetManager.h"
+#include "Renderer/ImageLoader.h"
+
+// A file is a header, a table of chunk headers and then the chunks, each starting on an 8 byte boundary. Values are
+// little endian. Strings are stored once in the string table and assets once in the asset table, records refer to
+// them and to entities by index
+
+static constexpr uint32_t FourCC(const char(&id)[5])
+{
+	return (uint32_t)id[0] | ((uint32_t)id[1] << 8) | ((uint32_t)id[2] << 16) | ((uint32_t)id[3] << 24);
+}
+
+static constexpr uint32_t s_Magic = FourCC("SCNB");
+static constexpr uint32_t s_Version = 1;
+static constexpr uint32_t s_NullIndex = UINT32_MAX;
+
+// The version each chunk is written with, chunks from a newer version of the engine are skipped
+static constexpr uint32_t s_ChunkVersion = 1;
+
+enum class ChunkId : uint32_t
+{
+	Strings = FourCC("STRS"),
+	Assets = FourCC("ASET"),
+	Data = FourCC("DATA"),
+	SceneSettings = FourCC("SCNE"),
+	Entities = FourCC("ENTS"),
+	Transforms = FourCC("TRFM"),
+	Cameras = FourCC("CAMR"),
+	Sprites = FourCC("SPRT"),
+	AnimatedSprites = FourCC("ASPR"),
+	StaticMeshes = FourCC("SMSH"),
+	Primitives = FourCC("PRIM"),
+	Tilemaps = FourCC("TMAP"),
+	RigidBodies2D = FourCC("RB2D"),
+	BoxColliders2D = FourCC("BOX2"),
+	CircleColliders2D = FourCC("CIR2"),
+	PolygonColliders2D = FourCC("PLY2"),
+	CapsuleColliders2D = FourCC("CAP2"),
+	CircleRenderers = FourCC("CREN"),
+	ParticleSystems = FourCC("PSYS"),
+	Texts = FourCC("TEXT"),
+	BehaviourTrees = FourCC("BTRE"),
+	StateMachines = FourCC("STMC"),
+	LuaScripts = FourCC("LUAS"),
+	PointLights = FourCC("PLGT"),
+	Billboards = FourCC("BILB"),
+	Canvases = FourCC("CNVS"),
+	EntityPools = FourCC("POOL")
+};
+
+enum class AssetType : uint32_t
+{
+	Texture,
+	SpriteSheet,
+	StaticMesh,
+	Material,
+	Tileset,
+	PhysicsMaterial,
+	Font
+};
+
+struct FileHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t chunkCount;
+	uint32_t engineVersion;
+};
+
+struct ChunkHeader
+{
+	uint32_t id;
+	uint32_t version;
+	uint32_t count; // of records
+	uint32_t stride; // size of a record, records can grow without changing the chunk version
+	uint64_t offset;
+	uint64_t size;
+};
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+struct AssetRecord
+{
+	uint32_t type;
+	uint32_t path;
+	uint32_t param0; // filter method of textures
+	uint32_t param1; // wrap method of textures
+};
+
+struct SceneRecord
+{
+	float gravity[2];
+	uint32_t pixelsPerUnit;
+	uint32_t padding;
+};
+
+static constexpr uint32_t s_EntityHasHierarchy = 1 << 0;
+static constexpr uint32_t s_EntityActive = 1 << 1;
+
+struct EntityRecord
+{
+	uint64_t idLo;
+	uint64_t idHi;
+	uint32_t name;
+	uint32_t flags;
+	uint32_t parent;
+	uint32_t firstChild;
+	uint32_t previousSibling;
+	uint32_t nextSibling;
+};
+
+struct TransformRecord
+{
+	uint32_t entity;
+	float position[3];
+	float rotation[3];
+	float scale[3];
+};
+
+struct CameraRecord
+{
+	uint32_t entity;
+	uint32_t primary;
+	uint32_t fixedAspectRatio;
+	uint32_t projectionType;
+	float orthoSize;
+	float orthoNear;
+	float orthoFar;
+	float perspectiveNear;
+	float perspectiveFar;
+	float fov;
+	float aspectRatio;
+};
+
+struct SpriteRecord
+{
+	uint32_t entity;
+	uint32_t texture;
+	float tint[4];
+	float tilingFactor;
+};
+
+struct AnimatedSpriteRecord
+{
+	uint32_t entity;
+	uint32_t spriteSheet;
+	uint32_t animation;
+	float tint[4];
+};
+
+struct StaticMeshRecord
+{
+	uint32_t entity;
+	uint32_t mesh;
+	uint32_t materials; // offset into the data chunk of the material asset indices
+	uint32_t materialCount;
+};
+
+struct PrimitiveRecord
+{
+	uint32_t entity;
+	uint32_t material;
+	uint32_t type;
+	float cubeWidth, cubeHeight, cubeDepth;
+	float sphereRadius;
+	uint32_t sphereLongitudeLines, sphereLatitudeLines;
+	float planeWidth, planeLength;
+	uint32_t planeWidthLines, planeLengthLines;
+	float planeTileU, planeTileV;
+	float cylinderBottomRadius, cylinderTopRadius, cylinderHeight;
+	uint32_t cylinderSliceCount, cylinderStackCount;
+	float coneBottomRadius, coneHeight;
+	uint32_t coneSliceCount, coneStackCount;
+	float torusOuterRadius, torusInnerRadius;
+	uint32_t torusSliceCount;
+};
+
+struct TilemapRecord
+{
+	uint32_t entity;
+	uint32_t tileset;
+	float tint[4];
+	uint32_t tilesWide;
+	uint32_t tilesHigh;
+	uint32_t tileWidth;
+	uint32_t tileHeight;
+	uint32_t orientation;
+	uint32_t isTrigger;
+	uint32_t tiles; // offset into the data chunk of tilesWide * tilesHigh tiles, row by row
+};
+
+struct RigidBody2DRecord
+{
+	uint32_t entity;
+	uint32_t type;
+	uint32_t fixedRotation;
+	float gravityScale;
+	float angularDamping;
+	float linearDamping;
+};
+
+struct BoxCollider2DRecord
+{
+	uint32_t entity;
+	uint32_t physicsMaterial;
+	float offset[2];
+	float size[2];
+	uint32_t isTrigger;
+};
+
+struct CircleCollider2DRecord
+{
+	uint32_t entity;
+	uint32_t physicsMaterial;
+	float offset[2];
+	float radius;
+	uint32_t isTrigger;
+};
+
+struct PolygonCollider2DRecord
+{
+	uint32_t entity;
+	uint32_t physicsMaterial;
+	float offset[2];
+	uint32_t isTrigger;
+	uint32_t vertices; // offset into the data chunk of the x and y of each vertex
+	uint32_t vertexCount;
+};
+
+struct CapsuleCollider2DRecord
+{
+	uint32_t entity;
+	uint32_t physicsMaterial;
+	float offset[2];
+	float radius;
+	float height;
+	uint32_t direction;
+	uint32_t isTrigger;
+};
+
+struct CircleRendererRecord
+{
+	uint32_t entity;
+	float colour[4];
+	float radius;
+	float thickness;
+	float fade;
+};
+
+struct ParticleSystemRecord
+{
+	uint32_t entity;
+	float emissionRate;
+	uint32_t maxParticles;
+	uint32_t emitting;
+	float velocity[2];
+	float velocityVariation[2];
+	float beginColour[4];
+	float endColour[4];
+	float sizeBegin;
+	float sizeEnd;
+	float sizeVariation;
+	float rotationSpeed;
+	float lifeTime;
+};
+
+struct TextRecord
+{
+	uint32_t entity;
+	uint32_t text;
+	uint32_t font;
+	float maxWidth;
+	float colour[4];
+};
+
+struct FilepathRecord
+{
+	uint32_t entity;
+	uint32_t filepath;
+};
+
+struct EntityOnlyRecord
+{
+	uint32_t entity;
+};
+
+struct PointLightRecord
+{
+	uint32_t entity;
+	float colour[4];
+	uint32_t castsShadows;
+	float range;
+	float attenuation;
+};
+
+struct BillboardRecord
+{
+	uint32_t entity;
+	uint32_t orientation;
+	uint32_t position;
+	float screenPosition[2];
+};
+
+struct CanvasRecord
+{
+	uint32_t entity;
+	float pixelPerUnit;
+};
+
+struct EntityPoolRecord
+{
+	uint32_t entity;
+	uint32_t prewarmCount;
+};
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static void Encode(float* out, const Vector2f& vec2) { out[0] = vec2.x; out[1] = vec2.y; }
+static void Encode(float* out, const Vector3f& vec3) { out[0] = vec3.x; out[1] = vec3.y; out[2] = vec3.z; }
+static void Encode(float* out, const Colour& colour) { out[0] = colour.r; out[1] = colour.g; out[2] = colour.b; out[3] = colour.a; }
+
+static void Decode(const float* in, Vector2f& vec2) { vec2.x = in[0]; vec2.y = in[1]; }
+static void Decode(const float* in, Vector3f& vec3) { vec3.x = in[0]; vec3.y = in[1]; vec3.z = in[2]; }
+static void Decode(const float* in, Colour& colour) { colour.r = in[0]; colour.g = in[1]; colour.b = in[2]; colour.a = in[3]; }
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Builds the chunks in memory before writing the file
+class SceneWriter
+{
+public:
+	SceneWriter()
+	{
+		AddString("");
+	}
+
+	uint32_t AddString(const std::string& string)
+	{
+		auto [it, inserted] = m_StringIndices.try_emplace(string, (uint32_t)m_StringOffsets.size());
+		if (inserted)
+		{
+			m_StringOffsets.push_back((uint32_t)m_StringData.size());
+			m_StringData.insert(m_StringData.end(), string.begin(), string.end());
+			m_StringData.push_back('\0');
+		}
+		return it->second;
+	}
+
+	uint32_t AddPath(const std::filesystem::path& filepath)
+	{
+		return filepath.empty() ? 0 : AddString(SerializationUtils::RelativePath(filepath));
+	}
+
+	uint32_t AddAsset(AssetType type, const Asset* asset, uint32_t param0 = 0, uint32_t param1 = 0)
+	{
+		if (!asset || asset->GetFilepath().empty())
+			return s_NullIndex;
+
+		AssetRecord record = { (uint32_t)type, AddPath(asset->GetFilepath()), param0, param1 };
+		auto [it, inserted] = m_AssetIndices.try_emplace(std::make_tuple(record.type, record.path, param0, param1), (uint32_t)m_Assets.size());
+		if (inserted)
+			m_Assets.push_back(record);
+		return it->second;
+	}
+
+	uint32_t AddData(const void* data, size_t words)
+	{
+		uint32_t offset = (uint32_t)m_Data.size();
+		m_Data.resize(m_Data.size() + words);
+		if (words > 0)
+			memcpy(&m_Data[offset], data, words * sizeof(uint32_t));
+		return offset;
+	}
+
+	void SetEntities(std::vector<entt::entity>&& entities)
+	{
+		m_Entities = std::move(entities);
+		m_EntityIndices.reserve(m_Entities.size());
+		for (uint32_t i = 0; i < (uint32_t)m_Entities.size(); i++)
+			m_EntityIndices[m_Entities[i]] = i;
+	}
+
+	const std::vector<entt::entity>& GetEntities() const { return m_Entities; }
+
+	uint32_t GetEntityIndex(entt::entity entity) const
+	{
+		auto it = m_EntityIndices.find(entity);
+		return it != m_EntityIndices.end() ? it->second : s_NullIndex;
+	}
+
+	template<typename Record>
+	void AddChunk(ChunkId id, const std::vector<Record>& records)
+	{
+		if (records.empty())
+			return;
+		AddChunk(id, (uint32_t)records.size(), sizeof(Record), records.data(), records.size() * sizeof(Record));
+	}
+
+	void AddChunk(ChunkId id, uint32_t count, uint32_t stride, const void* data, size_t size)
+	{
+		ChunkHeader header = { (uint32_t)id, s_ChunkVersion, count, stride, 0, size };
+		m_Chunks.emplace_back(header, std::vector<uint8_t>((const uint8_t*)data, (const uint8_t*)data + size));
+	}
+
+	bool Write(const std::filesystem::path& filepath)
+	{
+		PROFILE_FUNCTION();
+
+		// The string table is the count, the offset of each string and then the strings
+		std::vector<uint8_t> strings(sizeof(uint32_t) * (1 + m_StringOffsets.size()) + m_StringData.size());
+		uint32_t stringCount = (uint32_t)m_StringOffsets.size();
+		memcpy(strings.data(), &stringCount, sizeof(uint32_t));
+		memcpy(strings.data() + sizeof(uint32_t), m_StringOffsets.data(), m_StringOffsets.size() * sizeof(uint32_t));
+		memcpy(strings.data() + sizeof(uint32_t) * (1 + m_StringOffsets.size()), m_StringData.data(), m_StringData.size());
+
+		AddChunk(ChunkId::Strings, stringCount, 1, strings.data(), strings.size());
+		AddChunk(ChunkId::Assets, m_Assets);
+		AddChunk(ChunkId::Data, (uint32_t)m_Data.size(), sizeof(uint32_t), m_Data.data(), m_Data.size() * sizeof(uint32_t));
+
+		FileHeader fileHeader = { s_Magic, s_Version, (uint32_t)m_Chunks.size(), VERSION };
+
+		uint64_t offset = Align(sizeof(FileHeader) + sizeof(ChunkHeader) * m_Chunks.size());
+		for (auto& [header, data] : m_Chunks)
+		{
+			header.offset = offset;
+			offset = Align(offset + header.size);
+		}
+
+		std::ofstream file(filepath, std::ios::binary);
+		if (!file)
+			return false;
+
+		file.write((const char*)&fileHeader, sizeof(FileHeader));
+		for (auto& [header, data] : m_Chunks)
+			file.write((const char*)&header, sizeof(ChunkHeader));
+
+		static const char padding[8] = {};
+		uint64_t position = sizeof(FileHeader) + sizeof(ChunkHeader) * m_Chunks.size();
+		for (auto& [header, data] : m_Chunks)
+		{
+			file.write(padding, header.offset - position);
+			file.write((const char*)data.data(), data.size());
+			position = header.offset + header.size;
+		}
+
+		return file.good();
+	}
+
+private:
+	static uint64_t Align(uint64_t offset) { return (offset + 7) & ~(uint64_t)7; }
+
+	std::vector<std::pair<ChunkHeader, std::vector<uint8_t>>> m_Chunks;
+
+	std::unordered_map<std::string, uint32_t> m_StringIndices;
+	std::vector<uint32_t> m_StringOffsets;
+	std::vector<char> m_StringData;
+
+	std::map<std::tuple<uint32_t, uint32_t, uint32_t, uint32_t>, uint32_t> m_AssetIndices;
+	std::vector<AssetRecord> m_Assets;
+
+	std::vector<uint32_t> m_Data;
+
+	std::vector<entt::entity> m_Entities;
+	std::unordered_map<entt::entity, uint32_t> m_EntityIndices;
+};
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Everything the component decoders need to resolve the indices in their records
+struct SceneReader
+{
+	entt::registry& registry;
+	const uint8_t* data;
+
+	const uint32_t* stringOffsets = nullptr;
+	uint32_t stringCount = 0;
+	const char* stringData = nullptr;
+	size_t stringDataSize = 0;
+
+	const uint32_t* words = nullptr;
+	size_t wordCount = 0;
+
+	std::vector<AssetType> assetTypes;
+	std::vector<Ref<Asset>> assets;
+
+	std::vector<entt::entity> entities;
+
+	// The chunk each entity was last given a component by, to find duplicate records
+	std::vector<uint32_t> seen;
+	uint32_t chunk = 0;
+
+	const char* GetString(uint32_t index) const
+	{
+		if (index >= stringCount)
+			return "";
+		return stringData + stringOffsets[index];
+	}
+
+	std::filesystem::path GetPath(uint32_t index) const
+	{
+		const char* path = GetString(index);
+		return *path != '\0' ? SerializationUtils::AbsolutePath(path) : std::filesystem::path();
+	}
+
+	template<typename T>
+	Ref<T> GetAsset(uint32_t index, AssetType type) const
+	{
+		if (index >= assets.size() || assetTypes[index] != type)
+			return nullptr;
+		return std::static_pointer_cast<T>(assets[index]);
+	}
+
+	entt::entity GetEntity(uint32_t index) const
+	{
+		return index < entities.size() ? entities[index] : entt::null;
+	}
+
+	// The words at offset in the data chunk, null if they are out of range
+	const uint32_t* GetData(uint32_t offset, size_t count) const
+	{
+		if ((size_t)offset + count > wordCount)
+			return nullptr;
+		return words + offset;
+	}
+};
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+template<typename Component, typename Record, typename EncodeFunc>
+static void SaveComponents(entt::registry& registry, SceneWriter& writer, ChunkId id, EncodeFunc encode)
+{
+	auto view = registry.view<Component>();
+
+	std::vector<Record> records;
+	records.reserve(view.size());
+
+	view.each([&](entt::entity entity, const Component& component)
+		{
+			uint32_t index = writer.GetEntityIndex(entity);
+			if (index == s_NullIndex)
+				return;
+
+			Record& record = records.emplace_back();
+			record.entity = index;
+			encode(component, record);
+		});
+
+	writer.AddChunk(id, records);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Construct the components of every record in the chunk at once, then fill them in from the records
+template<typename Component, typename Record, typename DecodeFunc>
+static void LoadComponents(SceneReader& reader, const ChunkHeader& chunk, DecodeFunc decode)
+{
+	PROFILE_FUNCTION();
+
+	if (chunk.stride < sizeof(Record))
+	{
+		ENGINE_ERROR("Scene chunk records are smaller than expected, skipping chunk");
+		return;
+	}
+
+	const uint8_t* records = reader.data + chunk.offset;
+
+	std::vector<entt::entity> handles;
+	std::vector<const uint8_t*> sources;
+	handles.reserve(chunk.count);
+	sources.reserve(chunk.count);
+
+	reader.chunk++;
+	for (uint32_t i = 0; i < chunk.count; i++)
+	{
+		const uint8_t* source = records + (size_t)i * chunk.stride;
+
+		uint32_t entity;
+		memcpy(&entity, source, sizeof(uint32_t));
+		if (entity >= reader.entities.size() || reader.seen[entity] == reader.chunk)
+		{
+			ENGINE_WARN("Skipping scene record with an invalid or repeated entity {0}", entity);
+			continue;
+		}
+		reader.seen[entity] = reader.chunk;
+
+		handles.push_back(reader.entities[entity]);
+		sources.push_back(source);
+	}
+
+	reader.registry.insert<Component>(handles.begin(), handles.end());
+
+	for (size_t i = 0; i < handles.size(); i++)
+	{
+		Record record;
+		memcpy(&record, sources[i], sizeof(Record));
+		decode(reader.registry.get<Component>(handles[i]), record);
+	}
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+BinarySceneSerializer::BinarySceneSerializer(Scene* scene)
+	:m_Scene(scene)
+{
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+bool BinarySceneSerializer::Serialize(const std::filesystem::path& filepath) const
+{
+	PROFILE_FUNCTION();
+
+	entt::registry& registry = m_Scene->m_Registry;
+	SceneWriter writer;
+
+	// Entities are stored in the order they were created
+	std::vector<entt::entity> entities;
+	entities.reserve(registry.alive());
+	registry.each([&entities](entt::entity entity) { entities.push_back(entity); });
+	std::reverse(entities.begin(), entities.end());
+	writer.SetEntities(std::move(entities));
+
+	SceneRecord sceneRecord = {};
+	Encode(sceneRecord.gravity, m_Scene->GetGravity());
+	sceneRecord.pixelsPerUnit = m_Scene->GetPixelsPerUnit();
+	writer.AddChunk(ChunkId::SceneSettings, 1, sizeof(SceneRecord), &sceneRecord, sizeof(SceneRecord));
+
+	std::vector<EntityRecord> entityRecords;
+	entityRecords.reserve(writer.GetEntities().size());
+	for (entt::entity entity : writer.GetEntities())
+	{
+		EntityRecord& record = entityRecords.emplace_back();
+
+		const IDComponent* idComp = registry.try_get<IDComponent>(entity);
+		Uuid id = idComp ? idComp->ID : Uuid();
+		record.idLo = id.GetLo();
+		record.idHi = id.GetHi();
+
+		if (const NameComponent* nameComp = registry.try_get<NameComponent>(entity))
+			record.name = writer.AddString(nameComp->name);
+
+		record.parent = s_NullIndex;
+		record.firstChild = s_NullIndex;
+		record.previousSibling = s_NullIndex;
+		record.nextSibling = s_NullIndex;
+
+		if (const HierarchyComponent* hierarchyComp = registry.try_get<HierarchyComponent>(entity))
+		{
+			record.flags |= s_EntityHasHierarchy;
+			if (hierarchyComp->isActive)
+				record.flags |= s_EntityActive;
+
+			record.parent = writer.GetEntityIndex(hierarchyComp->parent);
+			record.firstChild = writer.GetEntityIndex(hierarchyComp->firstChild);
+			record.previousSibling = writer.GetEntityIndex(hierarchyComp->previousSibling);
+			record.nextSibling = writer.GetEntityIndex(hierarchyComp->nextSibling);
+		}
+	}
+	writer.AddChunk(ChunkId::Entities, entityRecords);
+
+	SaveComponents<TransformComponent, TransformRecord>(registry, writer, ChunkId::Transforms,
+		[](const TransformComponent& component, TransformRecord& record)
+		{
+			Encode(record.position, component.position);
+			Encode(record.rotation, component.rotation);
+			Encode(record.scale, component.scale);
+		});
+
+	SaveComponents<CameraComponent, CameraRecord>(registry, writer, ChunkId::Cameras,
+		[](const CameraComponent& component, CameraRecord& record)
+		{
+			record.primary = component.primary;
+			record.fixedAspectRatio = component.fixedAspectRatio;
+			record.projectionType = (uint32_t)component.camera.GetProjectionType();
+			record.orthoSize = component.camera.GetOrthoSize();
+			record.orthoNear = component.camera.GetOrthoNear();
+			record.orthoFar = component.camera.GetOrthoFar();
+			record.perspectiveNear = component.camera.GetPerspectiveNear();
+			record.perspectiveFar = component.camera.GetPerspectiveFar();
+			record.fov = component.camera.GetVerticalFov();
+			record.aspectRatio = component.camera.GetAspectRatio();
+		});
+
+	SaveComponents<SpriteComponent, SpriteRecord>(registry, writer, ChunkId::Sprites,
+		[&writer](const SpriteComponent& component, SpriteRecord& record)
+		{
+			record.texture = component.texture ? writer.AddAsset(AssetType::Texture, component.texture.get(),
+				(uint32_t)component.texture->GetFilterMethod(), (uint32_t)component.texture->GetWrapMethod()) : s_NullIndex;
+			Encode(record.tint, component.tint);
+			record.tilingFactor = component.tilingFactor;
+		});
+
+	SaveComponents<AnimatedSpriteComponent, AnimatedSpriteRecord>(registry, writer, ChunkId::AnimatedSprites,
+		[&writer](const AnimatedSpriteComponent& component, AnimatedSpriteRecord& record)
+		{
+			record.spriteSheet = writer.AddAsset(AssetType::SpriteSheet, component.spriteSheet.get());
+			record.animation = writer.AddString(component.animation);
+			Encode(record.tint, component.tint);
+		});
+
+	SaveComponents<StaticMeshComponent, StaticMeshRecord>(registry, writer, ChunkId::StaticMeshes,
+		[&writer](const StaticMeshComponent& component, StaticMeshRecord& record)
+		{
+			std::vector<uint32_t> materials;
+			materials.reserve(component.materialOverrides.size());
+			for (const Ref<Material>& material : component.materialOverrides)
+				materials.push_back(writer.AddAsset(AssetType::Material, material.get()));
+
+			record.mesh = writer.AddAsset(AssetType::StaticMesh, component.mesh.get());
+			record.materials = writer.AddData(materials.data(), materials.size());
+			record.materialCount = (uint32_t)materials.size();
+		});
+
+	SaveComponents<PrimitiveComponent, PrimitiveRecord>(registry, writer, ChunkId::Primitives,
+		[&writer](const PrimitiveComponent& component, PrimitiveRecord& record)
+		{
+			record.material = component.material != Material::GetDefaultMaterial()
+				? writer.AddAsset(AssetType::Material, component.material.get()) : s_NullIndex;
+			record.type = (uint32_t)component.type;
+			record.cubeWidth = component.cubeWidth;
+			record.cubeHeight = component.cubeHeight;
+			record.cubeDepth = component.cubeDepth;
+			record.sphereRadius = component.sphereRadius;
+			record.sphereLongitudeLines = component.sphereLongitudeLines;
+			record.sphereLatitudeLines = component.sphereLatitudeLines;
+			record.planeWidth = component.planeWidth;
+			record.planeLength = component.planeLength;
+			record.planeWidthLines = component.planeWidthLines;
+			record.planeLengthLines = component.planeLengthLines;
+			record.planeTileU = component.planeTileU;
+			record.planeTileV = component.planeTileV;
+			record.cylinderBottomRadius = component.cylinderBottomRadius;
+			record.cylinderTopRadius = component.cylinderTopRadius;
+			record.cylinderHeight = component.cylinderHeight;
+			record.cylinderSliceCount = component.cylinderSliceCount;
+			record.cylinderStackCount = component.cylinderStackCount;
+			record.coneBottomRadius = component.coneBottomRadius;
+			record.coneHeight = component.coneHeight;
+			record.coneSliceCount = component.coneSliceCount;
+			record.coneStackCount = component.coneStackCount;
+			record.torusOuterRadius = component.torusOuterRadius;
+			record.torusInnerRadius = component.torusInnerRadius;
+			record.torusSliceCount = component.torusSliceCount;
+		});
+
+	SaveComponents<TilemapComponent, TilemapRecord>(registry, writer, ChunkId::Tilemaps,
+		[&writer](const TilemapComponent& component, TilemapRecord& record)
+		{
+			std::vector<uint32_t> tiles((size_t)component.tilesWide * component.tilesHigh, 0);
+			for (uint32_t y = 0; y < component.tilesHigh && y < component.tiles.size(); y++)
+			{
+				for (uint32_t x = 0; x < component.tilesWide && x < component.tiles[y].size(); x++)
+					tiles[(size_t)y * component.tilesWide + x] = component.tiles[y][x];
+			}
+
+			record.tileset = writer.AddAsset(AssetType::Tileset, component.tileset.get());
+			Encode(record.tint, component.tint);
+			record.tilesWide = component.tilesWide;
+			record.tilesHigh = component.tilesHigh;
+			record.tileWidth = component.tileWidth;
+			record.tileHeight = component.tileHeight;
+			record.orientation = (uint32_t)component.orientation;
+			record.isTrigger = component.isTrigger;
+			record.tiles = writer.AddData(tiles.data(), tiles.size());
+		});
+
+	SaveComponents<RigidBody2DComponent, RigidBody2DRecord>(registry, writer, ChunkId::RigidBodies2D,
+		[](const RigidBody2DComponent& component, RigidBody2DRecord& record)
+		{
+			record.type = (uint32_t)component.type;
+			record.fixedRotation = component.fixedRotation;
+			record.gravityScale = component.gravityScale;
+			record.angularDamping = component.angularDamping;
+			record.linearDamping = component.linearDamping;
+		});
+
+	SaveComponents<BoxCollider2DComponent, BoxCollider2DRecord>(registry, writer, ChunkId::BoxColliders2D,
+		[&writer](const BoxCollider2DComponent& component, BoxCollider2DRecord& record)
+		{
+			record.physicsMaterial = writer.AddAsset(AssetType::PhysicsMaterial, component.physicsMaterial.get());
+			Encode(record.offset, component.offset);
+			Encode(record.size, component.size);
+			record.isTrigger = component.isTrigger;
+		});
+
+	SaveComponents<CircleCollider2DComponent, CircleCollider2DRecord>(registry, writer, ChunkId::CircleColliders2D,
+		[&writer](const CircleCollider2DComponent& component, CircleCollider2DRecord& record)
+		{
+			record.physicsMaterial = writer.AddAsset(AssetType::PhysicsMaterial, component.physicsMaterial.get());
+			Encode(record.offset, component.offset);
+			record.radius = component.radius;
+			record.isTrigger = component.isTrigger;
+		});
+
+	SaveComponents<PolygonCollider2DComponent, PolygonCollider2DRecord>(registry, writer, ChunkId::PolygonColliders2D,
+		[&writer](const PolygonCollider2DComponent& component, PolygonCollider2DRecord& record)
+		{
+			std::vector<float> vertices;
+			vertices.reserve(component.vertices.size() * 2);
+			for (const Vector2f& vertex : component.vertices)
+			{
+				vertices.push_back(vertex.x);
+				vertices.push_back(vertex.y);
+			}
+
+			record.physicsMaterial = writer.AddAsset(AssetType::PhysicsMaterial, component.physicsMaterial.get());
+			Encode(record.offset, component.offset);
+			record.isTrigger = component.isTrigger;
+			record.vertices = writer.AddData(vertices.data(), vertices.size());
+			record.vertexCount = (uint32_t)component.vertices.size();
+		});
+
+	SaveComponents<CapsuleCollider2DComponent, CapsuleCollider2DRecord>(registry, writer, ChunkId::CapsuleColliders2D,
+		[&writer](const CapsuleCollider2DComponent& component, CapsuleCollider2DRecord& record)
+		{
+			record.physicsMaterial = writer.AddAsset(AssetType::PhysicsMaterial, component.physicsMaterial.get());
+			Encode(record.offset, component.offset);
+			record.radius = component.radius;
+			record.height = component.height;
+			record.direction = (uint32_t)component.direction;
+			record.isTrigger = component.isTrigger;
+		});
+
+	SaveComponents<CircleRendererComponent, CircleRendererRecord>(registry, writer, ChunkId::CircleRenderers,
+		[](const CircleRendererComponent& component, CircleRendererRecord& record)
+		{
+			Encode(record.colour, component.colour);
+			record.radius = component.radius;
+			record.thickness = component.thickness;
+			record.fade = component.fade;
+		});
+
+	SaveComponents<ParticleSystemComponent, ParticleSystemRecord>(registry, writer, ChunkId::ParticleSystems,
+		[](const ParticleSystemComponent& component, ParticleSystemRecord& record)
+		{
+			record.emissionRate = component.emissionRate;
+			record.maxParticles = component.maxParticles;
+			record.emitting = component.emitting;
+			Encode(record.velocity, component.properties.velocity);
+			Encode(record.velocityVariation, component.properties.velocityVariation);
+			Encode(record.beginColour, component.properties.beginColour);
+			Encode(record.endColour, component.properties.endColour);
+			record.sizeBegin = component.properties.sizeBegin;
+			record.sizeEnd = component.properties.sizeEnd;
+			record.sizeVariation = component.properties.sizeVariation;
+			record.rotationSpeed = component.properties.rotationSpeed;
+			record.lifeTime = component.properties.lifeTime;
+		});
+
+	SaveComponents<TextComponent, TextRecord>(registry, writer, ChunkId::Texts,
+		[&writer](const TextComponent& component, TextRecord& record)
+		{
+			record.text = writer.AddString(component.text);
+			record.font = component.font != Font::GetDefaultFont() ? writer.AddAsset(AssetType::Font, component.font.get()) : s_NullIndex;
+			record.maxWidth = component.maxWidth;
+			Encode(record.colour, component.colour);
+		});
+
+	SaveComponents<BehaviourTreeComponent, FilepathRecord>(registry, writer, ChunkId::BehaviourTrees,
+		[&writer](const BehaviourTreeComponent& component, FilepathRecord& record)
+		{
+			record.filepath = writer.AddPath(component.filepath);
+		});
+
+	SaveComponents<StateMachineComponent, EntityOnlyRecord>(registry, writer, ChunkId::StateMachines,
+		[](const StateMachineComponent&, EntityOnlyRecord&) {});
+
+	SaveComponents<LuaScriptComponent, FilepathRecord>(registry, writer, ChunkId::LuaScripts,
+		[&writer](const LuaScriptComponent& component, FilepathRecord& record)
+		{
+			record.filepath = writer.AddPath(component.absoluteFilepath);
+		});
+
+	SaveComponents<PointLightComponent, PointLightRecord>(registry, writer, ChunkId::PointLights,
+		[](const PointLightComponent& component, PointLightRecord& record)
+		{
+			Encode(record.colour, component.colour);
+			record.castsShadows = component.castsShadows;
+			record.range = component.range;
+			record.attenuation = component.attenuation;
+		});
+
+	SaveComponents<BillboardComponent, BillboardRecord>(registry, writer, ChunkId::Billboards,
+		[](const BillboardComponent& component, BillboardRecord& record)
+		{
+			record.orientation = (uint32_t)component.orientation;
+			record.position = (uint32_t)component.position;
+			Encode(record.screenPosition, component.screenPosition);
+		});
+
+	SaveComponents<CanvasComponent, CanvasRecord>(registry, writer, ChunkId::Canvases,
+		[](const CanvasComponent& component, CanvasRecord& record)
+		{
+			record.pixelPerUnit = component.pixelPerUnit;
+		});
+
+	SaveComponents<EntityPoolComponent, EntityPoolRecord>(registry, writer, ChunkId::EntityPools,
+		[](const EntityPoolComponent& component, EntityPoolRecord& record)
+		{
+			record.prewarmCount = component.prewarmCount;
+		});
+
+	return writer.Write(filepath);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+bool BinarySceneSerializer::Deserialize(const std::filesystem::path& filepath)
+{
+	PROFILE_FUNCTION();
+
+	MappedFile file(filepath);
+	if (!file.IsOpen() || file.GetSize() < sizeof(FileHeader))
+	{
+		ENGINE_ERROR("Could not open scene {0}", filepath);
+		return false;
+	}
+
+	const uint8_t* data = file.GetData();
+	const size_t size = file.GetSize();
+
+	FileHeader fileHeader;
+	memcpy(&fileHeader, data, sizeof(FileHeader));
+	if (fileHeader.magic != s_Magic)
+	{
+		ENGINE_ERROR("Not a valid binary scene file {0}", filepath);
+		return false;
+	}
+	if (fileHeader.version > s_Version)
+	{
+		ENGINE_ERROR("Scene {0} was saved in a newer format, version {1}", filepath, fileHeader.version);
+		return false;
+	}
+	if (fileHeader.engineVersion != VERSION)
+		ENGINE_WARN("Loading scene created with a different version of the engine");
+
+	if ((size - sizeof(FileHeader)) / sizeof(ChunkHeader) < fileHeader.chunkCount)
+	{
+		ENGINE_ERROR("Scene {0} is truncated", filepath);
+		return false;
+	}
+
+	std::vector<ChunkHeader> chunks(fileHeader.chunkCount);
+	if (fileHeader.chunkCount > 0)
+		memcpy(chunks.data(), data + sizeof(FileHeader), sizeof(ChunkHeader) * fileHeader.chunkCount);
+
+	const ChunkHeader* stringChunk = nullptr;
+	const ChunkHeader* assetChunk = nullptr;
+	const ChunkHeader* dataChunk = nullptr;
+	const ChunkHeader* sceneChunk = nullptr;
+	const ChunkHeader* entityChunk = nullptr;
+
+	for (const ChunkHeader& chunk : chunks)
+	{
+		if (chunk.offset % 8 != 0 || chunk.offset > size || chunk.size > size - chunk.offset
+			|| (chunk.stride != 0 && chunk.count > chunk.size / chunk.stride) || (chunk.stride == 0 && chunk.count != 0))
+		{
+			ENGINE_ERROR("Scene {0} has a chunk outside of the file", filepath);
+			return false;
+		}
+
+		switch ((ChunkId)chunk.id)
+		{
+		case ChunkId::Strings: stringChunk = &chunk; break;
+		case ChunkId::Assets: assetChunk = &chunk; break;
+		case ChunkId::Data: dataChunk = &chunk; break;
+		case ChunkId::SceneSettings: sceneChunk = &chunk; break;
+		case ChunkId::Entities: entityChunk = &chunk; break;
+		default: break;
+		}
+	}
+
+	SceneReader reader = { m_Scene->m_Registry, data };
+
+	// Strings ------------------------------------------------------------------------------------------------------
+	if (stringChunk)
+	{
+		const uint8_t* strings = data + stringChunk->offset;
+		const uint32_t count = stringChunk->count;
+		if (stringChunk->size < sizeof(uint32_t) * (1 + (size_t)count))
+		{
+			ENGINE_ERROR("Scene {0} has an invalid string table", filepath);
+			return false;
+		}
+
+		reader.stringCount = count;
+		reader.stringOffsets = (const uint32_t*)(strings + sizeof(uint32_t));
+		reader.stringData = (const char*)(strings + sizeof(uint32_t) * (1 + (size_t)count));
+		reader.stringDataSize = stringChunk->size - sizeof(uint32_t) * (1 + (size_t)count);
+
+		// Every string has to end within the table
+		if (count > 0 && (reader.stringDataSize == 0 || reader.stringData[reader.stringDataSize - 1] != '\0'))
+		{
+			ENGINE_ERROR("Scene {0} has an invalid string table", filepath);
+			return false;
+		}
+		for (uint32_t i = 0; i < count; i++)
+		{
+			if (reader.stringOffsets[i] >= reader.stringDataSize)
+			{
+				ENGINE_ERROR("Scene {0} has an invalid string table", filepath);
+				return false;
+			}
+		}
+	}
+
+	// Data ---------------------------------------------------------------------------------------------------------
+	if (dataChunk && dataChunk->stride == sizeof(uint32_t))
+	{
+		reader.words = (const uint32_t*)(data + dataChunk->offset);
+		reader.wordCount = dataChunk->count;
+	}
+
+	// Assets, each one is looked up once however many components use it ------------------------------------------
+	if (assetChunk && assetChunk->stride >= sizeof(AssetRecord))
+	{
+		PROFILE_SCOPE("Resolve scene assets");
+
+		std::vector<AssetRecord> records(assetChunk->count);
+		std::vector<std::filesystem::path> texturePaths;
+		for (uint32_t i = 0; i < assetChunk->count; i++)
+		{
+			memcpy(&records[i], data + assetChunk->offset + (size_t)i * assetChunk->stride, sizeof(AssetRecord));
+			if ((AssetType)records[i].type == AssetType::Texture)
+				texturePaths.push_back(reader.GetPath(records[i].path));
+		}
+
+		// Textures are decoded on the worker threads while the other assets load, then uploaded last
+		AssetManager::PrefetchTextures(texturePaths);
+
+		reader.assetTypes.resize(assetChunk->count);
+		reader.assets.resize(assetChunk->count);
+		for (bool textures : { false, true })
+		{
+			for (uint32_t i = 0; i < assetChunk->count; i++)
+			{
+				const AssetRecord& record = records[i];
+				if (((AssetType)record.type == AssetType::Texture) != textures)
+					continue;
+
+				std::filesystem::path assetPath = reader.GetPath(record.path);
+				reader.assetTypes[i] = (AssetType)record.type;
+				if (assetPath.empty())
+					continue;
+
+				switch ((AssetType)record.type)
+				{
+				case AssetType::Texture:
+				{
+					Ref<Texture2D> texture = AssetManager::GetTexture(assetPath);
+					if (texture)
+					{
+						texture->SetFilterMethod((Texture::FilterMethod)record.param0);
+						texture->SetWrapMethod((Texture::WrapMethod)record.param1);
+					}
+					reader.assets[i] = texture;
+					break;
+				}
+				case AssetType::SpriteSheet: reader.assets[i] = AssetManager::GetAsset<SpriteSheet>(assetPath); break;
+				case AssetType::StaticMesh: reader.assets[i] = AssetManager::GetAsset<StaticMesh>(assetPath); break;
+				case AssetType::Material: reader.assets[i] = AssetManager::GetAsset<Material>(assetPath); break;
+				case AssetType::Tileset: reader.assets[i] = AssetManager::GetAsset<Tileset>(assetPath); break;
+				case AssetType::PhysicsMaterial: reader.assets[i] = AssetManager::GetAsset<PhysicsMaterial>(assetPath); break;
+				case AssetType::Font: reader.assets[i] = AssetManager::GetAsset<Font>(assetPath); break;
+				default:
+					ENGINE_WARN("Unknown asset type {0} in scene", record.type);
+					break;
+				}
+			}
+		}
+
+		ImageLoader::ClearPrefetched();
+	}
+
+	m_Scene->SetFilepath(filepath);
+
+	// Scene --------------------------------------------------------------------------------------------------------
+	if (sceneChunk && sceneChunk->count > 0 && sceneChunk->stride >= sizeof(SceneRecord))
+	{
+		SceneRecord record;
+		memcpy(&record, data + sceneChunk->offset, sizeof(SceneRecord));
+
+		Vector2f gravity;
+		Decode(record.gravity, gravity);
+		m_Scene->SetGravity(gravity);
+		m_Scene->SetPixelsPerUnit(record.pixelsPerUnit);
+	}
+
+	// Entities -----------------------------------------------------------------------------------------------------
+	if (entityChunk && entityChunk->stride >= sizeof(EntityRecord))
+	{
+		PROFILE_SCOPE("Create scene entities");
+
+		entt::registry& registry = m_Scene->m_Registry;
+		const uint32_t count = entityChunk->count;
+
+		reader.entities.resize(count);
+		reader.seen.resize(count, 0);
+		registry.create(reader.entities.begin(), reader.entities.end());
+
+		std::vector<EntityRecord> records(count);
+		std::vector<IDComponent> ids;
+		std::vector<NameComponent> names;
+		std::vector<entt::entity> hierarchyEntities;
+		ids.reserve(count);
+		names.reserve(count);
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			EntityRecord& record = records[i];
+			memcpy(&record, data + entityChunk->offset + (size_t)i * entityChunk->stride, sizeof(EntityRecord));
+
+			const char* name = reader.GetString(record.name);
+			ids.emplace_back(Uuid(record.idLo, record.idHi));
+			names.emplace_back(*name != '\0' ? name : "Unnamed Entity");
+			if (record.flags & s_EntityHasHierarchy)
+				hierarchyEntities.push_back(reader.entities[i]);
+		}
+
+		registry.insert<IDComponent>(reader.entities.begin(), reader.entities.end(), ids.begin());
+		registry.insert<NameComponent>(reader.entities.begin(), reader.entities.end(), std::make_move_iterator(names.begin()));
+		registry.insert<HierarchyComponent>(hierarchyEntities.begin(), hierarchyEntities.end());
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			const EntityRecord& record = records[i];
+			if (!(record.flags & s_EntityHasHierarchy))
+				continue;
+
+			HierarchyComponent& hierarchyComp = registry.get<HierarchyComponent>(reader.entities[i]);
+			hierarchyComp.parent = reader.GetEntity(record.parent);
+			hierarchyComp.firstChild = reader.GetEntity(record.firstChild);
+			hierarchyComp.previousSibling = reader.GetEntity(record.previousSibling);
+			hierarchyComp.nextSibling = reader.GetEntity(record.nextSibling);
+			hierarchyComp.isActive = (record.flags & s_EntityActive) != 0;
+		}
+	}
+
+	// Components ---------------------------------------------------------------------------------------------------
+	for (const ChunkHeader& chunk : chunks)
+	{
+		switch ((ChunkId)chunk.id)
+		{
+		case ChunkId::Strings:
+		case ChunkId::Assets:
+		case ChunkId::Data:
+		case ChunkId::SceneSettings:
+		case ChunkId::Entities:
+			continue;
+		default:
+			break;
+		}
+
+		if (chunk.version > s_ChunkVersion)
+		{
+			ENGINE_WARN("Skipping scene chunk saved by a newer version of the engine");
+			continue;
+		}
+
+		switch ((ChunkId)chunk.id)
+		{
+		case ChunkId::Transforms:
+			LoadComponents<TransformComponent, TransformRecord>(reader, chunk,
+				[](TransformComponent& component, const TransformRecord& record)
+				{
+					Decode(record.position, component.position);
+					Decode(record.rotation, component.rotation);
+					Decode(record.scale, component.scale);
+				});
+			break;
+		case ChunkId::Cameras:
+			LoadComponents<CameraComponent, CameraRecord>(reader, chunk,
+				[](CameraComponent& component, const CameraRecord& record)
+				{
+					component.primary = record.primary != 0;
+					component.fixedAspectRatio = record.fixedAspectRatio != 0;
+					component.camera.SetOrthoSize(record.orthoSize);
+					component.camera.SetOrthoNear(record.orthoNear);
+					component.camera.SetOrthoFar(record.orthoFar);
+					component.camera.SetPerspectiveNear(record.perspectiveNear);
+					component.camera.SetPerspectiveFar(record.perspectiveFar);
+					component.camera.SetVerticalFov(record.fov);
+					if (component.fixedAspectRatio)
+						component.camera.SetAspectRatio(record.aspectRatio);
+					component.camera.SetProjection((SceneCamera::ProjectionType)record.projectionType);
+				});
+			break;
+		case ChunkId::Sprites:
+			LoadComponents<SpriteComponent, SpriteRecord>(reader, chunk,
+				[&reader](SpriteComponent& component, const SpriteRecord& record)
+				{
+					component.texture = reader.GetAsset<Texture2D>(record.texture, AssetType::Texture);
+					Decode(record.tint, component.tint);
+					component.tilingFactor = record.tilingFactor;
+				});
+			break;
+		case ChunkId::AnimatedSprites:
+			LoadComponents<AnimatedSpriteComponent, AnimatedSpriteRecord>(reader, chunk,
+				[&reader](AnimatedSpriteComponent& component, const AnimatedSpriteRecord& record)
+				{
+					component.spriteSheet = reader.GetAsset<SpriteSheet>(record.spriteSheet, AssetType::SpriteSheet);
+					component.animation = reader.GetString(record.animation);
+					Decode(record.tint, component.tint);
+					if (component.spriteSheet && !component.animation.empty())
+					{
+						if (Animation* animation = component.spriteSheet->GetAnimation(component.animation))
+							component.currentFrame = animation->GetStartFrame();
+					}
+				});
+			break;
+		case ChunkId::StaticMeshes:
+			LoadComponents<StaticMeshComponent, StaticMeshRecord>(reader, chunk,
+				[&reader](StaticMeshComponent& component, const StaticMeshRecord& record)
+				{
+					component.mesh = reader.GetAsset<StaticMesh>(record.mesh, AssetType::StaticMesh);
+					if (const uint32_t* materials = reader.GetData(record.materials, record.materialCount))
+					{
+						component.materialOverrides.reserve(record.materialCount);
+						for (uint32_t i = 0; i < record.materialCount; i++)
+							component.materialOverrides.push_back(reader.GetAsset<Material>(materials[i], AssetType::Material));
+					}
+				});
+			break;
+		case ChunkId::Primitives:
+			LoadComponents<PrimitiveComponent, PrimitiveRecord>(reader, chunk,
+				[&reader](PrimitiveComponent& component, const PrimitiveRecord& record)
+				{
+					component.material = reader.GetAsset<Material>(record.material, AssetType::Material);
+					component.cubeWidth = record.cubeWidth;
+					component.cubeHeight = record.cubeHeight;
+					component.cubeDepth = record.cubeDepth;
+					component.sphereRadius = record.sphereRadius;
+					component.sphereLongitudeLines = record.sphereLongitudeLines;
+					component.sphereLatitudeLines = record.sphereLatitudeLines;
+					component.planeWidth = record.planeWidth;
+					component.planeLength = record.planeLength;
+					component.planeWidthLines = record.planeWidthLines;
+					component.planeLengthLines = record.planeLengthLines;
+					component.planeTileU = record.planeTileU;
+					component.planeTileV = record.planeTileV;
+					component.cylinderBottomRadius = record.cylinderBottomRadius;
+					component.cylinderTopRadius = record.cylinderTopRadius;
+					component.cylinderHeight = record.cylinderHeight;
+					component.cylinderSliceCount = record.cylinderSliceCount;
+					component.cylinderStackCount = record.cylinderStackCount;
+					component.coneBottomRadius = record.coneBottomRadius;
+					component.coneHeight = record.coneHeight;
+					component.coneSliceCount = record.coneSliceCount;
+					component.coneStackCount = record.coneStackCount;
+					component.torusOuterRadius = record.torusOuterRadius;
+					component.torusInnerRadius = record.torusInnerRadius;
+					component.torusSliceCount = record.torusSliceCount;
+					component.SetType((PrimitiveComponent::Shape)record.type);
+				});
+			break;
+		case ChunkId::Tilemaps:
+			LoadComponents<TilemapComponent, TilemapRecord>(reader, chunk,
+				[&reader](TilemapComponent& component, const TilemapRecord& record)
+				{
+					component.tileset = reader.GetAsset<Tileset>(record.tileset, AssetType::Tileset);
+					Decode(record.tint, component.tint);
+					component.tileWidth = record.tileWidth;
+					component.tileHeight = record.tileHeight;
+					component.orientation = (TilemapComponent::Orientation)record.orientation;
+					component.isTrigger = record.isTrigger != 0;
+
+					if (const uint32_t* tiles = reader.GetData(record.tiles, (size_t)record.tilesWide * record.tilesHigh))
+					{
+						component.tilesWide = record.tilesWide;
+						component.tilesHigh = record.tilesHigh;
+						component.tiles.resize(record.tilesHigh);
+						for (uint32_t y = 0; y < record.tilesHigh; y++)
+							component.tiles[y].assign(tiles + (size_t)y * record.tilesWide, tiles + (size_t)(y + 1) * record.tilesWide);
+					}
+					else
+					{
+						ENGINE_WARN("Tilemap tiles are outside of the scene data");
+					}
+
+					component.Rebuild();
+				});
+			break;
+		case ChunkId::RigidBodies2D:
+			LoadComponents<RigidBody2DComponent, RigidBody2DRecord>(reader, chunk,
+				[](RigidBody2DComponent& component, const RigidBody2DRecord& record)
+				{
+					component.type = (RigidBody2DComponent::BodyType)record.type;
+					component.fixedRotation = record.fixedRotation != 0;
+					component.gravityScale = record.gravityScale;
+					component.angularDamping = record.angularDamping;
+					component.linearDamping = record.linearDamping;
+				});
+			break;
+		case ChunkId::BoxColliders2D:
+			LoadComponents<BoxCollider2DComponent, BoxCollider2DRecord>(reader, chunk,
+				[&reader](BoxCollider2DComponent& component, const BoxCollider2DRecord& record)
+				{
+					component.physicsMaterial = reader.GetAsset<PhysicsMaterial>(record.physicsMaterial, AssetType::PhysicsMaterial);
+					Decode(record.offset, component.offset);
+					Decode(record.size, component.size);
+					component.isTrigger = record.isTrigger != 0;
+				});
+			break;
+		case ChunkId::CircleColliders2D:
+			LoadComponents<CircleCollider2DComponent, CircleCollider2DRecord>(reader, chunk,
+				[&reader](CircleCollider2DComponent& component, const CircleCollider2DRecord& record)
+				{
+					component.physicsMaterial = reader.GetAsset<PhysicsMaterial>(record.physicsMaterial, AssetType::PhysicsMaterial);
+					Decode(record.offset, component.offset);
+					component.radius = record.radius;
+					component.isTrigger = record.isTrigger != 0;
+				});
+			break;
+		case ChunkId::PolygonColliders2D:
+			LoadComponents<PolygonCollider2DComponent, PolygonCollider2DRecord>(reader, chunk,
+				[&reader](PolygonCollider2DComponent& component, const PolygonCollider2DRecord& record)
+				{
+					component.physicsMaterial = reader.GetAsset<PhysicsMaterial>(record.physicsMaterial, AssetType::PhysicsMaterial);
+					Decode(record.offset, component.offset);
+					component.isTrigger = record.isTrigger != 0;
+
+					if (const uint32_t* vertices = reader.GetData(record.vertices, (size_t)record.vertexCount * 2))
+					{
+						component.vertices.resize(record.vertexCount);
+						for (uint32_t i = 0; i < record.vertexCount; i++)
+							memcpy(&component.vertices[i].x, vertices + (size_t)i * 2, sizeof(float) * 2);
+					}
+				});
+			break;
+		case ChunkId::CapsuleColliders2D:
+			LoadComponents<CapsuleCollider2DComponent, CapsuleCollider2DRecord>(reader, chunk,
+				[&reader](CapsuleCollider2DComponent& component, const CapsuleCollider2DRecord& record)
+				{
+					component.physicsMaterial = reader.GetAsset<PhysicsMaterial>(record.physicsMaterial, AssetType::PhysicsMaterial);
+					Decode(record.offset, component.offset);
+					component.radius = record.radius;
+					component.height = record.height;
+					component.direction = (CapsuleCollider2DComponent::Direction)record.direction;
+					component.isTrigger = record.isTrigger != 0;
+				});
+			break;
+		case ChunkId::CircleRenderers:
+			LoadComponents<CircleRendererComponent, CircleRendererRecord>(reader, chunk,
+				[](CircleRendererComponent& component, const CircleRendererRecord& record)
+				{
+					Decode(record.colour, component.colour);
+					component.radius = record.radius;
+					component.thickness = record.thickness;
+					component.fade = record.fade;
+				});
+			break;
+		case ChunkId::ParticleSystems:
+			LoadComponents<ParticleSystemComponent, ParticleSystemRecord>(reader, chunk,
+				[](ParticleSystemComponent& component, const ParticleSystemRecord& record)
+				{
+					component.emissionRate = record.emissionRate;
+					component.maxParticles = record.maxParticles;
+					component.emitting = record.emitting != 0;
+					Decode(record.velocity, component.properties.velocity);
+					Decode(record.velocityVariation, component.properties.velocityVariation);
+					Decode(record.beginColour, component.properties.beginColour);
+					Decode(record.endColour, component.properties.endColour);
+					component.properties.sizeBegin = record.sizeBegin;
+					component.properties.sizeEnd = record.sizeEnd;
+					component.properties.sizeVariation = record.sizeVariation;
+					component.properties.rotationSpeed = record.rotationSpeed;
+					component.properties.lifeTime = record.lifeTime;
+				});
+			break;
+		case ChunkId::Texts:
+			LoadComponents<TextComponent, TextRecord>(reader, chunk,
+				[&reader](TextComponent& component, const TextRecord& record)
+				{
+					component.text = reader.GetString(record.text);
+					if (Ref<Font> font = reader.GetAsset<Font>(record.font, AssetType::Font))
+						component.font = font;
+					else
+						component.font = Font::GetDefaultFont();
+					component.maxWidth = record.maxWidth;
+					Decode(record.colour, component.colour);
+				});
+			break;
+		case ChunkId::BehaviourTrees:
+			LoadComponents<BehaviourTreeComponent, FilepathRecord>(reader, chunk,
+				[&reader](BehaviourTreeComponent& component, const FilepathRecord& record)
+				{
+					component.filepath = reader.GetPath(record.filepath);
+					if (!component.filepath.empty())
+						component.behaviourTree = BehaviourTree::Serializer::Deserialize(component.filepath);
+				});
+			break;
+		case ChunkId::StateMachines:
+			LoadComponents<StateMachineComponent, EntityOnlyRecord>(reader, chunk,
+				[](StateMachineComponent&, const EntityOnlyRecord&) {});
+			break;
+		case ChunkId::LuaScripts:
+			LoadComponents<LuaScriptComponent, FilepathRecord>(reader, chunk,
+				[&reader](LuaScriptComponent& component, const FilepathRecord& record)
+				{
+					component.absoluteFilepath = reader.GetPath(record.filepath);
+				});
+			break;
+		case ChunkId::PointLights:
+			LoadComponents<PointLightComponent, PointLightRecord>(reader, chunk,
+				[](PointLightComponent& component, const PointLightRecord& record)
+				{
+					Decode(record.colour, component.colour);
+					component.castsShadows = record.castsShadows != 0;
+					component.range = record.range;
+					component.attenuation = record.attenuation;
+				});
+			break;
+		case ChunkId::Billboards:
+			LoadComponents<BillboardComponent, BillboardRecord>(reader, chunk,
+				[](BillboardComponent& component, const BillboardRecord& record)
+				{
+					component.orientation = (BillboardComponent::Orientation)record.orientation;
+					component.position = (BillboardComponent::Position)record.position;
+					Decode(record.screenPosition, component.screenPosition);
+				});
+			break;
+		case ChunkId::Canvases:
+			LoadComponents<CanvasComponent, CanvasRecord>(reader, chunk,
+				[](CanvasComponent& component, const CanvasRecord& record)
+				{
+					component.pixelPerUnit = record.pixelPerUnit;
+				});
+			break;
+		case ChunkId::EntityPools:
+			LoadComponents<EntityPoolComponent, EntityPoolRecord>(reader, chunk,
+				[](EntityPoolComponent& component, const EntityPoolRecord& record)
+				{
+					component.prewarmCount = record.prewarmCount;
+				});
+			break;
+		default:
+			ENGINE_WARN("Skipping unknown scene chunk {0:x}", chunk.id);
+			break;
+		}
+	}
+
+	return true;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+bool BinarySceneSerializer::IsBinaryScene(const std::filesystem::path& filepath)
+{
+	std::ifstream file(filepath, std::ios::binary);
+	uint32_t magic = 0;
+	return file.read((char*)&magic, sizeof(uint32_t)) && magic == s_Magic;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+bool BinarySceneSerializer::ConvertFromXml(const std::filesystem::path& xmlFilepath, const std::filesystem::path& binaryFilepath)
+{
+	PROFILE_FUNCTION();
+
+	Scene scene(xmlFilepath);
+
+	SceneSerializer sceneSerializer(&scene);
+	if (!sceneSerializer.Deserialize(xmlFilepath))
+		return false;
+
+	BinarySceneSerializer binarySceneSerializer(&scene);
+	if (!binarySceneSerializer.Serialize(binaryFilepath))
+	{
+		ENGINE_ERROR("Could not write binary scene {0}", binaryFilepath);
+		return false;
+	}
+	return true;
+}
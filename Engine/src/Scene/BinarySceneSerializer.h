@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Scene.h"
+
+// Reads and writes scenes in a chunked binary format. Each component type is stored as a table of fixed size records
+// so a scene is loaded by memory mapping the file and constructing each component pool in one go
+class BinarySceneSerializer
+{
+public:
+	explicit BinarySceneSerializer(Scene* scene);
+
+	~BinarySceneSerializer() = default;
+
+	bool Serialize(const std::filesystem::path& filepath) const;
+	bool Deserialize(const std::filesystem::path& filepath);
+
+	// Does the file start with the binary scene header
+	static bool IsBinaryScene(const std::filesystem::path& filepath);
+
+	// Load an xml scene and save it again in the binary format
+	static bool ConvertFromXml(const std::filesystem::path& xmlFilepath, const std::filesystem::path& binaryFilepath);
+
+private:
+	Scene* m_Scene;
+};
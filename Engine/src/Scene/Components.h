@@ -15,6 +15,7 @@
 #include "Components/PolygonCollider2DComponent.h"
 #include "Components/CapsuleCollider2DComponent.h"
 #include "Components/CircleRendererComponent.h"
+#include "Components/ParticleSystemComponent.h"
 #include "Components/HierarchyComponent.h"
 #include "Components/LuaScriptComponent.h"
 #include "Components/BehaviourTreeComponent.h"
@@ -23,6 +24,7 @@
 #include "Components/CanvasComponent.h"
 #include "Components/TextComponent.h"
 #include "Components/PointLightComponent.h"
+#include "Components/EntityPoolComponent.h"
 
 #include "Components/UIWidgets/WidgetComponent.h"
 #include "Components/UIWidgets/ButtonComponent.h"
@@ -52,6 +54,8 @@ BillboardComponent,			\
 CanvasComponent,			\
 TextComponent,				\
 PointLightComponent,		\
+EntityPoolComponent,		\
 WidgetComponent,			\
-ButtonComponent				\
+ButtonComponent,			\
+ParticleSystemComponent		\
 
@@ -13,6 +13,15 @@ struct BehaviourTreeComponent
 
 	std::filesystem::path filepath;
 
+	// A copy with a tree of its own copied from this one, the tree keeps the blackboard and the running nodes
+	BehaviourTreeComponent Clone() const
+	{
+		BehaviourTreeComponent copy(*this);
+		if (behaviourTree)
+			copy.behaviourTree = behaviourTree->cloneTree();
+		return copy;
+	}
+
 private:
 	friend cereal::access;
 	template<typename Archive>
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "cereal/cereal.hpp"
+
+// Marks an entity as the prefab of an entity pool, the pool is created and pre-warmed when the runtime starts
+struct EntityPoolComponent
+{
+	EntityPoolComponent() = default;
+	EntityPoolComponent(const EntityPoolComponent&) = default;
+	EntityPoolComponent(uint32_t prewarmCount)
+		:prewarmCount(prewarmCount) {}
+
+	uint32_t prewarmCount = 0;
+
+private:
+	friend cereal::access;
+	template<typename Archive>
+	void serialize(Archive& archive)
+	{
+		archive(prewarmCount);
+	}
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "cereal/cereal.hpp"
+#include "cereal/access.hpp"
+
+#include "ParticleSystem/ParticleSystem.h"
+
+struct ParticleSystemComponent
+{
+	ParticleProps properties;
+	float emissionRate = 50.0f; // particles per second
+	uint32_t maxParticles = 1000;
+	bool emitting = true;
+
+	// Created at runtime, copies of the component get their own particles
+	Ref<ParticleSystem> particleSystem;
+	float emissionAccumulator = 0.0f;
+
+	ParticleSystemComponent() = default;
+	ParticleSystemComponent(const ParticleSystemComponent& other)
+		:properties(other.properties), emissionRate(other.emissionRate), maxParticles(other.maxParticles), emitting(other.emitting) {}
+	ParticleSystemComponent(ParticleSystemComponent&&) = default;
+
+	ParticleSystemComponent& operator=(const ParticleSystemComponent& other)
+	{
+		properties = other.properties;
+		emissionRate = other.emissionRate;
+		maxParticles = other.maxParticles;
+		emitting = other.emitting;
+		return *this;
+	}
+	ParticleSystemComponent& operator=(ParticleSystemComponent&&) = default;
+
+private:
+	friend cereal::access;
+	template<typename Archive>
+	void serialize(Archive& archive)
+	{
+		archive(properties.velocity, properties.velocityVariation, properties.beginColour, properties.endColour,
+			properties.sizeBegin, properties.sizeEnd, properties.sizeVariation, properties.rotationSpeed, properties.lifeTime,
+			emissionRate, maxParticles, emitting);
+	}
+};
@@ -2,6 +2,7 @@
 
 #include "cereal/cereal.hpp"
 #include "Renderer/Font.h"
+#include "Renderer/TextLayout.h"
 
 struct TextComponent
 {
@@ -13,7 +14,17 @@ struct TextComponent
 	float maxWidth = 10.0f;
 	Colour colour{ Colours::WHITE };
 
+	// The glyph quads of the text, laid out again only when the text, font or max width change
+	const TextLayout& GetLayout()
+	{
+		if (!m_Layout || !m_Layout->Matches(text, font, maxWidth))
+			m_Layout = TextLayout::Get(text, font, maxWidth);
+		return *m_Layout;
+	}
+
 private:
+	Ref<TextLayout> m_Layout;
+
 	friend cereal::access;
 	template<typename Archive>
 	void save(Archive& archive) const
@@ -1,6 +1,18 @@
 #include "stdafx.h"
 #include "TilemapComponent.h"
 
+bool TilemapComponent::HasCollision(uint32_t x, uint32_t y) const
+{
+	if (!tileset || y >= tiles.size() || x >= tiles[y].size())
+		return false;
+
+	uint32_t index = tiles[y][x];
+	if (index == 0 || index > tileset->GetNumberOfTiles())
+		return false;
+
+	return tileset->GetTile(index - 1).GetCollisionShape() != Tile::CollisionShape::None;
+}
+
 Vector2f TilemapComponent::IsoToWorld(uint32_t x, uint32_t y) const
 {
 	return Vector2f((float)((int)x - (int)y) / 2.0f, -(float)(x + y) / 4.0f);
@@ -20,6 +32,7 @@ void TilemapComponent::Rebuild()
 
 	std::vector<Vertex> verticesList;
 	std::vector<uint32_t> indicesList;
+	std::vector<Submesh> submeshes;
 
 	Vector2f positions[4] = {
 					{ 0.0f, 1.0f },
@@ -30,112 +43,120 @@ void TilemapComponent::Rebuild()
 
 	size_t maxTileIndex = tileset->GetNumberOfTiles();
 
-	if (orientation == Orientation::orthogonal)
+	// Add the four vertices of the tile in column j of row i, empty tiles are skipped
+	auto addTile = [&](uint32_t i, uint32_t j)
 	{
-		// 0,0________ X
-		//   |_|_|_|_|
-		//   |_|_|_|_|
-		//   |_|_|_|_|
-		//   |_|_|_|_|
-		//  Y
-
-		for (size_t i = 0; i < tilesHigh; i++)
-		{
-			for (size_t j = 0; j < tilesWide; j++)
-			{
-				if (tiles[i][j] == 0)
-					continue;
+		if (tiles[i][j] == 0)
+			return false;
 
-				if (tiles[i][j] > maxTileIndex) {
-					tiles[i][j] = 0;
-					continue;
-				}
+		if (tiles[i][j] > maxTileIndex) {
+			tiles[i][j] = 0;
+			return false;
+		}
 
-				tileset->SetCurrentTile(tiles[i][j] - 1);
-				const Vector2f* texCoords = tileset->GetSubTexture()->GetTextureCoordinates();
+		tileset->SetCurrentTile(tiles[i][j] - 1);
+		const Vector2f* texCoords = tileset->GetSubTexture()->GetTextureCoordinates();
 
-				for (size_t v = 0; v < 4; v++)
-				{
-					Vertex vertex;
-					vertex.position = Vector3f((float)(j)+positions[v].x, -(float)(i)-positions[v].y, 0.0f);
-					vertex.normal.z = 1.0f;
-					vertex.tangent.x = 1.0f;
-					vertex.texcoord = Vector2f(texCoords[v].x, texCoords[v].y);
-					verticesList.push_back(vertex);
-				}
+		if (orientation == Orientation::orthogonal)
+		{
+			// 0,0________ X
+			//   |_|_|_|_|
+			//   |_|_|_|_|
+			//   |_|_|_|_|
+			//   |_|_|_|_|
+			//  Y
+
+			for (size_t v = 0; v < 4; v++)
+			{
+				Vertex vertex;
+				vertex.position = Vector3f((float)(j)+positions[v].x, -(float)(i)-positions[v].y, 0.0f);
+				vertex.normal.z = 1.0f;
+				vertex.tangent.x = 1.0f;
+				vertex.texcoord = Vector2f(texCoords[v].x, texCoords[v].y);
+				verticesList.push_back(vertex);
 			}
 		}
-	}
-	else if (orientation == Orientation::isometric)
-	{
-		//   0,0
-		//    /\
-		//   /\/\
-		// Y/\/\/\ X
-		//  \/\/\/
-		//   \/\/
-		//    \/
-
-		for (uint32_t i = 0; i < tilesHigh; i++)
+		else if (orientation == Orientation::isometric)
 		{
-			for (uint32_t j = 0; j < tilesWide; j++)
+			//   0,0
+			//    /\
+			//   /\/\
+			// Y/\/\/\ X
+			//  \/\/\/
+			//   \/\/
+			//    \/
+
+			for (uint32_t v = 0; v < 4; v++)
 			{
-				if (tiles[i][j] == 0)
-					continue;
-
-				if (tiles[i][j] > maxTileIndex) {
-					tiles[i][j] = 0;
-					continue;
-				}
+				Vertex vertex;
+				Vector2f isoCoords = IsoToWorld(j, i);
 
-				tileset->SetCurrentTile(tiles[i][j] - 1);
-				const Vector2f* texCoords = tileset->GetSubTexture()->GetTextureCoordinates();
+				vertex.position.x = isoCoords.x + positions[3 - v].x - 0.5f;
+				vertex.position.y = isoCoords.y + positions[3 - v].y - 0.5f;
+				vertex.position.z = (i + j) * 0.0001f;
 
-				for (uint32_t v = 0; v < 4; v++)
-				{
-					Vertex vertex;
-					Vector2f isoCoords = IsoToWorld(j, i);
-
-					vertex.position.x = isoCoords.x + positions[3 - v].x - 0.5f;
-					vertex.position.y = isoCoords.y + positions[3 - v].y - 0.5f;
-					vertex.position.z = (i + j) * 0.0001f;
-
-					vertex.normal.z = 1.0f;
-					vertex.tangent.x = 1.0f;
+				vertex.normal.z = 1.0f;
+				vertex.tangent.x = 1.0f;
 
-					vertex.texcoord = Vector2f(texCoords[v].x, texCoords[v].y);
+				vertex.texcoord = Vector2f(texCoords[v].x, texCoords[v].y);
 
-					verticesList.push_back(vertex);
-				}
+				verticesList.push_back(vertex);
 			}
 		}
-	}
+		else
+		{
+			return false;
+		}
 
-	if (verticesList.size() == 0)
-		return;
+		uint32_t index = (uint32_t)verticesList.size() - 4;
+		indicesList.push_back(index);
+		indicesList.push_back(index + 1);
+		indicesList.push_back(index + 2);
 
-	uint32_t index = 0;
+		indicesList.push_back(index);
+		indicesList.push_back(index + 2);
+		indicesList.push_back(index + 3);
+		return true;
+	};
 
-	for (size_t i = 0; i < tilesHigh; i++)
+	// Each chunk of tiles is a submesh with its own bounds so the renderer can cull the parts of the map off screen
+	for (uint32_t chunkRow = 0; chunkRow < tilesHigh; chunkRow += s_ChunkSize)
 	{
-		for (size_t j = 0; j < tilesWide; j++)
+		for (uint32_t chunkColumn = 0; chunkColumn < tilesWide; chunkColumn += s_ChunkSize)
 		{
-			indicesList.push_back(index);
-			indicesList.push_back(index + 1);
-			indicesList.push_back(index + 2);
+			Submesh submesh;
+			submesh.firstIndex = (uint32_t)indicesList.size();
+			submesh.vertexOffset = 0;
+			submesh.materialIndex = 0;
+			submesh.localTransform = Matrix4x4();
+			submesh.transform = Matrix4x4();
+
+			const uint32_t firstVertex = (uint32_t)verticesList.size();
+			for (uint32_t i = chunkRow; i < std::min(chunkRow + s_ChunkSize, tilesHigh); i++)
+			{
+				for (uint32_t j = chunkColumn; j < std::min(chunkColumn + s_ChunkSize, tilesWide); j++)
+				{
+					addTile(i, j);
+				}
+			}
 
-			indicesList.push_back(index);
-			indicesList.push_back(index + 2);
-			indicesList.push_back(index + 3);
+			submesh.indexCount = (uint32_t)indicesList.size() - submesh.firstIndex;
+			submesh.vertexCount = (uint32_t)verticesList.size() - firstVertex;
+			if (submesh.indexCount == 0)
+				continue;
 
-			index += 4;
+			submesh.boundingBox.EnclosePoints((float*)&verticesList[firstVertex], submesh.vertexCount, sizeof(Vertex) / sizeof(float));
+			submeshes.push_back(submesh);
 		}
 	}
 
+	if (verticesList.size() == 0)
+		return;
+
 	Ref<Material> material = CreateRef<Material>("Standard", tint);
 	material->AddTexture(tileset->GetSubTexture()->GetTexture(), 0);
 	material->SetTwoSided(true);
 	material->SetTransparency(true);
 
-	mesh = CreateRef<Mesh>(verticesList, indicesList, material);
+	mesh = CreateRef<Mesh>(verticesList, indicesList, submeshes, std::vector<Ref<Material>>{ material });
 }
\ No newline at end of file
@@ -34,6 +34,7 @@ struct TilemapComponent
 
 	bool isTrigger = false;
 
+	// Built by Rebuild with one submesh for each chunk of tiles
 	Ref<Mesh> mesh;
 
 	b2Body* runtimeBody = nullptr;
@@ -50,8 +51,14 @@ struct TilemapComponent
 		}
 	}
 
+	// Tiles along each side of a chunk of the mesh
+	static constexpr uint32_t s_ChunkSize = 16;
+
 	void Rebuild();
 
+	// Does the tile in column x of row y have a collision shape
+	bool HasCollision(uint32_t x, uint32_t y) const;
+
 	Vector2f IsoToWorld(uint32_t x, uint32_t y) const;
 	Vector2f WorldToIso(Vector2f v) const;
 
@@ -38,18 +38,50 @@ struct TransformComponent
 		return Matrix4x4::Translate(position) * Matrix4x4::Rotate(Quaternion(rotation)) * Matrix4x4::Scale(scale);
 	}
 
-	void SetWorldMatrix(Matrix4x4 parentMatrix)
+	void SetWorldMatrix(const Matrix4x4& parentMatrix)
 	{ 
 		m_ParentMatrix = parentMatrix;
 		m_WorldMatrix = parentMatrix * GetLocalMatrix();
+
+		m_CachedPosition = position;
+		m_CachedRotation = rotation;
+		m_CachedScale = scale;
+		m_Dirty = false;
+		m_Version++;
 	}
 
+	// Incremented every time the world matrix is recalculated
+	uint32_t GetVersion() const { return m_Version; }
+
 	const Matrix4x4& GetParentMatrix() const { return m_ParentMatrix; }
 
+	// Has the local transform changed since the world matrix was last calculated
+	bool IsDirty() const
+	{
+		return m_Dirty
+			|| !Equals(position, m_CachedPosition)
+			|| !Equals(rotation, m_CachedRotation)
+			|| !Equals(scale, m_CachedScale);
+	}
+
+	// Force the world matrix to be recalculated on the next scene graph traversal
+	void MakeDirty() { m_Dirty = true; }
+
 private:
+	static bool Equals(const Vector3f& a, const Vector3f& b)
+	{
+		return a.x == b.x && a.y == b.y && a.z == b.z;
+	}
+
 	Matrix4x4 m_WorldMatrix;
 	Matrix4x4 m_ParentMatrix;
 
+	Vector3f m_CachedPosition;
+	Vector3f m_CachedRotation;
+	Vector3f m_CachedScale;
+	bool m_Dirty = true;
+	uint32_t m_Version = 0;
+
 	friend cereal::access;
 	template<typename Archive>
 	void serialize(Archive& archive)
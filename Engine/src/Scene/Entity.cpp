@@ -38,7 +38,7 @@ std::string& Entity::GetName()
 
 void Entity::SetName(const std::string_view name)
 {
-	GetComponent<NameComponent>().name = name;
+	m_Scene->m_Registry.patch<NameComponent>(m_EntityHandle, [name](NameComponent& nameComp) { nameComp.name = name; });
 }
 
 Uuid Entity::GetID()
@@ -0,0 +1,129 @@
+#include "stdafx.h"
+#include "EntityPool.h"
+
+#include "Entity.h"
+#include "Components.h"
+
+EntityPool::EntityPool(Scene* scene, Entity prefab)
+	:m_Scene(scene), m_Prefab(prefab), m_PrefabEntity(prefab.GetHandle())
+{
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void EntityPool::Prewarm(size_t count)
+{
+	PROFILE_FUNCTION();
+
+	const size_t entityCount = m_Prefab.GetEntityCount();
+
+	std::vector<entt::entity> entities;
+	m_Scene->InstantiatePrefab(m_Prefab, std::vector<Vector3f>(count, Vector3f()), entities);
+
+	m_Parked.reserve(m_Parked.size() + count);
+	for (size_t i = 0; i < entities.size(); i += entityCount)
+	{
+		std::vector<entt::entity>& instance = m_Parked.emplace_back(entities.begin() + i, entities.begin() + i + entityCount);
+		Park(instance);
+	}
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+Entity EntityPool::Spawn(const Vector3f& position)
+{
+	PROFILE_FUNCTION();
+
+	entt::registry& registry = m_Scene->GetRegistry();
+
+	// Instances removed from the scene while parked are dropped
+	while (!m_Parked.empty())
+	{
+		std::vector<entt::entity> instance = std::move(m_Parked.back());
+		m_Parked.pop_back();
+
+		if (!registry.valid(instance.front()))
+			continue;
+
+		Activate(instance, position);
+		entt::entity root = instance.front();
+		m_Active[root] = std::move(instance);
+		return Entity(root, m_Scene);
+	}
+
+	std::vector<entt::entity> instance;
+	m_Scene->InstantiatePrefab(m_Prefab, { position }, instance);
+	entt::entity root = instance.front();
+	m_Active[root] = std::move(instance);
+	return Entity(root, m_Scene);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+bool EntityPool::Despawn(Entity root)
+{
+	PROFILE_FUNCTION();
+
+	auto it = m_Active.find(root.GetHandle());
+	if (it == m_Active.end())
+		return false;
+
+	std::vector<entt::entity> instance = std::move(it->second);
+	m_Active.erase(it);
+
+	if (!m_Scene->GetRegistry().valid(instance.front()))
+		return false;
+
+	Park(instance);
+	m_Parked.push_back(std::move(instance));
+	return true;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void EntityPool::Park(const std::vector<entt::entity>& instance)
+{
+	entt::registry& registry = m_Scene->GetRegistry();
+
+	for (entt::entity handle : instance)
+	{
+		if (!registry.valid(handle))
+			continue;
+
+		// The environment is kept, OnCreate is called again when the instance is next spawned
+		if (LuaScriptComponent* scriptComponent = registry.try_get<LuaScriptComponent>(handle))
+		{
+			if (scriptComponent->created)
+			{
+				scriptComponent->OnDestroy();
+				scriptComponent->created = false;
+			}
+		}
+
+		if (m_Scene->m_PhysicsEngine2D)
+			m_Scene->m_PhysicsEngine2D->SetEntityEnabled(Entity(handle, m_Scene), false);
+
+		if (!registry.all_of<PooledMarker>(handle))
+			registry.emplace<PooledMarker>(handle);
+	}
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void EntityPool::Activate(const std::vector<entt::entity>& instance, const Vector3f& position)
+{
+	entt::registry& registry = m_Scene->GetRegistry();
+
+	m_Prefab.ResetTransforms(registry, instance.data(), position);
+
+	for (entt::entity handle : instance)
+	{
+		if (!registry.valid(handle))
+			continue;
+
+		registry.remove<PooledMarker>(handle);
+
+		if (m_Scene->m_PhysicsEngine2D && registry.all_of<TransformComponent>(handle))
+			m_Scene->m_PhysicsEngine2D->SetEntityEnabled(Entity(handle, m_Scene), true);
+	}
+}
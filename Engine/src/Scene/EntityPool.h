@@ -0,0 +1,48 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+
+#include "EnTT/entt.hpp"
+#include "math/Vector3f.h"
+#include "Prefab.h"
+
+class Scene;
+class Entity;
+
+// Tags the entities of instances parked in a pool, they are left out of rendering, scripts and physics
+struct PooledMarker {};
+
+// Recycles the instances of a prefab. Despawned instances are parked with their physics bodies disabled and their
+// lua environments kept, spawning takes a parked instance before creating a new one
+class EntityPool
+{
+public:
+	EntityPool(Scene* scene, Entity prefab);
+
+	// Create instances up front so the first spawns don't create entities or physics bodies
+	void Prewarm(size_t count);
+
+	// Returns the root of the instance, moved to the position
+	Entity Spawn(const Vector3f& position);
+
+	// Park an instance spawned from this pool, returns false if the entity is not the root of one
+	bool Despawn(Entity root);
+
+	size_t GetParkedCount() const { return m_Parked.size(); }
+	size_t GetActiveCount() const { return m_Active.size(); }
+
+	// The entity the prefab was compiled from
+	entt::entity GetPrefabEntity() const { return m_PrefabEntity; }
+
+private:
+	void Park(const std::vector<entt::entity>& instance);
+	void Activate(const std::vector<entt::entity>& instance, const Vector3f& position);
+
+	Scene* m_Scene;
+	Prefab m_Prefab;
+	entt::entity m_PrefabEntity;
+
+	std::vector<std::vector<entt::entity>> m_Parked;
+	std::unordered_map<entt::entity, std::vector<entt::entity>> m_Active;
+};
@@ -0,0 +1,304 @@
+#include "stdafx.h"
+#include "Prefab.h"
+
+#include "Entity.h"
+#include "Components.h"
+#include "SceneGraph.h"
+
+// Copy a component for the prefab, leaving out anything created at runtime for the original entity
+template<typename Component>
+static Component PrefabCopy(const Component& component)
+{
+	return component;
+}
+
+static TransformComponent PrefabCopy(const TransformComponent& component)
+{
+	return TransformComponent(component.position, component.rotation, component.scale);
+}
+
+static LuaScriptComponent PrefabCopy(const LuaScriptComponent& component)
+{
+	return LuaScriptComponent(component.absoluteFilepath);
+}
+
+template<typename Component>
+static Component PrefabCopyWithoutBody(const Component& component)
+{
+	Component copy(component);
+	copy.runtimeBody = nullptr;
+	return copy;
+}
+
+static RigidBody2DComponent PrefabCopy(const RigidBody2DComponent& component) { return PrefabCopyWithoutBody(component); }
+static BoxCollider2DComponent PrefabCopy(const BoxCollider2DComponent& component) { return PrefabCopyWithoutBody(component); }
+static CircleCollider2DComponent PrefabCopy(const CircleCollider2DComponent& component) { return PrefabCopyWithoutBody(component); }
+static PolygonCollider2DComponent PrefabCopy(const PolygonCollider2DComponent& component) { return PrefabCopyWithoutBody(component); }
+static CapsuleCollider2DComponent PrefabCopy(const CapsuleCollider2DComponent& component) { return PrefabCopyWithoutBody(component); }
+static TilemapComponent PrefabCopy(const TilemapComponent& component) { return PrefabCopyWithoutBody(component); }
+
+static BehaviourTreeComponent PrefabCopy(const BehaviourTreeComponent& component)
+{
+	return component.Clone();
+}
+
+// Components holding state that can't be shared between instances, each instance gets its own copy of the prefab's
+template<typename Component>
+static constexpr bool HasInstanceCopy = std::is_same_v<Component, BehaviourTreeComponent>;
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// EnTT reserves exactly the size needed for a range insert, so spawning a few instances at a time would copy the
+// whole pool every time. Growing the pool geometrically first keeps the inserts cheap
+template<typename Component, typename It, typename... Args>
+static void InsertComponents(entt::registry& registry, It first, It last, Args&&... args)
+{
+	auto& storage = registry.storage<Component>();
+
+	// The entity array and the component pages have their own capacity
+	const size_t capacity = std::min(storage.capacity(), storage.entt::sparse_set::capacity());
+	const size_t required = storage.size() + (size_t)std::distance(first, last);
+	if (required > capacity)
+	{
+		constexpr size_t pageSize = entt::component_traits<Component>::page_size;
+		const size_t grown = std::max(required, capacity * 2);
+		storage.reserve((grown + pageSize - 1) / pageSize * pageSize);
+	}
+
+	registry.insert<Component>(first, last, std::forward<Args>(args)...);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+struct Prefab::ComponentTable
+{
+	virtual ~ComponentTable() = default;
+
+	// Add the components to every instance, entities holds the instances one after another
+	virtual void Instantiate(entt::registry& registry, const entt::entity* entities, size_t nodeCount, size_t instanceCount) const = 0;
+};
+
+template<typename Component>
+struct Prefab::ComponentTableOf : Prefab::ComponentTable
+{
+	std::vector<uint32_t> nodes;
+	std::vector<Component> components;
+
+	void Instantiate(entt::registry& registry, const entt::entity* entities, size_t nodeCount, size_t instanceCount) const override
+	{
+		std::vector<entt::entity> handles(instanceCount);
+		for (size_t i = 0; i < nodes.size(); i++)
+		{
+			for (size_t instance = 0; instance < instanceCount; instance++)
+			{
+				handles[instance] = entities[instance * nodeCount + nodes[i]];
+			}
+
+			if constexpr (HasInstanceCopy<Component>)
+			{
+				std::vector<Component> copies;
+				copies.reserve(instanceCount);
+				for (size_t instance = 0; instance < instanceCount; instance++)
+				{
+					copies.push_back(PrefabCopy(components[i]));
+				}
+				InsertComponents<Component>(registry, handles.begin(), handles.end(), copies.begin());
+			}
+			else
+			{
+				InsertComponents<Component>(registry, handles.begin(), handles.end(), components[i]);
+			}
+		}
+	}
+};
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+Prefab::Prefab(Entity entity)
+{
+	PROFILE_FUNCTION();
+
+	entt::registry& registry = entity.GetScene()->GetRegistry();
+
+	std::vector<entt::entity> entities;
+	std::vector<Entity> stack = { entity };
+	while (!stack.empty())
+	{
+		Entity current = stack.back();
+		stack.pop_back();
+		entities.push_back(current.GetHandle());
+
+		std::vector<Entity> children = SceneGraph::GetChildren(current);
+		stack.insert(stack.end(), children.rbegin(), children.rend());
+	}
+
+	std::unordered_map<entt::entity, uint32_t> nodeIndices;
+	for (uint32_t i = 0; i < (uint32_t)entities.size(); i++)
+	{
+		nodeIndices[entities[i]] = i;
+	}
+
+	// Links to entities outside of the prefab, like the root's siblings, are dropped
+	auto nodeIndex = [&nodeIndices](entt::entity entity)
+	{
+		auto it = nodeIndices.find(entity);
+		return it != nodeIndices.end() ? it->second : s_NoNode;
+	};
+
+	m_Nodes.resize(entities.size());
+	for (size_t i = 0; i < entities.size(); i++)
+	{
+		Node& node = m_Nodes[i];
+		if (const NameComponent* nameComp = registry.try_get<NameComponent>(entities[i]))
+			node.name = nameComp->name;
+
+		if (const HierarchyComponent* hierarchyComp = registry.try_get<HierarchyComponent>(entities[i]))
+		{
+			node.hasHierarchy = true;
+			node.isActive = hierarchyComp->isActive;
+			node.parent = nodeIndex(hierarchyComp->parent);
+			node.firstChild = nodeIndex(hierarchyComp->firstChild);
+			node.previousSibling = nodeIndex(hierarchyComp->previousSibling);
+			node.nextSibling = nodeIndex(hierarchyComp->nextSibling);
+		}
+	}
+
+	m_Nodes[0].parent = s_NoNode;
+	m_Nodes[0].previousSibling = s_NoNode;
+	m_Nodes[0].nextSibling = s_NoNode;
+
+	CompileComponents<COMPONENTS>(registry, entities);
+	m_SourceEntities = std::move(entities);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+Prefab::~Prefab() = default;
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+template<typename Component>
+void Prefab::CompileComponent(entt::registry& registry, const std::vector<entt::entity>& entities)
+{
+	// Every instance gets a new id, the names and hierarchy are set from the nodes. Instances of a pooled prefab
+	// are not prefabs of pools themselves
+	if constexpr (!std::is_same_v<Component, IDComponent>
+		&& !std::is_same_v<Component, NameComponent>
+		&& !std::is_same_v<Component, HierarchyComponent>
+		&& !std::is_same_v<Component, EntityPoolComponent>)
+	{
+		Scope<ComponentTableOf<Component>> table = CreateScope<ComponentTableOf<Component>>();
+		for (uint32_t i = 0; i < (uint32_t)entities.size(); i++)
+		{
+			if (const Component* component = registry.try_get<Component>(entities[i]))
+			{
+				table->nodes.push_back(i);
+				table->components.push_back(PrefabCopy(*component));
+			}
+		}
+
+		if (table->nodes.empty())
+			return;
+
+		if constexpr (std::is_same_v<Component, TransformComponent>)
+			m_TransformTable = table.get();
+		m_Tables.push_back(std::move(table));
+	}
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+template<typename... Component>
+void Prefab::CompileComponents(entt::registry& registry, const std::vector<entt::entity>& entities)
+{
+	(CompileComponent<Component>(registry, entities), ...);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void Prefab::Instantiate(entt::registry& registry, const std::vector<Vector3f>& positions, std::vector<entt::entity>& entities) const
+{
+	PROFILE_FUNCTION();
+
+	const size_t nodeCount = m_Nodes.size();
+	const size_t instanceCount = positions.size();
+	if (instanceCount == 0)
+		return;
+
+	const size_t first = entities.size();
+	entities.resize(first + nodeCount * instanceCount);
+	registry.create(entities.begin() + first, entities.end());
+	const entt::entity* instances = entities.data() + first;
+
+	auto link = [instances, nodeCount](size_t instance, uint32_t node)
+	{
+		return node != s_NoNode ? instances[instance * nodeCount + node] : entt::null;
+	};
+
+	std::vector<IDComponent> ids(nodeCount * instanceCount);
+	std::vector<NameComponent> names;
+	std::vector<entt::entity> hierarchyEntities;
+	std::vector<HierarchyComponent> hierarchies;
+	names.reserve(nodeCount * instanceCount);
+
+	for (size_t instance = 0; instance < instanceCount; instance++)
+	{
+		for (uint32_t i = 0; i < (uint32_t)nodeCount; i++)
+		{
+			const Node& node = m_Nodes[i];
+			names.emplace_back(node.name.empty() ? "Unnamed Entity" : node.name);
+
+			if (!node.hasHierarchy)
+				continue;
+
+			HierarchyComponent& hierarchyComp = hierarchies.emplace_back();
+			hierarchyComp.parent = link(instance, node.parent);
+			hierarchyComp.firstChild = link(instance, node.firstChild);
+			hierarchyComp.previousSibling = link(instance, node.previousSibling);
+			hierarchyComp.nextSibling = link(instance, node.nextSibling);
+			hierarchyComp.isActive = node.isActive;
+			hierarchyEntities.push_back(instances[instance * nodeCount + i]);
+		}
+	}
+
+	InsertComponents<IDComponent>(registry, entities.begin() + first, entities.end(), ids.begin());
+	InsertComponents<NameComponent>(registry, entities.begin() + first, entities.end(), std::make_move_iterator(names.begin()));
+	InsertComponents<HierarchyComponent>(registry, hierarchyEntities.begin(), hierarchyEntities.end(), hierarchies.begin());
+
+	for (const Scope<ComponentTable>& table : m_Tables)
+	{
+		table->Instantiate(registry, instances, nodeCount, instanceCount);
+	}
+
+	for (size_t instance = 0; instance < instanceCount; instance++)
+	{
+		if (TransformComponent* transformComp = registry.try_get<TransformComponent>(instances[instance * nodeCount]))
+			transformComp->position += positions[instance];
+	}
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void Prefab::ResetTransforms(entt::registry& registry, const entt::entity* instance, const Vector3f& position) const
+{
+	if (m_TransformTable == nullptr)
+		return;
+
+	for (size_t i = 0; i < m_TransformTable->nodes.size(); i++)
+	{
+		const uint32_t node = m_TransformTable->nodes[i];
+		if (!registry.valid(instance[node]))
+			continue;
+
+		if (TransformComponent* transformComp = registry.try_get<TransformComponent>(instance[node]))
+		{
+			const TransformComponent& prefabTransform = m_TransformTable->components[i];
+			transformComp->position = prefabTransform.position;
+			transformComp->rotation = prefabTransform.rotation;
+			transformComp->scale = prefabTransform.scale;
+			if (node == 0)
+				transformComp->position += position;
+			transformComp->MakeDirty();
+		}
+	}
+}
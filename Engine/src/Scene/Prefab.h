@@ -0,0 +1,65 @@
+#pragma once
+
+#include <vector>
+#include <string>
+
+#include "Core/core.h"
+#include "EnTT/entt.hpp"
+#include "math/Vector3f.h"
+
+class Entity;
+struct TransformComponent;
+
+// An entity and its children compiled into a table of component copies per component type. Instances are copied
+// straight into the registry's component pools instead of being written out and parsed by the scene serializer
+class Prefab
+{
+public:
+	explicit Prefab(Entity entity);
+	~Prefab();
+
+	// Create an instance for each position, the position is added to the position of the root. The new entities
+	// are added to entities one instance after another, each starting with its root
+	void Instantiate(entt::registry& registry, const std::vector<Vector3f>& positions, std::vector<entt::entity>& entities) const;
+
+	// Move the entities of an instance back to where the prefab puts them, instance starts with the root
+	void ResetTransforms(entt::registry& registry, const entt::entity* instance, const Vector3f& position) const;
+
+	// Number of entities in one instance
+	size_t GetEntityCount() const { return m_Nodes.size(); }
+
+	// The entities the prefab was compiled from, the root first
+	const std::vector<entt::entity>& GetSourceEntities() const { return m_SourceEntities; }
+
+private:
+	static constexpr uint32_t s_NoNode = UINT32_MAX;
+
+	// An entity of the prefab, the hierarchy links are indices of other nodes
+	struct Node
+	{
+		std::string name;
+		bool hasHierarchy = false;
+		bool isActive = true;
+		uint32_t parent = s_NoNode;
+		uint32_t firstChild = s_NoNode;
+		uint32_t previousSibling = s_NoNode;
+		uint32_t nextSibling = s_NoNode;
+	};
+
+	struct ComponentTable;
+
+	template<typename Component>
+	struct ComponentTableOf;
+
+	template<typename Component>
+	void CompileComponent(entt::registry& registry, const std::vector<entt::entity>& entities);
+
+	template<typename... Component>
+	void CompileComponents(entt::registry& registry, const std::vector<entt::entity>& entities);
+
+	// Parents come before their children so the root is always the first node
+	std::vector<Node> m_Nodes;
+	std::vector<entt::entity> m_SourceEntities;
+	std::vector<Scope<ComponentTable>> m_Tables;
+	ComponentTableOf<TransformComponent>* m_TransformTable = nullptr;
+};
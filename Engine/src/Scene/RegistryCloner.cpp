@@ -0,0 +1,90 @@
+#include "stdafx.h"
+#include "RegistryCloner.h"
+
+#include "Components.h"
+
+static BehaviourTreeComponent SnapshotCopy(const BehaviourTreeComponent& component)
+{
+	return component.Clone();
+}
+
+static LuaScriptComponent SnapshotCopy(const LuaScriptComponent& component)
+{
+	return LuaScriptComponent(component.absoluteFilepath);
+}
+
+template<typename Component>
+static constexpr bool HasSnapshotCopy = std::is_same_v<Component, BehaviourTreeComponent>
+	|| std::is_same_v<Component, LuaScriptComponent>;
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Components are added in the order of the source pool so both pools share the same layout. Derived data like
+// meshes is shared with the original, a rebuild replaces it rather than changing it in place so the copy keeps the
+// data that matches its own inputs and nothing has to be rebuilt on restore
+template<typename Component>
+static void ClonePool(const entt::registry& source, entt::registry& destination)
+{
+	const auto& sourceStorage = source.storage<Component>();
+	const size_t count = sourceStorage.size();
+	if (count == 0)
+		return;
+
+	constexpr size_t pageSize = entt::component_traits<Component>::page_size;
+
+	auto& destinationStorage = destination.storage<Component>();
+	destinationStorage.reserve(count);
+
+	const entt::entity* entities = sourceStorage.data();
+	const auto sourcePages = sourceStorage.raw();
+
+	if constexpr (std::is_trivially_copyable_v<Component> && std::is_default_constructible_v<Component>)
+	{
+		destination.insert<Component>(entities, entities + count);
+
+		auto destinationPages = destinationStorage.raw();
+		for (size_t first = 0; first < count; first += pageSize)
+		{
+			const size_t pageCount = std::min(pageSize, count - first);
+			std::memcpy(destinationPages[first / pageSize], sourcePages[first / pageSize], pageCount * sizeof(Component));
+		}
+	}
+	else if constexpr (HasSnapshotCopy<Component>)
+	{
+		std::vector<Component> components;
+		components.reserve(count);
+		for (size_t i = 0; i < count; i++)
+		{
+			components.push_back(SnapshotCopy(sourcePages[i / pageSize][i % pageSize]));
+		}
+		destination.insert<Component>(entities, entities + count, components.begin());
+	}
+	else
+	{
+		for (size_t first = 0; first < count; first += pageSize)
+		{
+			const size_t pageCount = std::min(pageSize, count - first);
+			destination.insert<Component>(entities + first, entities + first + pageCount, sourcePages[first / pageSize]);
+		}
+	}
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+template<typename... Component>
+static void ClonePools(const entt::registry& source, entt::registry& destination)
+{
+	(ClonePool<Component>(source, destination), ...);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void RegistryCloner::Clone(const entt::registry& source, entt::registry& destination)
+{
+	PROFILE_FUNCTION();
+
+	destination = entt::registry();
+	destination.assign(source.data(), source.data() + source.size(), source.released());
+
+	ClonePools<COMPONENTS>(source, destination);
+}
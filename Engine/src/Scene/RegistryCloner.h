@@ -0,0 +1,13 @@
+#pragma once
+
+#include "EnTT/entt.hpp"
+
+// Copies the component pools of a scene registry straight into another registry. Used to snapshot the scene before
+// play mode, restoring it is then a swap of the two registries instead of deserializing every component
+class RegistryCloner
+{
+public:
+	// Replace destination with a copy of source. Entity identifiers, including the released ones, are kept so handles
+	// held by the editor stay valid
+	static void Clone(const entt::registry& source, entt::registry& destination);
+};
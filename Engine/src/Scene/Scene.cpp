@@ -12,20 +12,145 @@
 #include "Utilities/GeometryGenerator.h"
 #include "Utilities/Box2DDebugDraw.h"
 
-#include "cereal/archives/binary.hpp"
-#include "cereal/types/string.hpp"
-
 #include "Events/SceneEvent.h"
 #include "TinyXml2/tinyxml2.h"
 
 #include "SceneSerializer.h"
+#include "BinarySceneSerializer.h"
+#include "RegistryCloner.h"
+#include "Prefab.h"
+#include "EntityPool.h"
 #include "SceneGraph.h"
+#include "SpatialGrid.h"
 #include "Scripting/Lua/LuaManager.h"
 #include "Physics/HitResult2D.h"
 #include "Physics/Contact2D.h"
+#include "AI/PathRequestQueue.h"
+#include "AI/HierarchicalPathfinder.h"
+#include "Core/ThreadPool.h"
+#include "Core/Statistics.h"
 
 struct DestroyMarker {};
 
+// Spatial index of the 2D renderables stored in the registry context
+struct SpriteCulling
+{
+	SpatialGrid grid;
+	std::vector<entt::entity> candidates;
+	std::vector<uint32_t> visibleFrame; // last frame each entity index was found to be visible
+	uint32_t frame = 0;
+};
+
+static void OnSpriteTransformChanged(entt::registry& registry, entt::entity entity)
+{
+	if (SpriteCulling* culling = registry.try_ctx<SpriteCulling>())
+		culling->grid.Remove(entity);
+}
+
+// Find the sprites, animated sprites, circles, text and tilemaps that intersect the frustum
+// Only quads whose world matrix has changed since the last frame are moved in the grid. Text and tilemaps can change
+// shape without their transform changing, so the few of them there are get reinserted every frame
+static SpriteCulling& CullSprites(entt::registry& registry, const Frustum& frustum)
+{
+	PROFILE_FUNCTION();
+
+	SpriteCulling* culling = registry.try_ctx<SpriteCulling>();
+	if (culling == nullptr)
+	{
+		culling = &registry.set<SpriteCulling>();
+		registry.on_destroy<TransformComponent>().connect<&OnSpriteTransformChanged>();
+		registry.on_update<TransformComponent>().connect<&OnSpriteTransformChanged>();
+	}
+
+	static const BoundingBox s_UnitQuad(Vector3f(-0.5f, -0.5f, 0.0f), Vector3f(0.5f, 0.5f, 0.0f));
+
+	auto updateGrid = [culling](entt::entity entity, const TransformComponent& transformComp)
+	{
+		if (!culling->grid.IsCurrent(entity, transformComp.GetVersion()))
+			culling->grid.Update(entity, s_UnitQuad.Transform(transformComp.GetWorldMatrix()), transformComp.GetVersion());
+	};
+
+	registry.view<TransformComponent, SpriteComponent>(entt::exclude<PooledMarker>).each([&](auto entity, auto& transformComp, auto&) { updateGrid(entity, transformComp); });
+	registry.view<TransformComponent, AnimatedSpriteComponent>(entt::exclude<PooledMarker>).each([&](auto entity, auto& transformComp, auto&) { updateGrid(entity, transformComp); });
+	registry.view<TransformComponent, CircleRendererComponent>(entt::exclude<PooledMarker>).each([&](auto entity, auto& transformComp, auto&) { updateGrid(entity, transformComp); });
+
+	registry.view<TransformComponent, TextComponent>(entt::exclude<PooledMarker>).each([&](auto entity, auto& transformComp, auto& textComp)
+		{
+			culling->grid.Update(entity, textComp.GetLayout().GetBounds().Transform(transformComp.GetWorldMatrix()), transformComp.GetVersion());
+		});
+	registry.view<TransformComponent, TilemapComponent>(entt::exclude<PooledMarker>).each([&](auto entity, auto& transformComp, auto& tilemapComp)
+		{
+			if (tilemapComp.mesh)
+				culling->grid.Update(entity, tilemapComp.mesh->GetBounds().Transform(transformComp.GetWorldMatrix()), transformComp.GetVersion());
+		});
+
+	culling->frame++;
+	culling->candidates.clear();
+	culling->grid.Query(frustum.GetBounds(), culling->candidates);
+
+	for (entt::entity entity : culling->candidates)
+	{
+		if (!frustum.Intersects(culling->grid.GetBounds(entity)))
+			continue;
+
+		size_t index = (size_t)entt::to_entity(entity);
+		if (index >= culling->visibleFrame.size())
+			culling->visibleFrame.resize(index + 1, 0);
+		culling->visibleFrame[index] = culling->frame;
+	}
+	return *culling;
+}
+
+static bool IsVisible(const SpriteCulling& culling, entt::entity entity)
+{
+	size_t index = (size_t)entt::to_entity(entity);
+	return index < culling.visibleFrame.size() && culling.visibleFrame[index] == culling.frame;
+}
+
+// Visible entities are only split across the worker threads once there are enough to cover the overhead
+static constexpr size_t s_MinParallelSubmit = 4096;
+
+// Per chunk vertex recording for the sprites and circles, kept in the registry context to reuse the allocations
+struct SpriteSubmission
+{
+	std::vector<entt::entity> entities;
+	std::vector<Renderer2D::SubmissionContext> contexts;
+};
+
+// Record the entities into one submission context per chunk, on the worker threads for large scenes,
+// then submit the contexts in order so the batches are the same as drawing the entities one at a time
+template<typename Function>
+static void SubmitEntities(SpriteSubmission& submission, Function record)
+{
+	PROFILE_FUNCTION();
+
+	const std::vector<entt::entity>& entities = submission.entities;
+	if (entities.empty())
+		return;
+
+	size_t chunkCount = entities.size() >= s_MinParallelSubmit ? (size_t)ThreadPool::GetThreadCount() * 4 : 1;
+	if (submission.contexts.size() < chunkCount)
+		submission.contexts.resize(chunkCount);
+
+	ThreadPool::ParallelFor(chunkCount, 1, [&](size_t begin, size_t end)
+		{
+			for (size_t chunk = begin; chunk < end; chunk++)
+			{
+				size_t first = chunk * entities.size() / chunkCount;
+				size_t last = (chunk + 1) * entities.size() / chunkCount;
+				for (size_t i = first; i < last; i++)
+				{
+					record(submission.contexts[chunk], entities[i]);
+				}
+			}
+		});
+
+	for (size_t chunk = 0; chunk < chunkCount; chunk++)
+	{
+		Renderer2D::Submit(submission.contexts[chunk]);
+	}
+}
+
 template<typename Component>
 static void CopyComponentIfExists(entt::entity dst, entt::entity src, entt::registry& registry)
 {
@@ -42,6 +167,75 @@ static void CopyEntity(entt::entity dst, entt::entity src, entt::registry& regis
 	(CopyComponentIfExists<Component>(dst, src, registry), ...);
 }
 
+// Prefabs compiled by InstantiateEntity, kept in the registry context of the scene the prefab entities belong to.
+// A prefab is dropped when one of its entities gets, loses or has a component replaced or patched
+struct PrefabCache
+{
+	std::unordered_map<entt::entity, Ref<Prefab>> prefabs; // by root entity
+	std::unordered_multimap<entt::entity, entt::entity> roots; // the roots of the prefabs each entity is part of
+};
+
+static void OnPrefabSourceChanged(entt::registry& registry, entt::entity entity)
+{
+	PrefabCache& cache = registry.ctx<PrefabCache>();
+	auto [first, last] = cache.roots.equal_range(entity);
+	if (first == last)
+		return;
+
+	std::vector<entt::entity> roots;
+	for (auto it = first; it != last; ++it)
+	{
+		roots.push_back(it->second);
+	}
+
+	for (entt::entity root : roots)
+	{
+		auto prefab = cache.prefabs.find(root);
+		if (prefab == cache.prefabs.end())
+			continue;
+
+		for (entt::entity source : prefab->second->GetSourceEntities())
+		{
+			auto [begin, end] = cache.roots.equal_range(source);
+			for (auto it = begin; it != end;)
+				it = it->second == root ? cache.roots.erase(it) : std::next(it);
+		}
+		cache.prefabs.erase(prefab);
+	}
+}
+
+template<typename... Component>
+static void ConnectPrefabCache(entt::registry& registry)
+{
+	((registry.on_construct<Component>().template connect<&OnPrefabSourceChanged>(),
+		registry.on_update<Component>().template connect<&OnPrefabSourceChanged>(),
+		registry.on_destroy<Component>().template connect<&OnPrefabSourceChanged>()), ...);
+}
+
+// The compiled prefab of the entity, compiled the first time it is instantiated
+static Ref<Prefab> GetCompiledPrefab(Entity entity)
+{
+	entt::registry& registry = entity.GetScene()->GetRegistry();
+	PrefabCache* cache = registry.try_ctx<PrefabCache>();
+	if (cache == nullptr)
+	{
+		cache = &registry.set<PrefabCache>();
+		ConnectPrefabCache<COMPONENTS>(registry);
+	}
+
+	auto it = cache->prefabs.find(entity.GetHandle());
+	if (it != cache->prefabs.end())
+		return it->second;
+
+	Ref<Prefab> prefab = CreateRef<Prefab>(entity);
+	for (entt::entity source : prefab->GetSourceEntities())
+	{
+		cache->roots.emplace(source, entity.GetHandle());
+	}
+	cache->prefabs.emplace(entity.GetHandle(), prefab);
+	return prefab;
+}
+
 Scene::Scene(const std::filesystem::path& filepath)
 	:m_Filepath(filepath)
 {
@@ -51,6 +245,8 @@ Scene::Scene(const std::filesystem::path& filepath)
 
 Scene::~Scene()
 {
+	// Queued requests point at this scene's pathfinder
+	Astar::PathRequestQueue::Clear();
 	LuaManager::CleanUp();
 }
 
@@ -89,32 +285,87 @@ void Scene::InstantiateScene(const Ref<Scene> prefab, const Vector3f& position)
 
 Entity Scene::InstantiateEntity(const Entity prefab, const Vector3f& position)
 {
-	tinyxml2::XMLDocument doc;
-	tinyxml2::XMLElement* pEntityElement = doc.NewElement("Entity");
-	doc.InsertFirstChild(pEntityElement);
-	SceneSerializer::SerializeEntity(pEntityElement, prefab);
-	tinyxml2::XMLPrinter printer;
-	doc.Accept(&printer);
+	PROFILE_FUNCTION();
+
+	// Held while instantiating in case the instance changes the prefab and drops it from the cache
+	Ref<Prefab> compiled = GetCompiledPrefab(prefab);
+	return InstantiatePrefab(*compiled, { position }).front();
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+std::vector<Entity> Scene::InstantiatePrefab(const Prefab& prefab, const std::vector<Vector3f>& positions)
+{
+	PROFILE_FUNCTION();
+
+	std::vector<entt::entity> entities;
+	InstantiatePrefab(prefab, positions, entities);
 
-	Entity newEntity = SceneSerializer::DeserializeEntity(this, pEntityElement, true);
+	std::vector<Entity> roots;
+	roots.reserve(positions.size());
+	for (size_t i = 0; i < entities.size(); i += prefab.GetEntityCount())
+	{
+		roots.emplace_back(entities[i], this);
+	}
+	return roots;
+}
 
-	if(TransformComponent* transformComp = newEntity.TryGetComponent<TransformComponent>(); transformComp)
-		transformComp->position += position;
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void Scene::InstantiatePrefab(const Prefab& prefab, const std::vector<Vector3f>& positions, std::vector<entt::entity>& entities)
+{
+	PROFILE_FUNCTION();
 
-	if(m_PhysicsEngine2D)
-		m_PhysicsEngine2D->InitializeEntity(newEntity);
+	const size_t first = entities.size();
+	entities.reserve(first + prefab.GetEntityCount() * positions.size());
+	prefab.Instantiate(m_Registry, positions, entities);
+	m_Dirty = true;
 
-	if (LuaScriptComponent* scriptComponent = newEntity.TryGetComponent<LuaScriptComponent>())
+	for (size_t i = first; i < entities.size(); i++)
 	{
-		std::optional<std::pair<int, std::string>> result = scriptComponent->ParseScript(newEntity);
-		if (result.has_value())
+		Entity entity(entities[i], this);
+
+		if (m_PhysicsEngine2D && m_Registry.all_of<TransformComponent>(entities[i]))
+			m_PhysicsEngine2D->InitializeEntity(entity);
+
+		if (LuaScriptComponent* scriptComponent = entity.TryGetComponent<LuaScriptComponent>())
 		{
-			ENGINE_ERROR("Failed to parse lua script {0}({1}): {2}", scriptComponent->absoluteFilepath, result.value().first, result.value().second);
+			std::optional<std::pair<int, std::string>> result = scriptComponent->ParseScript(entity);
+			if (result.has_value())
+			{
+				ENGINE_ERROR("Failed to parse lua script {0}({1}): {2}", scriptComponent->absoluteFilepath, result.value().first, result.value().second);
+			}
 		}
 	}
-	return Entity();
 }
 
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+Ref<EntityPool> Scene::CreateEntityPool(Entity prefab, size_t prewarmCount)
+{
+	PROFILE_FUNCTION();
+
+	Ref<EntityPool> pool = CreateRef<EntityPool>(this, prefab);
+	if (prewarmCount > 0)
+		pool->Prewarm(prewarmCount);
+	m_EntityPools.push_back(pool);
+	return pool;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+Ref<EntityPool> Scene::GetEntityPool(Entity prefab) const
+{
+	for (const Ref<EntityPool>& pool : m_EntityPools)
+	{
+		if (pool->GetPrefabEntity() == prefab.GetHandle())
+			return pool;
+	}
+	return nullptr;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
 bool Scene::RemoveEntity(Entity& entity)
 {
 	if (entity.BelongsToScene(this))
@@ -167,6 +418,45 @@ Entity Scene::DuplicateEntity(Entity entity, Entity parent)
 
 /* ------------------------------------------------------------------------------------------------------------------ */
 
+// Tilemap rows run down from the entity while grid rows run up from the origin, so the rows are flipped
+static Scope<Astar::HierarchicalPathfinder> BuildPathfinder(entt::registry& registry)
+{
+	PROFILE_FUNCTION();
+
+	auto view = registry.view<TransformComponent, TilemapComponent>(entt::exclude<PooledMarker>);
+	for (auto entity : view)
+	{
+		auto [transformComp, tilemapComp] = view.get(entity);
+		if (tilemapComp.orientation != TilemapComponent::Orientation::orthogonal || !tilemapComp.tileset
+			|| !tilemapComp.tileset->HasCollision() || tilemapComp.tilesWide == 0 || tilemapComp.tilesHigh == 0)
+			continue;
+
+		int width = (int)tilemapComp.tilesWide;
+		int height = (int)tilemapComp.tilesHigh;
+
+		Scope<bool[]> cells(new bool[(size_t)width * height]);
+		std::vector<bool*> columns(width);
+		for (int x = 0; x < width; x++)
+		{
+			columns[x] = cells.get() + (size_t)x * height;
+			for (int y = 0; y < height; y++)
+				columns[x][y] = tilemapComp.HasCollision((uint32_t)x, (uint32_t)(height - 1 - y));
+		}
+
+		float tileWidth = transformComp.scale.x;
+		float tileHeight = transformComp.scale.y;
+		Vector3f position = transformComp.GetWorldPosition();
+		Astar::AstarGrid grid(width, height, tileWidth, tileHeight, Vector2f(position.x, position.y - height * tileHeight), columns.data());
+
+		Scope<Astar::HierarchicalPathfinder> pathfinder = CreateScope<Astar::HierarchicalPathfinder>();
+		pathfinder->Build(grid);
+		return pathfinder;
+	}
+	return nullptr;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
 void Scene::OnRuntimeStart()
 {
 	PROFILE_FUNCTION();
@@ -175,9 +465,8 @@ void Scene::OnRuntimeStart()
 	if (m_Dirty)
 		Save();
 
-	std::stringstream().swap(m_Snapshot);
-	cereal::BinaryOutputArchive output(m_Snapshot);
-	entt::snapshot(m_Registry).entities(output).component<COMPONENTS>(output);
+	RegistryCloner::Clone(m_Registry, m_Snapshot);
+	m_HasSnapshot = true;
 
 	m_Registry.view<LuaScriptComponent>().each(
 		[this](const auto entity, auto& scriptComponent)
@@ -198,6 +487,16 @@ void Scene::OnRuntimeStart()
 
 	if (m_DrawDebug)
 		m_PhysicsEngine2D->ShowDebugDraw(m_DrawDebug);
+
+	// Pools set up in the editor. Pre-warming creates entities so the prefabs are gathered first
+	auto poolView = m_Registry.view<EntityPoolComponent>();
+	std::vector<entt::entity> prefabs(poolView.begin(), poolView.end());
+	for (entt::entity prefab : prefabs)
+	{
+		CreateEntityPool(Entity(prefab, this), m_Registry.get<EntityPoolComponent>(prefab).prewarmCount);
+	}
+
+	m_Pathfinder = BuildPathfinder(m_Registry);
 }
 
 /* ------------------------------------------------------------------------------------------------------------------ */
@@ -212,18 +511,21 @@ void Scene::OnRuntimeStop()
 {
 	PROFILE_FUNCTION();
 
+	m_EntityPools.clear();
 	m_PhysicsEngine2D.reset();
 
+	Astar::PathRequestQueue::Clear();
+	m_Pathfinder.reset();
+
 	LuaManager::CleanUp();
 
-	if (m_Snapshot.rdbuf()->in_avail() != 0)
+	if (m_HasSnapshot)
 	{
 		ENGINE_DEBUG("Runtime End");
-		m_Registry = entt::registry();
-		cereal::BinaryInputArchive input(m_Snapshot);
-		entt::snapshot_loader(m_Registry).entities(input).component<COMPONENTS>(input);
+		std::swap(m_Registry, m_Snapshot);
+		m_HasSnapshot = false;
 	}
-	std::stringstream().swap(m_Snapshot);
+	m_Snapshot = entt::registry();
 	m_Dirty = false;
 	AssetManager::CleanUp();
 }
@@ -234,7 +536,7 @@ void Scene::Render(Ref<FrameBuffer> renderTarget, const Matrix4x4& cameraTransfo
 {
 	PROFILE_FUNCTION();
 
-	auto billboardView = m_Registry.view<TransformComponent, BillboardComponent>();
+	auto billboardView = m_Registry.view<TransformComponent, BillboardComponent>(entt::exclude<PooledMarker>);
 	for (auto entity : billboardView)
 	{
 		auto&& [transformComp, billboardComp] = billboardView.get(entity);
@@ -267,16 +569,43 @@ void Scene::Render(Ref<FrameBuffer> renderTarget, const Matrix4x4& cameraTransfo
 
 	Renderer::BeginScene(cameraTransform, projection);
 
-	auto spriteGroup = m_Registry.view<TransformComponent, SpriteComponent>();
+	const SpriteCulling& culling = CullSprites(m_Registry, Renderer::GetFrustum());
+	uint32_t visibleSprites = 0;
+	uint32_t culledSprites = 0;
+
+	SpriteSubmission* submission = m_Registry.try_ctx<SpriteSubmission>();
+	if (submission == nullptr)
+		submission = &m_Registry.set<SpriteSubmission>();
+
+	auto spriteGroup = m_Registry.view<TransformComponent, SpriteComponent>(entt::exclude<PooledMarker>);
+	submission->entities.clear();
 	for (auto entity : spriteGroup)
 	{
-		auto&& [transformComp, spriteComp] = spriteGroup.get(entity);
-		Renderer2D::DrawSprite(transformComp.GetWorldMatrix(), spriteComp, (int)entity);
+		if (!IsVisible(culling, entity))
+		{
+			culledSprites++;
+			continue;
+		}
+		visibleSprites++;
+		submission->entities.push_back(entity);
 	}
 
-	auto animatedSpriteGroup = m_Registry.view<TransformComponent, AnimatedSpriteComponent>();
+	SubmitEntities(*submission, [&spriteGroup](Renderer2D::SubmissionContext& context, entt::entity entity)
+		{
+			auto&& [transformComp, spriteComp] = spriteGroup.get(entity);
+			context.DrawSprite(transformComp.GetWorldMatrix(), spriteComp, (int)entity);
+		});
+
+	auto animatedSpriteGroup = m_Registry.view<TransformComponent, AnimatedSpriteComponent>(entt::exclude<PooledMarker>);
 	for (auto entity : animatedSpriteGroup)
 	{
+		if (!IsVisible(culling, entity))
+		{
+			culledSprites++;
+			continue;
+		}
+		visibleSprites++;
+
 		auto&& [transformComp, spriteComp] = animatedSpriteGroup.get(entity);
 		if (spriteComp.spriteSheet && spriteComp.spriteSheet->GetSubTexture()) {
 			spriteComp.spriteSheet->GetSubTexture()->SetCurrentCell(spriteComp.currentFrame);
@@ -284,21 +613,48 @@ void Scene::Render(Ref<FrameBuffer> renderTarget, const Matrix4x4& cameraTransfo
 		}
 	}
 
-	auto circleGroup = m_Registry.view<TransformComponent, CircleRendererComponent>();
+	auto circleGroup = m_Registry.view<TransformComponent, CircleRendererComponent>(entt::exclude<PooledMarker>);
+	submission->entities.clear();
 	for (auto entity : circleGroup)
 	{
-		auto&& [transformComp, circleComp] = circleGroup.get(entity);
-		Renderer2D::DrawCircle(transformComp.GetWorldMatrix(), circleComp, (int)entity);
+		if (!IsVisible(culling, entity))
+		{
+			culledSprites++;
+			continue;
+		}
+		visibleSprites++;
+		submission->entities.push_back(entity);
+	}
+
+	SubmitEntities(*submission, [&circleGroup](Renderer2D::SubmissionContext& context, entt::entity entity)
+		{
+			auto&& [transformComp, circleComp] = circleGroup.get(entity);
+			context.DrawCircle(transformComp.GetWorldMatrix(), circleComp, (int)entity);
+		});
+
+	auto particleGroup = m_Registry.view<TransformComponent, ParticleSystemComponent>(entt::exclude<PooledMarker>);
+	for (auto entity : particleGroup)
+	{
+		auto&& [transformComp, particleComp] = particleGroup.get(entity);
+		if (particleComp.particleSystem)
+			Renderer2D::DrawParticles(*particleComp.particleSystem, transformComp.GetWorldPosition().z, (int)entity);
 	}
 
-	auto textGroup = m_Registry.view<TransformComponent, TextComponent>();
+	auto textGroup = m_Registry.view<TransformComponent, TextComponent>(entt::exclude<PooledMarker>);
 	for (auto entity : textGroup)
 	{
+		if (!IsVisible(culling, entity))
+		{
+			culledSprites++;
+			continue;
+		}
+		visibleSprites++;
+
 		auto&& [transformComp, textComp] = textGroup.get(entity);
-		Renderer2D::DrawString(textComp.text, textComp.font, textComp.maxWidth, transformComp.GetWorldMatrix(), textComp.colour, (int)entity);
+		Renderer2D::DrawString(textComp.GetLayout(), transformComp.GetWorldMatrix(), textComp.colour, (int)entity);
 	}
 
-	auto staticMeshGroup = m_Registry.view<TransformComponent, StaticMeshComponent>();
+	auto staticMeshGroup = m_Registry.view<TransformComponent, StaticMeshComponent>(entt::exclude<PooledMarker>);
 	for (auto entity : staticMeshGroup)
 	{
 		auto&& [transformComp, staticMeshComp] = staticMeshGroup.get(entity);
@@ -318,22 +674,29 @@ void Scene::Render(Ref<FrameBuffer> renderTarget, const Matrix4x4& cameraTransfo
 		}
 	}
 
-	auto primitiveGroup = m_Registry.view<TransformComponent, PrimitiveComponent>();
+	auto primitiveGroup = m_Registry.view<TransformComponent, PrimitiveComponent>(entt::exclude<PooledMarker>);
 	for (auto entity : primitiveGroup)
 	{
 		auto&& [transformComp, primitiveComp] = primitiveGroup.get(entity);
 		Renderer::Submit(primitiveComp.mesh, primitiveComp.material, transformComp.GetWorldMatrix(), (int)entity);
 	}
 
-	auto tilemapGroup = m_Registry.view<TransformComponent, TilemapComponent>();
+	auto tilemapGroup = m_Registry.view<TransformComponent, TilemapComponent>(entt::exclude<PooledMarker>);
 	for (auto entity : tilemapGroup)
 	{
 		auto&& [transformComp, tilemapComp] = tilemapGroup.get(entity);
 		if (tilemapComp.tileset && tilemapComp.mesh)
 		{
+			// The chunks of a visible tilemap are culled one by one by the renderer
+			if (!IsVisible(culling, entity))
+			{
+				culledSprites++;
+				continue;
+			}
 			Renderer::Submit(tilemapComp.mesh, transformComp.GetWorldMatrix(), (int)entity);
 		}
 	}
+	Renderer2D::AddCullingStats(visibleSprites, culledSprites);
 
 	if (m_PhysicsEngine2D)
 		m_PhysicsEngine2D->OnRender();
@@ -349,7 +712,7 @@ void Scene::Render(Ref<FrameBuffer> renderTarget, const Matrix4x4& cameraTransfo
 	float halfHeight = renderTarget->GetSpecification().height / 2.0f;
 	Renderer::BeginScene(Matrix4x4::Translate(Vector3f(halfWidth, -halfHeight, 0.0f)), Matrix4x4::OrthographicRH(-halfWidth, halfWidth, -halfHeight, halfHeight, -1, 1.0f));
 
-	auto buttonGroup = m_Registry.view<WidgetComponent, ButtonComponent>();
+	auto buttonGroup = m_Registry.view<WidgetComponent, ButtonComponent>(entt::exclude<PooledMarker>);
 	for (auto entity : buttonGroup)
 	{
 		auto&& [widgetComp, buttonComp] = buttonGroup.get(entity);
@@ -391,31 +754,59 @@ void Scene::OnUpdate(float deltaTime)
 	PROFILE_FUNCTION();
 
 	m_IsUpdating = true;
-	m_Registry.view<AnimatedSpriteComponent>(entt::exclude<DestroyMarker>).each([deltaTime](auto entity, auto& animatedSpriteComp)
+	m_Registry.view<AnimatedSpriteComponent>(entt::exclude<DestroyMarker, PooledMarker>).each([deltaTime](auto entity, auto& animatedSpriteComp)
 		{
 			if (animatedSpriteComp.spriteSheet)
 				animatedSpriteComp.Animate(deltaTime);
 		});
 
-	m_Registry.view<LuaScriptComponent>(entt::exclude<DestroyMarker>).each([deltaTime](auto entity, auto& luaScriptComp)
+	{
+		StatisticsTimer luaTimer(Statistics::LuaTime);
+		m_Registry.view<LuaScriptComponent>(entt::exclude<DestroyMarker, PooledMarker>).each([deltaTime](auto entity, auto& luaScriptComp)
+			{
+				if (!luaScriptComp.created)
+				{
+					luaScriptComp.OnCreate();
+					luaScriptComp.created = true;
+				}
+				luaScriptComp.OnUpdate(deltaTime);
+			});
+	}
+
+	m_Registry.view<PrimitiveComponent>(entt::exclude<DestroyMarker, PooledMarker>).each([](auto entity, auto& primitiveComponent)
 		{
-			if (!luaScriptComp.created)
+			if (primitiveComponent.needsUpdating)
 			{
-				luaScriptComp.OnCreate();
-				luaScriptComp.created = true;
+				primitiveComponent.SetType(primitiveComponent.type);
 			}
-			luaScriptComp.OnUpdate(deltaTime);
 		});
 
-	m_Registry.view<PrimitiveComponent>(entt::exclude<DestroyMarker>).each([](auto entity, auto& primitiveComponent)
+	m_Registry.view<TransformComponent, ParticleSystemComponent>(entt::exclude<DestroyMarker, PooledMarker>).each([deltaTime](auto entity, auto& transformComp, auto& particleComp)
 		{
-			if (primitiveComponent.needsUpdating)
+			if (!particleComp.particleSystem)
+				particleComp.particleSystem = CreateRef<ParticleSystem>(particleComp.maxParticles);
+			else
+				particleComp.particleSystem->SetMaxParticles(particleComp.maxParticles);
+
+			if (particleComp.emitting)
 			{
-				primitiveComponent.SetType(primitiveComponent.type);
+				particleComp.emissionAccumulator += particleComp.emissionRate * deltaTime;
+				uint32_t emitCount = (uint32_t)particleComp.emissionAccumulator;
+				particleComp.emissionAccumulator -= (float)emitCount;
+
+				// Particles are simulated in world space so they trail behind a moving emitter
+				Vector3f position = transformComp.GetWorldPosition();
+				particleComp.properties.position = Vector2f(position.x, position.y);
+				particleComp.particleSystem->Emit(particleComp.properties, emitCount);
 			}
+
+			particleComp.particleSystem->OnUpdate(deltaTime);
 		});
 
-	m_Registry.view<BehaviourTreeComponent>(entt::exclude<DestroyMarker>).each([deltaTime](auto entity, auto& behaviourTreeComponent)
+	// Solve the path requests from the last frame so the behaviour trees see the results
+	Astar::PathRequestQueue::Update();
+
+	m_Registry.view<BehaviourTreeComponent>(entt::exclude<DestroyMarker, PooledMarker>).each([deltaTime](auto entity, auto& behaviourTreeComponent)
 		{
 			if(behaviourTreeComponent.behaviourTree)
 				behaviourTreeComponent.behaviourTree->update(deltaTime);
@@ -445,72 +836,75 @@ void Scene::OnFixedUpdate()
 	// Physics
 	m_PhysicsEngine2D->OnFixedUpdate();
 
-	m_Registry.view<LuaScriptComponent>(entt::exclude<DestroyMarker>).each([=](auto entity, auto& luaScriptComp)
-		{
-			if (!luaScriptComp.created)
-			{
-				luaScriptComp.OnCreate();
-				luaScriptComp.created = true;
-			}
-			luaScriptComp.OnFixedUpdate();
-			if (luaScriptComp.IsContactListener() && !m_PhysicsEngine2D->GetContactListener()->m_Contacts.empty())
+	{
+		StatisticsTimer luaTimer(Statistics::LuaTime);
+		m_Registry.view<LuaScriptComponent>(entt::exclude<DestroyMarker, PooledMarker>).each([=](auto entity, auto& luaScriptComp)
 			{
-				for (auto fixture : luaScriptComp.GetFixtures())
+				if (!luaScriptComp.created)
+				{
+					luaScriptComp.OnCreate();
+					luaScriptComp.created = true;
+				}
+				luaScriptComp.OnFixedUpdate();
+				if (luaScriptComp.IsContactListener() && !m_PhysicsEngine2D->GetContactListener()->m_Contacts.empty())
 				{
-					for (Contact2D& contact : m_PhysicsEngine2D->GetContactListener()->m_Contacts)
+					for (auto fixture : luaScriptComp.GetFixtures())
 					{
-						if (contact.fixtureA == fixture || contact.fixtureB == fixture)
+						for (Contact2D& contact : m_PhysicsEngine2D->GetContactListener()->m_Contacts)
 						{
-							if (fixture == contact.fixtureB && !contact.triggeredA)
-							{
-								luaScriptComp.OnBeginContact(contact.fixtureA, contact.localNormal, contact.localPoint);
-								contact.triggeredA = true;
-							}
-							else if (fixture == contact.fixtureA && !contact.triggeredB)
+							if (contact.fixtureA == fixture || contact.fixtureB == fixture)
 							{
-								luaScriptComp.OnBeginContact(contact.fixtureB, contact.localNormal, contact.localPoint);
-								contact.triggeredB = true;
-							}
-
-							if (contact.old)
-							{
-								luaScriptComp.OnEndContact(fixture == contact.fixtureA ? contact.fixtureB : contact.fixtureA);
+								if (fixture == contact.fixtureB && !contact.triggeredA)
+								{
+									luaScriptComp.OnBeginContact(contact.fixtureA, contact.localNormal, contact.localPoint);
+									contact.triggeredA = true;
+								}
+								else if (fixture == contact.fixtureA && !contact.triggeredB)
+								{
+									luaScriptComp.OnBeginContact(contact.fixtureB, contact.localNormal, contact.localPoint);
+									contact.triggeredB = true;
+								}
+
+								if (contact.old)
+								{
+									luaScriptComp.OnEndContact(fixture == contact.fixtureA ? contact.fixtureB : contact.fixtureA);
+								}
 							}
 						}
 					}
 				}
-			}
-		});
+			});
+	}
 
 	if (m_PhysicsEngine2D != nullptr)
 	{
 		m_PhysicsEngine2D->RemoveOldContacts();
-		m_Registry.view<TransformComponent, RigidBody2DComponent>().each([=](auto entity, auto& transformComp, auto& rigidBodyComp)
+		m_Registry.view<TransformComponent, RigidBody2DComponent>(entt::exclude<PooledMarker>).each([=](auto entity, auto& transformComp, auto& rigidBodyComp)
 			{
 				rigidBodyComp.runtimeBody->SetTransform(b2Vec2(transformComp.position.x, transformComp.position.y), transformComp.rotation.z);
 			});
 
-		m_Registry.view<TransformComponent, BoxCollider2DComponent>(entt::exclude<RigidBody2DComponent>).each([=](auto entity, auto& transformComp, auto& colliderComp)
+		m_Registry.view<TransformComponent, BoxCollider2DComponent>(entt::exclude<RigidBody2DComponent, PooledMarker>).each([=](auto entity, auto& transformComp, auto& colliderComp)
 			{
 				colliderComp.runtimeBody->SetTransform(b2Vec2(transformComp.position.x, transformComp.position.y), transformComp.rotation.z);
 			});
 
-		m_Registry.view<TransformComponent, CircleCollider2DComponent>(entt::exclude<RigidBody2DComponent>).each([=](auto entity, auto& transformComp, auto& colliderComp)
+		m_Registry.view<TransformComponent, CircleCollider2DComponent>(entt::exclude<RigidBody2DComponent, PooledMarker>).each([=](auto entity, auto& transformComp, auto& colliderComp)
 			{
 				colliderComp.runtimeBody->SetTransform(b2Vec2(transformComp.position.x, transformComp.position.y), transformComp.rotation.z);
 			});
 
-		m_Registry.view<TransformComponent, PolygonCollider2DComponent>(entt::exclude<RigidBody2DComponent>).each([=](auto entity, auto& transformComp, auto& colliderComp)
+		m_Registry.view<TransformComponent, PolygonCollider2DComponent>(entt::exclude<RigidBody2DComponent, PooledMarker>).each([=](auto entity, auto& transformComp, auto& colliderComp)
 			{
 				colliderComp.runtimeBody->SetTransform(b2Vec2(transformComp.position.x, transformComp.position.y), transformComp.rotation.z);
 			});
 
-		m_Registry.view<TransformComponent, CapsuleCollider2DComponent>(entt::exclude<RigidBody2DComponent>).each([=](auto entity, auto& transformComp, auto& colliderComp)
+		m_Registry.view<TransformComponent, CapsuleCollider2DComponent>(entt::exclude<RigidBody2DComponent, PooledMarker>).each([=](auto entity, auto& transformComp, auto& colliderComp)
 			{
 				colliderComp.runtimeBody->SetTransform(b2Vec2(transformComp.position.x, transformComp.position.y), transformComp.rotation.z);
 			});
 
-		m_Registry.view<TransformComponent, TilemapComponent>(entt::exclude<RigidBody2DComponent>).each([=](auto entity, auto& transformComp, auto& colliderComp)
+		m_Registry.view<TransformComponent, TilemapComponent>(entt::exclude<RigidBody2DComponent, PooledMarker>).each([=](auto entity, auto& transformComp, auto& colliderComp)
 			{
 				if(colliderComp.runtimeBody)
 					colliderComp.runtimeBody->SetTransform(b2Vec2(transformComp.position.x, transformComp.position.y), transformComp.rotation.z);
@@ -554,7 +948,7 @@ void Scene::Save(std::filesystem::path filepath, bool binary)
 {
 	PROFILE_FUNCTION();
 
-	if (m_Snapshot.rdbuf()->in_avail() != 0)
+	if (m_HasSnapshot)
 		return;
 
 	m_IsSaving = true;
@@ -584,12 +978,9 @@ void Scene::Save(std::filesystem::path filepath, bool binary)
 
 	if (binary)
 	{
-		std::ofstream file(finalPath, std::ios::binary);
-		{
-			cereal::BinaryOutputArchive output(file);
-			entt::snapshot(m_Registry).entities(output).component<COMPONENTS>(output);
-		}
-		file.close();
+		BinarySceneSerializer binarySceneSerializer = BinarySceneSerializer(this);
+		if (!binarySceneSerializer.Serialize(finalPath))
+			ENGINE_ERROR("Failed to save scene to {0}.", finalPath.string());
 	}
 	else
 	{
@@ -626,13 +1017,12 @@ bool Scene::Load(bool binary)
 		return false;
 	}
 
-	if (binary)
+	// Binary scenes are found from their header so either format can be loaded from the same path
+	if (binary || BinarySceneSerializer::IsBinaryScene(filepath))
 	{
-		m_Registry.clear();
-		std::ifstream file(filepath, std::ios::binary);
-		cereal::BinaryInputArchive input(file);
-		entt::snapshot_loader(m_Registry).entities(input).component<COMPONENTS>(input);
-		file.close();
+		BinarySceneSerializer binarySceneSerializer = BinarySceneSerializer(this);
+		if (!binarySceneSerializer.Deserialize(filepath))
+			ENGINE_ERROR("Failed to load scene. Could not read file {0}", filepath);
 	}
 	else
 	{
@@ -1,7 +1,6 @@
 #pragma once
 
 #include <filesystem>
-#include <sstream>
 
 #include "EnTT/entt.hpp"
 #include "Core/UUID.h"
@@ -9,11 +8,18 @@
 #include "Physics/PhysicsEngine2D.h"
 
 class Entity;
+class Prefab;
+class EntityPool;
 class FrameBuffer;
 class Camera;
 class Matrix4x4;
 struct HitResult2D;
 
+namespace Astar
+{
+	class HierarchicalPathfinder;
+}
+
 class Scene
 {
 public:
@@ -24,8 +30,25 @@ public:
 	Entity CreateEntity(Uuid id, const std::string& name = "");
 
 	void InstantiateScene(const Ref<Scene> prefab, const Vector3f& position);
+
+	// Create an instance of the entity and its children. The entity is compiled into a prefab the first time and
+	// the prefab is reused until one of its entities changes. Components changed in place need to be patched through
+	// the registry for the prefab to see the change
 	Entity InstantiateEntity(const Entity prefab, const Vector3f& position);
 
+	// Create an instance of the prefab at each position, returns the root entity of each instance
+	std::vector<Entity> InstantiatePrefab(const Prefab& prefab, const std::vector<Vector3f>& positions);
+
+	// Create an instance of the prefab at each position, the entities of each instance are added to entities
+	void InstantiatePrefab(const Prefab& prefab, const std::vector<Vector3f>& positions, std::vector<entt::entity>& entities);
+
+	// Create a pool that recycles the instances of the prefab, the pools are removed when the runtime stops
+	Ref<EntityPool> CreateEntityPool(Entity prefab, size_t prewarmCount = 0);
+
+	// The pool created for the prefab, null if there isn't one. Prefabs with an EntityPoolComponent get their pool
+	// when the runtime starts, once the physics engine is running and after the scripts' OnCreate
+	Ref<EntityPool> GetEntityPool(Entity prefab) const;
+
 	bool RemoveEntity(Entity& entity);
 
 	Entity DuplicateEntity(Entity entity, Entity parent);
@@ -80,6 +103,9 @@ public:
 
 	std::vector<HitResult2D> MultiRayCast2D(Vector2f begin, Vector2f end);
 
+	// Built from the first orthogonal tilemap with collisions when the runtime starts, null if there isn't one
+	Astar::HierarchicalPathfinder* GetPathfinder() const { return m_Pathfinder.get(); }
+
 private:
 	entt::registry m_Registry;
 
@@ -94,15 +120,22 @@ private:
 	bool m_IsSaving = false;
 
 	Ref<PhysicsEngine2D> m_PhysicsEngine2D;
+	Scope<Astar::HierarchicalPathfinder> m_Pathfinder;
 
 	Vector2f m_Gravity = { 0.0f, -9.81f };
 
 	uint32_t m_PixelsPerUnit = 16;
 
-	std::stringstream m_Snapshot;
+	// Copy of the registry taken when the runtime starts, swapped back in when it stops
+	entt::registry m_Snapshot;
+	bool m_HasSnapshot = false;
+
+	std::vector<Ref<EntityPool>> m_EntityPools;
 
 	friend class Entity;
 	friend class SceneSerializer;
+	friend class BinarySceneSerializer;
+	friend class EntityPool;
 
 	//Debug info
 	bool m_DrawDebug = false;
@@ -1,29 +1,86 @@
 #include "stdafx.h"
 #include "SceneGraph.h"
 #include "Components.h"
+#include "Core/ThreadPool.h"
+
+#include <atomic>
+
+// Below this many nodes in a level it is quicker to update them on the calling thread
+static constexpr size_t s_MinNodesPerJob = 512;
+
+bool SceneGraph::s_IncrementalUpdate = true;
+bool SceneGraph::s_ParallelUpdate = true;
+SceneGraph::Stats SceneGraph::s_Stats;
+
+/* ------------------------------------------------------------------------------------------------------------------ */
 
 void SceneGraph::Traverse(entt::registry& registry)
 {
 	PROFILE_FUNCTION();
 
-	auto nonHierarchyView = registry.view<TransformComponent>(entt::exclude<HierarchyComponent>);
-
-	for (auto entity : nonHierarchyView)
+	TransformCache* cache = registry.try_ctx<TransformCache>();
+	if (cache == nullptr)
+	{
+		cache = &registry.set<TransformCache>();
+		registry.on_construct<TransformComponent>().connect<&SceneGraph::OnTransformChanged>();
+		registry.on_destroy<TransformComponent>().connect<&SceneGraph::OnTransformChanged>();
+		registry.on_construct<HierarchyComponent>().connect<&SceneGraph::OnHierarchyChanged>();
+		registry.on_destroy<HierarchyComponent>().connect<&SceneGraph::OnHierarchyChanged>();
+		RebuildTransformCache(registry, *cache);
+	}
+	else if (!cache->changed.empty())
 	{
-		registry.get<TransformComponent>(entity).SetWorldMatrix(Matrix4x4());
+		UpdateTransformCache(registry, *cache);
 	}
 
-	registry.view<TransformComponent, HierarchyComponent>(/*entt::exclude<CanvasComponent>*/).each(
-		[&]([[maybe_unused]] const auto entity, auto& transformComp, auto& hierarchyComp)
+	s_Stats.nodeCount = (uint32_t)cache->nodeCount;
+
+	// The components are looked up by entity as each level is updated, so the cache holds no pointers into the pools
+	auto transforms = registry.view<TransformComponent>();
+	auto hierarchies = registry.view<HierarchyComponent>();
+	auto updateNode = [&](const TransformNode& node)
+	{
+		TransformComponent& transformComp = transforms.get<TransformComponent>(node.entity);
+		if (node.parent != entt::null)
+			return UpdateNode(*cache, node, transformComp, &transforms.get<TransformComponent>(node.parent), true);
+
+		bool active = !hierarchies.contains(node.entity) || hierarchies.get<HierarchyComponent>(node.entity).isActive;
+		return UpdateNode(*cache, node, transformComp, nullptr, active);
+	};
+
+	if (!s_ParallelUpdate)
+	{
+		for (const std::vector<TransformNode>& nodes : cache->levels)
 		{
-			// if the entity is active and a root node
-			if (hierarchyComp.isActive && hierarchyComp.parent == entt::null)
+			for (const TransformNode& node : nodes)
 			{
-				UpdateTransform(&transformComp, &hierarchyComp, registry);
+				if (updateNode(node))
+					s_Stats.transformsUpdated++;
 			}
-		});
+		}
+		return;
+	}
+
+	// Every node in a level only depends on nodes in the levels before it
+	std::atomic<uint32_t> transformsUpdated = 0;
+	for (const std::vector<TransformNode>& nodes : cache->levels)
+	{
+		ThreadPool::ParallelFor(nodes.size(), s_MinNodesPerJob, [&](size_t begin, size_t end)
+			{
+				uint32_t updated = 0;
+				for (size_t i = begin; i < end; i++)
+				{
+					if (updateNode(nodes[i]))
+						updated++;
+				}
+				transformsUpdated += updated;
+			});
+	}
+	s_Stats.transformsUpdated += transformsUpdated;
 }
 
+/* ------------------------------------------------------------------------------------------------------------------ */
+
 void SceneGraph::TraverseUI(entt::registry& registry, uint32_t viewportWidth, uint32_t viewportHeight)
 {
 	PROFILE_FUNCTION();
@@ -153,6 +210,11 @@ void SceneGraph::Reparent(Entity entity, Entity parent)
 			currentHierachyComp->nextSibling = entity.GetHandle();
 		hierarchyComp.previousSibling = previousSibling;
 	}
+
+	OnHierarchyChanged(registry, entity.GetHandle());
+
+	// The parent's children have changed
+	registry.patch<HierarchyComponent>(parent.GetHandle());
 }
 
 void SceneGraph::Unparent(Entity entity)
@@ -175,7 +237,9 @@ void SceneGraph::Unparent(Entity entity)
 				&& parentHierachyComp->nextSibling == entt::null
 				&& parentHierachyComp->previousSibling == entt::null)
 			{
+				// Removing from the pool moves another component into the gap, which may be this entity's
 				registry.remove<HierarchyComponent>(hierachyComp->parent);
+				hierachyComp = entity.TryGetComponent<HierarchyComponent>();
 			}
 		}
 
@@ -198,10 +262,17 @@ void SceneGraph::Unparent(Entity entity)
 			previousSiblingHierarchyComp->nextSibling = entt::null;
 		}
 
+		entt::entity parent = hierachyComp->parent;
 		hierachyComp->parent = entt::null;
 		hierachyComp->nextSibling = entt::null;
 		hierachyComp->previousSibling = entt::null;
 
+		OnHierarchyChanged(registry, entity.GetHandle());
+
+		// The parent's children have changed, it loses its hierarchy component if this was the only child
+		if (registry.all_of<HierarchyComponent>(parent))
+			registry.patch<HierarchyComponent>(parent);
+
 		// if there is no children then the HierarchyComponent is not needed
 		if (hierachyComp->firstChild == entt::null)
 			entity.RemoveComponent<HierarchyComponent>();
@@ -220,7 +291,10 @@ void SceneGraph::Remove(Entity entity)
 		{
 			Entity childEntity = { child, entity.GetScene() };
 			Remove(childEntity);
-			child = hierarchyComp->firstChild;
+
+			// Removing the child can move this entity's component in the pool, or remove it with the last child
+			hierarchyComp = entity.TryGetComponent<HierarchyComponent>();
+			child = hierarchyComp != nullptr ? hierarchyComp->firstChild : entt::null;
 		}
 	}
 	Unparent(entity);
@@ -282,41 +356,254 @@ entt::entity SceneGraph::FindEntity(const std::vector<std::string>& path, entt::
 	return entt::null;
 }
 
-void SceneGraph::UpdateTransform(TransformComponent* transformComp, HierarchyComponent* hierarchyComp, entt::registry& registry)
+const SceneGraph::Stats& SceneGraph::GetStats()
 {
-	if (hierarchyComp->parent != entt::null)
-	{
-		TransformComponent* parentTransformComp = registry.try_get<TransformComponent>(hierarchyComp->parent);
-		transformComp->SetWorldMatrix(parentTransformComp->GetWorldMatrix());
-	}
-	else
-	{
-		transformComp->SetWorldMatrix(Matrix4x4());
-	}
+	return s_Stats;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SceneGraph::ResetStats()
+{
+	s_Stats = Stats();
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SceneGraph::RebuildTransformCache(entt::registry& registry, TransformCache& cache)
+{
+	PROFILE_FUNCTION();
+
+	cache.levels.clear();
+	cache.entries.clear();
+	cache.states.clear();
+	cache.changed.clear();
+	cache.nodeCount = 0;
 
-	// Update the first child
-	if (hierarchyComp->firstChild != entt::null)
+	registry.view<TransformComponent>(entt::exclude<HierarchyComponent>).each(
+		[&](const auto entity, [[maybe_unused]] auto& transformComp)
+		{
+			AddNode(cache, entity, entt::null, 0);
+		});
+
+	registry.view<TransformComponent, HierarchyComponent>().each(
+		[&](const auto entity, [[maybe_unused]] auto& transformComp, auto& hierarchyComp)
+		{
+			if (hierarchyComp.parent == entt::null)
+				AddSubtree(registry, cache, entity, entt::null, 0);
+		});
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SceneGraph::UpdateTransformCache(entt::registry& registry, TransformCache& cache)
+{
+	PROFILE_FUNCTION();
+
+	// Take out every changed entity along with the nodes below it, then put back the ones that are still part of
+	// the hierarchy. Children that were taken out are put back with their parent, so each node is added once
+	for (entt::entity entity : cache.changed)
+		RemoveSubtree(cache, entity);
+
+	for (entt::entity entity : cache.changed)
 	{
-		TransformComponent* childTransformComp = registry.try_get<TransformComponent>(hierarchyComp->firstChild);
-		HierarchyComponent* childHierarchyComp = registry.try_get<HierarchyComponent>(hierarchyComp->firstChild);
-		if (childHierarchyComp != nullptr && childTransformComp != nullptr)
+		if (!registry.valid(entity) || FindEntry(cache, entity) != nullptr)
+			continue;
+
+		auto [transformComp, hierarchyComp] = registry.try_get<TransformComponent, HierarchyComponent>(entity);
+		if (transformComp == nullptr)
+			continue;
+
+		if (hierarchyComp == nullptr || hierarchyComp->parent == entt::null)
 		{
-			UpdateTransform(childTransformComp, childHierarchyComp, registry);
+			AddSubtree(registry, cache, entity, entt::null, 0);
+		}
+		else if (const NodeEntry* parentEntry = FindEntry(cache, hierarchyComp->parent))
+		{
+			// A parent that isn't in the cache yet adds this entity when it is added itself
+			AddSubtree(registry, cache, entity, hierarchyComp->parent, parentEntry->level + 1);
 		}
 	}
+	cache.changed.clear();
+
+	while (!cache.levels.empty() && cache.levels.back().empty())
+		cache.levels.pop_back();
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Add the root and the descendants reached through the hierarchy that have transforms
+void SceneGraph::AddSubtree(entt::registry& registry, TransformCache& cache, entt::entity root, entt::entity parent, uint32_t level)
+{
+	AddNode(cache, root, parent, level);
 
-	// Update the next sibling
-	if (hierarchyComp->nextSibling != entt::null)
+	cache.stack.assign(1, root);
+	while (!cache.stack.empty())
 	{
-		TransformComponent* siblingTransformComp = registry.try_get<TransformComponent>(hierarchyComp->nextSibling);
-		HierarchyComponent* siblingHierarchyComp = registry.try_get<HierarchyComponent>(hierarchyComp->nextSibling);
-		if (siblingHierarchyComp != nullptr && siblingTransformComp != nullptr)
+		entt::entity entity = cache.stack.back();
+		cache.stack.pop_back();
+
+		HierarchyComponent* hierarchyComp = registry.try_get<HierarchyComponent>(entity);
+		if (hierarchyComp == nullptr)
+			continue;
+
+		uint32_t childLevel = FindEntry(cache, entity)->level + 1;
+		entt::entity child = hierarchyComp->firstChild;
+		while (child != entt::null && registry.valid(child))
 		{
-			UpdateTransform(siblingTransformComp, siblingHierarchyComp, registry);
+			auto [childTransformComp, childHierarchyComp] = registry.try_get<TransformComponent, HierarchyComponent>(child);
+			if (childHierarchyComp == nullptr)
+				break;
+			if (childTransformComp != nullptr && FindEntry(cache, child) == nullptr)
+			{
+				AddNode(cache, child, entity, childLevel);
+				cache.stack.push_back(child);
+			}
+			child = childHierarchyComp->nextSibling;
 		}
 	}
 }
 
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SceneGraph::AddNode(TransformCache& cache, entt::entity entity, entt::entity parent, uint32_t level)
+{
+	size_t index = (size_t)entt::to_entity(entity);
+	if (index >= cache.entries.size())
+	{
+		cache.entries.resize(index + 1);
+		cache.states.resize(index + 1, NodeState::Clean);
+	}
+	if (level >= cache.levels.size())
+		cache.levels.resize(level + 1);
+
+	std::vector<TransformNode>& nodes = cache.levels[level];
+	NodeEntry& entry = cache.entries[index];
+	entry = NodeEntry();
+	entry.entity = entity;
+	entry.level = level;
+	entry.slot = (uint32_t)nodes.size();
+	nodes.push_back({ entity, parent });
+	cache.states[index] = NodeState::Clean;
+	cache.nodeCount++;
+
+	if (parent != entt::null)
+	{
+		NodeEntry& parentEntry = cache.entries[(size_t)entt::to_entity(parent)];
+		entry.nextSibling = parentEntry.firstChild;
+		if (parentEntry.firstChild != entt::null)
+			cache.entries[(size_t)entt::to_entity(parentEntry.firstChild)].previousSibling = entity;
+		parentEntry.firstChild = entity;
+	}
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Remove the root and the nodes below it using the links in the cache, the hierarchy may have already changed
+void SceneGraph::RemoveSubtree(TransformCache& cache, entt::entity root)
+{
+	NodeEntry* rootEntry = FindEntry(cache, root);
+	if (rootEntry == nullptr)
+		return;
+
+	const TransformNode& rootNode = cache.levels[rootEntry->level][rootEntry->slot];
+	if (rootEntry->previousSibling != entt::null)
+		cache.entries[(size_t)entt::to_entity(rootEntry->previousSibling)].nextSibling = rootEntry->nextSibling;
+	else if (rootNode.parent != entt::null)
+		cache.entries[(size_t)entt::to_entity(rootNode.parent)].firstChild = rootEntry->nextSibling;
+	if (rootEntry->nextSibling != entt::null)
+		cache.entries[(size_t)entt::to_entity(rootEntry->nextSibling)].previousSibling = rootEntry->previousSibling;
+
+	cache.stack.assign(1, root);
+	while (!cache.stack.empty())
+	{
+		entt::entity entity = cache.stack.back();
+		cache.stack.pop_back();
+
+		NodeEntry& entry = cache.entries[(size_t)entt::to_entity(entity)];
+		for (entt::entity child = entry.firstChild; child != entt::null; child = cache.entries[(size_t)entt::to_entity(child)].nextSibling)
+			cache.stack.push_back(child);
+
+		// Move the last node of the level into the gap
+		std::vector<TransformNode>& nodes = cache.levels[entry.level];
+		TransformNode last = nodes.back();
+		nodes[entry.slot] = last;
+		cache.entries[(size_t)entt::to_entity(last.entity)].slot = entry.slot;
+		nodes.pop_back();
+
+		entry = NodeEntry();
+		cache.nodeCount--;
+	}
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+SceneGraph::NodeEntry* SceneGraph::FindEntry(TransformCache& cache, entt::entity entity)
+{
+	size_t index = (size_t)entt::to_entity(entity);
+	if (index >= cache.entries.size() || cache.entries[index].entity != entity)
+		return nullptr;
+	return &cache.entries[index];
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+bool SceneGraph::UpdateNode(TransformCache& cache, const TransformNode& node, TransformComponent& transformComp, const TransformComponent* parentTransformComp, bool active)
+{
+	NodeState& state = cache.states[(size_t)entt::to_entity(node.entity)];
+
+	NodeState parentState = NodeState::Clean;
+	if (node.parent != entt::null)
+		parentState = cache.states[(size_t)entt::to_entity(node.parent)];
+	else if (!active)
+		parentState = NodeState::Inactive;
+
+	if (parentState == NodeState::Inactive)
+	{
+		// recalculate once the root becomes active again
+		transformComp.MakeDirty();
+		state = NodeState::Inactive;
+		return false;
+	}
+
+	if (s_IncrementalUpdate && parentState == NodeState::Clean && !transformComp.IsDirty())
+	{
+		state = NodeState::Clean;
+		return false;
+	}
+
+	if (parentTransformComp != nullptr)
+		transformComp.SetWorldMatrix(parentTransformComp->GetWorldMatrix());
+	else
+		transformComp.SetWorldMatrix(Matrix4x4());
+
+	state = NodeState::Updated;
+	return true;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SceneGraph::OnTransformChanged(entt::registry& registry, entt::entity entity)
+{
+	if (TransformCache* cache = registry.try_ctx<TransformCache>())
+		cache->changed.push_back(entity);
+
+	registry.get<TransformComponent>(entity).MakeDirty();
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SceneGraph::OnHierarchyChanged(entt::registry& registry, entt::entity entity)
+{
+	if (TransformCache* cache = registry.try_ctx<TransformCache>())
+		cache->changed.push_back(entity);
+
+	if (TransformComponent* transformComp = registry.try_get<TransformComponent>(entity))
+		transformComp->MakeDirty();
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
 void SceneGraph::UpdateUIWidgetTransform(WidgetComponent* widget, HierarchyComponent* hierachyComp, entt::registry& registry)
 {
 	Matrix4x4 parentTransform = Matrix4x4();
@@ -6,6 +6,12 @@
 class SceneGraph
 {
 public:
+	struct Stats
+	{
+		uint32_t nodeCount = 0;
+		uint32_t transformsUpdated = 0;
+	};
+
 	static void Traverse(entt::registry& registry);
 	static void TraverseUI(entt::registry& registry, uint32_t viewportWidth, uint32_t viewportHeight);
 	static void Reparent(Entity entity, Entity parent);
@@ -13,8 +19,68 @@ public:
 	static void Remove(Entity entity);
 	static std::vector<Entity> GetChildren(Entity entity);
 	static entt::entity FindEntity(const std::vector<std::string>& path, entt::registry& registry);
+
+	// When enabled only the transforms that have changed, or whose parent has changed, are recalculated
+	static void SetIncrementalUpdate(bool incremental) { s_IncrementalUpdate = incremental; }
+	static bool IsIncrementalUpdate() { return s_IncrementalUpdate; }
+
+	// When enabled each depth level of the hierarchy is split across the worker threads
+	static void SetParallelUpdate(bool parallel) { s_ParallelUpdate = parallel; }
+	static bool IsParallelUpdate() { return s_ParallelUpdate; }
+
+	static const Stats& GetStats();
+	static void ResetStats();
 private:
-	static void UpdateTransform(TransformComponent* transformComp, HierarchyComponent* hierarchyComp, entt::registry& registry);
+	struct TransformNode
+	{
+		entt::entity entity = entt::null;
+		entt::entity parent = entt::null;
+	};
+
+	enum class NodeState : uint8_t
+	{
+		Clean,
+		Updated,
+		Inactive
+	};
+
+	// Where an entity's node is in the cache and its links to the other cached nodes
+	struct NodeEntry
+	{
+		entt::entity entity = entt::null; // null if the entity isn't in the cache
+		uint32_t level = 0;
+		uint32_t slot = 0;
+		entt::entity firstChild = entt::null;
+		entt::entity previousSibling = entt::null;
+		entt::entity nextSibling = entt::null;
+	};
+
+	// Flattened hierarchy stored in the registry context, each level holds the nodes at one depth so parents are
+	// always updated before their children. Entities whose transform or hierarchy component is added or removed are
+	// queued, and their subtrees are taken out and put back in before the next update
+	struct TransformCache
+	{
+		std::vector<std::vector<TransformNode>> levels;
+		std::vector<NodeEntry> entries; // indexed by entity index
+		std::vector<NodeState> states; // indexed by entity index
+		std::vector<entt::entity> changed;
+		std::vector<entt::entity> stack; // reused when walking a subtree
+		size_t nodeCount = 0;
+	};
+
+	static void RebuildTransformCache(entt::registry& registry, TransformCache& cache);
+	static void UpdateTransformCache(entt::registry& registry, TransformCache& cache);
+	static void AddSubtree(entt::registry& registry, TransformCache& cache, entt::entity root, entt::entity parent, uint32_t level);
+	static void AddNode(TransformCache& cache, entt::entity entity, entt::entity parent, uint32_t level);
+	static void RemoveSubtree(TransformCache& cache, entt::entity root);
+	static NodeEntry* FindEntry(TransformCache& cache, entt::entity entity);
+	static bool UpdateNode(TransformCache& cache, const TransformNode& node, TransformComponent& transformComp, const TransformComponent* parentTransformComp, bool active);
+	static void OnTransformChanged(entt::registry& registry, entt::entity entity);
+	static void OnHierarchyChanged(entt::registry& registry, entt::entity entity);
 
 	static void UpdateUIWidgetTransform(WidgetComponent* transformComp, HierarchyComponent* hierachyComp, entt::registry& registry);
+
+	static bool s_IncrementalUpdate;
+	static bool s_ParallelUpdate;
+	static Stats s_Stats;
 };
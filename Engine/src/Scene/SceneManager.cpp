@@ -123,9 +123,11 @@ bool SceneManager::FinalChangeScene()
 	SceneChangedEvent event(s_NextFilepath);
 	Application::CallEvent(event);
 
-	const char* title = Application::GetWindow()->GetTitle();
-
-	s_CurrentScene->OnViewportResize(Settings::GetInt(title, "Window_Width"), Settings::GetInt(title, "Window_Height"));
+	if (Window* window = Application::GetWindow())
+	{
+		const char* title = window->GetTitle();
+		s_CurrentScene->OnViewportResize(Settings::GetInt(title, "Window_Width"), Settings::GetInt(title, "Window_Height"));
+	}
 
 	s_NextFilepath.clear();
 
@@ -173,6 +175,10 @@ bool SceneManager::ChangeSceneState(SceneState sceneState)
 			ChangeScene(s_EditingScene);
 			s_EditingScene.clear();
 		}
+		// Running headless there is no window or Dear ImGui context
+		if (Application::IsHeadless())
+			return true;
+
 		ImGuiIO& io = ImGui::GetIO();
 		if (sceneState == SceneState::Play) {
 			io.ConfigFlags |= ImGuiConfigFlags_NoMouseCursorChange;
@@ -7,6 +7,7 @@
 #include "Core/Version.h"
 #include "Utilities/SerializationUtils.h"
 #include "AssetManager.h"
+#include "Renderer/ImageLoader.h"
 
 #include "TinyXml2/tinyxml2.h"
 
@@ -80,15 +81,26 @@ bool SceneSerializer::Deserialize(const std::filesystem::path& filepath)
 		if (const char* version = pRoot->Attribute("EngineVersion"); version && atoi(version) != VERSION)
 			ENGINE_WARN("Loading scene created with a different version of the engine");
 
+		// Textures are decoded on the worker threads while the entities are built
+		std::vector<std::filesystem::path> texturePaths;
+		for (tinyxml2::XMLElement const* pEntityElement = pRoot->FirstChildElement("Entity");
+			pEntityElement; pEntityElement = pEntityElement->NextSiblingElement("Entity"))
+		{
+			CollectTextures(pEntityElement, texturePaths);
+		}
+		AssetManager::PrefetchTextures(texturePaths);
+
 		// Entities
+		std::vector<DeferredTexture> deferredTextures;
 		tinyxml2::XMLElement* pEntityElement = pRoot->LastChildElement("Entity");
 
 		while (pEntityElement)
 		{
-			DeserializeEntity(m_Scene, pEntityElement);
+			DeserializeEntity(m_Scene, pEntityElement, false, deferredTextures);
 			pEntityElement = pEntityElement->PreviousSiblingElement("Entity");
 		}
 
+		ResolveTextures(m_Scene, deferredTextures);
 		return true;
 	}
 	else
@@ -417,6 +429,27 @@ void SceneSerializer::SerializeEntity(tinyxml2::XMLElement* pElement, Entity ent
 		SerializationUtils::Encode(pCircleRendererElement->InsertNewChildElement("Colour"), component.colour);
 	}
 
+	if (entity.HasComponent<ParticleSystemComponent>())
+	{
+		ParticleSystemComponent const& component = entity.GetComponent<ParticleSystemComponent>();
+
+		tinyxml2::XMLElement* pParticleSystemElement = pElement->InsertNewChildElement("ParticleSystem");
+
+		pParticleSystemElement->SetAttribute("EmissionRate", component.emissionRate);
+		pParticleSystemElement->SetAttribute("MaxParticles", component.maxParticles);
+		pParticleSystemElement->SetAttribute("Emitting", component.emitting);
+		pParticleSystemElement->SetAttribute("SizeBegin", component.properties.sizeBegin);
+		pParticleSystemElement->SetAttribute("SizeEnd", component.properties.sizeEnd);
+		pParticleSystemElement->SetAttribute("SizeVariation", component.properties.sizeVariation);
+		pParticleSystemElement->SetAttribute("RotationSpeed", component.properties.rotationSpeed);
+		pParticleSystemElement->SetAttribute("LifeTime", component.properties.lifeTime);
+
+		SerializationUtils::Encode(pParticleSystemElement->InsertNewChildElement("Velocity"), component.properties.velocity);
+		SerializationUtils::Encode(pParticleSystemElement->InsertNewChildElement("VelocityVariation"), component.properties.velocityVariation);
+		SerializationUtils::Encode(pParticleSystemElement->InsertNewChildElement("BeginColour"), component.properties.beginColour);
+		SerializationUtils::Encode(pParticleSystemElement->InsertNewChildElement("EndColour"), component.properties.endColour);
+	}
+
 	if (entity.HasComponent<BehaviourTreeComponent>())
 	{
 		BehaviourTreeComponent const& component = entity.GetComponent<BehaviourTreeComponent>();
@@ -470,6 +503,13 @@ void SceneSerializer::SerializeEntity(tinyxml2::XMLElement* pElement, Entity ent
 		pCanvasElement->SetAttribute("PixelPerUnit", component->pixelPerUnit);
 	}
 
+	if (EntityPoolComponent* component = entity.TryGetComponent<EntityPoolComponent>())
+	{
+		tinyxml2::XMLElement* pEntityPoolElement = pElement->InsertNewChildElement("EntityPool");
+
+		pEntityPoolElement->SetAttribute("PrewarmCount", component->prewarmCount);
+	}
+
 	if (entity.HasComponent<HierarchyComponent>())
 	{
 		if (HierarchyComponent const& component = entity.GetComponent<HierarchyComponent>();
@@ -497,6 +537,63 @@ Entity SceneSerializer::DeserializeEntity(Scene* scene, tinyxml2::XMLElement* pE
 {
 	PROFILE_FUNCTION();
 
+	std::vector<std::filesystem::path> texturePaths;
+	CollectTextures(pEntityElement, texturePaths);
+	AssetManager::PrefetchTextures(texturePaths);
+
+	std::vector<DeferredTexture> deferredTextures;
+	Entity entity = DeserializeEntity(scene, pEntityElement, resetUuid, deferredTextures);
+	ResolveTextures(scene, deferredTextures);
+	return entity;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SceneSerializer::CollectTextures(tinyxml2::XMLElement const* pEntityElement, std::vector<std::filesystem::path>& filepaths)
+{
+	if (!pEntityElement)
+		return;
+
+	if (tinyxml2::XMLElement const* pSpriteComponentElement = pEntityElement->FirstChildElement("Sprite"))
+	{
+		if (tinyxml2::XMLElement const* pTextureElement = pSpriteComponentElement->FirstChildElement("Texture"))
+		{
+			std::filesystem::path filepath;
+			SerializationUtils::Decode(pTextureElement, filepath);
+			filepaths.push_back(filepath);
+		}
+	}
+
+	for (tinyxml2::XMLElement const* pChildElement = pEntityElement->FirstChildElement("Entity");
+		pChildElement; pChildElement = pChildElement->NextSiblingElement("Entity"))
+	{
+		CollectTextures(pChildElement, filepaths);
+	}
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SceneSerializer::ResolveTextures(Scene* scene, const std::vector<DeferredTexture>& deferredTextures)
+{
+	PROFILE_FUNCTION();
+
+	for (const DeferredTexture& deferredTexture : deferredTextures)
+	{
+		Entity entity(deferredTexture.entity, scene);
+		if (SpriteComponent* component = entity.TryGetComponent<SpriteComponent>())
+			SerializationUtils::Decode(deferredTexture.pElement, component->texture);
+	}
+
+	// Anything left was already loaded or failed to load
+	ImageLoader::ClearPrefetched();
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+Entity SceneSerializer::DeserializeEntity(Scene* scene, tinyxml2::XMLElement* pEntityElement, bool resetUuid, std::vector<DeferredTexture>& deferredTextures)
+{
+	PROFILE_FUNCTION();
+
 	Entity entity;
 	if (!pEntityElement)
 		return entity;
@@ -570,7 +667,8 @@ Entity SceneSerializer::DeserializeEntity(Scene* scene, tinyxml2::XMLElement* pE
 		SerializationUtils::Decode(pSpriteComponentElement->FirstChildElement("Tint"), component.tint);
 		pSpriteComponentElement->QueryFloatAttribute("Tilingfactor", &component.tilingFactor);
 
-		SerializationUtils::Decode(pSpriteComponentElement->FirstChildElement("Texture"), component.texture);
+		if (tinyxml2::XMLElement const* pTextureElement = pSpriteComponentElement->FirstChildElement("Texture"))
+			deferredTextures.push_back({ entity.GetHandle(), pTextureElement });
 	}
 
 	// Animated Sprite ---------------------------------------------------------------------------------------------------
@@ -916,6 +1014,26 @@ Entity SceneSerializer::DeserializeEntity(Scene* scene, tinyxml2::XMLElement* pE
 		SerializationUtils::Decode(pCircleRendererComponentElement->FirstChildElement("Colour"), component.colour);
 	}
 
+	// ParticleSystem -----------------------------------------------------------------------------------------------
+	if (tinyxml2::XMLElement const* pParticleSystemComponentElement = pEntityElement->FirstChildElement("ParticleSystem"))
+	{
+		ParticleSystemComponent& component = entity.AddComponent<ParticleSystemComponent>();
+
+		pParticleSystemComponentElement->QueryFloatAttribute("EmissionRate", &component.emissionRate);
+		pParticleSystemComponentElement->QueryUnsignedAttribute("MaxParticles", &component.maxParticles);
+		pParticleSystemComponentElement->QueryBoolAttribute("Emitting", &component.emitting);
+		pParticleSystemComponentElement->QueryFloatAttribute("SizeBegin", &component.properties.sizeBegin);
+		pParticleSystemComponentElement->QueryFloatAttribute("SizeEnd", &component.properties.sizeEnd);
+		pParticleSystemComponentElement->QueryFloatAttribute("SizeVariation", &component.properties.sizeVariation);
+		pParticleSystemComponentElement->QueryFloatAttribute("RotationSpeed", &component.properties.rotationSpeed);
+		pParticleSystemComponentElement->QueryFloatAttribute("LifeTime", &component.properties.lifeTime);
+
+		SerializationUtils::Decode(pParticleSystemComponentElement->FirstChildElement("Velocity"), component.properties.velocity);
+		SerializationUtils::Decode(pParticleSystemComponentElement->FirstChildElement("VelocityVariation"), component.properties.velocityVariation);
+		SerializationUtils::Decode(pParticleSystemComponentElement->FirstChildElement("BeginColour"), component.properties.beginColour);
+		SerializationUtils::Decode(pParticleSystemComponentElement->FirstChildElement("EndColour"), component.properties.endColour);
+	}
+
 	// Text --------------------------------------------------------------------------------------------------------
 	if (tinyxml2::XMLElement const* pTextComponentElement = pEntityElement->FirstChildElement("Text"))
 	{
@@ -990,6 +1108,14 @@ Entity SceneSerializer::DeserializeEntity(Scene* scene, tinyxml2::XMLElement* pE
 		component.pixelPerUnit = pCanvasComponent->FloatAttribute("PixelPerUnit", 1.0f);
 	}
 
+	// Entity Pool -------------------------------------------------------------------------------------------------
+	if (tinyxml2::XMLElement const* pEntityPoolComponent = pEntityElement->FirstChildElement("EntityPool"))
+	{
+		EntityPoolComponent& component = entity.AddComponent<EntityPoolComponent>();
+
+		component.prewarmCount = pEntityPoolComponent->UnsignedAttribute("PrewarmCount", 0);
+	}
+
 	// Hierarchy --------------------------------------------------------------------------------------------------
 	if (tinyxml2::XMLElement* pChildElement = pEntityElement->LastChildElement("Entity"))
 	{
@@ -999,7 +1125,7 @@ Entity SceneSerializer::DeserializeEntity(Scene* scene, tinyxml2::XMLElement* pE
 
 		while (pChildElement)
 		{
-			Entity childEntity = DeserializeEntity(scene, pChildElement, resetUuid);
+			Entity childEntity = DeserializeEntity(scene, pChildElement, resetUuid, deferredTextures);
 			HierarchyComponent& childHierarchyComp = childEntity.GetOrAddComponent<HierarchyComponent>();
 			childHierarchyComp.parent = entity.GetHandle();
 
@@ -23,5 +23,16 @@ public:
 	static std::string SerializeEntity(Entity entity);
 	static Entity DeserializeEntity(Scene* scene, const std::string& prefab, bool resetUuid = false);
 private:
+	// A sprite texture that is set once every entity has been built
+	struct DeferredTexture
+	{
+		entt::entity entity;
+		tinyxml2::XMLElement const* pElement;
+	};
+
+	static Entity DeserializeEntity(Scene* scene, tinyxml2::XMLElement* pEntityElement, bool resetUuid, std::vector<DeferredTexture>& deferredTextures);
+	static void CollectTextures(tinyxml2::XMLElement const* pEntityElement, std::vector<std::filesystem::path>& filepaths);
+	static void ResolveTextures(Scene* scene, const std::vector<DeferredTexture>& deferredTextures);
+
 	Scene* m_Scene;
 };
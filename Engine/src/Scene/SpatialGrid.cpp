@@ -0,0 +1,185 @@
+#include "stdafx.h"
+#include "SpatialGrid.h"
+
+// Clamp cell coordinates so that huge or infinite query areas don't overflow
+static constexpr float s_MaxCoord = (float)(INT32_MAX / 2);
+
+SpatialGrid::SpatialGrid(float cellSize)
+	:m_CellSize(cellSize > 0.0f ? cellSize : 1.0f)
+{
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SpatialGrid::Update(entt::entity entity, const BoundingBox& bounds, uint32_t version)
+{
+	size_t index = (size_t)entt::to_entity(entity);
+	if (index >= m_Entries.size())
+		m_Entries.resize(index + 1);
+
+	Entry& entry = m_Entries[index];
+	if (entry.entity != entt::null)
+	{
+		RemoveFromCell(entry);
+		m_Count--;
+	}
+
+	entry.entity = entity;
+	entry.bounds = bounds;
+	entry.version = version;
+
+	Vector3f min = bounds.Min();
+	Vector3f max = bounds.Max();
+	if (!bounds.IsValid() || max.x - min.x > m_CellSize || max.y - min.y > m_CellSize)
+	{
+		entry.cell = s_OversizedCell;
+	}
+	else
+	{
+		Vector3f centre = bounds.Center();
+		entry.cell = CellKey(CellCoord(std::clamp(centre.x, -s_MaxCoord, s_MaxCoord)), CellCoord(std::clamp(centre.y, -s_MaxCoord, s_MaxCoord)));
+	}
+
+	std::vector<entt::entity>& cell = m_Cells[entry.cell];
+	entry.slot = (uint32_t)cell.size();
+	cell.push_back(entity);
+	m_Count++;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SpatialGrid::Remove(entt::entity entity)
+{
+	Entry* entry = Find(entity);
+	if (entry == nullptr)
+		return;
+
+	RemoveFromCell(*entry);
+	*entry = Entry();
+	m_Count--;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SpatialGrid::Clear()
+{
+	m_Entries.clear();
+	m_Cells.clear();
+	m_Count = 0;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+bool SpatialGrid::IsCurrent(entt::entity entity, uint32_t version) const
+{
+	const Entry* entry = Find(entity);
+	return entry != nullptr && entry->version == version;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+BoundingBox SpatialGrid::GetBounds(entt::entity entity) const
+{
+	const Entry* entry = Find(entity);
+	return entry != nullptr ? entry->bounds : BoundingBox();
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SpatialGrid::Query(const BoundingBox& area, std::vector<entt::entity>& results) const
+{
+	PROFILE_FUNCTION();
+
+	if (!area.IsValid())
+		return;
+
+	auto oversized = m_Cells.find(s_OversizedCell);
+	if (oversized != m_Cells.end())
+		QueryCell(oversized->second, area, results);
+
+	// Entities can overhang their cell by half a cell
+	float halfCell = m_CellSize * 0.5f;
+	int32_t minX = CellCoord(std::clamp(area.Min().x - halfCell, -s_MaxCoord, s_MaxCoord));
+	int32_t minY = CellCoord(std::clamp(area.Min().y - halfCell, -s_MaxCoord, s_MaxCoord));
+	int32_t maxX = CellCoord(std::clamp(area.Max().x + halfCell, -s_MaxCoord, s_MaxCoord));
+	int32_t maxY = CellCoord(std::clamp(area.Max().y + halfCell, -s_MaxCoord, s_MaxCoord));
+
+	uint64_t cellsInArea = (uint64_t)((int64_t)maxX - minX + 1) * (uint64_t)((int64_t)maxY - minY + 1);
+	if (cellsInArea > m_Cells.size())
+	{
+		// The area covers more cells than are occupied, so walk the occupied cells instead
+		for (auto&& [key, cell] : m_Cells)
+		{
+			if (key == s_OversizedCell)
+				continue;
+			int32_t x = (int32_t)(key >> 32);
+			int32_t y = (int32_t)(uint32_t)key;
+			if (x >= minX && x <= maxX && y >= minY && y <= maxY)
+				QueryCell(cell, area, results);
+		}
+		return;
+	}
+
+	for (int32_t x = minX; x <= maxX; x++)
+	{
+		for (int32_t y = minY; y <= maxY; y++)
+		{
+			auto it = m_Cells.find(CellKey(x, y));
+			if (it != m_Cells.end())
+				QueryCell(it->second, area, results);
+		}
+	}
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+SpatialGrid::Entry* SpatialGrid::Find(entt::entity entity)
+{
+	size_t index = (size_t)entt::to_entity(entity);
+	if (index >= m_Entries.size() || m_Entries[index].entity != entity)
+		return nullptr;
+	return &m_Entries[index];
+}
+
+const SpatialGrid::Entry* SpatialGrid::Find(entt::entity entity) const
+{
+	size_t index = (size_t)entt::to_entity(entity);
+	if (index >= m_Entries.size() || m_Entries[index].entity != entity)
+		return nullptr;
+	return &m_Entries[index];
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SpatialGrid::RemoveFromCell(Entry& entry)
+{
+	auto it = m_Cells.find(entry.cell);
+	if (it == m_Cells.end())
+		return;
+
+	// Swap with the last entity in the cell so removal doesn't shift the others
+	std::vector<entt::entity>& cell = it->second;
+	entt::entity last = cell.back();
+	cell[entry.slot] = last;
+	m_Entries[(size_t)entt::to_entity(last)].slot = entry.slot;
+	cell.pop_back();
+
+	if (cell.empty())
+		m_Cells.erase(it);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void SpatialGrid::QueryCell(const std::vector<entt::entity>& cell, const BoundingBox& area, std::vector<entt::entity>& results) const
+{
+	for (entt::entity entity : cell)
+	{
+		const BoundingBox& bounds = m_Entries[(size_t)entt::to_entity(entity)].bounds;
+		if (!bounds.IsValid()
+			|| (bounds.Min().x <= area.Max().x && bounds.Max().x >= area.Min().x
+				&& bounds.Min().y <= area.Max().y && bounds.Max().y >= area.Min().y))
+		{
+			results.push_back(entity);
+		}
+	}
+}
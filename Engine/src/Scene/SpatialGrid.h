@@ -0,0 +1,58 @@
+#pragma once
+
+#include "EnTT/entt.hpp"
+#include "Core/BoundingBox.h"
+
+#include <unordered_map>
+
+// Loose uniform grid over the xy plane
+// Each entity is stored in the cell containing the centre of its bounds, so queries are expanded by half a cell
+// Entities larger than a cell are kept in a separate list which is checked by every query
+class SpatialGrid
+{
+public:
+	explicit SpatialGrid(float cellSize = 4.0f);
+
+	// Insert or move an entity, the version is stored so unchanged entities can be skipped
+	void Update(entt::entity entity, const BoundingBox& bounds, uint32_t version);
+	void Remove(entt::entity entity);
+	void Clear();
+
+	// Has the entity been inserted with this version
+	bool IsCurrent(entt::entity entity, uint32_t version) const;
+
+	// Bounds the entity was last inserted with, invalid if it isn't in the grid
+	BoundingBox GetBounds(entt::entity entity) const;
+
+	// Append every entity whose bounds overlap the area in the xy plane
+	void Query(const BoundingBox& area, std::vector<entt::entity>& results) const;
+
+	size_t Size() const { return m_Count; }
+	float GetCellSize() const { return m_CellSize; }
+
+private:
+	static constexpr int64_t s_OversizedCell = INT64_MAX;
+
+	struct Entry
+	{
+		entt::entity entity = entt::null;
+		BoundingBox bounds;
+		uint32_t version = 0;
+		int64_t cell = 0;
+		uint32_t slot = 0; // index within the cell
+	};
+
+	int64_t CellKey(int32_t x, int32_t y) const { return ((int64_t)x << 32) | (uint32_t)y; }
+	int32_t CellCoord(float value) const { return (int32_t)floorf(value / m_CellSize); }
+
+	Entry* Find(entt::entity entity);
+	const Entry* Find(entt::entity entity) const;
+	void RemoveFromCell(Entry& entry);
+	void QueryCell(const std::vector<entt::entity>& cell, const BoundingBox& area, std::vector<entt::entity>& results) const;
+
+	float m_CellSize;
+	size_t m_Count = 0;
+
+	std::vector<Entry> m_Entries; // indexed by the entity index
+	std::unordered_map<int64_t, std::vector<entt::entity>> m_Cells;
+};
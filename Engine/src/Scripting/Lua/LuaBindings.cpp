@@ -10,13 +10,17 @@
 #include "Scene/Scene.h"
 #include "Scene/Entity.h"
 #include "Scene/SceneManager.h"
+#include "Scene/Prefab.h"
+#include "Scene/EntityPool.h"
 #include "Scene/Components.h"
 #include "Utilities/StringUtils.h"
 #include "Renderer/Renderer2D.h"
 #include "Physics/HitResult2D.h"
 #include "Core/Settings.h"
+#include "Core/Statistics.h"
 #include "LuaManager.h"
 #include "AI/BehaviorTree.h"
+#include "AI/PathRequestQueue.h"
 
 template<typename T, typename... Args>
 void SetFunction(T& type, const std::string& name, const std::string& description, Args&&... args)
@@ -87,11 +91,11 @@ void BindApp(sol::state& state)
 		{ return Application::Get().GetFixedUpdateInterval(); });
 
 	application.set_function("MaximizeWindow", [](sol::this_state s)
-		{ return Application::GetWindow()->MaximizeWindow(); });
+		{ if (Window* window = Application::GetWindow()) window->MaximizeWindow(); });
 	application.set_function("RestoreWindow", [](sol::this_state s)
-		{ return Application::GetWindow()->RestoreWindow(); });
+		{ if (Window* window = Application::GetWindow()) window->RestoreWindow(); });
 	application.set_function("SetWindowMode", [](sol::this_state s, WindowMode windowMode)
-		{ return Application::GetWindow()->SetWindowMode(windowMode); });
+		{ if (Window* window = Application::GetWindow()) window->SetWindowMode(windowMode); });
 
 	application.set_function("GetDocumentDirectory", []()
 		{ return Application::GetOpenDocumentDirectory().string(); });
@@ -156,6 +160,21 @@ void BindScene(sol::state& state)
 	scene_type.set_function("FindEntity", &Scene::GetEntityByPath);
 	scene_type.set_function("InstantiateScene", &Scene::InstantiateScene);
 	scene_type.set_function("InstantiateEntity", &Scene::InstantiateEntity);
+	scene_type.set_function("InstantiatePrefab", static_cast<std::vector<Entity>(Scene::*)(const Prefab&, const std::vector<Vector3f>&)>(&Scene::InstantiatePrefab));
+	scene_type.set_function("CreateEntityPool", sol::overload(
+		&Scene::CreateEntityPool,
+		[](Scene& scene, Entity prefab) { return scene.CreateEntityPool(prefab); }));
+	scene_type.set_function("GetEntityPool", &Scene::GetEntityPool);
+
+	sol::usertype<Prefab> prefab_type = state.new_usertype<Prefab>("Prefab", sol::constructors<Prefab(Entity)>());
+	prefab_type.set_function("GetEntityCount", &Prefab::GetEntityCount);
+
+	sol::usertype<EntityPool> entityPool_type = state.new_usertype<EntityPool>("EntityPool");
+	entityPool_type.set_function("Spawn", &EntityPool::Spawn);
+	entityPool_type.set_function("Despawn", &EntityPool::Despawn);
+	entityPool_type.set_function("Prewarm", &EntityPool::Prewarm);
+	entityPool_type.set_function("GetParkedCount", &EntityPool::GetParkedCount);
+	entityPool_type.set_function("GetActiveCount", &EntityPool::GetActiveCount);
 
 	sol::usertype<HitResult2D> hitResult_type = state.new_usertype<HitResult2D>("HitResult2D");
 	hitResult_type["Hit"] = &HitResult2D::hit;
@@ -166,6 +185,34 @@ void BindScene(sol::state& state)
 	scene_type.set_function("RayCast2D", &Scene::RayCast2D);
 	scene_type.set_function("MultiRayCast2D", &Scene::MultiRayCast2D);
 
+	// Paths are solved on the worker threads during the scene update, poll the handle until it is ready
+	sol::table pathfinding = state.create_table("Pathfinding");
+	pathfinding.set_function("RequestPath", [](Vector2f source, Vector2f goal) -> Astar::PathRequestQueue::Handle
+		{
+			Scene* scene = SceneManager::CurrentScene();
+			if (!scene)
+				return Astar::PathRequestQueue::s_InvalidHandle;
+			return Astar::PathRequestQueue::Submit(source, goal, scene->GetPathfinder());
+		});
+	pathfinding.set_function("GetStatus", &Astar::PathRequestQueue::GetStatus);
+	pathfinding.set_function("GetPath", [](Astar::PathRequestQueue::Handle handle) -> sol::optional<std::vector<Vector2f>>
+		{
+			std::vector<Vector2f> path;
+			if (!Astar::PathRequestQueue::TryGetPath(handle, path))
+				return sol::nullopt;
+			return path;
+		});
+	pathfinding.set_function("Release", &Astar::PathRequestQueue::Release);
+
+	std::initializer_list<std::pair<sol::string_view, int>> pathStatusItems =
+	{
+		{ "Invalid", (int)Astar::PathRequestQueue::Status::Invalid },
+		{ "Pending", (int)Astar::PathRequestQueue::Status::Pending },
+		{ "Ready", (int)Astar::PathRequestQueue::Status::Ready },
+		{ "Failed", (int)Astar::PathRequestQueue::Status::Failed }
+	};
+	state.new_enum("PathStatus", pathStatusItems);
+
 	sol::table assetManager = state.create_table("AssetManager");
 	assetManager.set_function("GetTexture", [](std::string_view path) -> Ref<Texture2D>
 		{
@@ -353,6 +400,9 @@ void BindEntity(sol::state& state)
 	text_type["MaxWidth"] = &TextComponent::maxWidth;
 	text_type["Colour"] = &TextComponent::colour;
 	text_type["Font"] = &TextComponent::font;
+
+	auto entityPoolComponent_type = state["EntityPoolComponent"].get_or_create<sol::usertype<EntityPoolComponent>>();
+	entityPoolComponent_type["PrewarmCount"] = &EntityPoolComponent::prewarmCount;
 }
 
 //--------------------------------------------------------------------------------------------------------------
@@ -433,13 +483,13 @@ void BindInput(sol::state& state)
 	state.new_enum("Cursors", cursorItems);
 
 	SetFunction(input, "SetCursor", "Set the appearance of the cursor", [](sol::this_state s, Cursors cursor)
-		{ return Application::GetWindow()->SetCursor(cursor); });
+		{ if (Window* window = Application::GetWindow()) window->SetCursor(cursor); });
 	SetFunction(input, "DisableCursor", "Disable the cursor", [](sol::this_state s)
-		{ return Application::GetWindow()->DisableCursor(); });
+		{ if (Window* window = Application::GetWindow()) window->DisableCursor(); });
 	SetFunction(input, "EnableCursor", "Enable the cursor", [](sol::this_state s)
-		{ return Application::GetWindow()->EnableCursor(); });
+		{ if (Window* window = Application::GetWindow()) window->EnableCursor(); });
 	SetFunction(input, "SetCursorPosition", "Set the position of the cursor", [](sol::this_state s, double xPos, double yPos)
-		{ return Application::GetWindow()->SetCursorPosition(xPos, yPos); });
+		{ if (Window* window = Application::GetWindow()) window->SetCursorPosition(xPos, yPos); });
 
 }
 
@@ -565,7 +615,8 @@ void BindCommonTypes(sol::state& state)
 		"GetDouble", &BehaviourTree::Blackboard::getDouble,
 		"GetString", &BehaviourTree::Blackboard::getString,
 		"GetVec2", &BehaviourTree::Blackboard::getVector2,
-		"GetVec3", &BehaviourTree::Blackboard::getVector3
+		"GetVec3", &BehaviourTree::Blackboard::getVector3,
+		"GetPath", &BehaviourTree::Blackboard::getPath
 		);
 
 	sol::usertype<BehaviourTree::BehaviourTree> behaviourTree_type = state.new_usertype<BehaviourTree::BehaviourTree>(
@@ -594,4 +645,39 @@ void BindDebug(sol::state& state)
 	debug.set_function("DrawRect", [](const Vector3f& position, const Vector2f& size, const Colour& colour)
 		{ Renderer2D::DrawHairLineRect(position, size, colour); });
 }
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void BindStatistics(sol::state& state)
+{
+	PROFILE_FUNCTION();
+
+	sol::table stats = state.create_table("Stats");
+	LuaManager::AddIdentifier("Stats", "Per frame statistics");
+
+	SetFunction(stats, "Add", "Add to this frame's value of a statistic", [](const std::string& name, double value)
+		{ Statistics::Add(Statistics::Register(name), value); });
+	SetFunction(stats, "Set", "Set this frame's value of a statistic", [](const std::string& name, double value)
+		{ Statistics::Set(Statistics::Register(name), value); });
+	SetFunction(stats, "Get", "Get the summary of a statistic", [](sol::this_state s, const std::string& name)
+		{
+			sol::state_view lua(s);
+			sol::table result = lua.create_table();
+			Statistics::StatId id = Statistics::Find(name);
+			if (id == Statistics::s_InvalidStat)
+				return result;
+
+			Statistics::Summary summary = Statistics::GetSummary(id);
+			result["last"] = summary.last;
+			result["mean"] = summary.mean;
+			result["min"] = summary.min;
+			result["max"] = summary.max;
+			result["p50"] = summary.p50;
+			result["p95"] = summary.p95;
+			result["p99"] = summary.p99;
+			return result;
+		});
+	SetFunction(stats, "WriteCSV", "Write every statistic to a csv file", [](const std::string& filepath)
+		{ return Statistics::WriteCSV(filepath); });
+}
 }
\ No newline at end of file
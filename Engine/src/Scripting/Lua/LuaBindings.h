@@ -11,4 +11,5 @@ void BindInput(sol::state& state);
 void BindMath(sol::state& state);
 void BindCommonTypes(sol::state& state);
 void BindDebug(sol::state& state);
+void BindStatistics(sol::state& state);
 }
@@ -78,6 +78,7 @@ void LuaManager::Init()
 	Lua::BindMath(*s_State);
 	Lua::BindCommonTypes(*s_State);
 	Lua::BindDebug(*s_State);
+	Lua::BindStatistics(*s_State);
 
 	const char* lua_function_script = 
 	R"(
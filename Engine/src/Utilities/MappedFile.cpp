@@ -0,0 +1,92 @@
+#include "stdafx.h"
+#include "MappedFile.h"
+
+#ifndef __WINDOWS__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // !__WINDOWS__
+
+bool MappedFile::Open(const std::filesystem::path& filepath)
+{
+	PROFILE_FUNCTION();
+
+	Close();
+
+#ifdef __WINDOWS__
+	HANDLE file = CreateFileW(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!data)
+	{
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+
+	m_File = file;
+	m_Mapping = mapping;
+	m_Data = (const uint8_t*)data;
+	m_Size = (size_t)size.QuadPart;
+#else
+	int file = open(filepath.c_str(), O_RDONLY);
+	if (file < 0)
+		return false;
+
+	struct stat status;
+	if (fstat(file, &status) != 0 || status.st_size <= 0)
+	{
+		close(file);
+		return false;
+	}
+
+	void* data = mmap(nullptr, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+
+	// The mapping keeps the file open
+	close(file);
+	if (data == MAP_FAILED)
+		return false;
+
+	m_Data = (const uint8_t*)data;
+	m_Size = (size_t)status.st_size;
+#endif // __WINDOWS__
+	return true;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void MappedFile::Close()
+{
+	if (!m_Data)
+		return;
+
+#ifdef __WINDOWS__
+	UnmapViewOfFile(m_Data);
+	CloseHandle(m_Mapping);
+	CloseHandle(m_File);
+	m_Mapping = nullptr;
+	m_File = nullptr;
+#else
+	munmap((void*)m_Data, m_Size);
+#endif // __WINDOWS__
+
+	m_Data = nullptr;
+	m_Size = 0;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <filesystem>
+
+// A read only view of a whole file mapped into memory, pages are read from disk the first time they are touched
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	explicit MappedFile(const std::filesystem::path& filepath) { Open(filepath); }
+	~MappedFile() { Close(); }
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool Open(const std::filesystem::path& filepath);
+	void Close();
+
+	bool IsOpen() const { return m_Data != nullptr; }
+	const uint8_t* GetData() const { return m_Data; }
+	size_t GetSize() const { return m_Size; }
+
+private:
+	const uint8_t* m_Data = nullptr;
+	size_t m_Size = 0;
+
+#ifdef __WINDOWS__
+	void* m_File = nullptr;
+	void* m_Mapping = nullptr;
+#endif // __WINDOWS__
+};
@@ -56,6 +56,42 @@ static wchar_t* ConvertToWideChar(const std::string& s)
 	return wideString;
 }
 
+// decodes UTF-8 into codepoints, invalid sequences become U+FFFD
+static std::u32string DecodeUtf8(const std::string& s)
+{
+	std::u32string codepoints;
+	codepoints.reserve(s.size());
+
+	size_t i = 0;
+	while (i < s.size())
+	{
+		const uint8_t lead = (uint8_t)s[i];
+		char32_t codepoint;
+		size_t length;
+		if (lead < 0x80) { codepoint = lead; length = 1; }
+		else if ((lead & 0xE0) == 0xC0) { codepoint = lead & 0x1F; length = 2; }
+		else if ((lead & 0xF0) == 0xE0) { codepoint = lead & 0x0F; length = 3; }
+		else if ((lead & 0xF8) == 0xF0) { codepoint = lead & 0x07; length = 4; }
+		else { codepoints.push_back(0xFFFD); i++; continue; }
+
+		size_t continuation = 1;
+		while (continuation < length && i + continuation < s.size() && ((uint8_t)s[i + continuation] & 0xC0) == 0x80)
+		{
+			codepoint = (codepoint << 6) | ((uint8_t)s[i + continuation] & 0x3F);
+			continuation++;
+		}
+
+		// Truncated, overlong, surrogate or out of range
+		static const char32_t minimum[] = { 0, 0, 0x80, 0x800, 0x10000 };
+		if (continuation < length || codepoint < minimum[length] || (codepoint >= 0xD800 && codepoint <= 0xDFFF) || codepoint > 0x10FFFF)
+			codepoint = 0xFFFD;
+
+		codepoints.push_back(codepoint);
+		i += continuation;
+	}
+	return codepoints;
+}
+
 template <std::size_t...Idxs>
 constexpr auto substring_as_array(std::string_view str, std::index_sequence<Idxs...>)
 {
@@ -37,12 +37,15 @@ int main(int argc, char* argv[])
 	file.read((char*)&startupScene[0], size);
 	file.close();
 
-	Window* window = app->CreateDesktopWindow(WindowProps(gameName, 1920, 1080, 100, 100));
+	if (!Application::IsHeadless())
+	{
+		Window* window = app->CreateDesktopWindow(WindowProps(gameName, 1920, 1080, 100, 100));
 
-	if (!window)
-		return EXIT_FAILURE;
+		if (!window)
+			return EXIT_FAILURE;
 
-	RenderCommand::SetClearColour(Colours::GREY);
+		RenderCommand::SetClearColour(Colours::GREY);
+	}
 
 	SceneManager::ChangeScene(std::filesystem::path(startupScene));
 
@@ -0,0 +1,53 @@
+#include "stdafx.h"
+#include "Test.h"
+
+#include "Scene/Scene.h"
+#include "Scene/Entity.h"
+#include "Scene/Components.h"
+#include "Scene/EntityPool.h"
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// A prefab with an EntityPoolComponent gets a pre-warmed pool when the runtime starts, and loses it when it stops
+TEST(EntityPool, PrewarmedWhenRuntimeStarts)
+{
+	Scene scene("");
+	Entity prefab = scene.CreateEntity("Bullet");
+	prefab.AddComponent<TransformComponent>(Vector3f(1.0f, 0.0f, 0.0f));
+	prefab.AddComponent<EntityPoolComponent>(4);
+	Entity unpooled = scene.CreateEntity("Player");
+	unpooled.AddComponent<TransformComponent>();
+
+	const size_t entitiesBefore = scene.GetRegistry().alive();
+	CHECK(scene.GetEntityPool(prefab) == nullptr);
+
+	scene.MakeClean();
+	scene.OnRuntimeStart();
+
+	Ref<EntityPool> pool = scene.GetEntityPool(prefab);
+	CHECK(pool != nullptr);
+	CHECK(scene.GetEntityPool(unpooled) == nullptr);
+	if (pool)
+	{
+		CHECK_EQUAL((size_t)4, pool->GetParkedCount());
+		CHECK_EQUAL((size_t)0, pool->GetActiveCount());
+		CHECK_EQUAL(entitiesBefore + 4, scene.GetRegistry().alive());
+
+		// The instances are not prefabs of pools of their own
+		CHECK_EQUAL((size_t)1, scene.GetRegistry().view<EntityPoolComponent>().size());
+
+		Entity spawned = pool->Spawn(Vector3f(0.0f, 2.0f, 0.0f));
+		CHECK_EQUAL((size_t)3, pool->GetParkedCount());
+		CHECK_EQUAL((size_t)1, pool->GetActiveCount());
+		CHECK_EQUAL(entitiesBefore + 4, scene.GetRegistry().alive());
+
+		const Vector3f& position = spawned.GetComponent<TransformComponent>().position;
+		CHECK(position.x == 1.0f && position.y == 2.0f && position.z == 0.0f);
+	}
+	pool.reset();
+
+	scene.OnRuntimeStop();
+	CHECK(scene.GetEntityPool(prefab) == nullptr);
+	CHECK_EQUAL(entitiesBefore, scene.GetRegistry().alive());
+	CHECK_EQUAL((uint32_t)4, prefab.GetComponent<EntityPoolComponent>().prewarmCount);
+}
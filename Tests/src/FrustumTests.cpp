@@ -0,0 +1,131 @@
+#include "stdafx.h"
+#include "Test.h"
+
+#include "Core/Frustum.h"
+
+#include <cmath>
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static bool Near(float expected, float actual)
+{
+	return std::fabs(expected - actual) <= 1e-4f * std::max(1.0f, std::fabs(expected));
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static bool PlaneEquals(const Frustum& frustum, Frustum::Side side, const Vector3f& normal, float distance)
+{
+	const Frustum::ClipPlane& plane = frustum.GetPlane(side);
+	return Near(normal.x, plane.normal.x) && Near(normal.y, plane.normal.y) && Near(normal.z, plane.normal.z)
+		&& Near(distance, plane.distance);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// The side planes of a box 20 wide and 10 high, the near plane depends on the depth range of the projection so only
+// its direction is checked
+TEST(Frustum, OrthographicPlanes)
+{
+	Frustum frustum(Matrix4x4::OrthographicRH(-10.0f, 10.0f, -5.0f, 5.0f, -1.0f, 1.0f));
+
+	CHECK(PlaneEquals(frustum, Frustum::Side::Left, Vector3f(1.0f, 0.0f, 0.0f), 10.0f));
+	CHECK(PlaneEquals(frustum, Frustum::Side::Right, Vector3f(-1.0f, 0.0f, 0.0f), 10.0f));
+	CHECK(PlaneEquals(frustum, Frustum::Side::Bottom, Vector3f(0.0f, 1.0f, 0.0f), 5.0f));
+	CHECK(PlaneEquals(frustum, Frustum::Side::Top, Vector3f(0.0f, -1.0f, 0.0f), 5.0f));
+	CHECK(PlaneEquals(frustum, Frustum::Side::Far, Vector3f(0.0f, 0.0f, 1.0f), 1.0f));
+
+	const Frustum::ClipPlane& nearPlane = frustum.GetPlane(Frustum::Side::Near);
+	CHECK(Near(-1.0f, nearPlane.normal.z));
+	CHECK(nearPlane.distance >= 1.0f);
+
+	const BoundingBox& bounds = frustum.GetBounds();
+	CHECK(Near(-10.0f, bounds.Min().x) && Near(10.0f, bounds.Max().x));
+	CHECK(Near(-5.0f, bounds.Min().y) && Near(5.0f, bounds.Max().y));
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// A 90 degree field of view looking down -z, so each side plane is at 45 degrees to the view direction
+TEST(Frustum, PerspectivePlanes)
+{
+	static constexpr float s_NearDepth = 1.0f;
+	static constexpr float s_FarDepth = 100.0f;
+	const float diagonal = 1.0f / std::sqrt(2.0f);
+
+	Frustum frustum(Matrix4x4::PerspectiveRH((float)PI * 0.5f, 1.0f, s_NearDepth, s_FarDepth));
+
+	CHECK(PlaneEquals(frustum, Frustum::Side::Left, Vector3f(diagonal, 0.0f, -diagonal), 0.0f));
+	CHECK(PlaneEquals(frustum, Frustum::Side::Right, Vector3f(-diagonal, 0.0f, -diagonal), 0.0f));
+	CHECK(PlaneEquals(frustum, Frustum::Side::Bottom, Vector3f(0.0f, diagonal, -diagonal), 0.0f));
+	CHECK(PlaneEquals(frustum, Frustum::Side::Top, Vector3f(0.0f, -diagonal, -diagonal), 0.0f));
+	CHECK(PlaneEquals(frustum, Frustum::Side::Far, Vector3f(0.0f, 0.0f, 1.0f), s_FarDepth));
+
+	// Between the near plane and the eye for a 0 to 1 depth range, on the near plane for -1 to 1
+	const Frustum::ClipPlane& nearPlane = frustum.GetPlane(Frustum::Side::Near);
+	CHECK(Near(-1.0f, nearPlane.normal.z));
+	CHECK(nearPlane.distance <= 1e-4f && nearPlane.distance >= -s_NearDepth - 1e-4f);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+TEST(Frustum, OrthographicBoxes)
+{
+	Frustum frustum(Matrix4x4::OrthographicRH(-10.0f, 10.0f, -5.0f, 5.0f, -1.0f, 1.0f));
+
+	// Inside
+	CHECK(frustum.Intersects(BoundingBox(Vector3f(-1.0f, -1.0f, 0.0f), Vector3f(1.0f, 1.0f, 0.0f))));
+	CHECK(frustum.Intersects(BoundingBox(Vector3f(-9.0f, -4.0f, 0.0f), Vector3f(9.0f, 4.0f, 0.0f))));
+
+	// Outside each side
+	CHECK(!frustum.Intersects(BoundingBox(Vector3f(-22.0f, 0.0f, 0.0f), Vector3f(-20.0f, 1.0f, 0.0f))));
+	CHECK(!frustum.Intersects(BoundingBox(Vector3f(20.0f, 0.0f, 0.0f), Vector3f(22.0f, 1.0f, 0.0f))));
+	CHECK(!frustum.Intersects(BoundingBox(Vector3f(0.0f, -8.0f, 0.0f), Vector3f(1.0f, -6.0f, 0.0f))));
+	CHECK(!frustum.Intersects(BoundingBox(Vector3f(0.0f, 6.0f, 0.0f), Vector3f(1.0f, 8.0f, 0.0f))));
+	CHECK(!frustum.Intersects(BoundingBox(Vector3f(0.0f, 0.0f, -3.0f), Vector3f(1.0f, 1.0f, -2.0f))));
+
+	// Intersecting an edge, a corner, and enclosing the whole frustum
+	CHECK(frustum.Intersects(BoundingBox(Vector3f(9.0f, 0.0f, 0.0f), Vector3f(12.0f, 1.0f, 0.0f))));
+	CHECK(frustum.Intersects(BoundingBox(Vector3f(9.0f, 4.0f, 0.0f), Vector3f(12.0f, 6.0f, 0.0f))));
+	CHECK(frustum.Intersects(BoundingBox(Vector3f(-100.0f, -100.0f, -100.0f), Vector3f(100.0f, 100.0f, 100.0f))));
+
+	// Moving the camera moves the frustum with it
+	Frustum moved(Matrix4x4::OrthographicRH(-10.0f, 10.0f, -5.0f, 5.0f, -1.0f, 1.0f) * Matrix4x4::Inverse(Matrix4x4::Translate(Vector3f(100.0f, 0.0f, 0.0f))));
+	CHECK(!moved.Intersects(BoundingBox(Vector3f(-1.0f, -1.0f, 0.0f), Vector3f(1.0f, 1.0f, 0.0f))));
+	CHECK(moved.Intersects(BoundingBox(Vector3f(99.0f, -1.0f, 0.0f), Vector3f(101.0f, 1.0f, 0.0f))));
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+TEST(Frustum, PerspectiveBoxes)
+{
+	Frustum frustum(Matrix4x4::PerspectiveRH((float)PI * 0.5f, 1.0f, 1.0f, 100.0f));
+
+	// Inside, the view widens with distance so a box too wide to be seen up close fits further away
+	CHECK(frustum.Intersects(BoundingBox(Vector3f(-1.0f, -1.0f, -11.0f), Vector3f(1.0f, 1.0f, -9.0f))));
+	CHECK(frustum.Intersects(BoundingBox(Vector3f(30.0f, -1.0f, -51.0f), Vector3f(40.0f, 1.0f, -49.0f))));
+	CHECK(!frustum.Intersects(BoundingBox(Vector3f(30.0f, -1.0f, -11.0f), Vector3f(40.0f, 1.0f, -9.0f))));
+
+	// Outside, behind the eye, beyond the far plane and off to each side
+	CHECK(!frustum.Intersects(BoundingBox(Vector3f(-1.0f, -1.0f, 4.0f), Vector3f(1.0f, 1.0f, 6.0f))));
+	CHECK(!frustum.Intersects(BoundingBox(Vector3f(-1.0f, -1.0f, -201.0f), Vector3f(1.0f, 1.0f, -199.0f))));
+	CHECK(!frustum.Intersects(BoundingBox(Vector3f(-20.0f, -1.0f, -11.0f), Vector3f(-15.0f, 1.0f, -9.0f))));
+	CHECK(!frustum.Intersects(BoundingBox(Vector3f(-1.0f, 15.0f, -11.0f), Vector3f(1.0f, 20.0f, -9.0f))));
+
+	// Intersecting a side plane, and reaching from behind the eye through the near plane
+	CHECK(frustum.Intersects(BoundingBox(Vector3f(5.0f, -1.0f, -11.0f), Vector3f(15.0f, 1.0f, -9.0f))));
+	CHECK(frustum.Intersects(BoundingBox(Vector3f(-0.5f, -0.5f, -20.0f), Vector3f(0.5f, 0.5f, 5.0f))));
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// A frustum that hasn't been built from a matrix, and boxes without bounds, are never culled
+TEST(Frustum, InvalidInputsIntersect)
+{
+	const BoundingBox box(Vector3f(1000.0f, 1000.0f, 1000.0f), Vector3f(1001.0f, 1001.0f, 1001.0f));
+	CHECK(Frustum().Intersects(box));
+
+	Frustum frustum(Matrix4x4::OrthographicRH(-10.0f, 10.0f, -5.0f, 5.0f, -1.0f, 1.0f));
+	CHECK(!frustum.Intersects(box));
+	CHECK(frustum.Intersects(BoundingBox()));
+}
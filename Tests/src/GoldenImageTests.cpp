@@ -0,0 +1,237 @@
+#include "stdafx.h"
+#include "Test.h"
+#include "TestEnvironment.h"
+
+#include "Renderer/Renderer.h"
+#include "Renderer/Renderer2D.h"
+#include "Renderer/RenderCommand.h"
+#include "Renderer/FrameBuffer.h"
+#include "Renderer/Buffer.h"
+#include "Renderer/Shader.h"
+#include "Renderer/UniformBuffer.h"
+#include "Platform/Software/SoftwareFrameBuffer.h"
+
+#include <fstream>
+
+// Each scene is drawn by the software renderer and compared against the image of the same name in the image
+// directory. A missing reference is written there to be checked in, a mismatch writes <name>.actual.tga beside it
+static constexpr uint32_t s_ImageSize = 64;
+static constexpr int s_Tolerance = 2; // per channel, float results can differ slightly between compilers
+static const std::filesystem::path s_ImageDirectory = "data/GoldenImages";
+static const Colour s_ClearColour(0.1f, 0.1f, 0.15f, 1.0f);
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Reads the uncompressed 32 bit TGA images SoftwareFrameBuffer::WriteImage writes, in the frame buffer's pixel format
+static bool ReadImage(const std::filesystem::path& filepath, uint32_t& width, uint32_t& height, std::vector<uint32_t>& pixels)
+{
+	std::ifstream file(filepath, std::ios::in | std::ios::binary);
+	uint8_t header[18];
+	if (!file.read((char*)header, sizeof(header)) || header[2] != 2 || header[16] != 32)
+		return false;
+
+	width = header[12] | (header[13] << 8);
+	height = header[14] | (header[15] << 8);
+	file.ignore(header[0]);
+
+	std::vector<uint8_t> data((size_t)width * height * 4);
+	if (!file.read((char*)data.data(), data.size()))
+		return false;
+
+	pixels.resize((size_t)width * height);
+	for (size_t i = 0; i < pixels.size(); i++)
+	{
+		const uint8_t* bgra = &data[i * 4];
+		pixels[i] = bgra[2] | (bgra[1] << 8) | (bgra[0] << 16) | ((uint32_t)bgra[3] << 24);
+	}
+	return true;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static bool PixelsMatch(uint32_t expected, uint32_t actual)
+{
+	for (int shift = 0; shift < 32; shift += 8)
+	{
+		if (std::abs((int)((expected >> shift) & 0xff) - (int)((actual >> shift) & 0xff)) > s_Tolerance)
+			return false;
+	}
+	return true;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static void CheckImage(const SoftwareFrameBuffer& frameBuffer, const std::string& name)
+{
+	std::filesystem::path reference = s_ImageDirectory / (name + ".tga");
+	std::filesystem::path actual = s_ImageDirectory / (name + ".actual.tga");
+
+	uint32_t width = 0, height = 0;
+	std::vector<uint32_t> expected;
+	if (!ReadImage(reference, width, height, expected))
+	{
+		std::filesystem::create_directories(s_ImageDirectory);
+		frameBuffer.WriteImage(reference);
+		Test::Fail(__FILE__, __LINE__, "No reference image for " + name + ", wrote " + reference.string() + " to review and check in");
+		return;
+	}
+
+	if (width != frameBuffer.GetWidth() || height != frameBuffer.GetHeight())
+	{
+		frameBuffer.WriteImage(actual);
+		Test::Fail(__FILE__, __LINE__, name + " is a different size to its reference image");
+		return;
+	}
+
+	const uint32_t* pixels = frameBuffer.GetAttachmentData(0);
+	size_t mismatches = 0;
+	size_t first = 0;
+	for (size_t i = 0; i < expected.size(); i++)
+	{
+		if (!PixelsMatch(expected[i], pixels[i]) && mismatches++ == 0)
+			first = i;
+	}
+
+	if (mismatches > 0)
+	{
+		frameBuffer.WriteImage(actual);
+		Test::Fail(__FILE__, __LINE__, name + " has " + std::to_string(mismatches) + " pixels different to its reference image, the first at ("
+			+ std::to_string(first % width) + ", " + std::to_string(first / width) + "), wrote " + actual.string());
+	}
+	else
+	{
+		std::filesystem::remove(actual);
+	}
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Render into an image sized frame buffer with an identity camera, so positions are in clip space
+static void RenderImage(const std::string& name, const std::function<void()>& draw)
+{
+	CHECK(TestEnvironment::InitRenderer(true));
+
+	FrameBufferSpecification specification;
+	specification.width = s_ImageSize;
+	specification.height = s_ImageSize;
+	specification.attachments = { FrameBufferTextureFormat::RGBA8, FrameBufferTextureFormat::Depth };
+	Ref<FrameBuffer> frameBuffer = FrameBuffer::Create(specification);
+
+	SoftwareFrameBuffer* softwareFrameBuffer = dynamic_cast<SoftwareFrameBuffer*>(frameBuffer.get());
+	CHECK(softwareFrameBuffer != nullptr);
+	if (softwareFrameBuffer == nullptr)
+		return;
+
+	frameBuffer->Bind();
+	RenderCommand::SetClearColour(s_ClearColour);
+	RenderCommand::Clear();
+
+	Renderer::BeginScene(Matrix4x4(), Matrix4x4());
+	draw();
+	Renderer::EndScene();
+
+	frameBuffer->UnBind();
+	CheckImage(*softwareFrameBuffer, name);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Transform of a quad covering the pixels from (x0, y0) up to (x1, y1). The edges fall between pixel centres
+// so which pixels are covered doesn't depend on rounding
+static Matrix4x4 PixelRect(float x0, float y0, float x1, float y1, float depth)
+{
+	const float scale = 2.0f / (float)s_ImageSize;
+	return Matrix4x4::Translate(Vector3f((x0 + x1) * 0.5f * scale - 1.0f, (y0 + y1) * 0.5f * scale - 1.0f, depth))
+		* Matrix4x4::Scale(Vector3f((x1 - x0) * scale, (y1 - y0) * scale, 1.0f));
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Overlapping quads at different depths, the translucent one blends over what is behind it and the last one
+// drawn is hidden behind the first
+TEST(GoldenImage, Quads)
+{
+	RenderImage("Quads", []()
+		{
+			Renderer2D::DrawQuad(PixelRect(16, 8, 48, 40, 0.5f), Colour(1.0f, 0.0f, 0.0f, 1.0f));
+			Renderer2D::DrawQuad(PixelRect(32, 24, 56, 56, 0.0f), Colour(0.0f, 1.0f, 0.0f, 1.0f));
+			Renderer2D::DrawQuad(PixelRect(4, 28, 28, 60, -0.5f), Colour(0.0f, 0.0f, 1.0f, 0.5f));
+			Renderer2D::DrawQuad(PixelRect(40, 4, 60, 20, 0.75f), Colour(1.0f, 1.0f, 1.0f, 1.0f));
+		});
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+TEST(GoldenImage, Circles)
+{
+	RenderImage("Circles", []()
+		{
+			Renderer2D::DrawCircle(PixelRect(4, 36, 28, 60, 0.0f), Colour(1.0f, 0.5f, 0.0f, 1.0f), 1.0f, 0.005f);
+			Renderer2D::DrawCircle(PixelRect(36, 36, 60, 60, 0.0f), Colour(0.0f, 1.0f, 1.0f, 1.0f), 0.25f, 0.005f);
+			Renderer2D::DrawCircle(PixelRect(12, 2, 52, 34, 0.0f), Colour(1.0f, 0.0f, 1.0f, 1.0f), 1.0f, 0.5f);
+		});
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// One line per cap style of Renderer2D_Line.frag, from top to bottom butt, square, round and triangle
+TEST(GoldenImage, LineCaps)
+{
+	struct LineVertex
+	{
+		float clipCoord[3];
+		float colour[4];
+		float texCoord[2];
+		float width;
+		float length;
+	};
+
+	// Renderer2D::DrawLine doesn't project its end points, so the quads it would build are laid out here in clip space.
+	// The half width isn't a whole or half pixel so no pixel centre lands exactly on the edge of a cap
+	constexpr float start = 16.0f, end = 48.0f, halfWidth = 5.75f;
+	const Colour colours[] = { Colour(1.0f, 1.0f, 1.0f, 1.0f), Colour(1.0f, 1.0f, 0.0f, 1.0f), Colour(0.0f, 1.0f, 0.5f, 1.0f), Colour(0.5f, 0.5f, 1.0f, 1.0f) };
+	const Renderer2D::LineCaps caps[] = { Renderer2D::LineCaps::Butt, Renderer2D::LineCaps::Square, Renderer2D::LineCaps::Round, Renderer2D::LineCaps::Triangle };
+
+	RenderImage("LineCaps", [&]()
+		{
+			Ref<Shader> shader = Shader::Create("Renderer2D_Line");
+			Ref<UniformBuffer> uniformBuffer = UniformBuffer::Create(sizeof(int) * 4, 3);
+
+			uint32_t indices[] = { 0, 1, 2, 2, 3, 0 };
+			Ref<IndexBuffer> indexBuffer = IndexBuffer::Create(indices, 6);
+
+			for (int i = 0; i < 4; i++)
+			{
+				const float y = 56.0f - 16.0f * (float)i;
+				const float corners[4][2] = { { -1.0f, -1.0f }, { 1.0f, -1.0f }, { 1.0f, 1.0f }, { -1.0f, 1.0f } };
+
+				LineVertex vertices[4];
+				for (int corner = 0; corner < 4; corner++)
+				{
+					float u = corners[corner][0] < 0.0f ? -halfWidth : end - start + halfWidth;
+					float v = corners[corner][1] * halfWidth;
+					vertices[corner] = {
+						{ (start + u) * 2.0f / (float)s_ImageSize - 1.0f, (y + v) * 2.0f / (float)s_ImageSize - 1.0f, 0.0f },
+						{ colours[i].r, colours[i].g, colours[i].b, colours[i].a },
+						{ u, v }, 2.0f * halfWidth, end - start };
+				}
+
+				Ref<VertexBuffer> vertexBuffer = VertexBuffer::Create(vertices, sizeof(vertices));
+				vertexBuffer->SetLayout({
+					{ShaderDataType::Float3, "a_clipCoord"},
+					{ShaderDataType::Float4, "a_colour"},
+					{ShaderDataType::Float2, "a_texcoord"},
+					{ShaderDataType::Float, "a_width"},
+					{ShaderDataType::Float, "a_length"}
+					});
+
+				int lineCaps[4] = { (int)caps[i], 0, 0, 0 };
+				uniformBuffer->SetData(lineCaps, sizeof(lineCaps));
+
+				vertexBuffer->Bind();
+				indexBuffer->Bind();
+				shader->Bind();
+				RenderCommand::DrawIndexed(6, 0, 0, false);
+			}
+		});
+}
@@ -0,0 +1,262 @@
+#include "stdafx.h"
+#include "Test.h"
+
+#include "Scene/Scene.h"
+#include "Scene/Entity.h"
+#include "Scene/Components.h"
+#include "Scene/SceneGraph.h"
+#include "Scene/Prefab.h"
+#include "AI/BehaviorTree.h"
+#include "AI/Decorators.h"
+#include "AI/Tasks.h"
+
+#include <unordered_set>
+
+static const std::vector<Vector3f> s_Positions = { Vector3f(10.0f, 0.0f, 0.0f), Vector3f(0.0f, -5.0f, 1.0f), Vector3f(2.5f, 2.5f, 0.0f) };
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// A root with two children, the first of which has a child of its own
+static Entity CreateSource(Scene& scene)
+{
+	Entity root = scene.CreateEntity("Root");
+	root.AddComponent<TransformComponent>(Vector3f(1.0f, 2.0f, 3.0f));
+
+	Entity left = scene.CreateEntity("Left");
+	left.AddComponent<TransformComponent>(Vector3f(-1.0f, 0.0f, 0.0f));
+	SceneGraph::Reparent(left, root);
+
+	Entity right = scene.CreateEntity("Right");
+	right.AddComponent<TransformComponent>(Vector3f(1.0f, 0.0f, 0.0f));
+	SceneGraph::Reparent(right, root);
+
+	Entity leaf = scene.CreateEntity("Leaf");
+	leaf.AddComponent<TransformComponent>(Vector3f(0.0f, 1.0f, 0.0f));
+	SceneGraph::Reparent(leaf, left);
+
+	return root;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// The names of the entity and its descendants in hierarchy order, like Root(Left(Leaf),Right)
+static std::string Describe(Entity entity)
+{
+	std::string description = entity.GetComponent<NameComponent>().name;
+	std::vector<Entity> children = SceneGraph::GetChildren(entity);
+	if (children.empty())
+		return description;
+
+	description += "(";
+	for (size_t i = 0; i < children.size(); i++)
+	{
+		if (i > 0)
+			description += ",";
+		description += Describe(children[i]);
+	}
+	return description + ")";
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Every entity of each instance is linked only to entities of the same instance, and the links agree with each other
+TEST(Prefab, InstanceHierarchyLinks)
+{
+	Scene scene("");
+	Entity source = CreateSource(scene);
+	Prefab prefab(source);
+	CHECK_EQUAL((size_t)4, prefab.GetEntityCount());
+
+	std::vector<entt::entity> entities;
+	scene.InstantiatePrefab(prefab, s_Positions, entities);
+	CHECK_EQUAL(prefab.GetEntityCount() * s_Positions.size(), entities.size());
+
+	entt::registry& registry = scene.GetRegistry();
+	const size_t nodeCount = prefab.GetEntityCount();
+	for (size_t first = 0; first < entities.size(); first += nodeCount)
+	{
+		std::unordered_set<entt::entity> instance(entities.begin() + first, entities.begin() + first + nodeCount);
+		auto inInstance = [&instance](entt::entity entity) { return entity == entt::null || instance.count(entity) > 0; };
+
+		Entity root(entities[first], &scene);
+		CHECK_EQUAL(Describe(source), Describe(root));
+
+		const HierarchyComponent& rootHierarchy = registry.get<HierarchyComponent>(entities[first]);
+		CHECK(rootHierarchy.parent == entt::null);
+		CHECK(rootHierarchy.previousSibling == entt::null);
+		CHECK(rootHierarchy.nextSibling == entt::null);
+
+		for (entt::entity entity : instance)
+		{
+			const HierarchyComponent& hierarchyComp = registry.get<HierarchyComponent>(entity);
+			CHECK(inInstance(hierarchyComp.parent));
+			CHECK(inInstance(hierarchyComp.firstChild));
+			CHECK(inInstance(hierarchyComp.previousSibling));
+			CHECK(inInstance(hierarchyComp.nextSibling));
+
+			if (hierarchyComp.firstChild != entt::null)
+				CHECK(registry.get<HierarchyComponent>(hierarchyComp.firstChild).parent == entity);
+			if (hierarchyComp.nextSibling != entt::null)
+				CHECK(registry.get<HierarchyComponent>(hierarchyComp.nextSibling).previousSibling == entity);
+		}
+	}
+
+	// The source is left as it was
+	CHECK_EQUAL(std::string("Root(Left(Leaf),Right)"), Describe(source));
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+TEST(Prefab, InstancesGetFreshUuids)
+{
+	Scene scene("");
+	Prefab prefab(CreateSource(scene));
+
+	std::vector<entt::entity> entities;
+	scene.InstantiatePrefab(prefab, s_Positions, entities);
+	scene.InstantiatePrefab(prefab, s_Positions, entities);
+
+	// Each id is only seen once across the source and every instance
+	std::unordered_set<Uuid> ids;
+	size_t count = 0;
+	scene.GetRegistry().view<IDComponent>().each([&](const IDComponent& idComp)
+		{
+			ids.insert(idComp.ID);
+			count++;
+		});
+
+	CHECK_EQUAL(prefab.GetEntityCount() * (2 * s_Positions.size() + 1), count);
+	CHECK_EQUAL(count, ids.size());
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// The root is moved by the position of the instance and its children keep their positions relative to it
+TEST(Prefab, RootOffsetByPosition)
+{
+	Scene scene("");
+	Entity source = CreateSource(scene);
+	Prefab prefab(source);
+
+	std::vector<Entity> roots = scene.InstantiatePrefab(prefab, s_Positions);
+	CHECK_EQUAL(s_Positions.size(), roots.size());
+
+	const Vector3f& sourcePosition = source.GetComponent<TransformComponent>().position;
+	std::vector<Entity> sourceChildren = SceneGraph::GetChildren(source);
+	for (size_t i = 0; i < roots.size() && i < s_Positions.size(); i++)
+	{
+		const Vector3f& position = roots[i].GetComponent<TransformComponent>().position;
+		CHECK_EQUAL(sourcePosition.x + s_Positions[i].x, position.x);
+		CHECK_EQUAL(sourcePosition.y + s_Positions[i].y, position.y);
+		CHECK_EQUAL(sourcePosition.z + s_Positions[i].z, position.z);
+
+		std::vector<Entity> children = SceneGraph::GetChildren(roots[i]);
+		CHECK_EQUAL(sourceChildren.size(), children.size());
+		for (size_t child = 0; child < children.size() && child < sourceChildren.size(); child++)
+		{
+			const Vector3f& expected = sourceChildren[child].GetComponent<TransformComponent>().position;
+			const Vector3f& actual = children[child].GetComponent<TransformComponent>().position;
+			CHECK(expected.x == actual.x && expected.y == actual.y && expected.z == actual.z);
+		}
+	}
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// InstantiateEntity reuses the prefab it compiled until the source entities change
+TEST(Prefab, InstantiateEntityFollowsSourceChanges)
+{
+	Scene scene("");
+	Entity source = CreateSource(scene);
+	Entity right = SceneGraph::GetChildren(source).back();
+
+	Entity instance = scene.InstantiateEntity(source, Vector3f());
+	CHECK_EQUAL(std::string("Root(Left(Leaf),Right)"), Describe(instance));
+	CHECK(!instance.HasComponent<SpriteComponent>());
+
+	source.AddComponent<SpriteComponent>();
+	CHECK(scene.InstantiateEntity(source, Vector3f()).HasComponent<SpriteComponent>());
+
+	Entity extra = scene.CreateEntity("Extra");
+	extra.AddComponent<TransformComponent>();
+	SceneGraph::Reparent(extra, right);
+	CHECK_EQUAL(std::string("Root(Left(Leaf),Right(Extra))"), Describe(scene.InstantiateEntity(source, Vector3f())));
+
+	extra.SetName("Renamed");
+	CHECK_EQUAL(std::string("Root(Left(Leaf),Right(Renamed))"), Describe(scene.InstantiateEntity(source, Vector3f())));
+
+	scene.RemoveEntity(extra);
+	CHECK_EQUAL(std::string("Root(Left(Leaf),Right)"), Describe(scene.InstantiateEntity(source, Vector3f())));
+
+	scene.GetRegistry().patch<TransformComponent>(source, [](TransformComponent& transformComp) { transformComp.position.x = 5.0f; });
+	CHECK_EQUAL(5.0f, scene.InstantiateEntity(source, Vector3f()).GetComponent<TransformComponent>().position.x);
+
+	// Changes to the instances leave the prefab as it is
+	instance.AddComponent<CircleRendererComponent>();
+	CHECK(!scene.InstantiateEntity(source, Vector3f()).HasComponent<CircleRendererComponent>());
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// A blackboard check with a leaf under it, the check passes while the tree's "Ready" value is set
+static Ref<BehaviourTree::BehaviourTree> CreateTree()
+{
+	Ref<BehaviourTree::BehaviourTree> tree = CreateRef<BehaviourTree::BehaviourTree>();
+	tree->getBlackboard()->setBool("Ready", true);
+
+	Ref<BehaviourTree::BlackboardBool> check = CreateRef<BehaviourTree::BlackboardBool>(tree->getBlackboard(), "Ready", true);
+	check->setChild(CreateRef<BehaviourTree::Wait>(tree.get(), 0.0f));
+	tree->setRoot(check);
+	return tree;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// The tree keeps the blackboard and the running nodes so each instance gets a copy of its own. The file the
+// component names doesn't exist, so the copies can only have come from the tree in memory
+TEST(Prefab, InstancesCopyTheBehaviourTreeWithoutTheFile)
+{
+	static constexpr size_t s_InstanceCount = 50;
+
+	Scene scene("");
+	Entity source = CreateSource(scene);
+	BehaviourTreeComponent& sourceComp = source.AddComponent<BehaviourTreeComponent>();
+	sourceComp.filepath = std::filesystem::temp_directory_path() / "PrefabTests" / "Missing.behaviourtree";
+	sourceComp.behaviourTree = CreateTree();
+	CHECK(!std::filesystem::exists(sourceComp.filepath));
+
+	std::vector<Entity> roots = scene.InstantiatePrefab(Prefab(source), std::vector<Vector3f>(s_InstanceCount));
+	for (size_t i = 0; i < s_InstanceCount; i++)
+	{
+		roots.push_back(scene.InstantiateEntity(source, Vector3f()));
+	}
+	CHECK_EQUAL(2 * s_InstanceCount, roots.size());
+
+	std::unordered_set<BehaviourTree::BehaviourTree*> trees = { sourceComp.behaviourTree.get() };
+	std::unordered_set<BehaviourTree::Blackboard*> blackboards = { sourceComp.behaviourTree->getBlackboard().get() };
+	for (Entity root : roots)
+	{
+		const BehaviourTreeComponent& instanceComp = root.GetComponent<BehaviourTreeComponent>();
+		CHECK(instanceComp.behaviourTree != nullptr);
+		if (instanceComp.behaviourTree == nullptr)
+			continue;
+
+		CHECK(instanceComp.behaviourTree->getRoot() != nullptr);
+		CHECK(instanceComp.behaviourTree->getRoot() != sourceComp.behaviourTree->getRoot());
+		CHECK(instanceComp.behaviourTree->getBlackboard()->getBool("Ready"));
+		trees.insert(instanceComp.behaviourTree.get());
+		blackboards.insert(instanceComp.behaviourTree->getBlackboard().get());
+	}
+
+	CHECK_EQUAL(roots.size() + 1, trees.size());
+	CHECK_EQUAL(roots.size() + 1, blackboards.size());
+
+	// The copied check reads the blackboard of its own tree
+	Ref<BehaviourTree::BehaviourTree> instanceTree = roots.front().GetComponent<BehaviourTreeComponent>().behaviourTree;
+	if (instanceTree)
+	{
+		instanceTree->getBlackboard()->setBool("Ready", false);
+		CHECK(instanceTree->tick(0.1f) == BehaviourTree::Node::Status::Failure);
+		CHECK(sourceComp.behaviourTree->tick(0.1f) == BehaviourTree::Node::Status::Success);
+	}
+}
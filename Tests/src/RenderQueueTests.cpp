@@ -0,0 +1,311 @@
+#include "stdafx.h"
+#include "Test.h"
+#include "TestEnvironment.h"
+
+#include "Renderer/RenderQueue.h"
+#include "Renderer/Renderer.h"
+#include "Renderer/RenderCommand.h"
+#include "Renderer/Material.h"
+#include "Platform/Null/NullRendererAPI.h"
+#include "Utilities/GeometryGenerator.h"
+
+static DrawCommand MakeCommand(RenderQueue::Pass pass, uint32_t shaderId, uint32_t materialId, uint32_t meshId, uint32_t submeshIndex, float depth, int entityId)
+{
+	DrawCommand command;
+	command.sortKey = RenderQueue::MakeSortKey(pass, shaderId, materialId, meshId, submeshIndex, depth);
+	command.entityId = entityId;
+	return command;
+}
+
+static std::vector<int> SortedEntityIds(const RenderQueue& queue)
+{
+	std::vector<int> ids;
+	queue.ForEach([&ids](const DrawCommand& command) { ids.push_back(command.entityId); });
+	return ids;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+TEST(RenderQueue, OpaqueGroupedByShaderThenMaterialThenMesh)
+{
+	RenderQueue queue;
+	queue.Submit(MakeCommand(RenderQueue::Pass::Opaque, 1, 0, 0, 0, 1.0f, 4));
+	queue.Submit(MakeCommand(RenderQueue::Pass::Opaque, 0, 1, 0, 0, 1.0f, 2));
+	queue.Submit(MakeCommand(RenderQueue::Pass::Opaque, 0, 0, 1, 0, 1.0f, 1));
+	queue.Submit(MakeCommand(RenderQueue::Pass::Opaque, 0, 0, 0, 0, 1.0f, 0));
+	queue.Submit(MakeCommand(RenderQueue::Pass::Opaque, 0, 1, 1, 0, 1.0f, 3));
+	queue.Sort();
+
+	CHECK(SortedEntityIds(queue) == std::vector<int>({ 0, 1, 2, 3, 4 }));
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+TEST(RenderQueue, OpaqueFrontToBackWithinState)
+{
+	RenderQueue queue;
+	queue.Submit(MakeCommand(RenderQueue::Pass::Opaque, 0, 0, 0, 0, 50.0f, 2));
+	queue.Submit(MakeCommand(RenderQueue::Pass::Opaque, 0, 0, 0, 0, 0.5f, 0));
+	queue.Submit(MakeCommand(RenderQueue::Pass::Opaque, 0, 0, 0, 0, 10.0f, 1));
+	queue.Sort();
+
+	CHECK(SortedEntityIds(queue) == std::vector<int>({ 0, 1, 2 }));
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Submeshes of one mesh with the same material are grouped before they are sorted by depth, so each can be instanced
+TEST(RenderQueue, OpaqueGroupedBySubmeshBeforeDepth)
+{
+	RenderQueue queue;
+	queue.Submit(MakeCommand(RenderQueue::Pass::Opaque, 0, 0, 0, 1, 1.0f, 2));
+	queue.Submit(MakeCommand(RenderQueue::Pass::Opaque, 0, 0, 0, 0, 2.0f, 0));
+	queue.Submit(MakeCommand(RenderQueue::Pass::Opaque, 0, 0, 0, 1, 3.0f, 3));
+	queue.Submit(MakeCommand(RenderQueue::Pass::Opaque, 0, 0, 0, 0, 4.0f, 1));
+	queue.Sort();
+
+	CHECK(SortedEntityIds(queue) == std::vector<int>({ 0, 1, 2, 3 }));
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+TEST(RenderQueue, TransparentBackToFrontAfterOpaque)
+{
+	RenderQueue queue;
+	queue.Submit(MakeCommand(RenderQueue::Pass::Transparent, 0, 0, 0, 0, 1.0f, 3));
+	queue.Submit(MakeCommand(RenderQueue::Pass::Transparent, 5, 5, 5, 0, 100.0f, 1));
+	queue.Submit(MakeCommand(RenderQueue::Pass::Opaque, 3, 3, 3, 0, 1000.0f, 0));
+	queue.Submit(MakeCommand(RenderQueue::Pass::Transparent, 0, 0, 0, 0, 10.0f, 2));
+	queue.Sort();
+
+	CHECK(SortedEntityIds(queue) == std::vector<int>({ 0, 1, 2, 3 }));
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+TEST(RenderQueue, NegativeDepthSortsFirst)
+{
+	RenderQueue queue;
+	queue.Submit(MakeCommand(RenderQueue::Pass::Opaque, 0, 0, 0, 0, 2.0f, 1));
+	queue.Submit(MakeCommand(RenderQueue::Pass::Opaque, 0, 0, 0, 0, -4.0f, 0));
+	queue.Sort();
+
+	CHECK(SortedEntityIds(queue) == std::vector<int>({ 0, 1 }));
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+TEST(RenderQueue, SortIsStableForEqualKeys)
+{
+	RenderQueue queue;
+	for (int i = 0; i < 1000; i++)
+		queue.Submit(MakeCommand(RenderQueue::Pass::Opaque, 0, 0, 0, 0, 1.0f, i));
+	queue.Sort();
+
+	std::vector<int> ids = SortedEntityIds(queue);
+	CHECK(std::is_sorted(ids.begin(), ids.end()));
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Two materials sharing a shader and a mesh, submitted interleaved. Sorting groups each material's draws so the
+// shader and mesh are bound once and each material once, and every other bind the draws would need is skipped
+TEST(RenderQueue, RedundantBindsAreSkipped)
+{
+	CHECK(TestEnvironment::InitRenderer());
+
+	NullRendererAPI* api = dynamic_cast<NullRendererAPI*>(RenderCommand::GetRendererAPI());
+	CHECK(api != nullptr);
+	if (api == nullptr)
+		return;
+
+	Ref<Mesh> mesh = GeometryGenerator::CreateCube(1.0f, 1.0f, 1.0f);
+	Ref<Material> red = CreateRef<Material>("Standard", Colours::RED);
+	Ref<Material> blue = CreateRef<Material>("Standard", Colours::BLUE);
+
+	Renderer::ResetStats();
+	api->ClearRecording();
+
+	Renderer::BeginScene(Matrix4x4(), Matrix4x4());
+	for (int i = 0; i < 6; i++)
+	{
+		// A non zero index count skips the culling, the camera is not what is being tested
+		Renderer::Submit(mesh, i % 2 == 0 ? red : blue, Matrix4x4::Translate(Vector3f((float)i, 0.0f, 0.0f)), i, mesh->GetIndexCount());
+	}
+	Renderer::EndScene();
+
+	// Each material's three draws become one instanced draw
+	const Renderer::Stats& stats = Renderer::GetStats();
+	CHECK_EQUAL(2u, stats.drawCalls);
+	CHECK_EQUAL(1u, stats.shaderBinds);
+	CHECK_EQUAL(2u, stats.materialBinds);
+	CHECK_EQUAL(1u, stats.meshBinds);
+
+	// Six draws each needing a shader, material and mesh would make 18 binds
+	CHECK_EQUAL(18u - stats.shaderBinds - stats.materialBinds - stats.meshBinds, stats.stateChangesAvoided);
+	CHECK_EQUAL(14u, stats.stateChangesAvoided);
+
+	// The null API records the draws in the order they were made
+	CHECK_EQUAL((size_t)2, api->GetDrawCalls().size());
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// The instance counts of the draws the null API recorded, in the order they were made
+static std::vector<uint32_t> RecordedInstanceCounts(const NullRendererAPI& api)
+{
+	std::vector<uint32_t> counts;
+	for (const NullRendererAPI::DrawCall& drawCall : api.GetDrawCalls())
+		counts.push_back(drawCall.instanceCount);
+	return counts;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static DrawCommand MakeDrawCommand(const Ref<Mesh>& mesh, const Ref<Material>& material, uint32_t startIndex)
+{
+	DrawCommand command;
+	command.mesh = mesh.get();
+	command.material = material.get();
+	command.indexCount = 36;
+	command.startIndex = startIndex;
+	return command;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+TEST(RenderQueue, CanBatchOnlyTheSameRangeAndMaterial)
+{
+	CHECK(TestEnvironment::InitRenderer());
+
+	Ref<Mesh> cube = GeometryGenerator::CreateCube(1.0f, 1.0f, 1.0f);
+	Ref<Mesh> sphere = GeometryGenerator::CreateSphere(1.0f, 8, 8);
+	Ref<Material> red = CreateRef<Material>("Standard", Colours::RED);
+	Ref<Material> blue = CreateRef<Material>("Standard", Colours::BLUE);
+
+	CHECK(RenderQueue::CanBatch(MakeDrawCommand(cube, red, 0), MakeDrawCommand(cube, red, 0)));
+	CHECK(!RenderQueue::CanBatch(MakeDrawCommand(cube, red, 0), MakeDrawCommand(cube, blue, 0)));
+	CHECK(!RenderQueue::CanBatch(MakeDrawCommand(cube, red, 0), MakeDrawCommand(sphere, red, 0)));
+	CHECK(!RenderQueue::CanBatch(MakeDrawCommand(cube, red, 0), MakeDrawCommand(cube, red, 36)));
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// 300 draws of one mesh and material are drawn as instanced draws of at most 128 instances
+TEST(RenderQueue, InstancedDrawsSplitAtMaxInstances)
+{
+	CHECK(TestEnvironment::InitRenderer());
+
+	NullRendererAPI* api = dynamic_cast<NullRendererAPI*>(RenderCommand::GetRendererAPI());
+	CHECK(api != nullptr);
+	if (api == nullptr)
+		return;
+
+	Ref<Mesh> mesh = GeometryGenerator::CreateCube(1.0f, 1.0f, 1.0f);
+	Ref<Material> material = CreateRef<Material>("Standard", Colours::RED);
+
+	Renderer::ResetStats();
+	api->ClearRecording();
+
+	Renderer::BeginScene(Matrix4x4(), Matrix4x4());
+	for (int i = 0; i < 300; i++)
+	{
+		Renderer::Submit(mesh, material, Matrix4x4::Translate(Vector3f((float)i, 0.0f, 0.0f)), i, mesh->GetIndexCount());
+	}
+	Renderer::EndScene();
+
+	CHECK(RecordedInstanceCounts(*api) == std::vector<uint32_t>({ 128, 128, 44 }));
+
+	const Renderer::Stats& stats = Renderer::GetStats();
+	CHECK_EQUAL(3u, stats.drawCalls);
+	CHECK_EQUAL(3u, stats.instancedDrawCalls);
+	CHECK_EQUAL(300u, stats.instances);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Interleaved draws of two meshes with two materials are sorted into one run per mesh and material. A run of one
+// is drawn without instancing
+TEST(RenderQueue, InstancedDrawsSplitOnMaterialAndMesh)
+{
+	CHECK(TestEnvironment::InitRenderer());
+
+	NullRendererAPI* api = dynamic_cast<NullRendererAPI*>(RenderCommand::GetRendererAPI());
+	CHECK(api != nullptr);
+	if (api == nullptr)
+		return;
+
+	Ref<Mesh> cube = GeometryGenerator::CreateCube(1.0f, 1.0f, 1.0f);
+	Ref<Mesh> sphere = GeometryGenerator::CreateSphere(1.0f, 8, 8);
+	Ref<Material> red = CreateRef<Material>("Standard", Colours::RED);
+	Ref<Material> blue = CreateRef<Material>("Standard", Colours::BLUE);
+
+	Renderer::ResetStats();
+	api->ClearRecording();
+
+	// Ids are handed out in submission order, so red sorts before blue and the cube before the sphere
+	Renderer::BeginScene(Matrix4x4(), Matrix4x4());
+	int entityId = 0;
+	auto submit = [&entityId](const Ref<Mesh>& mesh, const Ref<Material>& material, int count)
+	{
+		for (int i = 0; i < count; i++, entityId++)
+			Renderer::Submit(mesh, material, Matrix4x4::Translate(Vector3f((float)entityId, 0.0f, 0.0f)), entityId, mesh->GetIndexCount());
+	};
+	submit(cube, red, 2);
+	submit(sphere, red, 1);
+	submit(cube, blue, 3);
+	submit(sphere, red, 3);
+	submit(cube, red, 3);
+	submit(sphere, blue, 1);
+	Renderer::EndScene();
+
+	CHECK(RecordedInstanceCounts(*api) == std::vector<uint32_t>({ 5, 4, 3, 1 }));
+
+	const std::vector<NullRendererAPI::DrawCall>& drawCalls = api->GetDrawCalls();
+	if (drawCalls.size() == 4)
+	{
+		CHECK_EQUAL(cube->GetIndexCount(), drawCalls[0].indexCount);
+		CHECK_EQUAL(sphere->GetIndexCount(), drawCalls[1].indexCount);
+		CHECK_EQUAL(cube->GetIndexCount(), drawCalls[2].indexCount);
+		CHECK_EQUAL(sphere->GetIndexCount(), drawCalls[3].indexCount);
+	}
+
+	const Renderer::Stats& stats = Renderer::GetStats();
+	CHECK_EQUAL(4u, stats.drawCalls);
+	CHECK_EQUAL(3u, stats.instancedDrawCalls);
+	CHECK_EQUAL(12u, stats.instances);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// A range of a mesh is passed to the API with the same start index whether or not it is instanced
+TEST(RenderQueue, StartIndexSameForInstancedAndSingleDraws)
+{
+	CHECK(TestEnvironment::InitRenderer());
+
+	NullRendererAPI* api = dynamic_cast<NullRendererAPI*>(RenderCommand::GetRendererAPI());
+	CHECK(api != nullptr);
+	if (api == nullptr)
+		return;
+
+	Ref<Mesh> mesh = GeometryGenerator::CreateCube(1.0f, 1.0f, 1.0f);
+	Ref<Material> red = CreateRef<Material>("Standard", Colours::RED);
+	Ref<Material> blue = CreateRef<Material>("Standard", Colours::BLUE);
+
+	api->ClearRecording();
+
+	Renderer::BeginScene(Matrix4x4(), Matrix4x4());
+	Renderer::Submit(mesh, red, Matrix4x4::Translate(Vector3f(0.0f, 0.0f, 0.0f)), 0, 6, 12, 0, 2);
+	Renderer::Submit(mesh, red, Matrix4x4::Translate(Vector3f(1.0f, 0.0f, 0.0f)), 1, 6, 12, 0, 2);
+	Renderer::Submit(mesh, blue, Matrix4x4::Translate(Vector3f(2.0f, 0.0f, 0.0f)), 2, 6, 12, 0, 2);
+	Renderer::EndScene();
+
+	const std::vector<NullRendererAPI::DrawCall>& drawCalls = api->GetDrawCalls();
+	CHECK_EQUAL((size_t)2, drawCalls.size());
+	for (const NullRendererAPI::DrawCall& drawCall : drawCalls)
+	{
+		CHECK_EQUAL(6u, drawCall.indexCount);
+		CHECK_EQUAL(12u, drawCall.startIndex);
+	}
+	CHECK(RecordedInstanceCounts(*api) == std::vector<uint32_t>({ 2, 1 }));
+}
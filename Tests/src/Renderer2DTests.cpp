@@ -0,0 +1,191 @@
+#include "stdafx.h"
+#include "Test.h"
+#include "TestEnvironment.h"
+
+#include "Renderer/Renderer.h"
+#include "Renderer/Renderer2D.h"
+#include "Renderer/RenderCommand.h"
+#include "Renderer/TextureAtlas.h"
+#include "Platform/Null/NullRendererAPI.h"
+#include "Core/ThreadPool.h"
+
+static constexpr size_t s_QuadCount = 25000; // spans a few batches
+static constexpr size_t s_TextureCount = 48; // more than fit in a batch's texture slots
+
+struct TestQuad
+{
+	Matrix4x4 transform;
+	Ref<Texture> texture;
+	Colour colour;
+	bool circle = false;
+};
+
+static std::vector<TestQuad> MakeQuads()
+{
+	std::vector<Ref<Texture>> textures;
+	for (size_t i = 0; i < s_TextureCount; i++)
+		textures.push_back(Texture2D::Create(4, 4));
+
+	std::vector<TestQuad> quads(s_QuadCount);
+	for (size_t i = 0; i < s_QuadCount; i++)
+	{
+		TestQuad& quad = quads[i];
+		quad.transform = Matrix4x4::Translate(Vector3f((float)(i % 160), (float)(i / 160), 0.0f));
+		quad.texture = i % 5 == 0 ? nullptr : textures[(i * 7) % s_TextureCount];
+		quad.colour = Colour((float)(i % 3) * 0.5f, (float)(i % 7) / 6.0f, 1.0f, 1.0f);
+		quad.circle = i % 11 == 0;
+	}
+	return quads;
+}
+
+static std::vector<NullRendererAPI::DrawCall> Record(NullRendererAPI* api, const std::function<void()>& draw)
+{
+	api->ClearRecording();
+	Renderer::BeginScene(Matrix4x4(), Matrix4x4());
+	draw();
+	Renderer::EndScene();
+	return api->GetDrawCalls();
+}
+
+static void DrawDirect(const std::vector<TestQuad>& quads)
+{
+	for (size_t i = 0; i < quads.size(); i++)
+	{
+		const TestQuad& quad = quads[i];
+		if (quad.circle)
+			Renderer2D::DrawCircle(quad.transform, quad.colour, 1.0f, 0.005f, (int)i);
+		else if (quad.texture)
+			Renderer2D::DrawQuad(quad.transform, quad.texture, quad.colour, 1.0f, (int)i);
+		else
+			Renderer2D::DrawQuad(quad.transform, quad.colour, (int)i);
+	}
+}
+
+// Fill one context per chunk across the thread pool then submit them in order, the same as the scene does
+static void DrawWithContexts(const std::vector<TestQuad>& quads, size_t chunkCount)
+{
+	std::vector<Renderer2D::SubmissionContext> contexts(chunkCount);
+
+	ThreadPool::ParallelFor(chunkCount, 1, [&](size_t begin, size_t end)
+		{
+			for (size_t chunk = begin; chunk < end; chunk++)
+			{
+				size_t first = chunk * quads.size() / chunkCount;
+				size_t last = (chunk + 1) * quads.size() / chunkCount;
+				for (size_t i = first; i < last; i++)
+				{
+					const TestQuad& quad = quads[i];
+					if (quad.circle)
+						contexts[chunk].DrawCircle(quad.transform, quad.colour, 1.0f, 0.005f, (int)i);
+					else if (quad.texture)
+						contexts[chunk].DrawQuad(quad.transform, quad.texture, quad.colour, 1.0f, (int)i);
+					else
+						contexts[chunk].DrawQuad(quad.transform, quad.colour, (int)i);
+				}
+			}
+		});
+
+	for (Renderer2D::SubmissionContext& context : contexts)
+		Renderer2D::Submit(context);
+}
+
+static void CheckSameDraws(const std::vector<NullRendererAPI::DrawCall>& expected, const std::vector<NullRendererAPI::DrawCall>& actual)
+{
+	CHECK_EQUAL(expected.size(), actual.size());
+	for (size_t i = 0; i < std::min(expected.size(), actual.size()); i++)
+	{
+		CHECK_EQUAL(expected[i].indexCount, actual[i].indexCount);
+		CHECK_EQUAL(expected[i].vertexDataHash, actual[i].vertexDataHash);
+	}
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Recording into contexts on the worker threads must upload the same vertices in the same draws as drawing directly,
+// including where the batches break because the texture slots run out
+TEST(Renderer2D, SubmissionContextsMatchDirectDrawing)
+{
+	CHECK(TestEnvironment::InitRenderer());
+
+	NullRendererAPI* api = dynamic_cast<NullRendererAPI*>(RenderCommand::GetRendererAPI());
+	CHECK(api != nullptr);
+	if (api == nullptr)
+		return;
+
+	// Atlas pages and texture arrays would hide the texture slot limit
+	bool atlasEnabled = TextureAtlas::IsEnabled();
+	TextureAtlas::SetEnabled(false);
+	Renderer2D::TextureBatching textureBatching = Renderer2D::GetTextureBatching();
+	Renderer2D::SetTextureBatching(Renderer2D::TextureBatching::Slots);
+
+	std::vector<TestQuad> quads = MakeQuads();
+
+	Renderer2D::ResetStats();
+	std::vector<NullRendererAPI::DrawCall> direct = Record(api, [&quads]() { DrawDirect(quads); });
+	CHECK(Renderer2D::GetStats().textureBatchBreaks > 0);
+	CHECK(direct.size() > 3);
+
+	ThreadPool::Init(3);
+	for (size_t chunkCount : { (size_t)1, (size_t)4, (size_t)16 })
+	{
+		std::vector<NullRendererAPI::DrawCall> submitted = Record(api, [&quads, chunkCount]() { DrawWithContexts(quads, chunkCount); });
+		CheckSameDraws(direct, submitted);
+	}
+	ThreadPool::Shutdown();
+
+	TextureAtlas::SetEnabled(atlasEnabled);
+	Renderer2D::SetTextureBatching(textureBatching);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// A context reused across frames must not hand out texture indices from the previous frame
+TEST(Renderer2D, ReusedContextMatchesFreshContext)
+{
+	CHECK(TestEnvironment::InitRenderer());
+
+	NullRendererAPI* api = dynamic_cast<NullRendererAPI*>(RenderCommand::GetRendererAPI());
+	CHECK(api != nullptr);
+	if (api == nullptr)
+		return;
+
+	bool atlasEnabled = TextureAtlas::IsEnabled();
+	TextureAtlas::SetEnabled(false);
+
+	std::vector<TestQuad> quads = MakeQuads();
+	std::vector<TestQuad> reversed(quads.rbegin(), quads.rend());
+
+	Renderer2D::SubmissionContext context;
+	auto submit = [&context](const std::vector<TestQuad>& frame)
+	{
+		for (size_t i = 0; i < frame.size(); i++)
+		{
+			if (frame[i].texture)
+				context.DrawQuad(frame[i].transform, frame[i].texture, frame[i].colour, 1.0f, (int)i);
+			else
+				context.DrawQuad(frame[i].transform, frame[i].colour, (int)i);
+		}
+		Renderer2D::Submit(context);
+	};
+
+	Record(api, [&]() { submit(quads); });
+	CHECK(context.Empty());
+	std::vector<NullRendererAPI::DrawCall> reused = Record(api, [&]() { submit(reversed); });
+
+	Renderer2D::SubmissionContext freshContext;
+	std::vector<NullRendererAPI::DrawCall> fresh = Record(api, [&]()
+		{
+			for (size_t i = 0; i < reversed.size(); i++)
+			{
+				if (reversed[i].texture)
+					freshContext.DrawQuad(reversed[i].transform, reversed[i].texture, reversed[i].colour, 1.0f, (int)i);
+				else
+					freshContext.DrawQuad(reversed[i].transform, reversed[i].colour, (int)i);
+			}
+			Renderer2D::Submit(freshContext);
+		});
+
+	CheckSameDraws(fresh, reused);
+
+	TextureAtlas::SetEnabled(atlasEnabled);
+}
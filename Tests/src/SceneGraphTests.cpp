@@ -0,0 +1,95 @@
+#include "stdafx.h"
+#include "Test.h"
+
+#include "Scene/Scene.h"
+#include "Scene/Entity.h"
+#include "Scene/Components.h"
+#include "Scene/SceneGraph.h"
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static Entity CreateNode(Scene& scene, const std::string& name, float x)
+{
+	Entity entity = scene.CreateEntity(name);
+	entity.AddComponent<TransformComponent>(Vector3f(x, 0.0f, 0.0f));
+	return entity;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static float WorldX(Entity entity)
+{
+	return entity.GetComponent<TransformComponent>().GetWorldMatrix().ExtractTranslation().x;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Each change to the hierarchy moves the affected subtree in the transform cache, the world positions and the number
+// of cached nodes match the hierarchy after every change
+TEST(SceneGraph, CacheFollowsHierarchyChanges)
+{
+	Scene scene("");
+	entt::registry& registry = scene.GetRegistry();
+
+	Entity a = CreateNode(scene, "A", 1.0f);
+	Entity b = CreateNode(scene, "B", 2.0f);
+	Entity c = CreateNode(scene, "C", 4.0f);
+	Entity d = CreateNode(scene, "D", 10.0f);
+	SceneGraph::Reparent(b, a);
+	SceneGraph::Reparent(c, b);
+
+	SceneGraph::Traverse(registry);
+	CHECK_EQUAL((uint32_t)4, SceneGraph::GetStats().nodeCount);
+	CHECK_EQUAL(1.0f, WorldX(a));
+	CHECK_EQUAL(3.0f, WorldX(b));
+	CHECK_EQUAL(7.0f, WorldX(c));
+	CHECK_EQUAL(10.0f, WorldX(d));
+
+	SceneGraph::Reparent(b, d);
+	SceneGraph::Traverse(registry);
+	CHECK_EQUAL((uint32_t)4, SceneGraph::GetStats().nodeCount);
+	CHECK_EQUAL(12.0f, WorldX(b));
+	CHECK_EQUAL(16.0f, WorldX(c));
+
+	Entity e = CreateNode(scene, "E", 100.0f);
+	SceneGraph::Reparent(e, c);
+	SceneGraph::Traverse(registry);
+	CHECK_EQUAL((uint32_t)5, SceneGraph::GetStats().nodeCount);
+	CHECK_EQUAL(116.0f, WorldX(e));
+
+	SceneGraph::Unparent(e);
+	SceneGraph::Traverse(registry);
+	CHECK_EQUAL((uint32_t)5, SceneGraph::GetStats().nodeCount);
+	CHECK_EQUAL(100.0f, WorldX(e));
+
+	// Without a transform the children can't be placed, so they leave the cache until it is added back
+	Entity f = CreateNode(scene, "F", 20.0f);
+	SceneGraph::Reparent(f, c);
+	b.RemoveComponent<TransformComponent>();
+	SceneGraph::Traverse(registry);
+	CHECK_EQUAL((uint32_t)3, SceneGraph::GetStats().nodeCount);
+
+	b.AddComponent<TransformComponent>(Vector3f(3.0f, 0.0f, 0.0f));
+	SceneGraph::Traverse(registry);
+	CHECK_EQUAL((uint32_t)6, SceneGraph::GetStats().nodeCount);
+	CHECK_EQUAL(13.0f, WorldX(b));
+	CHECK_EQUAL(17.0f, WorldX(c));
+	CHECK_EQUAL(37.0f, WorldX(f));
+
+	// Removing an entity removes its descendants with it
+	SceneGraph::Remove(b);
+	SceneGraph::Traverse(registry);
+	CHECK_EQUAL((uint32_t)3, SceneGraph::GetStats().nodeCount);
+	CHECK(!registry.valid(c.GetHandle()) && !registry.valid(f.GetHandle()));
+	CHECK(SceneGraph::GetChildren(d).empty());
+
+	// Entities created in place of the removed ones reuse their indices
+	Entity g = CreateNode(scene, "G", 5.0f);
+	Entity h = CreateNode(scene, "H", 6.0f);
+	SceneGraph::Reparent(h, g);
+	SceneGraph::Reparent(g, a);
+	SceneGraph::Traverse(registry);
+	CHECK_EQUAL((uint32_t)5, SceneGraph::GetStats().nodeCount);
+	CHECK_EQUAL(6.0f, WorldX(g));
+	CHECK_EQUAL(12.0f, WorldX(h));
+}
@@ -0,0 +1,317 @@
+#include "stdafx.h"
+#include "Test.h"
+#include "TestEnvironment.h"
+
+#include "Scene/Scene.h"
+#include "Scene/Entity.h"
+#include "Scene/Components.h"
+#include "Scene/SceneGraph.h"
+#include "Scene/SceneSerializer.h"
+#include "Scene/BinarySceneSerializer.h"
+
+#include <random>
+#include <unordered_map>
+
+static constexpr size_t s_EntityCount = 500;
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Entities with a spread of components and values, every fourth one a child of an earlier entity
+static void BuildScene(Scene& scene)
+{
+	std::mt19937 generator(1234);
+	std::uniform_real_distribution<float> value(-100.0f, 100.0f);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+	scene.SetGravity(Vector2f(0.0f, -4.5f));
+
+	std::vector<Entity> entities;
+	for (size_t i = 0; i < s_EntityCount; i++)
+	{
+		Entity entity = scene.CreateEntity("Entity " + std::to_string(i));
+		TransformComponent& transformComp = entity.GetOrAddComponent<TransformComponent>();
+		transformComp.position = Vector3f(value(generator), value(generator), value(generator));
+		transformComp.rotation = Vector3f(0.0f, 0.0f, unit(generator));
+		transformComp.scale = Vector3f(unit(generator) + 0.5f, unit(generator) + 0.5f, 1.0f);
+
+		switch (i % 5)
+		{
+		case 0:
+		{
+			SpriteComponent& spriteComp = entity.AddComponent<SpriteComponent>();
+			spriteComp.tint = Colour(unit(generator), unit(generator), unit(generator), 1.0f);
+			spriteComp.tilingFactor = unit(generator) * 4.0f;
+			break;
+		}
+		case 1:
+		{
+			CircleRendererComponent& circleComp = entity.AddComponent<CircleRendererComponent>();
+			circleComp.colour = Colour(unit(generator), unit(generator), unit(generator), unit(generator));
+			circleComp.radius = unit(generator);
+			circleComp.thickness = unit(generator);
+			circleComp.fade = unit(generator) * 0.1f;
+			break;
+		}
+		case 2:
+		{
+			RigidBody2DComponent& rigidBodyComp = entity.AddComponent<RigidBody2DComponent>(RigidBody2DComponent::BodyType::DYNAMIC, i % 2 == 0);
+			rigidBodyComp.gravityScale = unit(generator);
+			rigidBodyComp.angularDamping = unit(generator);
+			rigidBodyComp.linearDamping = unit(generator);
+
+			BoxCollider2DComponent& boxComp = entity.AddComponent<BoxCollider2DComponent>();
+			boxComp.offset = Vector2f(unit(generator), unit(generator));
+			boxComp.size = Vector2f(unit(generator) + 0.1f, unit(generator) + 0.1f);
+			boxComp.isTrigger = i % 3 == 0;
+
+			CircleCollider2DComponent& circleComp = entity.AddComponent<CircleCollider2DComponent>();
+			circleComp.offset = Vector2f(unit(generator), unit(generator));
+			circleComp.radius = unit(generator) + 0.1f;
+			circleComp.isTrigger = i % 3 == 1;
+			break;
+		}
+		case 3:
+		{
+			PolygonCollider2DComponent& polygonComp = entity.AddComponent<PolygonCollider2DComponent>();
+			polygonComp.vertices = { { 0.0f, 0.0f }, { unit(generator) + 0.1f, 0.0f }, { 0.0f, unit(generator) + 0.1f } };
+			polygonComp.offset = Vector2f(unit(generator), unit(generator));
+			polygonComp.isTrigger = false;
+
+			CapsuleCollider2DComponent& capsuleComp = entity.AddComponent<CapsuleCollider2DComponent>();
+			capsuleComp.direction = i % 2 == 0 ? CapsuleCollider2DComponent::Direction::Vertical : CapsuleCollider2DComponent::Direction::Horizontal;
+			capsuleComp.offset = Vector2f(unit(generator), unit(generator));
+			capsuleComp.radius = unit(generator) + 0.1f;
+			capsuleComp.height = unit(generator) + 0.5f;
+			capsuleComp.isTrigger = true;
+			break;
+		}
+		case 4:
+		{
+			PointLightComponent& lightComp = entity.AddComponent<PointLightComponent>();
+			lightComp.colour = Colour(unit(generator), unit(generator), unit(generator), 1.0f);
+			lightComp.castsShadows = i % 2 == 0;
+			lightComp.range = unit(generator) * 20.0f;
+			lightComp.attenuation = unit(generator);
+			break;
+		}
+		}
+
+		if (i == 0)
+		{
+			CameraComponent& cameraComp = entity.AddComponent<CameraComponent>();
+			cameraComp.camera.SetOrthographic(7.5f, -2.0f, 2.0f);
+			cameraComp.fixedAspectRatio = true;
+		}
+
+		if (i % 50 == 0)
+			entity.AddComponent<EntityPoolComponent>((uint32_t)i);
+
+		if (i % 4 == 3)
+			SceneGraph::Reparent(entity, entities[i / 2]);
+
+		entities.push_back(entity);
+	}
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static std::unordered_map<Uuid, entt::entity> MapByUuid(entt::registry& registry)
+{
+	std::unordered_map<Uuid, entt::entity> entities;
+	registry.view<IDComponent>().each([&](entt::entity entity, const IDComponent& idComp) { entities[idComp.ID] = entity; });
+	return entities;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// The id of the entity a hierarchy link points to, so links can be compared between registries
+static std::string LinkedUuid(entt::registry& registry, entt::entity entity)
+{
+	return entity == entt::null ? "null" : registry.get<IDComponent>(entity).ID.to_string();
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static bool Equal(const Vector2f& a, const Vector2f& b) { return a.x == b.x && a.y == b.y; }
+static bool Equal(const Vector3f& a, const Vector3f& b) { return a.x == b.x && a.y == b.y && a.z == b.z; }
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Both registries have the component or neither does, the values are compared when they both do
+template<typename Component, typename Compare>
+static void CheckComponent(entt::registry& expected, entt::entity expectedEntity, entt::registry& actual, entt::entity actualEntity, Compare compare)
+{
+	const Component* expectedComp = expected.try_get<Component>(expectedEntity);
+	const Component* actualComp = actual.try_get<Component>(actualEntity);
+	CHECK((expectedComp == nullptr) == (actualComp == nullptr));
+	if (expectedComp && actualComp)
+		compare(*expectedComp, *actualComp);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static void CheckSameRegistry(Scene& expectedScene, Scene& actualScene)
+{
+	entt::registry& expected = expectedScene.GetRegistry();
+	entt::registry& actual = actualScene.GetRegistry();
+
+	CHECK(Equal(expectedScene.GetGravity(), actualScene.GetGravity()));
+	CHECK_EQUAL(expectedScene.GetPixelsPerUnit(), actualScene.GetPixelsPerUnit());
+
+	std::unordered_map<Uuid, entt::entity> expectedEntities = MapByUuid(expected);
+	std::unordered_map<Uuid, entt::entity> actualEntities = MapByUuid(actual);
+	CHECK_EQUAL(expectedEntities.size(), actualEntities.size());
+
+	for (auto [uuid, expectedEntity] : expectedEntities)
+	{
+		auto found = actualEntities.find(uuid);
+		CHECK(found != actualEntities.end());
+		if (found == actualEntities.end())
+			continue;
+		entt::entity actualEntity = found->second;
+
+		CheckComponent<NameComponent>(expected, expectedEntity, actual, actualEntity,
+			[](const NameComponent& a, const NameComponent& b) { CHECK_EQUAL(a.name, b.name); });
+
+		CheckComponent<TransformComponent>(expected, expectedEntity, actual, actualEntity,
+			[](const TransformComponent& a, const TransformComponent& b)
+			{
+				CHECK(Equal(a.position, b.position));
+				CHECK(Equal(a.rotation, b.rotation));
+				CHECK(Equal(a.scale, b.scale));
+			});
+
+		CheckComponent<HierarchyComponent>(expected, expectedEntity, actual, actualEntity,
+			[&](const HierarchyComponent& a, const HierarchyComponent& b)
+			{
+				CHECK_EQUAL(LinkedUuid(expected, a.parent), LinkedUuid(actual, b.parent));
+				CHECK_EQUAL(LinkedUuid(expected, a.firstChild), LinkedUuid(actual, b.firstChild));
+				CHECK_EQUAL(LinkedUuid(expected, a.previousSibling), LinkedUuid(actual, b.previousSibling));
+				CHECK_EQUAL(LinkedUuid(expected, a.nextSibling), LinkedUuid(actual, b.nextSibling));
+				CHECK_EQUAL(a.isActive, b.isActive);
+			});
+
+		CheckComponent<SpriteComponent>(expected, expectedEntity, actual, actualEntity,
+			[](const SpriteComponent& a, const SpriteComponent& b)
+			{
+				CHECK(a.tint == b.tint);
+				CHECK_EQUAL(a.tilingFactor, b.tilingFactor);
+				CHECK(a.texture == b.texture);
+			});
+
+		CheckComponent<CircleRendererComponent>(expected, expectedEntity, actual, actualEntity,
+			[](const CircleRendererComponent& a, const CircleRendererComponent& b)
+			{
+				CHECK(a.colour == b.colour);
+				CHECK_EQUAL(a.radius, b.radius);
+				CHECK_EQUAL(a.thickness, b.thickness);
+				CHECK_EQUAL(a.fade, b.fade);
+			});
+
+		CheckComponent<RigidBody2DComponent>(expected, expectedEntity, actual, actualEntity,
+			[](const RigidBody2DComponent& a, const RigidBody2DComponent& b)
+			{
+				CHECK_EQUAL(a.type, b.type);
+				CHECK_EQUAL(a.fixedRotation, b.fixedRotation);
+				CHECK_EQUAL(a.gravityScale, b.gravityScale);
+				CHECK_EQUAL(a.angularDamping, b.angularDamping);
+				CHECK_EQUAL(a.linearDamping, b.linearDamping);
+			});
+
+		CheckComponent<BoxCollider2DComponent>(expected, expectedEntity, actual, actualEntity,
+			[](const BoxCollider2DComponent& a, const BoxCollider2DComponent& b)
+			{
+				CHECK(Equal(a.offset, b.offset));
+				CHECK(Equal(a.size, b.size));
+				CHECK_EQUAL(a.isTrigger, b.isTrigger);
+			});
+
+		CheckComponent<CircleCollider2DComponent>(expected, expectedEntity, actual, actualEntity,
+			[](const CircleCollider2DComponent& a, const CircleCollider2DComponent& b)
+			{
+				CHECK(Equal(a.offset, b.offset));
+				CHECK_EQUAL(a.radius, b.radius);
+				CHECK_EQUAL(a.isTrigger, b.isTrigger);
+			});
+
+		CheckComponent<PolygonCollider2DComponent>(expected, expectedEntity, actual, actualEntity,
+			[](const PolygonCollider2DComponent& a, const PolygonCollider2DComponent& b)
+			{
+				CHECK_EQUAL(a.vertices.size(), b.vertices.size());
+				for (size_t i = 0; i < a.vertices.size() && i < b.vertices.size(); i++)
+					CHECK(Equal(a.vertices[i], b.vertices[i]));
+				CHECK(Equal(a.offset, b.offset));
+				CHECK_EQUAL(a.isTrigger, b.isTrigger);
+			});
+
+		CheckComponent<CapsuleCollider2DComponent>(expected, expectedEntity, actual, actualEntity,
+			[](const CapsuleCollider2DComponent& a, const CapsuleCollider2DComponent& b)
+			{
+				CHECK_EQUAL(a.direction, b.direction);
+				CHECK(Equal(a.offset, b.offset));
+				CHECK_EQUAL(a.radius, b.radius);
+				CHECK_EQUAL(a.height, b.height);
+				CHECK_EQUAL(a.isTrigger, b.isTrigger);
+			});
+
+		CheckComponent<PointLightComponent>(expected, expectedEntity, actual, actualEntity,
+			[](const PointLightComponent& a, const PointLightComponent& b)
+			{
+				CHECK(a.colour == b.colour);
+				CHECK_EQUAL(a.castsShadows, b.castsShadows);
+				CHECK_EQUAL(a.range, b.range);
+				CHECK_EQUAL(a.attenuation, b.attenuation);
+			});
+
+		CheckComponent<CameraComponent>(expected, expectedEntity, actual, actualEntity,
+			[](const CameraComponent& a, const CameraComponent& b)
+			{
+				CHECK_EQUAL(a.primary, b.primary);
+				CHECK_EQUAL(a.fixedAspectRatio, b.fixedAspectRatio);
+				CHECK_EQUAL(a.camera.GetProjectionType(), b.camera.GetProjectionType());
+				CHECK_EQUAL(a.camera.GetOrthoSize(), b.camera.GetOrthoSize());
+				CHECK_EQUAL(a.camera.GetOrthoNear(), b.camera.GetOrthoNear());
+				CHECK_EQUAL(a.camera.GetOrthoFar(), b.camera.GetOrthoFar());
+				CHECK_EQUAL(a.camera.GetPerspectiveNear(), b.camera.GetPerspectiveNear());
+				CHECK_EQUAL(a.camera.GetPerspectiveFar(), b.camera.GetPerspectiveFar());
+				CHECK_EQUAL(a.camera.GetVerticalFov(), b.camera.GetVerticalFov());
+			});
+
+		CheckComponent<EntityPoolComponent>(expected, expectedEntity, actual, actualEntity,
+			[](const EntityPoolComponent& a, const EntityPoolComponent& b) { CHECK_EQUAL(a.prewarmCount, b.prewarmCount); });
+	}
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// A scene saved as xml, converted to binary and loaded again gives the same registry as loading the xml
+TEST(SceneSerializer, XmlToBinaryRoundTrip)
+{
+	CHECK(TestEnvironment::InitRenderer());
+
+	const std::filesystem::path directory = std::filesystem::temp_directory_path() / "SceneSerializerTests";
+	const std::filesystem::path xmlPath = directory / "Xml.scene";
+	const std::filesystem::path binaryPath = directory / "Binary.scene";
+	std::filesystem::create_directories(directory);
+
+	{
+		Scene scene(xmlPath);
+		BuildScene(scene);
+		CHECK(SceneSerializer(&scene).Serialize(xmlPath));
+	}
+
+	CHECK(!BinarySceneSerializer::IsBinaryScene(xmlPath));
+	CHECK(BinarySceneSerializer::ConvertFromXml(xmlPath, binaryPath));
+	CHECK(BinarySceneSerializer::IsBinaryScene(binaryPath));
+
+	Scene xmlScene(xmlPath);
+	CHECK(SceneSerializer(&xmlScene).Deserialize(xmlPath));
+	CHECK_EQUAL(s_EntityCount, xmlScene.GetRegistry().view<IDComponent>().size());
+
+	Scene binaryScene(binaryPath);
+	CHECK(BinarySceneSerializer(&binaryScene).Deserialize(binaryPath));
+
+	CheckSameRegistry(xmlScene, binaryScene);
+
+	std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,108 @@
+#include "stdafx.h"
+#include "Test.h"
+
+#include "Scene/SpatialGrid.h"
+
+#include <algorithm>
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static BoundingBox Square(float x, float y, float size)
+{
+	return BoundingBox(Vector3f(x, y, 0.0f), Vector3f(x + size, y + size, 0.0f));
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// The entities the grid finds in the area, in entity order
+static std::vector<entt::entity> Query(const SpatialGrid& grid, const BoundingBox& area)
+{
+	std::vector<entt::entity> results;
+	grid.Query(area, results);
+	std::sort(results.begin(), results.end());
+	return results;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+TEST(SpatialGrid, InsertAndQuery)
+{
+	entt::registry registry;
+	const entt::entity close = registry.create();
+	const entt::entity neighbour = registry.create();
+	const entt::entity distant = registry.create();
+	const entt::entity large = registry.create();
+
+	SpatialGrid grid(4.0f);
+	grid.Update(close, Square(1.0f, 1.0f, 1.0f), 1);
+	grid.Update(neighbour, Square(3.5f, 1.0f, 1.0f), 1); // centred in the next cell along but overhanging this one
+	grid.Update(distant, Square(100.0f, 100.0f, 1.0f), 1);
+	grid.Update(large, Square(-50.0f, -50.0f, 100.0f), 1); // larger than a cell
+	CHECK_EQUAL((size_t)4, grid.Size());
+
+	CHECK(grid.IsCurrent(close, 1));
+	CHECK(!grid.IsCurrent(close, 2));
+	CHECK(grid.GetBounds(distant).Min().x == 100.0f);
+
+	CHECK(Query(grid, Square(0.0f, 0.0f, 3.9f)) == std::vector<entt::entity>({ close, neighbour, large }));
+	CHECK(Query(grid, Square(0.0f, 0.0f, 2.0f)) == std::vector<entt::entity>({ close, large }));
+	CHECK(Query(grid, Square(99.0f, 99.0f, 4.0f)) == std::vector<entt::entity>({ distant }));
+	CHECK(Query(grid, Square(-1000.0f, -1000.0f, 1.0f)).empty());
+	CHECK(Query(grid, BoundingBox()).empty());
+
+	// An area covering more cells than are occupied finds the same entities
+	CHECK(Query(grid, Square(-1e6f, -1e6f, 2e6f)) == std::vector<entt::entity>({ close, neighbour, distant, large }));
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+TEST(SpatialGrid, MoveAndRemove)
+{
+	entt::registry registry;
+	const entt::entity first = registry.create();
+	const entt::entity second = registry.create();
+	const entt::entity third = registry.create();
+
+	SpatialGrid grid(4.0f);
+	grid.Update(first, Square(1.0f, 1.0f, 1.0f), 1);
+	grid.Update(second, Square(1.5f, 1.5f, 1.0f), 1);
+	grid.Update(third, Square(2.0f, 2.0f, 1.0f), 1);
+
+	// Moving an entity takes it out of its old cell rather than adding it twice
+	grid.Update(first, Square(41.0f, 1.0f, 1.0f), 2);
+	CHECK_EQUAL((size_t)3, grid.Size());
+	CHECK(grid.IsCurrent(first, 2));
+	CHECK(grid.GetBounds(first).Min().x == 41.0f);
+	CHECK(Query(grid, Square(0.0f, 0.0f, 4.0f)) == std::vector<entt::entity>({ second, third }));
+	CHECK(Query(grid, Square(40.0f, 0.0f, 4.0f)) == std::vector<entt::entity>({ first }));
+
+	// Growing past the cell size moves it into the oversized list, shrinking moves it back
+	grid.Update(first, Square(40.0f, 0.0f, 10.0f), 3);
+	CHECK(Query(grid, Square(48.0f, 8.0f, 1.0f)) == std::vector<entt::entity>({ first }));
+	grid.Update(first, Square(41.0f, 1.0f, 1.0f), 4);
+	CHECK(Query(grid, Square(48.0f, 8.0f, 1.0f)).empty());
+	CHECK_EQUAL((size_t)3, grid.Size());
+
+	// Removing an entity leaves the others in its cell
+	grid.Remove(second);
+	CHECK_EQUAL((size_t)2, grid.Size());
+	CHECK(!grid.IsCurrent(second, 1));
+	CHECK(!grid.GetBounds(second).IsValid());
+	CHECK(Query(grid, Square(0.0f, 0.0f, 4.0f)) == std::vector<entt::entity>({ third }));
+
+	// Removing again, or removing an entity that was never inserted, does nothing
+	grid.Remove(second);
+	grid.Remove(registry.create());
+	CHECK_EQUAL((size_t)2, grid.Size());
+
+	// A destroyed entity's index can be reused by a new entity without it inheriting the old entry
+	registry.destroy(third);
+	const entt::entity recycled = registry.create();
+	CHECK(!grid.IsCurrent(recycled, 1));
+	grid.Remove(recycled);
+	CHECK_EQUAL((size_t)2, grid.Size());
+
+	grid.Clear();
+	CHECK_EQUAL((size_t)0, grid.Size());
+	CHECK(Query(grid, Square(-1e6f, -1e6f, 2e6f)).empty());
+}
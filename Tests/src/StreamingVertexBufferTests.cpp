@@ -0,0 +1,147 @@
+#include "stdafx.h"
+#include "Test.h"
+#include "TestEnvironment.h"
+
+#include "Renderer/StreamingVertexBuffer.h"
+#include "Renderer/RenderCommand.h"
+#include "Platform/Null/NullRendererAPI.h"
+
+static constexpr uint32_t s_RegionSize = 1024;
+static constexpr uint32_t s_RegionCount = 3;
+static constexpr uint32_t s_Stride = 16;
+static constexpr uint32_t s_RegionVertices = s_RegionSize / s_Stride;
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static NullRendererAPI* InitNullRenderer()
+{
+	CHECK(TestEnvironment::InitRenderer());
+
+	NullRendererAPI* api = dynamic_cast<NullRendererAPI*>(RenderCommand::GetRendererAPI());
+	CHECK(api != nullptr);
+	if (api)
+	{
+		api->SignalFences();
+		api->ClearRecording();
+	}
+	return api;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static Scope<StreamingVertexBuffer> CreateBuffer()
+{
+	Scope<StreamingVertexBuffer> buffer = CreateScope<StreamingVertexBuffer>(s_RegionSize, s_RegionCount);
+	buffer->SetLayout({ { ShaderDataType::Float4, "a_Position" } });
+	return buffer;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Fill, commit and draw from the current region, returning the first vertex of the region
+static uint32_t DrawBatch(StreamingVertexBuffer& buffer)
+{
+	void* vertices = buffer.Begin();
+	CHECK(vertices != nullptr);
+	memset(vertices, 0, s_RegionSize);
+	uint32_t firstVertex = buffer.Commit(s_RegionSize);
+	buffer.Fence();
+	return firstVertex;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// With the GPU keeping up, batches go through the regions in turn and back to the first without waiting
+TEST(StreamingVertexBuffer, WrapsAroundRegions)
+{
+	NullRendererAPI* api = InitNullRenderer();
+	if (api == nullptr)
+		return;
+
+	Scope<StreamingVertexBuffer> buffer = CreateBuffer();
+	CHECK(!buffer->IsMapped());
+
+	for (uint32_t batch = 0; batch < s_RegionCount * 3; batch++)
+	{
+		CHECK_EQUAL((batch % s_RegionCount) * s_RegionVertices, DrawBatch(*buffer));
+		CHECK(!buffer->Stalled());
+		api->SignalFences();
+	}
+
+	CHECK_EQUAL((uint32_t)0, api->GetFenceStallCount());
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Coming back round to a region the GPU may still be drawing from waits on that region's fence, and only that one
+TEST(StreamingVertexBuffer, WaitsForFenceOfReusedRegion)
+{
+	NullRendererAPI* api = InitNullRenderer();
+	if (api == nullptr)
+		return;
+
+	Scope<StreamingVertexBuffer> buffer = CreateBuffer();
+	const size_t fencesBefore = api->GetFenceCount();
+
+	for (uint32_t batch = 0; batch < s_RegionCount; batch++)
+	{
+		DrawBatch(*buffer);
+		CHECK(!buffer->Stalled());
+	}
+	CHECK_EQUAL(fencesBefore + s_RegionCount, api->GetFenceCount());
+
+	// The first region's fence is waited on and deleted, the later regions' are left pending
+	buffer->Begin();
+	CHECK(buffer->Stalled());
+	CHECK_EQUAL((uint32_t)1, api->GetFenceStallCount());
+	CHECK_EQUAL(fencesBefore + s_RegionCount - 1, api->GetFenceCount());
+	CHECK_EQUAL((uint32_t)0, buffer->Commit(s_RegionSize));
+	buffer->Fence();
+
+	// Once the GPU has caught up nothing waits
+	api->SignalFences();
+	buffer->Begin();
+	CHECK(!buffer->Stalled());
+	CHECK_EQUAL((uint32_t)1, api->GetFenceStallCount());
+	CHECK_EQUAL(s_RegionVertices, buffer->Commit(s_RegionSize));
+	buffer->Fence();
+
+	// Deleting the buffer deletes the fences it still holds
+	buffer.reset();
+	CHECK_EQUAL(fencesBefore, api->GetFenceCount());
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// A region is written over until something is drawn from it, and drawing from it again replaces its fence
+TEST(StreamingVertexBuffer, ReusesRegionUntilDrawn)
+{
+	NullRendererAPI* api = InitNullRenderer();
+	if (api == nullptr)
+		return;
+
+	Scope<StreamingVertexBuffer> buffer = CreateBuffer();
+	const size_t fencesBefore = api->GetFenceCount();
+
+	// Nothing drawn, so the next batch starts in the same region
+	buffer->Begin();
+	CHECK_EQUAL((uint32_t)0, buffer->Commit(s_RegionSize));
+	buffer->Begin();
+	CHECK_EQUAL((uint32_t)0, buffer->Commit(s_RegionSize));
+
+	// Two draws from one region leave one fence for it
+	buffer->Fence();
+	buffer->Fence();
+	CHECK_EQUAL(fencesBefore + 1, api->GetFenceCount());
+
+	// Regions are taken in order, the one after the last drawn from
+	CHECK_EQUAL(s_RegionVertices, DrawBatch(*buffer));
+	CHECK_EQUAL(2 * s_RegionVertices, DrawBatch(*buffer));
+	CHECK_EQUAL(fencesBefore + s_RegionCount, api->GetFenceCount());
+
+	// However many batches go through, each region holds at most one fence
+	for (uint32_t batch = 0; batch < s_RegionCount * 4; batch++)
+		DrawBatch(*buffer);
+	CHECK_EQUAL(fencesBefore + s_RegionCount, api->GetFenceCount());
+	CHECK_EQUAL(s_RegionCount * 4, api->GetFenceStallCount());
+}
@@ -0,0 +1,68 @@
+#include "stdafx.h"
+#include "Test.h"
+
+struct RegisteredTest
+{
+	const char* suite;
+	const char* name;
+	Test::Function function;
+};
+
+// Registered from static initializers so the list has to be created on first use
+static std::vector<RegisteredTest>& GetTests()
+{
+	static std::vector<RegisteredTest> s_Tests;
+	return s_Tests;
+}
+
+static uint32_t s_Failures = 0;
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+bool Test::Register(const char* suite, const char* name, Function function)
+{
+	GetTests().push_back({ suite, name, function });
+	return true;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+int Test::Run(int argc, char* argv[])
+{
+	std::vector<std::string> selected(argv + 1, argv + argc);
+
+	uint32_t run = 0;
+	uint32_t failed = 0;
+	for (const RegisteredTest& test : GetTests())
+	{
+		if (!selected.empty() && std::find(selected.begin(), selected.end(), test.suite) == selected.end())
+			continue;
+
+		uint32_t failuresBefore = s_Failures;
+		test.function();
+		run++;
+
+		bool passed = s_Failures == failuresBefore;
+		if (!passed)
+			failed++;
+		std::printf("%s %s.%s\n", passed ? "[  passed  ]" : "[  FAILED  ]", test.suite, test.name);
+		std::fflush(stdout);
+	}
+
+	if (run == 0)
+	{
+		std::printf("No tests matched\n");
+		return 1;
+	}
+
+	std::printf("%u of %u tests passed\n", run - failed, run);
+	return failed == 0 ? 0 : 1;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void Test::Fail(const char* file, int line, const std::string& message)
+{
+	s_Failures++;
+	std::printf("%s(%d): check failed: %s\n", file, line, message.c_str());
+}
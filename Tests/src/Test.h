@@ -0,0 +1,47 @@
+#pragma once
+
+#include <string>
+#include <type_traits>
+
+// A named test in a suite. Run the executable with the names of the suites to run, or with no arguments to run them all
+class Test
+{
+public:
+	using Function = void(*)();
+
+	static bool Register(const char* suite, const char* name, Function function);
+	static int Run(int argc, char* argv[]);
+
+	// Record a failed check, the test carries on so every failure is reported
+	static void Fail(const char* file, int line, const std::string& message);
+
+	template<typename Expected, typename Actual>
+	static void CheckEqual(const Expected& expected, const Actual& actual, const char* file, int line, const char* text)
+	{
+		if (!(expected == actual))
+			Fail(file, line, std::string(text) + " (" + ToString(expected) + " != " + ToString(actual) + ")");
+	}
+
+private:
+	template<typename T>
+	static std::string ToString(const T& value)
+	{
+		if constexpr (std::is_enum_v<T>)
+			return std::to_string((long long)value);
+		else if constexpr (std::is_arithmetic_v<T>)
+			return std::to_string(value);
+		else if constexpr (std::is_convertible_v<T, std::string>)
+			return std::string(value);
+		else
+			return "?";
+	}
+};
+
+#define TEST(suite, name) \
+	static void Test_##suite##_##name(); \
+	static bool s_Test_##suite##_##name = Test::Register(#suite, #name, &Test_##suite##_##name); \
+	static void Test_##suite##_##name()
+
+#define CHECK(condition) do { if (!(condition)) Test::Fail(__FILE__, __LINE__, #condition); } while (false)
+
+#define CHECK_EQUAL(expected, actual) Test::CheckEqual((expected), (actual), __FILE__, __LINE__, #expected " == " #actual)
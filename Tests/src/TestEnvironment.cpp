@@ -0,0 +1,21 @@
+#include "stdafx.h"
+#include "TestEnvironment.h"
+
+#include "Renderer/Renderer.h"
+#include "Renderer/RenderCommand.h"
+
+static bool s_RendererInitialized = false;
+static bool s_Software = false;
+
+bool TestEnvironment::InitRenderer(bool software)
+{
+	if (s_RendererInitialized && s_Software == software)
+		return true;
+
+	if (s_RendererInitialized)
+		Renderer::Shutdown();
+
+	s_RendererInitialized = RenderCommand::CreateRendererAPI(true, software) == 0 && Renderer::Init();
+	s_Software = software;
+	return s_RendererInitialized;
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+// Engine set up shared by the tests, nothing needs a window
+class TestEnvironment
+{
+public:
+	// Start the renderer headless with the null API, or the software API when software is set. Calling it again
+	// with the other API restarts the renderer
+	static bool InitRenderer(bool software = false);
+};
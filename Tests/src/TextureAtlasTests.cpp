@@ -0,0 +1,261 @@
+#include "stdafx.h"
+#include "Test.h"
+#include "TestEnvironment.h"
+
+#include "Renderer/AtlasPacker.h"
+#include "Renderer/TextureAtlas.h"
+#include "Platform/Software/SoftwareTexture.h"
+
+#include <random>
+#include <cmath>
+
+static constexpr uint32_t s_PackerSize = 1024;
+static constexpr uint32_t s_PageSize = 64;
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static bool Overlap(const AtlasPacker::Rect& a, const AtlasPacker::Rect& b)
+{
+	return a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height && b.y < a.y + a.height;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// The texels a region covers in its page, grown by the gutter
+static AtlasPacker::Rect PageRect(const TextureAtlas::Region& region, uint32_t gutter)
+{
+	const float size = (float)s_PageSize;
+	AtlasPacker::Rect rect;
+	rect.x = (uint32_t)std::lround(region.offset.x * size) - gutter;
+	rect.y = (uint32_t)std::lround(region.offset.y * size) - gutter;
+	rect.width = (uint32_t)std::lround(region.scale.x * size) + 2 * gutter;
+	rect.height = (uint32_t)std::lround(region.scale.y * size) + 2 * gutter;
+	return rect;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static void CheckRegionsApart(const std::vector<const TextureAtlas::Region*>& regions)
+{
+	std::vector<AtlasPacker::Rect> rects;
+	for (const TextureAtlas::Region* region : regions)
+	{
+		CHECK(region != nullptr);
+		if (region == nullptr)
+			return;
+
+		AtlasPacker::Rect rect = PageRect(*region, 1);
+		CHECK(rect.x + rect.width <= s_PageSize && rect.y + rect.height <= s_PageSize);
+		for (const AtlasPacker::Rect& other : rects)
+			CHECK(!Overlap(rect, other));
+		rects.push_back(rect);
+	}
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Sets the atlas up with one small page for a test and puts the renderer's atlas back afterwards
+struct ScopedAtlas
+{
+	bool enabled;
+
+	ScopedAtlas()
+	{
+		enabled = TextureAtlas::IsEnabled();
+		TextureAtlas::Init(s_PageSize, 1, 32);
+		TextureAtlas::SetEnabled(true);
+	}
+
+	~ScopedAtlas()
+	{
+		TextureAtlas::Init();
+		TextureAtlas::SetEnabled(enabled);
+	}
+};
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+TEST(AtlasPacker, RectanglesStayInBoundsAndApart)
+{
+	std::mt19937 generator(1234);
+	std::uniform_int_distribution<uint32_t> size(1, 96);
+
+	AtlasPacker packer(s_PackerSize, s_PackerSize);
+	std::vector<AtlasPacker::Rect> rects;
+	uint64_t area = 0;
+	uint32_t failures = 0;
+
+	while (failures < 32)
+	{
+		uint32_t width = size(generator), height = size(generator);
+		AtlasPacker::Rect rect;
+		if (!packer.Insert(width, height, rect))
+		{
+			failures++;
+			continue;
+		}
+
+		CHECK_EQUAL(width, rect.width);
+		CHECK_EQUAL(height, rect.height);
+		CHECK(rect.x + rect.width <= s_PackerSize && rect.y + rect.height <= s_PackerSize);
+		rects.push_back(rect);
+		area += (uint64_t)width * height;
+	}
+
+	for (size_t i = 0; i < rects.size(); i++)
+	{
+		for (size_t j = i + 1; j < rects.size(); j++)
+			CHECK(!Overlap(rects[i], rects[j]));
+	}
+
+	CHECK_EQUAL(area, packer.GetUsedArea());
+	CHECK(packer.GetOccupancy() > 0.75f);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+TEST(AtlasPacker, RejectsWhatDoesntFit)
+{
+	AtlasPacker packer(s_PackerSize, s_PackerSize);
+	AtlasPacker::Rect rect;
+
+	CHECK(!packer.Insert(0, 16, rect));
+	CHECK(!packer.Insert(16, 0, rect));
+	CHECK(!packer.Insert(s_PackerSize + 1, 16, rect));
+	CHECK(!packer.Insert(16, s_PackerSize + 1, rect));
+	CHECK(packer.Insert(s_PackerSize, s_PackerSize, rect));
+	CHECK(!packer.Insert(1, 1, rect));
+	CHECK_EQUAL(1.0f, packer.GetOccupancy());
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Squares that tile the packer exactly fill it, and fill it again after it is cleared
+TEST(AtlasPacker, ClearReclaimsSpace)
+{
+	constexpr uint32_t tile = 64;
+	constexpr uint32_t tiles = (s_PackerSize / tile) * (s_PackerSize / tile);
+
+	AtlasPacker packer(s_PackerSize, s_PackerSize);
+	for (int pass = 0; pass < 2; pass++)
+	{
+		AtlasPacker::Rect rect;
+		uint32_t inserted = 0;
+		while (packer.Insert(tile, tile, rect))
+			inserted++;
+
+		CHECK_EQUAL(tiles, inserted);
+		CHECK_EQUAL(1.0f, packer.GetOccupancy());
+
+		packer.Clear();
+		CHECK_EQUAL((uint64_t)0, packer.GetUsedArea());
+	}
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// With the page full, the texture drawn longest ago makes room for the one that didn't fit
+TEST(TextureAtlas, EvictsLeastRecentlyUsed)
+{
+	CHECK(TestEnvironment::InitRenderer());
+	ScopedAtlas atlas;
+
+	// Four fit in a page with their gutters
+	std::vector<Ref<Texture>> textures;
+	for (int i = 0; i < 5; i++)
+		textures.push_back(Texture2D::Create(30, 30));
+
+	for (int i = 0; i < 4; i++)
+		CHECK(TextureAtlas::Find(textures[i]) != nullptr);
+
+	TextureAtlas::NewFrame();
+	for (int i = 1; i < 4; i++)
+		TextureAtlas::Find(textures[i]);
+	CHECK(TextureAtlas::Find(textures[4]) == nullptr);
+
+	TextureAtlas::Stats before = TextureAtlas::GetStats();
+	TextureAtlas::NewFrame();
+
+	std::vector<const TextureAtlas::Region*> regions;
+	for (int i = 1; i < 5; i++)
+		regions.push_back(TextureAtlas::Find(textures[i]));
+	CheckRegionsApart(regions);
+
+	TextureAtlas::Stats after = TextureAtlas::GetStats();
+	CHECK_EQUAL(before.evictions + 1, after.evictions);
+	CHECK_EQUAL((uint32_t)4, after.textures);
+	CHECK(TextureAtlas::Find(textures[0]) == nullptr);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// Holes left by destroyed textures are gathered up by repacking the page, without evicting anything
+TEST(TextureAtlas, RepackReclaimsHoles)
+{
+	CHECK(TestEnvironment::InitRenderer());
+	ScopedAtlas atlas;
+
+	// Eight narrow textures fill the page, destroying every other one leaves holes too narrow for the wide one
+	std::vector<Ref<Texture>> textures;
+	for (int i = 0; i < 8; i++)
+	{
+		textures.push_back(Texture2D::Create(14, 30));
+		CHECK(TextureAtlas::Find(textures[i]) != nullptr);
+	}
+	for (int i = 0; i < 8; i += 2)
+		textures[i].reset();
+
+	Ref<Texture> wide = Texture2D::Create(30, 30);
+	CHECK(TextureAtlas::Find(wide) == nullptr);
+
+	TextureAtlas::Stats before = TextureAtlas::GetStats();
+	TextureAtlas::NewFrame();
+
+	std::vector<const TextureAtlas::Region*> regions = { TextureAtlas::Find(wide) };
+	for (int i = 1; i < 8; i += 2)
+		regions.push_back(TextureAtlas::Find(textures[i]));
+	CheckRegionsApart(regions);
+
+	TextureAtlas::Stats after = TextureAtlas::GetStats();
+	CHECK_EQUAL(before.evictions, after.evictions);
+	CHECK_EQUAL(before.defragmentations + 1, after.defragmentations);
+	CHECK_EQUAL((uint32_t)5, after.textures);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+// The gutter on every side repeats the texel next to it, corners included
+TEST(TextureAtlas, GutterRepeatsEdgeTexels)
+{
+	CHECK(TestEnvironment::InitRenderer(true));
+	ScopedAtlas atlas;
+
+	constexpr uint32_t width = 3, height = 2;
+	const uint32_t pixels[width * height] = { 0xff0000ff, 0xff00ff00, 0xffff0000, 0xff00ffff, 0xffff00ff, 0xffffff00 };
+	Ref<Texture> texture = Texture2D::Create(width, height, Texture::Format::RGBA, pixels);
+
+	const TextureAtlas::Region* region = TextureAtlas::Find(texture);
+	CHECK(region != nullptr);
+	if (region == nullptr)
+		return;
+
+	const SoftwareTexture2D* page = dynamic_cast<const SoftwareTexture2D*>(region->page.get());
+	CHECK(page != nullptr);
+	if (page == nullptr)
+		return;
+
+	AtlasPacker::Rect rect = PageRect(*region, 1);
+	CHECK_EQUAL(width + 2, rect.width);
+	CHECK_EQUAL(height + 2, rect.height);
+
+	const std::vector<uint32_t>& pagePixels = page->GetPixels();
+	for (uint32_t y = 0; y < rect.height; y++)
+	{
+		for (uint32_t x = 0; x < rect.width; x++)
+		{
+			uint32_t sourceX = std::clamp((int)x - 1, 0, (int)width - 1);
+			uint32_t sourceY = std::clamp((int)y - 1, 0, (int)height - 1);
+			CHECK_EQUAL(pixels[sourceY * width + sourceX], pagePixels[(size_t)(rect.y + y) * s_PageSize + rect.x + x]);
+		}
+	}
+}
@@ -0,0 +1,10 @@
+#include "stdafx.h"
+#include "Test.h"
+
+#include "Logging/Logger.h"
+
+int main(int argc, char* argv[])
+{
+	Logger::Init();
+	return Test::Run(argc, argv);
+}